@@ -256,7 +256,7 @@ BOOLEAN DeleteStackNodeContents( undo_stack *pCurrent )
 	while ( pLandNode != NULL )
 	{
 		pMapTile->pLandHead = pLandNode->pNext;
-		MemFree( pLandNode );
+		FreeLevelNode( pLandNode );
 		pLandNode = pMapTile->pLandHead;
 	}
 
@@ -264,7 +264,7 @@ BOOLEAN DeleteStackNodeContents( undo_stack *pCurrent )
 	while ( pObjectNode != NULL )
 	{
 		pMapTile->pObjectHead = pObjectNode->pNext;
-		MemFree( pObjectNode );
+		FreeLevelNode( pObjectNode );
 		pObjectNode = pMapTile->pObjectHead;
 	}
 
@@ -272,7 +272,7 @@ BOOLEAN DeleteStackNodeContents( undo_stack *pCurrent )
 	while ( pStructNode != NULL )
 	{
 		pMapTile->pStructHead = pStructNode->pNext;
-		MemFree( pStructNode );
+		FreeLevelNode( pStructNode );
 		pStructNode = pMapTile->pStructHead;
 	}
 
@@ -280,7 +280,7 @@ BOOLEAN DeleteStackNodeContents( undo_stack *pCurrent )
 	while ( pShadowNode != NULL )
 	{
 		pMapTile->pShadowHead = pShadowNode->pNext;
-		MemFree( pShadowNode );
+		FreeLevelNode( pShadowNode );
 		pShadowNode = pMapTile->pShadowHead;
 	}
 
@@ -288,7 +288,7 @@ BOOLEAN DeleteStackNodeContents( undo_stack *pCurrent )
 	while ( pMercNode != NULL )
 	{
 		pMapTile->pMercHead = pMercNode->pNext;
-		MemFree( pMercNode );
+		FreeLevelNode( pMercNode );
 		pMercNode = pMapTile->pMercHead;
 	}
 
@@ -296,7 +296,7 @@ BOOLEAN DeleteStackNodeContents( undo_stack *pCurrent )
 	while ( pRoofNode != NULL )
 	{
 		pMapTile->pRoofHead = pRoofNode->pNext;
-		MemFree( pRoofNode );
+		FreeLevelNode( pRoofNode );
 		pRoofNode = pMapTile->pRoofHead;
 	}
 
@@ -304,7 +304,7 @@ BOOLEAN DeleteStackNodeContents( undo_stack *pCurrent )
 	while ( pOnRoofNode != NULL )
 	{
 		pMapTile->pOnRoofHead = pOnRoofNode->pNext;
-		MemFree( pOnRoofNode );
+		FreeLevelNode( pOnRoofNode );
 		pOnRoofNode = pMapTile->pOnRoofHead;
 	}
 
@@ -312,7 +312,7 @@ BOOLEAN DeleteStackNodeContents( undo_stack *pCurrent )
 	while ( pTopmostNode != NULL )
 	{
 		pMapTile->pTopmostHead = pTopmostNode->pNext;
-		MemFree( pTopmostNode );
+		FreeLevelNode( pTopmostNode );
 		pTopmostNode = pMapTile->pTopmostHead;
 	}
 
@@ -758,7 +758,7 @@ void DeleteMapElementContentsAfterCreationFail( MAP_ELEMENT *pNewMapElement )
 			LEVELNODE *temp;
 			temp = pLevelNode;
 			pLevelNode = pLevelNode->pNext;
-			MemFree( temp );
+			FreeLevelNode( temp );
 		}
 	}
 	pStructure = pNewMapElement->pStructureHead;
@@ -875,7 +875,7 @@ BOOLEAN CopyMapElementFromWorld( MAP_ELEMENT *pNewMapElement, INT32 iMapIndex )
 				continue;
 			}
 			//copy the level node
-			pLevelNode = ( LEVELNODE* )MemAlloc( sizeof( LEVELNODE ) );
+			pLevelNode = AllocLevelNode();
 			if( !pLevelNode )
 			{
 				DeleteMapElementContentsAfterCreationFail( pNewMapElement );
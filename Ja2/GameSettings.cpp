@@ -1132,6 +1132,11 @@ void LoadGameExternalOptions()
 	gGameExternalOptions.autoSaveOnAssertionFailure		= iniReader.ReadBoolean("Troubleshooting Settings","AUTO_SAVE_ON_ASSERTION_FAILURE", FALSE);
 	gGameExternalOptions.autoSaveTime 					= iniReader.ReadInteger("Troubleshooting Settings","AUTO_SAVE_EVERY_N_HOURS", 6, 0, 24);
 
+	// zlib compress the savegame data (turn off to get savegames that are easier to look into)
+	gGameExternalOptions.fCompressSaveGames				= iniReader.ReadBoolean("Troubleshooting Settings","COMPRESS_SAVE_GAMES", TRUE);
+	// write autosaves on a worker thread instead of holding the game until they are on disk
+	gGameExternalOptions.fBackgroundAutoSave			= iniReader.ReadBoolean("Troubleshooting Settings","BACKGROUND_AUTO_SAVE", TRUE);
+
 	//################# Graphics Settings #################
 	gGameExternalOptions.gfVSync = iniReader.ReadBoolean("Graphics Settings","VERTICAL_SYNC",0);
 
@@ -1186,6 +1191,21 @@ void LoadGameExternalOptions()
 	gGameExternalOptions.ubOverheadMapModeDay				= iniReader.ReadInteger("Graphics Settings", "OVERHEAD_MAP_MODE_DAY", 0, 0, 2);
 	gGameExternalOptions.ubOverheadMapModeNight				= iniReader.ReadInteger("Graphics Settings", "OVERHEAD_MAP_MODE_NIGHT", 0, 0, 3);
 
+	// memory (in MB) for soldier animations that are kept loaded after the last soldier using them stopped (0 = none, and no prefetching)
+	gGameExternalOptions.uiAnimationCacheBudget				= iniReader.ReadInteger("Graphics Settings", "ANIMATION_CACHE_BUDGET", 64, 0, 1024) * 1024 * 1024;
+
+	// memory (in MB) for tiles in the tile cache (explosions, corpses, ...) that are kept around after they were last used
+	gGameExternalOptions.uiTileCacheBudget					= iniReader.ReadInteger("Graphics Settings", "TILE_CACHE_BUDGET", 32, 1, 1024) * 1024 * 1024;
+
+	// render the world tiles in that many horizontal bands, each on its own thread (0 or 1 = all on the main thread)
+	gGameExternalOptions.ubRenderBands						= iniReader.ReadInteger("Graphics Settings", "RENDER_BANDS", 1, 0, 8);
+
+	// after loading a map, move the tile nodes (land, objects, structs, ...) together tile by tile for faster rendering and lighting
+	gGameExternalOptions.fCompactLevelNodes					= iniReader.ReadBoolean("Graphics Settings", "COMPACT_LEVELNODES", TRUE);
+
+	// when a squad arrives in a sector within that many game minutes, read its map and tileset ahead of time (0 = off)
+	gGameExternalOptions.ubSectorPreloadMinutes				= iniReader.ReadInteger("Graphics Settings", "SECTOR_PRELOAD_MINUTES", 30, 0, 240);
+
 	//################# Sound Settings #################
 	
 	gGameExternalOptions.guiWeaponSoundEffectsVolume		= iniReader.ReadInteger("Sound Settings","WEAPON_SOUND_EFFECTS_VOLUME", 0, 0, 1000 /*1000 = 10x?*/);
@@ -1517,6 +1537,9 @@ void LoadGameExternalOptions()
 	gGameExternalOptions.gfAllowLimitedVision				= iniReader.ReadBoolean("Tactical Vision Settings","ALLOW_TUNNEL_VISION",0);
 	gGameExternalOptions.usLowerVisionWhileRunning			= iniReader.ReadInteger("Tactical Vision Settings", "LOWER_VISION_WHILE_RUNNING", 0, 0, 2 );
 
+	// remember line of sight results until a structure or smoke cloud changes
+	gGameExternalOptions.fSightCache						= iniReader.ReadBoolean("Tactical Vision Settings","SIGHT_CACHE",FALSE);
+
 	//################# Tactical Tooltip Settings #################
 
 	// ShadoWarrior: Tooltip changes (start)
@@ -1585,6 +1608,9 @@ void LoadGameExternalOptions()
 
 	gGameExternalOptions.fScopeModes						= iniReader.ReadBoolean("Tactical Gameplay Settings","USE_SCOPE_MODES", FALSE);
 
+	// keep item and attachment bonuses with the object until it changes (2: also check each cached value against a fresh one)
+	gGameExternalOptions.ubItemStatsCache					= iniReader.ReadInteger("Tactical Gameplay Settings","ITEM_STATS_CACHE", 0, 0, 2);
+
 	gGameExternalOptions.usSpotterPreparationTurns			= iniReader.ReadInteger("Tactical Gameplay Settings","SPOTTER_PREPARATIONTURNS", 2, 2,  10);
 	gGameExternalOptions.usSpotterRange						= iniReader.ReadInteger("Tactical Gameplay Settings","SPOTTER_RANGE",			10, 0,  30);
 	gGameExternalOptions.usSpotterMaxCTHBoost				= iniReader.ReadInteger("Tactical Gameplay Settings","SPOTTER_MAX_CTHBOOST",	50, 0, 100);
@@ -2568,6 +2594,8 @@ void LoadGameExternalOptions()
 	gGameExternalOptions.fAITacticalRetreat = iniReader.ReadBoolean("Tactical AI Settings", "AI_TACTICAL_RETREAT", FALSE);
 	gGameExternalOptions.fAIMovementMode = iniReader.ReadBoolean("Tactical AI Settings", "AI_MOVEMENT_MODE", TRUE);
 	gGameExternalOptions.fAIPathTweaks = iniReader.ReadBoolean("Tactical AI Settings", "AI_PATH_TWEAKS", TRUE);
+	gGameExternalOptions.fHierarchicalPathfinding = iniReader.ReadBoolean("Tactical AI Settings", "HIERARCHICAL_PATHFINDING", FALSE);
+	gGameExternalOptions.fAIPathCache = iniReader.ReadBoolean("Tactical AI Settings", "AI_PATH_CACHE", FALSE);
 	gGameExternalOptions.fAIShootUnseen = iniReader.ReadBoolean("Tactical AI Settings", "AI_SHOOT_UNSEEN", FALSE);
 	gGameExternalOptions.fAISafeSuppression = iniReader.ReadBoolean("Tactical AI Settings", "AI_SAFE_SUPPRESSION", TRUE);
 
@@ -636,6 +636,9 @@ typedef struct
 	BOOLEAN autoSaveOnAssertionFailure;
 	UINT32  autoSaveTime;
 
+	BOOLEAN fCompressSaveGames;			// pack the chunks of the savegame container with zlib
+	BOOLEAN fBackgroundAutoSave;		// write end turn and timed autosaves on a worker thread
+
 	//JMich
 	UINT16 guiMaxWeaponSize;
 	UINT16 guiMaxItemSize;
@@ -652,6 +655,8 @@ typedef struct
 	BOOLEAN gfAllowLimitedVision;
 	UINT8 usLowerVisionWhileRunning;
 
+	BOOLEAN fSightCache;
+
 	BOOLEAN gfShiftFUnloadWeapons;
 	BOOLEAN gfShiftFRemoveAttachments;
 
@@ -962,6 +967,12 @@ typedef struct
 	UINT8 ubOverheadMapModeDay;
 	UINT8 ubOverheadMapModeNight;
 
+	UINT32 uiAnimationCacheBudget;					// bytes of soldier animation surfaces kept loaded while no soldier uses them
+	UINT32 uiTileCacheBudget;						// bytes of animation/corpse tiles kept in the tile cache
+	UINT8 ubRenderBands;							// number of horizontal bands the tile renderer splits the view into, drawn by that many threads
+	BOOLEAN fCompactLevelNodes;						// lay out the nodes of a loaded map tile by tile
+	UINT8 ubSectorPreloadMinutes;					// game minutes before a squad's arrival in which the sector's map is preloaded
+
 	//enable ext mouse key
 	BOOLEAN bAltAimEnabled;	
 	BOOLEAN bAimedBurstEnabled;
@@ -1490,6 +1501,8 @@ typedef struct
 	// Flugente: Scope Modes
 	BOOLEAN fScopeModes;							// allow the player to toggle between existing scopes/sights
 
+	UINT8 ubItemStatsCache;							// 0: off, 1: keep item and attachment bonuses with the object, 2: and check them
+
 	// Flugente: Spotter skill
 	UINT8	usSpotterPreparationTurns;
 	UINT16	usSpotterRange;
@@ -1662,6 +1675,8 @@ typedef struct
 	BOOLEAN fAITacticalRetreat;
 	BOOLEAN fAIMovementMode;
 	BOOLEAN fAIPathTweaks;
+	BOOLEAN fHierarchicalPathfinding;
+	BOOLEAN fAIPathCache;
 	BOOLEAN fAIShootUnseen;
 	BOOLEAN fAISafeSuppression;
 
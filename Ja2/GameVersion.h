@@ -23,6 +23,7 @@ extern	CHAR16		zBuildInformation[256];
 //		Keeps track of the saved game version.	Increment the saved game version whenever 
 //	you will invalidate the saved game file
 
+#define			SAVEGAME_CONTAINER								187 // Everything after the header and game options is stored as a table of zlib compressed chunks
 #define			INCREASED_TEAMSIZES								186 // Asdow: SOLDIERTYPE ubID changed from UINT8 -> UINT16
 #define			MERC_PROFILE_INSERTION_DATA					    185 // Bigmap support for AddProfileToMap function
 #define			GROWTH_MODIFIERS								184
@@ -107,7 +108,7 @@ extern	CHAR16		zBuildInformation[256];
 #define			AP100_SAVEGAME_DATATYPE_CHANGE					105	// Before this, we didn't have the 100AP structure changes
 #define			NIV_SAVEGAME_DATATYPE_CHANGE					102	// Before this, we used the old structure system
 
-#define			SAVE_GAME_VERSION								INCREASED_TEAMSIZES
+#define			SAVE_GAME_VERSION								SAVEGAME_CONTAINER
 
 //#define RUSSIANGOLD
 #ifdef __cplusplus
@@ -13,6 +13,7 @@
 #include "Timer Control.h"
 #include "Utilities.h"
 #include "Render Dirty.h"
+#include "renderworld.h"
 #include "Sound Control.h"
 #include "lighting.h"
 #include "Cursor Control.h"
@@ -65,6 +66,7 @@
 #include "AimArchives.h"
 #include "connect.h"
 #include "DynamicDialogueWidget.h"		// added by Flugente for InitMyBoxes()
+#include "ItemIndex.h"
 
 #include <language.hpp>
 
@@ -1398,6 +1400,9 @@ if( g_lang != i18n::Lang::en ) {
 				}
 			}
 
+	// lookup tables over the item, attachment and launchable data read above
+	BuildItemIndex();
+
 	LuaState::INIT(lua::LUA_STATE_STRATEGIC_MINES_AND_UNDERGROUND, true);
 	g_luaUnderground.LoadScript(GetLanguagePrefix());
 	// load Lua for Strategic Mines initialization
@@ -1626,6 +1631,9 @@ void ShutdownJA2(void)
 
 	RefreshScreen( NULL );
 
+	// let an autosave still being written finish
+	FinishBackgroundSaveGame( );
+
 	ShutdownStrategicLayer();
 
 	// remove temp files built by laptop
@@ -1657,6 +1665,8 @@ void ShutdownJA2(void)
 
 	DeleteTileCache( );
 
+	ShutdownRenderBands( );
+
 	ShutdownJA2Clock( );
 
 	ShutdownFonts();
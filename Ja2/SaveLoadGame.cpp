@@ -3,6 +3,10 @@
 #include "FileMan.h"
 #include <string.h>
 #include <stdio.h>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
 #include "DEBUG.H"
 #include "Overhead.h"
 #include "Keys.h"
@@ -109,6 +113,7 @@
 #include "Map Screen Interface Map Inventory.h"//dnl ch51 081009
 #include "Ambient Control.h"		// added by Flugente for HandleNewSectorAmbience(...)
 #include "WorldDat.h"
+#include "Compression.h"
 /////////////////////////////////////////////////////
 //
 // Local Defines
@@ -3370,14 +3375,413 @@ BOOLEAN InitSaveDir()
 	return TRUE;
 }
 
+// Savegames from SAVEGAME_CONTAINER on look like this:
+//	[SAVED_GAME_HEADER][GAME_OPTIONS][SAVEGAME_CONTAINER_HEADER][SAVEGAME_CHUNK * uiNumChunks][chunk data]
+// Everything after the game options is written to a memory file first, then cut into chunks of
+// SAVEGAME_CHUNK_SIZE bytes. Every chunk is compressed on its own, so they can be packed and unpacked on
+// several threads, and any single chunk can be found and unpacked through the table.
+// Header and options stay uncompressed, the load screen reads them straight from the file.
+#define SAVEGAME_CONTAINER_MAGIC		0x5a47534a		// "JSGZ"
+#define SAVEGAME_CHUNK_SIZE				(1024 * 1024)
+#define SAVEGAME_COMPRESSION_LEVEL		1				// zlib level, saving fast matters more than the last few percent
+#define SAVEGAME_MAX_WORKERS			8
+
+typedef struct
+{
+	UINT32	uiMagic;
+	UINT32	uiNumChunks;
+	UINT32	uiDataSize;		// size of all chunks unpacked
+} SAVEGAME_CONTAINER_HEADER;
+
+typedef struct
+{
+	UINT32	uiOffset;		// of the stored data, counted from the end of the chunk table
+	UINT32	uiStoredSize;	// same as uiSize if the chunk is stored uncompressed
+	UINT32	uiSize;
+} SAVEGAME_CHUNK;
+
+// Calls ChunkJob( uiChunk ) for every chunk, spread over up to SAVEGAME_MAX_WORKERS threads
+template<typename JOB>
+static void RunSaveGameChunkJobs( UINT32 uiNumChunks, BOOLEAN fParallel, JOB ChunkJob )
+{
+	UINT32 uiNumThreads = fParallel ? std::thread::hardware_concurrency() : 1;
+	uiNumThreads = __max( 1, __min( __min( uiNumThreads, (UINT32)SAVEGAME_MAX_WORKERS ), uiNumChunks ) );
+
+	std::atomic<UINT32> uiNextChunk( 0 );
+	auto Worker = [&]()
+	{
+		for ( UINT32 uiChunk = uiNextChunk++; uiChunk < uiNumChunks; uiChunk = uiNextChunk++ )
+		{
+			ChunkJob( uiChunk );
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for ( UINT32 cnt = 1; cnt < uiNumThreads; ++cnt )
+	{
+		workers.push_back( std::thread( Worker ) );
+	}
+
+	// the calling thread helps out
+	Worker();
+
+	for ( size_t cnt = 0; cnt < workers.size(); ++cnt )
+	{
+		workers[ cnt ].join();
+	}
+}
+
+static BOOLEAN PackSaveGameContainer( const BYTE *pData, UINT32 uiSize, std::vector<BYTE>& container, BOOLEAN fCompress, BOOLEAN fParallel )
+{
+	SAVEGAME_CONTAINER_HEADER	header;
+	UINT32						uiNumChunks = ( uiSize + SAVEGAME_CHUNK_SIZE - 1 ) / SAVEGAME_CHUNK_SIZE;
+	std::vector<SAVEGAME_CHUNK>	table( uiNumChunks );
+	std::vector< std::vector<BYTE> > packed( uiNumChunks );
+
+	RunSaveGameChunkJobs( uiNumChunks, fParallel, [&]( UINT32 uiChunk )
+	{
+		const BYTE	*pSrc = pData + uiChunk * SAVEGAME_CHUNK_SIZE;
+		UINT32		uiChunkSize = __min( uiSize - uiChunk * SAVEGAME_CHUNK_SIZE, (UINT32)SAVEGAME_CHUNK_SIZE );
+		UINT32		uiStoredSize = 0;
+
+		table[ uiChunk ].uiSize = uiChunkSize;
+
+		if ( fCompress )
+		{
+			packed[ uiChunk ].resize( uiChunkSize );
+			// no room for anything that doesn't get smaller, those are stored as they are
+			uiStoredSize = CompressBuffer( &packed[ uiChunk ][ 0 ], uiChunkSize - 1, pSrc, uiChunkSize, SAVEGAME_COMPRESSION_LEVEL );
+		}
+
+		if ( !uiStoredSize )
+		{
+			packed[ uiChunk ].assign( pSrc, pSrc + uiChunkSize );
+			uiStoredSize = uiChunkSize;
+		}
+
+		table[ uiChunk ].uiStoredSize = uiStoredSize;
+	} );
+
+	header.uiMagic = SAVEGAME_CONTAINER_MAGIC;
+	header.uiNumChunks = uiNumChunks;
+	header.uiDataSize = uiSize;
+
+	UINT32 uiOffset = 0;
+	for ( UINT32 cnt = 0; cnt < uiNumChunks; ++cnt )
+	{
+		table[ cnt ].uiOffset = uiOffset;
+		uiOffset += table[ cnt ].uiStoredSize;
+	}
+
+	// one buffer, so it goes to disk with a single write
+	container.resize( sizeof( SAVEGAME_CONTAINER_HEADER ) + uiNumChunks * sizeof( SAVEGAME_CHUNK ) + uiOffset );
+
+	BYTE *pDest = &container[ 0 ];
+	memcpy( pDest, &header, sizeof( SAVEGAME_CONTAINER_HEADER ) );
+	pDest += sizeof( SAVEGAME_CONTAINER_HEADER );
+
+	if ( uiNumChunks )
+	{
+		memcpy( pDest, &table[ 0 ], uiNumChunks * sizeof( SAVEGAME_CHUNK ) );
+		pDest += uiNumChunks * sizeof( SAVEGAME_CHUNK );
+	}
+
+	for ( UINT32 cnt = 0; cnt < uiNumChunks; ++cnt )
+	{
+		memcpy( pDest + table[ cnt ].uiOffset, &packed[ cnt ][ 0 ], table[ cnt ].uiStoredSize );
+	}
+
+	return( TRUE );
+}
+
+static BOOLEAN UnpackSaveGameContainer( const BYTE *pContainer, UINT32 uiContainerSize, std::vector<BYTE>& data, BOOLEAN fParallel )
+{
+	SAVEGAME_CONTAINER_HEADER header;
+
+	if ( uiContainerSize < sizeof( SAVEGAME_CONTAINER_HEADER ) )
+		return( FALSE );
+
+	memcpy( &header, pContainer, sizeof( SAVEGAME_CONTAINER_HEADER ) );
+
+	if ( header.uiMagic != SAVEGAME_CONTAINER_MAGIC ||
+		 header.uiNumChunks != ( header.uiDataSize + SAVEGAME_CHUNK_SIZE - 1 ) / SAVEGAME_CHUNK_SIZE ||
+		 header.uiNumChunks > ( uiContainerSize - sizeof( SAVEGAME_CONTAINER_HEADER ) ) / sizeof( SAVEGAME_CHUNK ) )
+		return( FALSE );
+
+	const SAVEGAME_CHUNK	*pTable = (const SAVEGAME_CHUNK *)( pContainer + sizeof( SAVEGAME_CONTAINER_HEADER ) );
+	const BYTE				*pStored = (const BYTE *)( pTable + header.uiNumChunks );
+	UINT32					uiStoredSize = uiContainerSize - (UINT32)( pStored - pContainer );
+
+	// check the table before anything gets unpacked
+	for ( UINT32 cnt = 0; cnt < header.uiNumChunks; ++cnt )
+	{
+		UINT32 uiExpectedSize = __min( header.uiDataSize - cnt * SAVEGAME_CHUNK_SIZE, (UINT32)SAVEGAME_CHUNK_SIZE );
+
+		if ( pTable[ cnt ].uiSize != uiExpectedSize ||
+			 pTable[ cnt ].uiStoredSize > pTable[ cnt ].uiSize ||
+			 pTable[ cnt ].uiOffset > uiStoredSize ||
+			 pTable[ cnt ].uiStoredSize > uiStoredSize - pTable[ cnt ].uiOffset )
+			return( FALSE );
+	}
+
+	data.resize( header.uiDataSize );
+
+	std::atomic<BOOLEAN> fOk( TRUE );
+	RunSaveGameChunkJobs( header.uiNumChunks, fParallel, [&]( UINT32 uiChunk )
+	{
+		const SAVEGAME_CHUNK	*pChunk = &pTable[ uiChunk ];
+		BYTE					*pDest = &data[ uiChunk * SAVEGAME_CHUNK_SIZE ];
+
+		if ( pChunk->uiStoredSize == pChunk->uiSize )
+		{
+			memcpy( pDest, pStored + pChunk->uiOffset, pChunk->uiSize );
+		}
+		else if ( !DecompressBuffer( pDest, pChunk->uiSize, pStored + pChunk->uiOffset, pChunk->uiStoredSize ) )
+		{
+			fOk = FALSE;
+		}
+	} );
+
+	return( fOk );
+}
+
+// Packs what was written to the memory file hMemFile and writes it to hFile
+static BOOLEAN WriteSaveGameContainer( HWFILE hFile, HWFILE hMemFile )
+{
+	UINT32				uiSize = FileGetSize( hMemFile );
+	UINT32				uiNumBytesWritten = 0;
+	std::vector<BYTE>	data( __max( uiSize, 1 ) );
+	std::vector<BYTE>	container;
+
+	if ( !FileGetMemoryContents( hMemFile, &data[ 0 ], uiSize ) )
+		return( FALSE );
+
+	if ( !PackSaveGameContainer( &data[ 0 ], uiSize, container, gGameExternalOptions.fCompressSaveGames, TRUE ) )
+		return( FALSE );
+
+	FileWrite( hFile, &container[ 0 ], (UINT32)container.size(), &uiNumBytesWritten );
+
+	return( uiNumBytesWritten == container.size() );
+}
+
+// Reads and unpacks the rest of hFile. Returns a memory file to load the sections from, 0 if the data is damaged.
+static HWFILE ReadSaveGameContainer( HWFILE hFile )
+{
+	INT32				iPos = FileGetPos( hFile );
+	UINT32				uiSize = FileGetSize( hFile );
+	UINT32				uiNumBytesRead = 0;
+	std::vector<BYTE>	container;
+	std::vector<BYTE>	data;
+
+	if ( iPos < 0 || (UINT32)iPos >= uiSize )
+		return( 0 );
+
+	container.resize( uiSize - iPos );
+	if ( !FileRead( hFile, &container[ 0 ], (UINT32)container.size(), &uiNumBytesRead ) )
+		return( 0 );
+
+	if ( !UnpackSaveGameContainer( &container[ 0 ], (UINT32)container.size(), data, TRUE ) )
+		return( 0 );
+
+	return( FileOpenMemoryRead( data.empty() ? NULL : &data[ 0 ], (UINT32)data.size() ) );
+}
+
+// Background autosaves (BACKGROUND_AUTO_SAVE)
+// SaveGame collects the whole savegame in memory as always, which is the quick part. Packing the container and
+// writing the file is then left to a worker thread. It writes to a temp file next to the savegame and moves that
+// over the savegame when done, so the slot always holds a complete save. Only one may be in flight at a time.
+typedef struct
+{
+	CHAR16				zDiskPath[ MAX_PATH ];
+	std::vector<BYTE>	header;		// header and game options, written as they are
+	std::vector<BYTE>	data;		// everything else, goes into the container
+	BOOLEAN				fCompress;
+} BACKGROUND_SAVEGAME_JOB;
+
+static std::thread			gBackgroundSaveThread;
+static std::atomic<BOOLEAN>	gfBackgroundSaveDone( FALSE );
+static BOOLEAN				gfBackgroundSaveSucceeded = FALSE;
+static BOOLEAN				gfBackgroundSaveReportSuccess = FALSE;	// say it's saved once it's written
+
+static BOOLEAN IsBackgroundSaveSlot( int ubSaveGameID )
+{
+	return( ubSaveGameID == SAVE__END_TURN_NUM || ( ubSaveGameID >= SAVE__TIMED_AUTOSAVE_SLOT1 && ubSaveGameID <= SAVE__TIMED_AUTOSAVE_SLOT5 ) );
+}
+
+static void BackgroundSaveGameThread( BACKGROUND_SAVEGAME_JOB *pJob )
+{
+	ProfilerSetThreadName( "Background save" );
+	PERFORMANCE_MARKER
+
+	std::vector<BYTE>	container;
+	BOOLEAN				fOk = PackSaveGameContainer( pJob->data.empty() ? NULL : &pJob->data[ 0 ], (UINT32)pJob->data.size(), container, pJob->fCompress, TRUE );
+
+	if ( fOk )
+	{
+		container.insert( container.begin(), pJob->header.begin(), pJob->header.end() );
+		fOk = FileReplaceOnDisk( pJob->zDiskPath, &container[ 0 ], (UINT32)container.size() );
+	}
+
+	delete pJob;
+
+	gfBackgroundSaveSucceeded = fOk;
+	gfBackgroundSaveDone = TRUE;
+}
+
+// Hands the contents of the memory files hHeaderFile and hMemFile to the worker thread, which writes them to
+// zSaveGameName. Both files can be closed right after.
+static BOOLEAN StartBackgroundSaveGame( STR zSaveGameName, HWFILE hHeaderFile, HWFILE hMemFile )
+{
+	BACKGROUND_SAVEGAME_JOB *pJob = new BACKGROUND_SAVEGAME_JOB;
+
+	// the slot isn't opened, the old save stays as it is until the worker replaces it
+	BOOLEAN fOk = FileGetWriteDiskPath( zSaveGameName, pJob->zDiskPath, MAX_PATH );
+
+	if ( fOk )
+	{
+		pJob->header.resize( FileGetSize( hHeaderFile ) );
+		pJob->data.resize( FileGetSize( hMemFile ) );
+		fOk = ( pJob->header.empty() || FileGetMemoryContents( hHeaderFile, &pJob->header[ 0 ], (UINT32)pJob->header.size() ) ) &&
+			  ( pJob->data.empty() || FileGetMemoryContents( hMemFile, &pJob->data[ 0 ], (UINT32)pJob->data.size() ) );
+	}
+
+	if ( !fOk )
+	{
+		delete pJob;
+		return( FALSE );
+	}
+
+	pJob->fCompress = gGameExternalOptions.fCompressSaveGames;
+
+	gfBackgroundSaveDone = FALSE;
+	gfBackgroundSaveReportSuccess = FALSE;
+	gBackgroundSaveThread = std::thread( BackgroundSaveGameThread, pJob );
+
+	return( TRUE );
+}
+
+// Waits for the background save to be written, and reports how that went
+void FinishBackgroundSaveGame( void )
+{
+	if ( !gBackgroundSaveThread.joinable() )
+		return;
+
+	gBackgroundSaveThread.join();
+
+	if ( !gfBackgroundSaveSucceeded )
+	{
+		ScreenMsg( FONT_MCOLOR_WHITE, MSG_INTERFACE, zSaveLoadText[SLG_SAVE_GAME_ERROR] );
+	}
+	else if ( gfBackgroundSaveReportSuccess )
+	{
+		ScreenMsg( FONT_MCOLOR_WHITE, MSG_INTERFACE, pMessageStrings[ MSG_SAVESLOTSUCCESS ] );
+	}
+
+	gfBackgroundSaveReportSuccess = FALSE;
+}
+
+// TRUE if an autosave is to be skipped because the last one is still being written, and says so
+BOOLEAN SkipAutoSaveGame( void )
+{
+	if ( !gBackgroundSaveThread.joinable() || gfBackgroundSaveDone )
+		return( FALSE );
+
+	ScreenMsg( FONT_MCOLOR_WHITE, MSG_INTERFACE, pMessageStrings[ MSG_AUTOSAVE_SKIPPED ] );
+	return( TRUE );
+}
+
+// Called every frame, cleans up after a background save once it's done
+void HandleBackgroundSaveGame( void )
+{
+	if ( gBackgroundSaveThread.joinable() && gfBackgroundSaveDone )
+	{
+		FinishBackgroundSaveGame();
+	}
+}
+
+#ifdef JA2TESTVERSION
+extern WorldItems gAllWorldItems;
+
+// Packs and unpacks a synthetic large campaign (all sector items, repeated up to 64 MB), once on one
+// thread and once on several, and reports the times, the sizes and whether the data survived the round trip.
+void BenchmarkSaveGameContainer( void )
+{
+	HWFILE				hMemFile = FileOpenMemory();
+	UINT32				uiNumBytesWritten = 0;
+	UINT32				uiSize;
+	std::vector<BYTE>	data;
+	std::vector<BYTE>	container;
+	std::vector<BYTE>	result;
+
+	if ( !hMemFile )
+		return;
+
+	// the items of all sectors, written the way the savegame has them
+	for ( auto it = gAllWorldItems.Items.begin(); it != gAllWorldItems.Items.end(); ++it )
+	{
+		UINT32 uiNumItems = (UINT32)it->size();
+		FileWrite( hMemFile, &uiNumItems, sizeof( UINT32 ), &uiNumBytesWritten );
+		for ( UINT32 cnt = 0; cnt < uiNumItems; ++cnt )
+		{
+			(*it)[ cnt ].Save( hMemFile, FALSE );
+		}
+	}
+
+	uiSize = FileGetSize( hMemFile );
+	data.resize( __max( uiSize, 1 ) );
+	FileGetMemoryContents( hMemFile, &data[ 0 ], uiSize );
+	FileClose( hMemFile );
+
+	// a large campaign has a lot more of everything: repeat it up to 64 MB, changing every copy a bit so it
+	// doesn't compress better than real data would
+	data.resize( uiSize );
+	if ( data.empty() )
+	{
+		data.resize( 4096 );
+		for ( size_t cnt = 0; cnt < data.size(); ++cnt )
+		{
+			data[ cnt ] = (BYTE)Random( 256 );
+		}
+	}
+
+	while ( data.size() < 64 * 1024 * 1024 )
+	{
+		size_t uiOldSize = data.size();
+		data.resize( uiOldSize * 2 );
+		for ( size_t cnt = uiOldSize; cnt < data.size(); ++cnt )
+		{
+			data[ cnt ] = (BYTE)( data[ cnt - uiOldSize ] + ( cnt % 61 == 0 ? Random( 256 ) : 0 ) );
+		}
+	}
+	uiSize = (UINT32)data.size();
+
+	for ( UINT8 ubPass = 0; ubPass < 2; ++ubPass )
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		PackSaveGameContainer( &data[ 0 ], uiSize, container, TRUE, ubPass == 1 );
+		std::chrono::steady_clock::time_point packed = std::chrono::steady_clock::now();
+		BOOLEAN fOk = UnpackSaveGameContainer( &container[ 0 ], (UINT32)container.size(), result, ubPass == 1 ) && result == data;
+		std::chrono::steady_clock::time_point unpacked = std::chrono::steady_clock::now();
+
+		ScreenMsg( FONT_MCOLOR_LTYELLOW, MSG_INTERFACE, L"Savegame benchmark (%s): %d KB -> %d KB, pack %d ms, unpack %d ms, %s.",
+					ubPass == 1 ? L"parallel" : L"serial", uiSize / 1024, (UINT32)container.size() / 1024,
+					(UINT32)std::chrono::duration_cast<std::chrono::milliseconds>( packed - start ).count(),
+					(UINT32)std::chrono::duration_cast<std::chrono::milliseconds>( unpacked - packed ).count(),
+					fOk ? L"round trip ok" : L"ROUND TRIP FAILED" );
+	}
+}
+#endif
+
 // WDS - Automatically try to save when an assertion failure occurs
 extern bool alreadySaving = false;
 extern bool bHideTopMessage;
 
 BOOLEAN SaveGame( int ubSaveGameID, STR16 pGameDesc )
 {
+	PERFORMANCE_MARKER
 	UINT32	uiNumBytesWritten=0;
 	HWFILE	hFile=0;
+	HWFILE	hSaveFile=0;
 	SAVED_GAME_HEADER SaveGameHeader;
 	CHAR8		zSaveGameName[ MAX_PATH ];
 	//UINT8		saveDir[100];
@@ -3386,11 +3790,18 @@ BOOLEAN SaveGame( int ubSaveGameID, STR16 pGameDesc )
 	INT32		iSaveLoadGameMessageBoxID = -1;
 	UINT16	usPosX, usActualWidth, usActualHeight;
 	BOOLEAN fWePausedIt = FALSE;
+	BOOLEAN	fBackground = gGameExternalOptions.fBackgroundAutoSave && IsBackgroundSaveSlot( ubSaveGameID );
 	
 	CHAR16	zString[128];
 
 	if( ubSaveGameID > NUM_SAVE_GAMES || ubSaveGameID == EARLIST_SPECIAL_SAVE )
 		return( FALSE );
+
+	// one save at a time: an autosave is skipped while the last one is still being written, anything else waits for it
+	if( IsBackgroundSaveSlot( ubSaveGameID ) && SkipAutoSaveGame() )
+		return( TRUE );
+
+	FinishBackgroundSaveGame();
 	alreadySaving = true;
 
 #ifdef LOADSAVEGAME_LOGTIME
@@ -3580,8 +3991,8 @@ BOOLEAN SaveGame( int ubSaveGameID, STR16 pGameDesc )
 	TimingLog("\nShutdown stuff", 10);
 #endif
 
-	//if the file already exists, delete it
-	if( FileExists( zSaveGameName ) )
+	//if the file already exists, delete it (a background save replaces it in one go once the new one is written)
+	if( !fBackground && FileExists( zSaveGameName ) )
 	{
 		if( !FileDelete( zSaveGameName ) )
 		{
@@ -3594,8 +4005,11 @@ BOOLEAN SaveGame( int ubSaveGameID, STR16 pGameDesc )
 		if(!SaveInventoryPoolQ(ubSaveGameID))
 			return(FALSE);
 
-	// create the save game file
-	hFile = FileOpen( zSaveGameName, FILE_ACCESS_WRITE | FILE_CREATE_ALWAYS, FALSE );
+	// create the save game file, or collect it in memory for the background save
+	if( fBackground )
+		hFile = FileOpenMemory();
+	else
+		hFile = FileOpen( zSaveGameName, FILE_ACCESS_WRITE | FILE_CREATE_ALWAYS, FALSE );
 	if( !hFile )
 	{
 		ScreenMsg( FONT_MCOLOR_WHITE, MSG_ERROR, L"ERROR creating new save");
@@ -3696,6 +4110,15 @@ BOOLEAN SaveGame( int ubSaveGameID, STR16 pGameDesc )
 	//CHRISL: Added here so we can get game options earlier in the load process
 	FileWrite( hFile, &gGameOptions, sizeof( GAME_OPTIONS ), &uiNumBytesWritten );
 
+	// everything else is collected in memory and written packed at the end (see SAVEGAME_CONTAINER)
+	hSaveFile = hFile;
+	hFile = FileOpenMemory();
+	if( !hFile )
+	{
+		ScreenMsg( FONT_MCOLOR_WHITE, MSG_ERROR, L"ERROR creating save game buffer");
+		goto FAILED_TO_SAVE;
+	}
+
 	//
 	//Save the gTactical Status array, plus the current sector location
 	//
@@ -4427,8 +4850,23 @@ BOOLEAN SaveGame( int ubSaveGameID, STR16 pGameDesc )
 	TimingLog("File read done", 10);
 #endif
 
+	if( fBackground )
+	{
+		if( !StartBackgroundSaveGame( zSaveGameName, hSaveFile, hFile ) )
+		{
+			ScreenMsg( FONT_MCOLOR_WHITE, MSG_ERROR, L"ERROR starting background save");
+			goto FAILED_TO_SAVE;
+		}
+	}
+	else if( !WriteSaveGameContainer( hSaveFile, hFile ) )
+	{
+		ScreenMsg( FONT_MCOLOR_WHITE, MSG_ERROR, L"ERROR writing save game data");
+		goto FAILED_TO_SAVE;
+	}
+
 	//Close the saved game file
 	FileClose( hFile );
+	FileClose( hSaveFile );
 
 	// This defines, which savegame is highlighted in the load screen
 	if (ubSaveGameID == SAVE__END_TURN_NUM)
@@ -4467,6 +4905,11 @@ BOOLEAN SaveGame( int ubSaveGameID, STR16 pGameDesc )
 //		ScreenMsg( FONT_MCOLOR_WHITE, MSG_INTERFACE, pMessageStrings[ MSG_END_TURN_AUTO_SAVE ] );
 	}
 //#endif
+	else if( fBackground )
+	{
+		// not written yet, FinishBackgroundSaveGame() says so when it is
+		gfBackgroundSaveReportSuccess = TRUE;
+	}
 	else
 	{
 		ScreenMsg( FONT_MCOLOR_WHITE, MSG_INTERFACE, pMessageStrings[ MSG_SAVESLOTSUCCESS ] );
@@ -4522,6 +4965,10 @@ FAILED_TO_SAVE:
 #endif
 
 	FileClose( hFile );
+	if( hSaveFile )
+	{
+		FileClose( hSaveFile );
+	}
 
 	if ( fWePausedIt )
 	{
@@ -4567,6 +5014,7 @@ extern int gCivPreservedTempFileVersion[256];
 
 BOOLEAN LoadSavedGame( int ubSavedGameID )
 {
+	PERFORMANCE_MARKER
 	HWFILE	hFile;
 	SAVED_GAME_HEADER SaveGameHeader;
 	UINT32	uiNumBytesRead=0;
@@ -4593,6 +5041,9 @@ BOOLEAN LoadSavedGame( int ubSavedGameID )
 	//Empty the dialogue Queue cause someone could still have a quote in waiting
 	EmptyDialogueQueue( );
 
+	// the save being loaded might still be written
+	FinishBackgroundSaveGame( );
+
 #ifdef JA2UB	
 	//Reset Jerry Quotes  JA25UB
 	if ( gGameUBOptions.JerryQuotes == TRUE )
@@ -4765,6 +5216,20 @@ BOOLEAN LoadSavedGame( int ubSavedGameID )
 	//Store the loading screenID that was saved
 	gubLastLoadingScreenID = SaveGameHeader.ubLoadScreenID;
 
+	// unpack the rest of the file and load from memory
+	if( guiCurrentSaveGameVersion >= SAVEGAME_CONTAINER )
+	{
+		HWFILE hMemFile = ReadSaveGameContainer( hFile );
+
+		FileClose( hFile );
+		if( !hMemFile )
+		{
+			DebugMsg( TOPIC_JA2, DBG_LEVEL_3, String("ReadSaveGameContainer failed" ) );
+			return(FALSE);
+		}
+		hFile = hMemFile;
+	}
+
 
 /*
 	if( !LoadGeneralInfo( hFile ) )
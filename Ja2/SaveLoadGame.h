@@ -75,6 +75,11 @@ BOOLEAN InitSaveDir();
 BOOLEAN SaveGame( int ubSaveGameID, STR16 pGameDesc );
 BOOLEAN LoadSavedGame( int ubSavedGameID );
 
+// autosaves written on a worker thread (BACKGROUND_AUTO_SAVE)
+void FinishBackgroundSaveGame( void );
+void HandleBackgroundSaveGame( void );
+BOOLEAN SkipAutoSaveGame( void );
+
 BOOLEAN CopySavedSoldierInfoToNewSoldier( SOLDIERTYPE *pDestSourceInfo, SOLDIERTYPE *pSourceInfo );
 
 BOOLEAN		SaveFilesToSavedGame( STR pSrcFileName, HWFILE hFile );
@@ -82,6 +87,11 @@ BOOLEAN		LoadFilesFromSavedGame( STR pSrcFileName, HWFILE hFile );
 
 void GetBestPossibleSectorXYZValues( INT16 *psSectorX, INT16 *psSectorY, INT8 *pbSectorZ );
 
+#ifdef JA2TESTVERSION
+// round trip of a synthetic large savegame through the savegame container, serial and parallel
+void BenchmarkSaveGameContainer( void );
+#endif
+
 
 extern UINT32	guiLastSaveGameNum;			// The end turn auto save number (0 = Auto00.sav, 1 = Auto01.sav)
 
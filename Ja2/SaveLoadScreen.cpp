@@ -669,6 +669,9 @@ BOOLEAN	EnterSaveLoadScreen()
 	extern UINT32 guiPreviousScreen;
 	guiSaveLoadExitScreen = guiPreviousScreen;
 
+	// so the list shows the autosave that may still be written
+	FinishBackgroundSaveGame( );
+
 	//init the list
 	InitSaveGameArray();
 
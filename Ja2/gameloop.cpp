@@ -24,6 +24,8 @@
 	#include "Ambient Control.h"	// sevenfm
 
 #include "SaveLoadScreen.h"
+#include "SaveLoadGame.h"
+#include "Sector Preload.h"
 
 //**ddd direct link libraries
 #pragma comment (lib, "user32.lib")
@@ -228,6 +230,8 @@ extern void RefreshBoxes( );
 
 void GameLoop(void)
 {
+	ProfilerNewFrame();
+	PERFORMANCE_MARKER
 	//	DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"GameLoop");
 
 	InputAtom	InputEvent;
@@ -248,6 +252,9 @@ void GameLoop(void)
 	//DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"GameLoop: get music");
 	MusicPoll( FALSE );
 
+	HandleBackgroundSaveGame( );
+	HandleSectorPreload( );
+
 	//DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"GameLoop: check for mouse events");
 	//*** dddd
 	//while (DequeueSpecificEvent(&InputEvent, LEFT_BUTTON_REPEAT|RIGHT_BUTTON_REPEAT|LEFT_BUTTON_DOWN|LEFT_BUTTON_UP|RIGHT_BUTTON_DOWN|RIGHT_BUTTON_UP ) == TRUE )
@@ -1,442 +1,428 @@
-#ifdef PROFILER_ENABLED
-
 #include "builddefines.h"
-#include <sstream>
-
-#ifdef PERIODIC_PROFILING
-bool gRecordingProfile = false;
-#endif
-
-PerfManager* PerfManager::_instance(NULL);
-
-PerfDatum::PerfDatum(	const char* const fileName, 
-						const char* const functionName,
-						const int lineNumber,
-						__int64 cycles,
-						__int64 calls)
-	:
-	_fileName(fileName),
-	_functionName(functionName),
-	_lineNumber(lineNumber),
-	_cycles(cycles),
-	_calls(calls)
+#include "types.h"
+#include <windows.h>
+#include <stdio.h>
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// zones kept per thread, the oldest are overwritten
+#define PROFILER_ZONES_PER_THREAD	( 1 << 16 )
+// frame starts kept for the summary
+#define PROFILER_FRAMES				4096
+
+#define PROFILER_TRACE_FILENAME		"ja2_profile.json"
+#define PROFILER_SUMMARY_FILENAME	"ja2_profile.txt"
+
+std::atomic<bool> gfProfilerRecording( false );
+
+typedef struct
 {
-}
-
-PerfManager::PerfManager(void)
-	:
-	_callTime(0),
-	_totalTime(0)
+	const char	*szName;
+	__int64		iStart;
+	__int64		iEnd;
+} ProfileZone;
+
+// Only the owning thread writes to a buffer, the lock is only ever contended while the files are written. A thread
+// only gets one when it records a zone. If it ends while the profiler records, it leaves its buffer behind for the
+// files, which is thrown away once they are written. Otherwise the buffer goes with the thread.
+struct ProfileThreadBuffer
 {
-	//Set up a root function so that the stack is never empty:
-	//(this will be the only entry with _lineNumber equal to 0)
-	_perfLog.insert(PerfDatum(__FILE__, "Root",0));
-	_perfStack.push_back(&*(_perfLog.begin()));
-	_lastTime = getCPUCount();
-	calibrate();
-}
-
-void PerfManager::calibrate()
+	std::mutex					lock;
+	UINT32						uiThreadId;
+	std::string					name;
+	std::vector<ProfileZone>	zones;
+	UINT32						uiWritten;		// since ProfilerStart(), the next one goes to uiWritten % PROFILER_ZONES_PER_THREAD
+	bool						fThreadEnded;
+};
+
+static std::mutex							gProfilerLock;		// guards the list of buffers and the frames
+static std::vector<ProfileThreadBuffer*>	gProfilerBuffers;
+static std::vector<__int64>					gProfilerFrames;
+static UINT32								guiProfilerFrames = 0;	// since ProfilerStart()
+static UINT32								guiProfilerMainThread = 0;
+static __int64								giProfilerStart = 0;
+
+// hands out the buffer of the calling thread, and frees it or marks it as ended when the thread goes away
+class ProfileThreadSlot
 {
-}
-
-PerfManager::~PerfManager(void)
-{
-}
+public:
+	ProfileThreadSlot() : pBuffer( NULL ), szName( NULL ) {}
+	~ProfileThreadSlot()
+	{
+		if ( pBuffer )
+		{
+			std::lock_guard<std::mutex> guard( gProfilerLock );
+
+			if ( ProfilerIsRecording() )
+			{
+				pBuffer->fThreadEnded = true;
+			}
+			else
+			{
+				gProfilerBuffers.erase( std::find( gProfilerBuffers.begin(), gProfilerBuffers.end(), pBuffer ) );
+				delete pBuffer;
+			}
+		}
+	}
 
-PerfManager* PerfManager::instance()
-{
-	if(!_instance)		//Double-check locking (first check)
-	{	_instance = new PerfManager();
+	ProfileThreadBuffer* Get()
+	{
+		if ( !pBuffer )
+		{
+			pBuffer = new ProfileThreadBuffer();
+			pBuffer->uiThreadId = GetCurrentThreadId();
+			pBuffer->uiWritten = 0;
+			pBuffer->fThreadEnded = false;
+			pBuffer->zones.resize( PROFILER_ZONES_PER_THREAD );
+			if ( szName )
+				pBuffer->name = szName;
+
+			std::lock_guard<std::mutex> guard( gProfilerLock );
+			gProfilerBuffers.push_back( pBuffer );
+		}
+		return( pBuffer );
 	}
-	return _instance;
-}
 
-void PerfManager::enterFunction(const char* const fileName, 
-								const char* const functionName, 
-								const int lineNumber)
-{
-	//Mark the time when we end processing the previous function
-	__int64 endTime = getCPUCount();
-	//assuming we haven't corrupted the stack and reduced it to zero elements
-	if(_perfStack.size())
-	{	PERF_STACK_T::reverse_iterator lastMarker = _perfStack.rbegin();
-		//Update the total time spent processing the previous function
-		__int64 runTime = (endTime - _lastTime) - _callTime;
-		(**lastMarker)._cycles += runTime;
-		_totalTime += runTime;
+	void SetName( const char *szNewName )
+	{
+		szName = szNewName;
+
+		if ( pBuffer )
+		{
+			std::lock_guard<std::mutex> guard( pBuffer->lock );
+			pBuffer->name = szName;
+		}
 	}
 
-	//If we fail to insert the performance marker into our log, it means it is
-	//a duplicate.	We can ignore this "error" as using the existing copy is
-	//the correct behavior.
-	std::pair<PERF_LOG_T::iterator, bool> result = 
-		_perfLog.insert(PerfDatum(fileName, functionName, lineNumber));
-	//Update the call count on the new function:
-	PerfDatum* marker = &*(result.first);
-	marker->_calls++;
-	//Add performance marker to the stack as well as the log:
-	_perfStack.push_back(marker); 
-	//Now that we are clear of any complex operations, we can set the call
-	//time of the new marker more accurately:
-	_lastTime = getCPUCount();
-}
+private:
+	ProfileThreadBuffer	*pBuffer;
+	const char			*szName;	// kept until the thread records its first zone
+};
+
+static thread_local ProfileThreadSlot	gProfilerThreadSlot;
 
-void PerfManager::exitFunction()
+
+__int64 ProfilerTimestamp( void )
 {
-	//Mark the time when we exited the function
-	__int64 endTime = getCPUCount();
-	//Update the function in our log with its new runtime
-	PERF_STACK_T::reverse_iterator lastMarker = _perfStack.rbegin();
-	__int64 runTime = endTime - _lastTime;
-	(**lastMarker)._cycles += runTime;
-	_totalTime += runTime;
-	_perfStack.pop_back();
-	//Lastly, update the function we've fallen back to with the new current
-	//run time.
-	_lastTime = getCPUCount();
+	LARGE_INTEGER liCount;
+
+	QueryPerformanceCounter( &liCount );
+	return( liCount.QuadPart );
 }
 
-__int64 PerfManager::getCPUCount () const
+__int64 ProfilerTicksPerSecond( void )
 {
-	_asm rdtsc
+	static __int64 iFrequency = 0;
+
+	if ( !iFrequency )
+	{
+		LARGE_INTEGER liFrequency;
+
+		QueryPerformanceFrequency( &liFrequency );
+		iFrequency = liFrequency.QuadPart;
+	}
+	return( iFrequency );
 }
 
-bool PerfSort::operator ()(const PerfDatum& lhs, const PerfDatum&rhs) const
+void ProfilerRecordZone( const char *szName, __int64 iStart )
 {
-	if(rhs._lineNumber == lhs._lineNumber)
-	{	return 0 < strcmp(rhs._fileName, lhs._fileName);
-	}
-	else
-	{	return rhs._lineNumber > lhs._lineNumber;
-	}
+	__int64 iEnd = ProfilerTimestamp();
+	ProfileThreadBuffer *pBuffer = gProfilerThreadSlot.Get();
+	std::lock_guard<std::mutex> guard( pBuffer->lock );
+
+	ProfileZone &zone = pBuffer->zones[ pBuffer->uiWritten % PROFILER_ZONES_PER_THREAD ];
+	zone.szName = szName;
+	zone.iStart = iStart;
+	zone.iEnd = iEnd;
+	++pBuffer->uiWritten;
 }
 
-bool PerfSort2::operator ()(const PerfDatum& lhs, const PerfDatum&rhs) const
+void ProfilerSetThreadName( const char *szName )
 {
-	return lhs._cycles > rhs._cycles;
+	gProfilerThreadSlot.SetName( szName );
 }
 
-int PerfManager::getPercision(const double value) const
+void ProfilerNewFrame( void )
 {
-	int retVal = 1;
-	if(10.0 <= value)
-	{	retVal = 3;
-	}
-	else if (1.0 <= value)
-	{	retVal = 2;
-	}
-	return retVal;
+	if ( !ProfilerIsRecording() )
+		return;
+
+	std::lock_guard<std::mutex> guard( gProfilerLock );
+
+	gProfilerFrames[ guiProfilerFrames % PROFILER_FRAMES ] = ProfilerTimestamp();
+	++guiProfilerFrames;
+	guiProfilerMainThread = GetCurrentThreadId();
 }
 
-void PerfManager::log(std::ostream &os)
+void ProfilerStart( void )
 {
-	//Create a copy of the log that sorts by cycles used
-	std::set<PerfDatum, PerfSort2> logCopy;
-	for(PERF_LOG_T::iterator i = _perfLog.begin(); i != _perfLog.end(); i++)
-	{
-		logCopy.insert(*i);
-	}
+	if ( ProfilerIsRecording() )
+		return;
 
-	int cyclesWidth = 1;
-	//I want the formatting to be nice!
-	for(std::set<PerfDatum, PerfSort2>::iterator i = logCopy.begin(); 
-		i != logCopy.end(); 
-		i++)
 	{
-		if(i->_lineNumber) {
-			std::stringstream cyclesString;
-			cyclesString << i->_cycles;
-			std::string tempString;
-			cyclesString >> tempString;
-			cyclesWidth = tempString.size();
-			break;
+		std::lock_guard<std::mutex> guard( gProfilerLock );
+
+		for ( size_t cnt = 0; cnt < gProfilerBuffers.size(); )
+		{
+			ProfileThreadBuffer *pBuffer = gProfilerBuffers[ cnt ];
+
+			if ( pBuffer->fThreadEnded )
+			{
+				delete pBuffer;
+				gProfilerBuffers.erase( gProfilerBuffers.begin() + cnt );
+				continue;
+			}
+
+			std::lock_guard<std::mutex> bufferGuard( pBuffer->lock );
+			pBuffer->uiWritten = 0;
+			++cnt;
 		}
-	}
 
-	//Stream the sorted log to the supplied ostream
-	for(std::set<PerfDatum, PerfSort2>::iterator i = logCopy.begin(); 
-		i != logCopy.end(); 
-		++i)
-	{
-		if(i->_lineNumber)
-		{	//Truncate path from file name if the compiler included it.
-			const char* j = i->_fileName + strlen(i->_fileName);
-			while('\\' != *j && '/' != *j && j >= i->_fileName){j--;}
-			if('\\' == *j || '/' == *j){j++;}
-			std::stringstream cyclesString;
-			std::string tempString;
-			cyclesString << i->_cycles;
-			cyclesString >> tempString;
-			os.width(cyclesWidth);
-			os << tempString.c_str() << ", ";
-			__int64 cyclesPerCall = i->_cycles / i->_calls;
-			cyclesString.clear();
-			tempString.clear();
-			cyclesString << cyclesPerCall;
-			cyclesString >> tempString;
-			os.width(cyclesWidth);
-			os << tempString.c_str() << "] cycles (";
-			double percent = double(i->_cycles) / double(_totalTime) * 100;
-			os.precision(getPercision(percent));
-			os.width(4);
-			os << percent << "%) used in [";
-			os.width(8);
-			os << i->_calls << "] calls by " << j << "::" << i->_functionName\
-				<< " at line " << i->_lineNumber << std::endl;
-		}
+		gProfilerFrames.assign( PROFILER_FRAMES, 0 );
+		guiProfilerFrames = 0;
+		giProfilerStart = ProfilerTimestamp();
 	}
+
+	gfProfilerRecording = true;
 }
 
-PerfMarker::PerfMarker( const char* const fileName, 
-						const char* const functionName,
-						const int lineNumber)
-	:
-#ifdef PERIODIC_PROFILING
-	_onStack(gRecordingProfile)
-#else
-	_onStack(true)
-#endif
+// the zones of a buffer that are still there, oldest first
+static void CopyProfileZones( ProfileThreadBuffer *pBuffer, std::vector<ProfileZone> &zones )
 {
-#ifdef PERIODIC_PROFILING
-	if (gRecordingProfile == true) {
-#endif
-		PerfManager::instance()->enterFunction(fileName,functionName,lineNumber);
-#ifdef PERIODIC_PROFILING
-	}
-#endif
+	std::lock_guard<std::mutex> guard( pBuffer->lock );
+
+	UINT32 uiCount = __min( pBuffer->uiWritten, (UINT32)PROFILER_ZONES_PER_THREAD );
+	UINT32 uiFirst = pBuffer->uiWritten - uiCount;
+
+	zones.resize( uiCount );
+	for ( UINT32 cnt = 0; cnt < uiCount; ++cnt )
+		zones[ cnt ] = pBuffer->zones[ ( uiFirst + cnt ) % PROFILER_ZONES_PER_THREAD ];
 }
 
-PerfMarker::~PerfMarker()
+static double ProfilerMicroseconds( __int64 iTicks )
 {
-	endMark();
+	return( (double)iTicks * 1000000.0 / (double)ProfilerTicksPerSecond() );
 }
 
-void PerfMarker::endMark()
+static void WriteJsonString( FILE *pFile, const char *szText )
 {
-	if(_onStack)
-	{	PerfManager::instance()->exitFunction();
-		_onStack = false;
+	fputc( '"', pFile );
+	for ( ; *szText; ++szText )
+	{
+		if ( *szText == '"' || *szText == '\\' )
+			fputc( '\\', pFile );
+		if ( (unsigned char)*szText >= ' ' )
+			fputc( *szText, pFile );
 	}
-}
-#include "profiler.h"
-#include <sstream>
-
-#ifdef PERIODIC_PROFILING
-bool gRecordingProfile = false;
-#endif
-
-PerfManager* PerfManager::_instance(NULL);
-
-PerfDatum::PerfDatum(	const char* const fileName, 
-						const char* const functionName,
-						const int lineNumber,
-						__int64 cycles,
-						__int64 calls)
-	:
-	_fileName(fileName),
-	_functionName(functionName),
-	_lineNumber(lineNumber),
-	_cycles(cycles),
-	_calls(calls)
-{
+	fputc( '"', pFile );
 }
 
-PerfManager::PerfManager(void)
-	:
-	_callTime(0),
-	_totalTime(0)
+static bool WriteChromeTrace( const std::vector<ProfileThreadBuffer*> &buffers, const std::vector< std::vector<ProfileZone> > &zones, const std::vector<__int64> &frames )
 {
-	//Set up a root function so that the stack is never empty:
-	//(this will be the only entry with _lineNumber equal to 0)
-	_perfLog.insert(PerfDatum(__FILE__, "Root",0));
-	_perfStack.push_back(&*(_perfLog.begin()));
-	_lastTime = getCPUCount();
-	calibrate();
-}
+	FILE *pFile = fopen( PROFILER_TRACE_FILENAME, "w" );
 
-void PerfManager::calibrate()
-{
-}
+	if ( !pFile )
+		return( false );
 
-PerfManager::~PerfManager(void)
-{
-}
+	bool fFirst = true;
+	fprintf( pFile, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" );
 
-PerfManager* PerfManager::instance()
-{
-	if(!_instance)		//Double-check locking (first check)
-	{	_instance = new PerfManager();
+	for ( size_t uiBuffer = 0; uiBuffer < buffers.size(); ++uiBuffer )
+	{
+		ProfileThreadBuffer *pBuffer = buffers[ uiBuffer ];
+		char szThreadName[ 64 ];
+
+		if ( !pBuffer->name.empty() )
+			_snprintf( szThreadName, sizeof( szThreadName ), "%s", pBuffer->name.c_str() );
+		else if ( pBuffer->uiThreadId == guiProfilerMainThread )
+			strcpy( szThreadName, "Main" );
+		else
+			_snprintf( szThreadName, sizeof( szThreadName ), "Thread %u", pBuffer->uiThreadId );
+		szThreadName[ 63 ] = '\0';
+
+		fprintf( pFile, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", fFirst ? "" : ",\n", pBuffer->uiThreadId );
+		WriteJsonString( pFile, szThreadName );
+		fprintf( pFile, "}}" );
+		fFirst = false;
+
+		for ( size_t cnt = 0; cnt < zones[ uiBuffer ].size(); ++cnt )
+		{
+			const ProfileZone &zone = zones[ uiBuffer ][ cnt ];
+
+			fprintf( pFile, ",\n{\"name\":" );
+			WriteJsonString( pFile, zone.szName );
+			fprintf( pFile, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", pBuffer->uiThreadId,
+						ProfilerMicroseconds( zone.iStart - giProfilerStart ), ProfilerMicroseconds( zone.iEnd - zone.iStart ) );
+		}
 	}
-	return _instance;
-}
 
-void PerfManager::enterFunction(const char* const fileName, 
-								const char* const functionName, 
-								const int lineNumber)
-{
-	//Mark the time when we end processing the previous function
-	__int64 endTime = getCPUCount();
-	//assuming we haven't corrupted the stack and reduced it to zero elements
-	if(_perfStack.size())
-	{	PERF_STACK_T::reverse_iterator lastMarker = _perfStack.rbegin();
-		//Update the total time spent processing the previous function
-		__int64 runTime = (endTime - _lastTime) - _callTime;
-		(**lastMarker)._cycles += runTime;
-		_totalTime += runTime;
+	for ( size_t cnt = 0; cnt < frames.size(); ++cnt )
+	{
+		fprintf( pFile, "%s{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}", fFirst ? "" : ",\n",
+					guiProfilerMainThread, ProfilerMicroseconds( frames[ cnt ] - giProfilerStart ) );
+		fFirst = false;
 	}
 
-	//If we fail to insert the performance marker into our log, it means it is
-	//a duplicate.	We can ignore this "error" as using the existing copy is
-	//the correct behavior.
-	std::pair<PERF_LOG_T::iterator, bool> result = 
-		_perfLog.insert(PerfDatum(fileName, functionName, lineNumber));
-	//Update the call count on the new function:
-	PerfDatum* marker = &*(result.first);
-	marker->_calls++;
-	//Add performance marker to the stack as well as the log:
-	_perfStack.push_back(marker); 
-	//Now that we are clear of any complex operations, we can set the call
-	//time of the new marker more accurately:
-	_lastTime = getCPUCount();
+	fprintf( pFile, "\n]}\n" );
+	return( fclose( pFile ) == 0 );
 }
 
-void PerfManager::exitFunction()
+typedef struct
 {
-	//Mark the time when we exited the function
-	__int64 endTime = getCPUCount();
-	//Update the function in our log with its new runtime
-	PERF_STACK_T::reverse_iterator lastMarker = _perfStack.rbegin();
-	__int64 runTime = endTime - _lastTime;
-	(**lastMarker)._cycles += runTime;
-	_totalTime += runTime;
-	_perfStack.pop_back();
-	//Lastly, update the function we've fallen back to with the new current
-	//run time.
-	_lastTime = getCPUCount();
-}
-
-__int64 PerfManager::getCPUCount () const
+	UINT32	uiCalls;
+	double	dTotal;				// ms, inclusive of the zones inside
+	double	dMaxPerCall;
+	double	dMaxPerFrame;
+} ProfileZoneTotal;
+
+// Totals of the main thread's zones over the frames that are still complete in the buffer, and one line per frame
+// with the time of each zone in it. Zones are counted in the frame they started in.
+static bool WriteFrameSummary( const std::vector<ProfileZone> &zones, const std::vector<__int64> &frames )
 {
-	_asm rdtsc
-}
+	FILE *pFile = fopen( PROFILER_SUMMARY_FILENAME, "w" );
 
-bool PerfSort::operator ()(const PerfDatum& lhs, const PerfDatum&rhs) const
-{
-	if(rhs._lineNumber == lhs._lineNumber)
-	{	return 0 < strcmp(rhs._fileName, lhs._fileName);
-	}
-	else
-	{	return rhs._lineNumber > lhs._lineNumber;
+	if ( !pFile )
+		return( false );
+
+	// frames that started before the oldest zone still there aren't complete
+	size_t uiFirstFrame = 0;
+	if ( !zones.empty() )
+	{
+		while ( uiFirstFrame < frames.size() && frames[ uiFirstFrame ] < zones[ 0 ].iStart )
+			++uiFirstFrame;
 	}
-}
 
-bool PerfSort2::operator ()(const PerfDatum& lhs, const PerfDatum&rhs) const
-{
-	return lhs._cycles > rhs._cycles;
-}
+	size_t uiFrames = frames.size() > uiFirstFrame + 1 ? frames.size() - uiFirstFrame - 1 : 0;
 
-int PerfManager::getPercision(const double value) const
-{
-	int retVal = 1;
-	if(10.0 <= value)
-	{	retVal = 3;
-	}
-	else if (1.0 <= value)
-	{	retVal = 2;
-	}
-	return retVal;
-}
+	std::vector<const char*>					names;
+	std::map<const char*, ProfileZoneTotal>		totals;
+	std::vector< std::map<const char*, double> >	perFrame( uiFrames );
+	double										dFrameTotal = 0, dFrameMax = 0;
 
-void PerfManager::log(std::ostream &os)
-{
-	//Create a copy of the log that sorts by cycles used
-	std::set<PerfDatum, PerfSort2> logCopy;
-	for(PERF_LOG_T::iterator i = _perfLog.begin(); i != _perfLog.end(); i++)
+	size_t uiZone = 0;
+	for ( size_t uiFrame = 0; uiFrame < uiFrames; ++uiFrame )
 	{
-		logCopy.insert(*i);
+		__int64 iFrameStart = frames[ uiFirstFrame + uiFrame ];
+		__int64 iFrameEnd = frames[ uiFirstFrame + uiFrame + 1 ];
+
+		while ( uiZone < zones.size() && zones[ uiZone ].iStart < iFrameStart )
+			++uiZone;
+
+		for ( ; uiZone < zones.size() && zones[ uiZone ].iStart < iFrameEnd; ++uiZone )
+		{
+			const ProfileZone &zone = zones[ uiZone ];
+			double dTime = ProfilerMicroseconds( zone.iEnd - zone.iStart ) / 1000.0;
+
+			if ( !totals.count( zone.szName ) )
+			{
+				ProfileZoneTotal total = { 0, 0, 0, 0 };
+				totals[ zone.szName ] = total;
+				names.push_back( zone.szName );
+			}
+
+			ProfileZoneTotal &total = totals[ zone.szName ];
+			total.uiCalls++;
+			total.dTotal += dTime;
+			total.dMaxPerCall = __max( total.dMaxPerCall, dTime );
+			perFrame[ uiFrame ][ zone.szName ] += dTime;
+		}
+
+		double dFrame = ProfilerMicroseconds( iFrameEnd - iFrameStart ) / 1000.0;
+		dFrameTotal += dFrame;
+		dFrameMax = __max( dFrameMax, dFrame );
+
+		for ( std::map<const char*, double>::const_iterator it = perFrame[ uiFrame ].begin(); it != perFrame[ uiFrame ].end(); ++it )
+			totals[ it->first ].dMaxPerFrame = __max( totals[ it->first ].dMaxPerFrame, it->second );
 	}
 
-	int cyclesWidth = 1;
-	//I want the formatting to be nice!
-	for(std::set<PerfDatum, PerfSort2>::iterator i = logCopy.begin(); 
-		i != logCopy.end(); 
-		i++)
+	fprintf( pFile, "JA2 profile of the main thread: %u frames, %.3f ms per frame on average, %.3f ms at most\n\n",
+				(UINT32)uiFrames, uiFrames ? dFrameTotal / uiFrames : 0.0, dFrameMax );
+
+	// zones that took the most time first
+	std::vector<const char*> sorted( names );
+	std::sort( sorted.begin(), sorted.end(), [&]( const char *a, const char *b ) { return totals[ a ].dTotal > totals[ b ].dTotal; } );
+
+	fprintf( pFile, "%-40s %10s %12s %12s %12s %12s\n", "zone", "calls", "total ms", "ms/frame", "max ms/frame", "max ms/call" );
+	for ( size_t cnt = 0; cnt < sorted.size(); ++cnt )
 	{
-		if(i->_lineNumber) {
-			std::stringstream cyclesString;
-			cyclesString << i->_cycles;
-			std::string tempString;
-			cyclesString >> tempString;
-			cyclesWidth = tempString.size();
-			break;
-		}
+		const ProfileZoneTotal &total = totals[ sorted[ cnt ] ];
+
+		fprintf( pFile, "%-40s %10u %12.3f %12.3f %12.3f %12.3f\n", sorted[ cnt ], total.uiCalls, total.dTotal,
+					uiFrames ? total.dTotal / uiFrames : 0.0, total.dMaxPerFrame, total.dMaxPerCall );
 	}
 
-	//Stream the sorted log to the supplied ostream
-	for(std::set<PerfDatum, PerfSort2>::iterator i = logCopy.begin(); 
-		i != logCopy.end(); 
-		++i)
+	// the timeline, tab separated so it can be pasted into a spreadsheet
+	fprintf( pFile, "\nframe\tms" );
+	for ( size_t cnt = 0; cnt < sorted.size(); ++cnt )
+		fprintf( pFile, "\t%s", sorted[ cnt ] );
+	fprintf( pFile, "\n" );
+
+	for ( size_t uiFrame = 0; uiFrame < uiFrames; ++uiFrame )
 	{
-		if(i->_lineNumber)
-		{	//Truncate path from file name if the compiler included it.
-			const char* j = i->_fileName + strlen(i->_fileName);
-			while('\\' != *j && '/' != *j && j >= i->_fileName){j--;}
-			if('\\' == *j || '/' == *j){j++;}
-			std::stringstream cyclesString;
-			std::string tempString;
-			cyclesString << i->_cycles;
-			cyclesString >> tempString;
-			os.width(cyclesWidth);
-			os << tempString.c_str() << ", ";
-			__int64 cyclesPerCall = i->_cycles / i->_calls;
-			cyclesString.clear();
-			tempString.clear();
-			cyclesString << cyclesPerCall;
-			cyclesString >> tempString;
-			os.width(cyclesWidth);
-			os << tempString.c_str() << "] cycles (";
-			double percent = double(i->_cycles) / double(_totalTime) * 100;
-			os.precision(getPercision(percent));
-			os.width(4);
-			os << percent << "%) used in [";
-			os.width(8);
-			os << i->_calls << "] calls by " << j << "::" << i->_functionName\
-				<< " at line " << i->_lineNumber << std::endl;
+		fprintf( pFile, "%u\t%.3f", (UINT32)uiFrame, ProfilerMicroseconds( frames[ uiFirstFrame + uiFrame + 1 ] - frames[ uiFirstFrame + uiFrame ] ) / 1000.0 );
+
+		for ( size_t cnt = 0; cnt < sorted.size(); ++cnt )
+		{
+			std::map<const char*, double>::const_iterator it = perFrame[ uiFrame ].find( sorted[ cnt ] );
+
+			fprintf( pFile, "\t%.3f", it != perFrame[ uiFrame ].end() ? it->second : 0.0 );
 		}
+		fprintf( pFile, "\n" );
 	}
+
+	return( fclose( pFile ) == 0 );
 }
 
-PerfMarker::PerfMarker( const char* const fileName, 
-						const char* const functionName,
-						const int lineNumber)
-	:
-#ifdef PERIODIC_PROFILING
-	_onStack(gRecordingProfile)
-#else
-	_onStack(true)
-#endif
+bool ProfilerStop( void )
 {
-#ifdef PERIODIC_PROFILING
-	if (gRecordingProfile == true) {
-#endif
-		PerfManager::instance()->enterFunction(fileName,functionName,lineNumber);
-#ifdef PERIODIC_PROFILING
+	if ( !ProfilerIsRecording() )
+		return( false );
+
+	// zones that were still open when recording stopped can still come in while the buffers are copied, they may or may not make it
+	std::vector<ProfileThreadBuffer*>			buffers;
+	std::vector< std::vector<ProfileZone> >		zones;
+	std::vector<__int64>						frames;
+	std::vector<ProfileZone>					mainZones;
+
+	// held until the files are written, threads that end in the meantime wait before they free their buffers
+	std::lock_guard<std::mutex> guard( gProfilerLock );
+
+	gfProfilerRecording = false;
+	buffers = gProfilerBuffers;
+
+	UINT32 uiCount = __min( guiProfilerFrames, (UINT32)PROFILER_FRAMES );
+	for ( UINT32 cnt = guiProfilerFrames - uiCount; cnt < guiProfilerFrames; ++cnt )
+		frames.push_back( gProfilerFrames[ cnt % PROFILER_FRAMES ] );
+
+	zones.resize( buffers.size() );
+	for ( size_t cnt = 0; cnt < buffers.size(); ++cnt )
+	{
+		CopyProfileZones( buffers[ cnt ], zones[ cnt ] );
+
+		if ( buffers[ cnt ]->uiThreadId == guiProfilerMainThread )
+			mainZones = zones[ cnt ];
 	}
-#endif
-}
 
-PerfMarker::~PerfMarker()
-{
-	endMark();
-}
+	// zones are written when they end, the summary wants them by start
+	std::stable_sort( mainZones.begin(), mainZones.end(), []( const ProfileZone &a, const ProfileZone &b ) { return a.iStart < b.iStart; } );
 
-void PerfMarker::endMark()
-{
-	if(_onStack)
-	{	PerfManager::instance()->exitFunction();
-		_onStack = false;
+	bool fTrace = WriteChromeTrace( buffers, zones, frames );
+	bool fSummary = WriteFrameSummary( mainZones, frames );
+
+	// the buffers of threads that ended while recording were only kept for the files
+	for ( size_t cnt = 0; cnt < gProfilerBuffers.size(); )
+	{
+		if ( gProfilerBuffers[ cnt ]->fThreadEnded )
+		{
+			delete gProfilerBuffers[ cnt ];
+			gProfilerBuffers.erase( gProfilerBuffers.begin() + cnt );
+			continue;
+		}
+		++cnt;
 	}
-}
 
-#endif
+	return( fTrace && fSummary );
+}
@@ -1,87 +1,73 @@
 #pragma once
 
-#include <vector>
-#include <set>
-#include <ostream>
+#include <atomic>
 
-//#ifndef PROFILER_ENABLED
-//#define PROFILER_ENABLED
-//#endif
+// Scoped timing zones for finding out where a frame goes.
+//
+// Put PERFORMANCE_MARKER at the top of a function (or NAMED_PERFORMANCE_MARKER( "name" ) at the top of any block)
+// and while the profiler records, the time spent until the end of the scope is kept as one zone, on the thread
+// that ran it. Each thread writes to its own ring buffer, so the profiler can run for as long as it likes and
+// keeps the last zones of every thread. ProfilerStop() writes them as a Chrome trace (ja2_profile.json, open it
+// in chrome://tracing or ui.perfetto.dev) and a frame by frame summary of the main thread (ja2_profile.txt).
+//
+// The markers are always compiled in. While the profiler doesn't record, a marker costs one test of
+// gfProfilerRecording. Start it with /PROFILE on the command line (written when the game exits) or, in the test
+// version, with Shift+F11 in tactical.
+//
+// The names must be string literals (or __FUNCTION__), only the pointer is kept.
 
-#ifdef PROFILER_ENABLED
-#define STRINGIZE(x) #x
-#define NAMED_	PERFORMANCE_MARKER(x) PerfMarker x(__FILE__, STRINGIZE(x), __LINE__);
-#define END_NAMED_	PERFORMANCE_MARKER(x) x.endMark();
-#define PERFORMANCE_MARKER PerfMarker MARK(__FILE__, __FUNCTION__, __LINE__);
-#define PERIODIC_PROFILING
-#else
-#define PERFORMANCE_MARKER
-#endif
-#pragma warning (disable : 4512)//disables assignment operator could not be generated
+#define PROFILER_MARKER_CONCAT2( a, b )		a##b
+#define PROFILER_MARKER_CONCAT( a, b )		PROFILER_MARKER_CONCAT2( a, b )
+#define NAMED_PERFORMANCE_MARKER( name )	PerfMarker PROFILER_MARKER_CONCAT( MARK, __LINE__ )( name );
+#define PERFORMANCE_MARKER					NAMED_PERFORMANCE_MARKER( __FUNCTION__ )
 
-struct PerfDatum
-{
-	PerfDatum(	const char* const fileName, 
-				const char* const functionName,
-				const int lineNumber,
-				__int64 cycles = 0,
-				__int64 calls = 0);
-	const char* const	_fileName;
-	const char* const	_functionName;
-	const int			_lineNumber;
-	__int64			 _cycles;		//Number of CPU cycles used
-	__int64			 _calls;		 //Number of calls to this function
-};
-#pragma warning (default : 4512)//disables assignment operator could not be generated
-
-class PerfSort
-{
-public:
-	bool operator()(const PerfDatum& lhs, const PerfDatum& rhs) const;
-};
+extern std::atomic<bool> gfProfilerRecording;
 
-class PerfSort2
-{
-public:
-	bool operator()(const PerfDatum& lhs, const PerfDatum& rhs) const;
-};
+void		ProfilerStart( void );
+// stops recording and writes the files, false if they couldn't be written
+bool		ProfilerStop( void );
+inline bool	ProfilerIsRecording( void )		{ return gfProfilerRecording.load( std::memory_order_relaxed ); }
 
+// called by the game loop at the start of every frame, the summary is split at these
+void		ProfilerNewFrame( void );
+// name of the calling thread in the trace, threads that don't set one are listed by their id
+void		ProfilerSetThreadName( const char *szName );
 
-typedef std::set<PerfDatum, PerfSort>		PERF_LOG_T;
-typedef std::vector<PerfDatum* >			PERF_STACK_T;
+// monotonic timestamp in ticks of ProfilerTicksPerSecond()
+__int64		ProfilerTimestamp( void );
+__int64		ProfilerTicksPerSecond( void );
 
-class PerfManager
-{
-public:
-	~PerfManager(void);
-	static PerfManager* instance();
-	void enterFunction( const char* const fileName, 
-						const char* const functionName,
-						const int lineNumber);
-	void exitFunction();
-	void log(std::ostream &os);
-private:
-	PerfManager(void);
-	__int64 getCPUCount(void) const;
-	void calibrate(void);
-	int getPercision(const double value) const; //used for formatting percentages
-	static PerfManager* _instance;
-	PERF_LOG_T		_perfLog;
-	PERF_STACK_T	_perfStack;
-	__int64		 _callTime;	//Time it takes to call the getCPUCount function
-	__int64		 _totalTime;
-	__int64		 _lastTime;	//The last time we got hte CPU count.
-};
+void		ProfilerRecordZone( const char *szName, __int64 iStart );
 
 class PerfMarker
 {
 public:
-	PerfMarker( const char* const fileName, 
-				const char* const functionName,
-				const int lineNumber);
-	~PerfMarker();
-	void endMark();
+	explicit PerfMarker( const char *szName ) : _szName( NULL )
+	{
+		if ( ProfilerIsRecording() )
+		{
+			_szName = szName;
+			_iStart = ProfilerTimestamp();
+		}
+	}
+	~PerfMarker()
+	{
+		endMark();
+	}
+	// ends the zone before the end of the scope
+	void endMark()
+	{
+		if ( _szName )
+		{
+			ProfilerRecordZone( _szName, _iStart );
+			_szName = NULL;
+		}
+	}
+
 private:
-	bool _onStack;
-};
+	PerfMarker( const PerfMarker& );
+	PerfMarker& operator=( const PerfMarker& );
 
+	const char	*_szName;
+	__int64		_iStart;
+};
@@ -114,6 +114,7 @@
 #include "new.h"
 #include "types.h"
 #include "connect.h"
+#include "replication.h"
 #include "message.h"
 #include "Event Pump.h"
 #include "Soldier Init List.h"
@@ -156,6 +157,70 @@ RakPeerInterface *client;
 // WANNE: FILE TRANSFER
 FileListTransfer fltClient;	// flt2
 
+// tactical messages go out in one batch per frame, see replication.h
+static bool				gfBatchNetworkMessages = true;
+static ReplicationEncoder	gReplicationEncoder;
+static ReplicationDecoder	gClientReplicationDecoder;
+static UINT32				guiLastCosmeticUpdate = 0;
+
+// how long placement GUI updates may only have gone out unreliable before they are settled
+#define REPL_SETTLE_DELAY	250
+
+// On a dedicated server nobody runs the game next to the server, so the server makes the first client that joins
+// the match host: it sets is_server like the host's game does and runs the AI, the turns and the game start. The
+// server hands it the two calls that need the game (server.cpp handles them for a game hosted server).
+// It has no server of its own (server is NULL), so what the host's server does, it gets from the dedicated one.
+bool					gfDedicatedMatchHost = false;
+void startCOMBAT(RPCParameters *rpcParameters);
+void sendREAL(RPCParameters *rpcParameters);
+
+static void SendTactical( const char *szRPC, UINT8 ubMessage, UINT16 usKey, const char *pData, UINT32 uiBytes )
+{
+	if ( gfBatchNetworkMessages )
+		gReplicationEncoder.Queue( ubMessage, usKey, pData, uiBytes );
+	else
+		client->RPC(szRPC, pData, (int)uiBytes*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+}
+
+static void SendCosmetic( const char *szRPC, UINT8 ubMessage, UINT16 usKey, const char *pData, UINT32 uiBytes )
+{
+	if ( gfBatchNetworkMessages )
+	{
+		gReplicationEncoder.QueueCosmetic( ubMessage, usKey, pData, uiBytes );
+		guiLastCosmeticUpdate = GetJA2Clock();
+	}
+	else
+		client->RPC(szRPC, pData, (int)uiBytes*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+}
+
+// Sends what the frame has queued, called at the end of client_packet(). Anything sent without a batch must
+// flush first with fSettle, so the placement GUI is up to date and it is queued behind the batched messages. The
+// client RPCs go RELIABLE_ORDERED on channel 0 like the batch and the servers relay them the same way (relay.cpp),
+// so they can't overtake it on the way to the other clients either.
+static void FlushReplication( bool fSettle )
+{
+	RakNet::BitStream bs;
+
+	if ( !is_client )
+		return;
+
+	if ( gReplicationEncoder.HasCosmetic() )
+	{
+		gReplicationEncoder.WriteCosmeticBatch( (UINT8)CLIENT_NUM, bs );
+		client->RPC("sendBATCH",(const char*)bs.GetData(), bs.GetNumberOfBitsUsed(), HIGH_PRIORITY, UNRELIABLE_SEQUENCED, REPL_COSMETIC_CHANNEL, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	}
+
+	// settle the cosmetic updates with the next batch, or once they have stopped changing
+	if ( gReplicationEncoder.HasQueued() || GetJA2Clock() - guiLastCosmeticUpdate >= REPL_SETTLE_DELAY )
+		fSettle = true;
+
+	if ( gReplicationEncoder.HasQueued() || ( fSettle && gReplicationEncoder.HasUnsettled() ) )
+	{
+		gReplicationEncoder.WriteBatch( (UINT8)CLIENT_NUM, bs, fSettle );
+		client->RPC("sendBATCH",(const char*)bs.GetData(), bs.GetNumberOfBitsUsed(), HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	}
+}
+
 char *ReplaceCharactersInString_Client(char *str, char *orig, char *rep)
 {
 	static char buffer[4096];
@@ -272,7 +337,7 @@ class ClientTransferCB : public FileListTransferCBInterface
 					prog.downloading = 1;
 					prog.progress = currentProgress;
 
-					client->RPC("sendDOWNLOADSTATUS",(const char*)&prog, (int)sizeof(progress_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+					client->RPC("sendDOWNLOADSTATUS",(const char*)&prog, (int)sizeof(progress_struct)*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 				}
 			}
 
@@ -331,7 +396,7 @@ class ClientTransferCB : public FileListTransferCBInterface
 
 					fDrawCharacterList = true;
 
-					client->RPC("sendDOWNLOADSTATUS",(const char*)&prog, (int)sizeof(progress_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+					client->RPC("sendDOWNLOADSTATUS",(const char*)&prog, (int)sizeof(progress_struct)*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 				}
 			}
 
@@ -433,13 +498,6 @@ typedef struct
 	SoldierID Interrupted;
 } INT_STRUCT;
 
-typedef struct
-{
-	UINT8 client_num;
-	bool status;
-	UINT8 ready_stage;
-} ready_struct;
-
 typedef struct
 {
 	INT32 remote_id;
@@ -790,7 +848,7 @@ void send_path (  SOLDIERTYPE *pSoldier, INT32 sDestGridNo, UINT16 usMovementAni
 		SNetPath.usPathDataSize=pSoldier->pathing.usPathDataSize;
 		SNetPath.sDestGridNo=sDestGridNo;
 			
-		client->RPC("sendPATH",(const char*)&SNetPath, (int)sizeof(EV_S_SENDPATHTONETWORK)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+		SendTactical("sendPATH", REPL_PATH, SNetPath.usSoldierID, (const char*)&SNetPath, sizeof(EV_S_SENDPATHTONETWORK));
 	}
 }
 
@@ -850,7 +908,7 @@ void send_stance ( SOLDIERTYPE *pSoldier, UINT8 ubDesiredStance )
 
 		//ScreenMsg( FONT_LTGREEN, MSG_MPSYSTEM, L"change stance: %d",ubDesiredStance );
 	
-		client->RPC("sendSTANCE",(const char*)&SChangeStance, (int)sizeof(EV_S_CHANGESTANCE)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+		SendTactical("sendSTANCE", REPL_STANCE, SChangeStance.usSoldierID, (const char*)&SChangeStance, sizeof(EV_S_CHANGESTANCE));
 	}
 }
 
@@ -893,7 +951,7 @@ void send_dir ( SOLDIERTYPE *pSoldier, UINT16 usDesiredDirection )
 		SSetDesiredDirection.usDesiredDirection = usDesiredDirection;
 		SSetDesiredDirection.uiUniqueId = pSoldier -> uiUniqueSoldierIdValue;
 
-		client->RPC("sendDIR",(const char*)&SSetDesiredDirection, (int)sizeof(EV_S_SETDESIREDDIRECTION)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+		SendTactical("sendDIR", REPL_DIR, SSetDesiredDirection.usSoldierID, (const char*)&SSetDesiredDirection, sizeof(EV_S_SETDESIREDDIRECTION));
 	}
 }
 
@@ -934,7 +992,7 @@ void send_fire( SOLDIERTYPE *pSoldier, INT32 sTargetGridNo )
 	SBeginFireWeapon.uiUniqueId = pSoldier->usAttackingWeapon;
 		
 
-	client->RPC("sendFIRE",(const char*)&SBeginFireWeapon, (int)sizeof(EV_S_BEGINFIREWEAPON)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	SendTactical("sendFIRE", REPL_FIRE, SBeginFireWeapon.usSoldierID, (const char*)&SBeginFireWeapon, sizeof(EV_S_BEGINFIREWEAPON));
 	}
 }
 
@@ -970,7 +1028,7 @@ void send_hit(  EV_S_WEAPONHIT *SWeaponHit  )
 	if(SWeaponHit->usSoldierID < 20)weaphit_struct.usSoldierID = weaphit_struct.usSoldierID+ubID_prefix;
 	if(SWeaponHit->ubAttackerID < 20)weaphit_struct.ubAttackerID = weaphit_struct.ubAttackerID+ubID_prefix;
 		
-	client->RPC("sendHIT",(const char*)&weaphit_struct, (int)sizeof(EV_S_WEAPONHIT)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	SendTactical("sendHIT", REPL_HIT, weaphit_struct.ubAttackerID, (const char*)&weaphit_struct, sizeof(EV_S_WEAPONHIT));
 }
 
 void recieveHIT(RPCParameters *rpcParameters)
@@ -1014,7 +1072,7 @@ void send_dismiss(UINT16 ubCurrentSoldierID)
 
 	sDismissMerc.ubProfileID = ubCurrentSoldierID + ubID_prefix;
 
-	client->RPC("sendDISMISS",(const char*)&sDismissMerc, (int)sizeof(send_dismiss_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	client->RPC("sendDISMISS",(const char*)&sDismissMerc, (int)sizeof(send_dismiss_struct)*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 }
 
 void send_hire( SoldierID iNewIndex, UINT8 ubCurrentSoldier, INT16 iTotalContractLength, BOOLEAN fCopyProfileItemsOver)
@@ -1062,7 +1120,7 @@ void send_hire( SoldierID iNewIndex, UINT8 ubCurrentSoldier, INT16 iTotalContrac
 		}
 	}
 
-	client->RPC("sendHIRE",(const char*)&sHireMerc, (int)sizeof(send_hire_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	client->RPC("sendHIRE",(const char*)&sHireMerc, (int)sizeof(send_hire_struct)*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 }
 
 void recieveDISMISS(RPCParameters *rpcParameters)
@@ -1160,7 +1218,7 @@ void send_gui_pos(SOLDIERTYPE *pSoldier,  FLOAT dNewXPos, FLOAT dNewYPos)
 	gnPOS.dNewXPos = dNewXPos;
 	gnPOS.dNewYPos = dNewYPos;
 
-	client->RPC("sendguiPOS",(const char*)&gnPOS, (int)sizeof(gui_pos)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	SendCosmetic("sendguiPOS", REPL_GUIPOS, gnPOS.usSoldierID, (const char*)&gnPOS, sizeof(gui_pos));
 }
 
 void recieveguiPOS(RPCParameters *rpcParameters)
@@ -1186,7 +1244,7 @@ void send_gui_dir(SOLDIERTYPE *pSoldier, UINT16	usNewDirection)
 	gnDIR.usSoldierID = (pSoldier->ubID)+ubID_prefix;
 	gnDIR.usNewDirection = usNewDirection;
 	
-	client->RPC("sendguiDIR",(const char*)&gnDIR, (int)sizeof(gui_dir)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	SendCosmetic("sendguiDIR", REPL_GUIDIR, gnDIR.usSoldierID, (const char*)&gnDIR, sizeof(gui_dir));
 }
 
 void recieveguiDIR(RPCParameters *rpcParameters)
@@ -1215,7 +1273,7 @@ void send_EndTurn( UINT8 ubNextTeam )
 	tStruct.tsnetbTeam = netbTeam;
 	tStruct.tsubNextTeam = ubNextTeam;
 	
-	client->RPC("sendEndTurn",(const char*)&tStruct, (int)sizeof(turn_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	SendTactical("sendEndTurn", REPL_ENDTURN, 0, (const char*)&tStruct, sizeof(turn_struct));
 }
 
 void recieveEndTurn(RPCParameters *rpcParameters)
@@ -1283,7 +1341,8 @@ void send_AI( SOLDIERCREATE_STRUCT *pCreateStruct )
 		send_inv.slot[x] = pCreateStruct->Inv[x];
 	}
 	
-	client->RPC("sendAI",(const char*)&send_inv, (int)sizeof(AI_STRUCT)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	FlushReplication( true );
+	client->RPC("sendAI",(const char*)&send_inv, (int)sizeof(AI_STRUCT)*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 }
 
 void recieveAI (RPCParameters *rpcParameters)
@@ -1399,7 +1458,8 @@ void send_ready ( void )
 		info.status = 1; 					
 	}	
 			
-	client->RPC("sendREADY",(const char*)&info, (int)sizeof(ready_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	FlushReplication( true );
+	client->RPC("sendREADY",(const char*)&info, (int)sizeof(ready_struct)*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 
 	if(is_server && numready == cMaxClients)
 	{
@@ -1450,7 +1510,7 @@ void recieveREADY (RPCParameters *rpcParameters)
 			start_battle();
 		}
 	}
-	else if(info->ready_stage==36)//server allows laptop access
+	else if(info->ready_stage==READY_STAGE_ALLOW_LAPTOP)//server allows laptop access
 	{
 		ScreenMsg( FONT_LTGREEN, MSG_MPSYSTEM, MPClientMessage[36] );
 		allowlaptop=1;
@@ -1487,7 +1547,8 @@ void send_loaded (void)
 		info.status=1;
 	}
 
-	client->RPC("sendGUI",(const char*)&info, (int)sizeof(ready_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	FlushReplication( true );
+	client->RPC("sendGUI",(const char*)&info, (int)sizeof(ready_struct)*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 }
 
 void send_donegui ( UINT8 ubResult )
@@ -1530,7 +1591,8 @@ void send_donegui ( UINT8 ubResult )
 		info.status=0;
 	}
 
-	client->RPC("sendGUI",(const char*)&info, (int)sizeof(ready_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	FlushReplication( true );
+	client->RPC("sendGUI",(const char*)&info, (int)sizeof(ready_struct)*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 }
 
 void recieveGUI (RPCParameters *rpcParameters)
@@ -1551,7 +1613,8 @@ void recieveGUI (RPCParameters *rpcParameters)
 			info.ready_stage = 2;//done placing mercs
 			info.status=1;
 
-			client->RPC("sendGUI",(const char*)&info, (int)sizeof(ready_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+			FlushReplication( true );
+			client->RPC("sendGUI",(const char*)&info, (int)sizeof(ready_struct)*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 		}
 	}
 
@@ -1578,7 +1641,8 @@ void recieveGUI (RPCParameters *rpcParameters)
 			KillTacticalPlacementGUI();
 			ScreenMsg( FONT_LTBLUE, MSG_MPSYSTEM, MPClientMessage[13]);
 
-			client->RPC("sendGUI",(const char*)&info, (int)sizeof(ready_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+			FlushReplication( true );
+			client->RPC("sendGUI",(const char*)&info, (int)sizeof(ready_struct)*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 		}
 	}
 
@@ -1606,7 +1670,7 @@ void allowlaptop_callback ( UINT8 ubResult )
 
 		ready_struct info;
 		info.client_num = CLIENT_NUM;
-		info.ready_stage=36;
+		info.ready_stage=READY_STAGE_ALLOW_LAPTOP;
 		info.status=1;
 
 		if (gRandomMercs)
@@ -1622,7 +1686,8 @@ void allowlaptop_callback ( UINT8 ubResult )
 
 		cMaxClients = iPlayersConnected;
 
-		client->RPC("sendREADY",(const char*)&info, (int)sizeof(ready_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+		FlushReplication( true );
+		client->RPC("sendREADY",(const char*)&info, (int)sizeof(ready_struct)*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 	}
 }
 
@@ -1658,6 +1723,8 @@ void start_battle ( void )
 			// notify the server that at least one other player must be connected
 			ScreenMsg( FONT_LTGREEN, MSG_MPSYSTEM, MPClientMessage[51] );
 		}
+		// the clients' download states are relayed by either server, a dedicated server doesn't send files so
+		// nobody downloads there
 		else if (are_clients_downloading())
 		{
 			clientsFinishedDownloading = FALSE;
@@ -1889,7 +1956,7 @@ void send_stop (EV_S_STOP_MERC *SStopMerc) // used to stop a merc when he spots
 
 		stop_struct.sXPos=SStopMerc->sXPos;
 		stop_struct.sYPos=SStopMerc->sYPos;
-		client->RPC("sendSTOP",(const char*)&stop_struct, (int)sizeof(EV_S_STOP_MERC)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+		SendTactical("sendSTOP", REPL_STOP, stop_struct.usSoldierID, (const char*)&stop_struct, sizeof(EV_S_STOP_MERC));
 	}
 }
 
@@ -1933,7 +2000,7 @@ void send_interrupt (SOLDIERTYPE *pSoldier)
 	if(INT.bTeam !=netbTeam) 
 		gTacticalStatus.ubCurrentTeam=INT.bTeam;
 	
-	client->RPC("sendINTERRUPT",(const char*)&INT, (int)sizeof(INT_STRUCT)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	SendTactical("sendINTERRUPT", REPL_INTERRUPT, INT.ubID, (const char*)&INT, sizeof(INT_STRUCT));
 }
 
 #ifdef INTERRUPT_MP_DEADLOCK_FIX
@@ -2150,7 +2217,7 @@ void end_interrupt ( BOOLEAN fMarkInterruptOccurred )
 		}
 	}
 	
-	client->RPC("endINTERRUPT",(const char*)&INT, (int)sizeof(INT_STRUCT)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	SendTactical("endINTERRUPT", REPL_ENDINTERRUPT, INT.ubID, (const char*)&INT, sizeof(INT_STRUCT));
 }
 
 void resume_turn(RPCParameters *rpcParameters)
@@ -2229,7 +2296,8 @@ void overide_callback( UINT8 ubResult )
 			info.ready_stage = 1;
 			info.status = 1; 		
 			
-			client->RPC("sendREADY",(const char*)&info, (int)sizeof(ready_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+			FlushReplication( true );
+			client->RPC("sendREADY",(const char*)&info, (int)sizeof(ready_struct)*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 	
 			status=0;//reset
 			numready=0;
@@ -2247,7 +2315,8 @@ void overide_callback( UINT8 ubResult )
 			numready=0;
 			info.ready_stage = 2;//done placing mercs
 			info.status=1;
-			client->RPC("sendGUI",(const char*)&info, (int)sizeof(ready_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+			FlushReplication( true );
+			client->RPC("sendGUI",(const char*)&info, (int)sizeof(ready_struct)*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 		}
 
 		if(ubResult==4) //overide waiting on merc placement
@@ -2263,7 +2332,8 @@ void overide_callback( UINT8 ubResult )
 			KillTacticalPlacementGUI(); //kill
 			ScreenMsg( FONT_LTBLUE, MSG_MPSYSTEM, MPClientMessage[13]);
 
-			client->RPC("sendGUI",(const char*)&info, (int)sizeof(ready_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+			FlushReplication( true );
+			client->RPC("sendGUI",(const char*)&info, (int)sizeof(ready_struct)*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 		}
 	
 		goahead = 0;
@@ -2275,7 +2345,7 @@ void overide_callback( UINT8 ubResult )
 
 void requestFILE_TRANSFER_SETTINGS(void)
 {
-	client->RPC("requestFILE_TRANSFER_SETTINGS","", 0, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	client->RPC("requestFILE_TRANSFER_SETTINGS","", 0, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 }
 
 // OJW - 20090430
@@ -2291,7 +2361,7 @@ void allowDownloadCallback( UINT8 ubResult )
 		char buffer[3];
 		sprintf(buffer, "%i", setID);
 
-		client->RPC("receiveSETID", (const char*) buffer, (int)sizeof(char*), HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+		client->RPC("receiveSETID", (const char*) buffer, (int)sizeof(char*), HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 	}
 	else
 	{
@@ -2332,7 +2402,7 @@ void requestSETTINGS(void)
 	// OJW - 20090507
 	// send client version to server
 	strcpy(cl_name.client_version,MPVERSION);
-	client->RPC("requestSETTINGS",(const char*)&cl_name, (int)sizeof(client_info)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	client->RPC("requestSETTINGS",(const char*)&cl_name, (int)sizeof(client_info)*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 }
 
 // OJW: FILE TRANSFER: Clients get notified of other clients transfer progress
@@ -2408,6 +2478,18 @@ void recieveSETTINGS (RPCParameters *rpcParameters) //recive settings from serve
 
 		CLIENT_NUM=cl_lan->client_num;//assign client number from server
 
+		if ( cl_lan->hostClient == CLIENT_NUM )
+		{
+			gfDedicatedMatchHost = true;
+			is_server = true;
+
+			gEnemyEnabled = cl_lan->enemyEnabled;
+			gCreatureEnabled = cl_lan->creatureEnabled;
+			gMilitiaEnabled = cl_lan->militiaEnabled;
+			gCivEnabled = cl_lan->civEnabled;
+			gMaxEnemiesEnabled = cl_lan->maxEnemiesEnabled;
+		}
+
 		netbTeam = (CLIENT_NUM)+5;
 		ubID_prefix = gTacticalStatus.Team[ netbTeam ].bFirstID;//over here now
 
@@ -2647,11 +2729,13 @@ void recieveSETTINGS (RPCParameters *rpcParameters) //recive settings from serve
 			strcpy(client_names[cl_lan->client_num-1],szDefault);
 
 			// OJW - 20091024 - extract random table
-			if (!is_server)
+			// (the match host on a dedicated server gets it from there like everybody else)
+			if (!is_server || gfDedicatedMatchHost)
 				memcpy(guiPreRandomNums,cl_lan->random_table,sizeof(UINT32)*MAX_PREGENERATED_NUMS);			
 
 			// WANNE: Turn on airspace mode (to switch maps) for the server!
-			if (is_server)			
+			// The dedicated server's sector is fixed, its match host can't switch maps.
+			if (is_server && !gfDedicatedMatchHost)			
 				TurnOnAirSpaceMode();			
 		}
 	}
@@ -2951,7 +3035,7 @@ void send_grenade (OBJECTTYPE *pGameObj, float dLifeLength, float xPos, float yP
 			gfMPDebugOutputRandoms = true;
 #endif
 
-			client->RPC("sendGRENADE",(const char*)&gren, (int)sizeof(physics_object)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+			SendTactical("sendGRENADE", REPL_GRENADE, gren.ubID, (const char*)&gren, sizeof(physics_object));
 		}
 	}
 }
@@ -3053,7 +3137,7 @@ void send_grenade_result (float xPos, float yPos, float zPos, INT32 sGridNo, Sol
 			gfMPDebugOutputRandoms = true;
 #endif
 
-			client->RPC("sendGRENADERESULT",(const char*)&gres, (int)sizeof(grenade_result)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+			SendTactical("sendGRENADERESULT", REPL_GRENADERESULT, gres.ubOwnerID, (const char*)&gres, sizeof(grenade_result));
 		}
 	}
 }
@@ -3148,7 +3232,7 @@ void send_plant_explosive (SoldierID ubID,UINT16 usItem,UINT8 ubItemStatus,UINT1
 	MPDebugMsg(tmpMPDbgString);
 #endif
 
-	client->RPC("sendPLANTEXPLOSIVE",(const char*)&exp, (int)sizeof(explosive_obj)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	SendTactical("sendPLANTEXPLOSIVE", REPL_PLANTEXPLOSIVE, exp.ubID, (const char*)&exp, sizeof(explosive_obj));
 }
 
 void recievePLANTEXPLOSIVE (RPCParameters *rpcParameters)
@@ -3275,7 +3359,7 @@ void send_detonate_explosive (UINT32 uiWorldIndex, SoldierID ubID)
 				gfMPDebugOutputRandoms = true;
 #endif
 
-				client->RPC("sendDETONATEEXPLOSIVE",(const char*)&det, (int)sizeof(detonate_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+				SendTactical("sendDETONATEEXPLOSIVE", REPL_DETONATEEXPLOSIVE, det.ubID, (const char*)&det, sizeof(detonate_struct));
 			}
 			else
 			{
@@ -3388,7 +3472,7 @@ void send_disarm_explosive(UINT32 sGridNo, UINT32 uiWorldItem, SoldierID ubID)
 				gfMPDebugOutputRandoms = true;
 	#endif
 
-				client->RPC("sendDISARMEXPLOSIVE",(const char*)&disarm, (int)sizeof(disarm_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+				SendTactical("sendDISARMEXPLOSIVE", REPL_DISARMEXPLOSIVE, disarm.ubID, (const char*)&disarm, sizeof(disarm_struct));
 			}
 			else
 			{
@@ -3482,7 +3566,7 @@ void send_spreadeffect ( INT32 sGridNo, UINT8 ubRadius, UINT16 usItem, SoldierID
 	MPDebugMsg(tmpMPDbgString);
 #endif
 
-	client->RPC("sendSPREADEFFECT",(const char*)&sef, (int)sizeof(spreadeffect_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	SendTactical("sendSPREADEFFECT", REPL_SPREADEFFECT, sef.ubOwner, (const char*)&sef, sizeof(spreadeffect_struct));
 }
 
 void recieveSPREADEFFECT (RPCParameters *rpcParameters)
@@ -3566,7 +3650,7 @@ void send_newsmokeeffect(INT32 sGridNo, UINT16 usItem, INT8 bLevel, SoldierID ub
 	MPDebugMsg(tmpMPDbgString);
 #endif
 
-	client->RPC("sendNEWSMOKEEFFECT",(const char*)&sef, (int)sizeof(spreadeffect_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	SendTactical("sendNEWSMOKEEFFECT", REPL_NEWSMOKEEFFECT, sef.ubOwner, (const char*)&sef, sizeof(spreadeffect_struct));
 }
 
 void recieveNEWSMOKEEFFECT (RPCParameters *rpcParameters)
@@ -3628,7 +3712,7 @@ void send_gasdamage( SOLDIERTYPE * pSoldier, UINT16 usExplosiveClassID, INT16 sS
 	MPDebugMsg(tmpMPDbgString);
 #endif
 
-	client->RPC("sendEXPLOSIONDAMAGE",(const char*)&exp, (int)sizeof(explosiondamage_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	SendTactical("sendEXPLOSIONDAMAGE", REPL_EXPLOSIONDAMAGE, exp.ubSoldierID, (const char*)&exp, sizeof(explosiondamage_struct));
 }
 
 void send_explosivedamage( SoldierID ubPerson, SoldierID ubOwner, INT32 sBombGridNo, INT16 sWoundAmt, INT16 sBreathAmt, UINT32 uiDist, UINT16 usItem, INT16 sSubsequent )
@@ -3651,7 +3735,7 @@ void send_explosivedamage( SoldierID ubPerson, SoldierID ubOwner, INT32 sBombGri
 	MPDebugMsg(tmpMPDbgString);
 #endif
 
-	client->RPC("sendEXPLOSIONDAMAGE",(const char*)&exp, (int)sizeof(explosiondamage_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	SendTactical("sendEXPLOSIONDAMAGE", REPL_EXPLOSIONDAMAGE, exp.ubSoldierID, (const char*)&exp, sizeof(explosiondamage_struct));
 }
 
 void recieveEXPLOSIONDAMAGE (RPCParameters *rpcParameters)
@@ -3716,7 +3800,7 @@ void send_bullet(  BULLET * pBullet,UINT16 usHandItem )
 	if(pBullet->ubFirerID < 20)netb.net_bullet.ubFirerID = netb.net_bullet.ubFirerID+ubID_prefix;
 				
 	
-	client->RPC("sendBULLET",(const char*)&netb, (int)sizeof(netb_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	SendTactical("sendBULLET", REPL_BULLET, netb.net_bullet.ubFirerID, (const char*)&netb, sizeof(netb_struct));
 
 }
 
@@ -3783,7 +3867,7 @@ void send_changestate (EV_S_CHANGESTATE * SChangeState)
 	if(new_state.usSoldierID < 20)
 		new_state.usSoldierID = new_state.usSoldierID+ubID_prefix;
 	
-	client->RPC("sendSTATE",(const char*)&new_state, (int)sizeof(EV_S_CHANGESTATE)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	SendTactical("sendSTATE", REPL_STATE, new_state.usSoldierID, (const char*)&new_state, sizeof(EV_S_CHANGESTATE));
 }
 
 void recieveSTATE(RPCParameters *rpcParameters)
@@ -3920,7 +4004,7 @@ void send_death( SOLDIERTYPE *pSoldier )
 	nDeath.soldier_team = pS_bTeam;
 
 	// notify other clients of death
-	client->RPC("sendDEATH",(const char*)&nDeath, (int)sizeof(death_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	SendTactical("sendDEATH", REPL_DEATH, nDeath.soldier_id, (const char*)&nDeath, sizeof(death_struct));
 	
 	// print kill notice to screen	
 	if (pSoldier && pSoldier->bTeam==1)  
@@ -4039,7 +4123,7 @@ void send_hitstruct(EV_S_STRUCTUREHIT	*	SStructureHit)
 	memcpy( &struct_hit , SStructureHit, sizeof( EV_S_STRUCTUREHIT ));
 	if(SStructureHit->ubAttackerID <20)struct_hit.ubAttackerID = SStructureHit->ubAttackerID+ubID_prefix;
 			
-	client->RPC("sendhitSTRUCT",(const char*)&struct_hit, (int)sizeof(EV_S_STRUCTUREHIT)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	SendTactical("sendhitSTRUCT", REPL_HITSTRUCT, struct_hit.ubAttackerID, (const char*)&struct_hit, sizeof(EV_S_STRUCTUREHIT));
 }
 
 void send_hitwindow(EV_S_WINDOWHIT * SWindowHit)
@@ -4050,7 +4134,7 @@ void send_hitwindow(EV_S_WINDOWHIT * SWindowHit)
 	if(SWindowHit->ubAttackerID <20)
 		window_hit.ubAttackerID = SWindowHit->ubAttackerID+ubID_prefix;
 			
-	client->RPC("sendhitWINDOW",(const char*)&window_hit, (int)sizeof(EV_S_WINDOWHIT)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	SendTactical("sendhitWINDOW", REPL_HITWINDOW, window_hit.ubAttackerID, (const char*)&window_hit, sizeof(EV_S_WINDOWHIT));
 }
 
 void send_miss(EV_S_MISS * SMiss)
@@ -4061,7 +4145,7 @@ void send_miss(EV_S_MISS * SMiss)
 	if(SMiss->ubAttackerID <20)
 		shot_miss.ubAttackerID = SMiss->ubAttackerID+ubID_prefix;
 			
-	client->RPC("sendMISS",(const char*)&shot_miss, (int)sizeof(EV_S_MISS)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	SendTactical("sendMISS", REPL_MISS, shot_miss.ubAttackerID, (const char*)&shot_miss, sizeof(EV_S_MISS));
 }
 
 void recievehitSTRUCT  (RPCParameters *rpcParameters)
@@ -4230,7 +4314,7 @@ void UpdateSoldierToNetwork ( SOLDIERTYPE *pSoldier )
 			else
 				SUpdateNetworkSoldier.usTactialTurnLimitCounter = 9999;
 			
-			client->RPC("updatenetworksoldier",(const char*)&SUpdateNetworkSoldier, (int)sizeof(EV_S_UPDATENETWORKSOLDIER)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+			SendTactical("updatenetworksoldier", REPL_UPDATESOLDIER, SUpdateNetworkSoldier.usSoldierID, (const char*)&SUpdateNetworkSoldier, sizeof(EV_S_UPDATENETWORKSOLDIER));
 		}
 	}
 }
@@ -4308,7 +4392,8 @@ void kick_callback (UINT8 ubResult)
 				kickR kick;
 				kick.ubResult=ubResult+5;
 				
-				client->RPC("Snull_team",(const char*)&kick, (int)sizeof(kickR)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+				FlushReplication( true );
+				client->RPC("Snull_team",(const char*)&kick, (int)sizeof(kickR)*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 
 				// If the team that should be kicked has the turn, give the turn to the server
 				if (gTacticalStatus.ubCurrentTeam == kick.ubResult)
@@ -4413,7 +4498,7 @@ void send_fireweapon (EV_S_FIREWEAPON  *SFireWeapon)
 	sFire.bTargetCubeLevel=SFireWeapon->bTargetCubeLevel;
 	sFire.bTargetLevel=SFireWeapon->bTargetLevel;
 
-	client->RPC("sendFIREW",(const char*)&sFire, (int)sizeof(EV_S_FIREWEAPON)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	SendTactical("sendFIREW", REPL_FIREWEAPON, sFire.usSoldierID, (const char*)&sFire, sizeof(EV_S_FIREWEAPON));
 }
 
 void recieve_fireweapon (RPCParameters *rpcParameters)
@@ -4437,7 +4522,7 @@ void send_door ( SOLDIERTYPE *pSoldier, INT32 sGridNo, BOOLEAN fNoAnimations )
 		sDoor.sGridNo=sGridNo;
 		sDoor.fNoAnimations=fNoAnimations;
 		
-		client->RPC("sendDOOR",(const char*)&sDoor, (int)sizeof(doors)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+		SendTactical("sendDOOR", REPL_DOOR, sDoor.ubID, (const char*)&sDoor, sizeof(doors));
 	}
 }
 
@@ -4490,8 +4575,10 @@ void recieveDISCONNECT(RPCParameters* rpcParameters)
 
 	// clear our records from this client
 	memset(client_names[cl_num-1],NULL,sizeof(char)*30);
+	gClientReplicationDecoder.ResetSender( (UINT8)cl_num );
 	memset(&client_ready[cl_num-1],0,sizeof(int));
 	memset(&client_teams[cl_num-1],0,sizeof(int));
+	client_downloading[cl_num-1] = 0;	// or a client that left while downloading keeps the game from starting
 
 	if (guiCurrentScreen == MAP_SCREEN && !(gTacticalStatus.uiFlags & INCOMBAT))
 	{
@@ -4629,7 +4716,8 @@ void sendRT(void)
 		real_struct rData;
 		rData.bteam=netbTeam;
 
-		client->RPC("sendREAL",(const char*)&rData, (int)sizeof(real_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+		FlushReplication( true );
+		client->RPC("sendREAL",(const char*)&rData, (int)sizeof(real_struct)*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 	}
 }
 
@@ -4664,7 +4752,14 @@ void startCombat(UINT8 ubStartingTeam)
 
 	data.ubStartingTeam=ubStartingTeam;
 
-	client->RPC("startCOMBAT",(const char*)&data, (int)sizeof(sc_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	FlushReplication( true );
+	client->RPC("startCOMBAT",(const char*)&data, (int)sizeof(sc_struct)*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+}
+
+void send_gotoRT( real_struct *rData )
+{
+	FlushReplication( true );
+	client->RPC("sendGOTORT",(const char*)rData, (int)sizeof(real_struct)*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 }
 
 void teamwiped ( void )
@@ -4674,7 +4769,7 @@ void teamwiped ( void )
 	sc_struct data;
 	data.ubStartingTeam=netbTeam;
 
-	client->RPC("sendWIPE",(const char*)&data, (int)sizeof(sc_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	SendTactical("sendWIPE", REPL_WIPE, 0, (const char*)&data, sizeof(sc_struct));
 
 	if (is_server)
 	{
@@ -4714,7 +4809,7 @@ void send_heal (SOLDIERTYPE *pSoldier )
 	data.bLife=pSoldier->stats.bLife;
 	data.bBleeding=pSoldier->bBleeding;
 
-	client->RPC("sendHEAL",(const char*)&data, (int)sizeof(heal)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	SendTactical("sendHEAL", REPL_HEAL, data.ubID, (const char*)&data, sizeof(heal));
 }
 
 void recieve_heal (RPCParameters *rpcParameters)
@@ -4747,7 +4842,8 @@ void requestAIint(SOLDIERTYPE *pSoldier )
 	ScreenMsg( FONT_LTGREEN, MSG_INTERFACE, L"interrupt requested" );
 #endif
 		
-	client->RPC("rINT",(const char*)&data, (int)sizeof(AIint)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	FlushReplication( true );
+	client->RPC("rINT",(const char*)&data, (int)sizeof(AIint)*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 }
 
 void awardINT (RPCParameters *rpcParameters)
@@ -4793,7 +4889,8 @@ void send_gameover()
 	iScoreScreenTime = 0;
 
 	// notify all the clients that the game is over
-	client->RPC("sendGAMEOVER",(const char*)&CLIENT_NUM, (int)sizeof(CLIENT_NUM)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+	FlushReplication( true );
+	client->RPC("sendGAMEOVER",(const char*)&CLIENT_NUM, (int)sizeof(CLIENT_NUM)*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 }
 
 void recieveGAMEOVER(RPCParameters *rpcParameters)
@@ -4805,6 +4902,64 @@ void recieveGAMEOVER(RPCParameters *rpcParameters)
 	StartScoreScreen();
 }
 
+// the recieve function of every batched message, in the order of the REPL_ numbers
+static void (*gReplicationHandlers[ NUM_REPL_MESSAGES ])(RPCParameters *rpcParameters) =
+{
+	recievePATH,
+	recieveSTANCE,
+	recieveDIR,
+	recieveFIRE,
+	recieveHIT,
+	recieveEndTurn,
+	recieveSTOP,
+	recieveINTERRUPT,
+	resume_turn,
+	recieveBULLET,
+	recieveGRENADE,
+	recieveGRENADERESULT,
+	recievePLANTEXPLOSIVE,
+	recieveDETONATEEXPLOSIVE,
+	recieveDISARMEXPLOSIVE,
+	recieveSPREADEFFECT,
+	recieveNEWSMOKEEFFECT,
+	recieveEXPLOSIONDAMAGE,
+	recieveSTATE,
+	recieveDEATH,
+	recievehitSTRUCT,
+	recievehitWINDOW,
+	recieveMISS,
+	UpdateSoldierFromNetwork,
+	recieve_fireweapon,
+	recieve_door,
+	recieve_wipe,
+	recieve_heal,
+	recieveguiPOS,
+	recieveguiDIR,
+};
+
+void recieveBATCH(RPCParameters *rpcParameters)
+{
+	std::vector<ReplicationEntry> entries;
+	UINT8 ubSender;
+	bool fCosmetic = false;
+
+	if ( !gClientReplicationDecoder.ReadBatch( rpcParameters->input, rpcParameters->numberOfBitsOfData, ubSender, fCosmetic, entries ) )
+	{
+		ScreenMsg( FONT_BEIGE, MSG_MPSYSTEM, L"** a batch of messages could not be unpacked **");
+		return;
+	}
+
+	// every message gets handled as if it had come on its own
+	for ( size_t cnt = 0; cnt < entries.size(); ++cnt )
+	{
+		RPCParameters entryParameters = *rpcParameters;
+
+		entryParameters.input = &entries[ cnt ].data[ 0 ];
+		entryParameters.numberOfBitsOfData = (BitSize_t)entries[ cnt ].data.size() * 8;
+		gReplicationHandlers[ entries[ cnt ].ubMessage ]( &entryParameters );
+	}
+}
+
 //***************************
 //*** client connection*****
 //*************************
@@ -4869,6 +5024,9 @@ void connect_client ( void )
 		REGISTER_STATIC_RPC(client, recieveCHATMSG);
 		REGISTER_STATIC_RPC(client, requestSETID);
 		REGISTER_STATIC_RPC(client, recieveDISCONNECTREASON);
+		REGISTER_STATIC_RPC(client, recieveBATCH);
+		REGISTER_STATIC_RPC(client, startCOMBAT);
+		REGISTER_STATIC_RPC(client, sendREAL);
 		//***
 		
 		if (b)
@@ -4914,6 +5072,10 @@ void connect_client ( void )
 		strncpy(serverIP, iniReader.ReadString(JA2MP_INI_INITIAL_SECTION,JA2MP_SERVER_IP, ""), 30);
 		strncpy(cClientName, iniReader.ReadString(JA2MP_INI_INITIAL_SECTION,JA2MP_CLIENT_NAME, ""), 30);
 		strncpy(cGameDataSyncDirectory, iniReader.ReadString(JA2MP_INI_INITIAL_SECTION,JA2MP_FILE_TRANSFER_DIRECTORY, "MULTIPLAYER/Servers/My Server"), 100);
+		gfBatchNetworkMessages = iniReader.ReadBoolean(JA2MP_INI_INITIAL_SECTION,JA2MP_BATCH_MESSAGES, true, false);
+
+		gReplicationEncoder.Reset();
+		gClientReplicationDecoder.Reset();
 
 		vfs::PropertyContainer props;
 		props.initFromIniFile(JA2MP_INI_FILENAME);
@@ -5094,6 +5256,9 @@ void client_packet ( void )
 			p = client->Receive();
 		}
 
+		// everything this frame has sent goes out now
+		FlushReplication( false );
+
 		// OJW - 20081223
 		if (is_game_over)
 		{
@@ -5141,7 +5306,15 @@ void client_disconnect (void)
 		client->DetachPlugin(&fltClient);
 
 		client->Shutdown(300);
+		gReplicationEncoder.Reset();
+		gClientReplicationDecoder.Reset();
 		is_client = false;
+
+		if ( gfDedicatedMatchHost )
+		{
+			gfDedicatedMatchHost = false;
+			is_server = false;
+		}
 		is_connected=false;
 		is_connecting=false;
 		
@@ -5185,7 +5358,7 @@ void send_edgechange(int newedge)
 		lan.client_num = CLIENT_NUM;
 		lan.newedge = newedge;
 
-		client->RPC("sendEDGECHANGE",(const char*)&lan, (int)sizeof(edgechange_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+		client->RPC("sendEDGECHANGE",(const char*)&lan, (int)sizeof(edgechange_struct)*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 
 		// redraw the character list on the map screen
 		fDrawCharacterList = true;
@@ -5215,7 +5388,7 @@ void send_teamchange(int newteam)
 		lan.client_num = CLIENT_NUM;
 		lan.newteam = newteam;
 
-		client->RPC("sendTEAMCHANGE",(const char*)&lan, (int)sizeof(teamchange_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+		client->RPC("sendTEAMCHANGE",(const char*)&lan, (int)sizeof(teamchange_struct)*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 
 		// redraw the character list on the map screen
 		fDrawCharacterList = true;
@@ -5265,7 +5438,7 @@ void ChatCallback( UINT8 ubResult )
 		cmsg.client_num = CLIENT_NUM;
 
 		// notify all of the chat message
-		client->RPC("sendCHATMSG",(const char*)&cmsg, (int)sizeof(chat_msg)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+		client->RPC("sendCHATMSG",(const char*)&cmsg, (int)sizeof(chat_msg)*8, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 	}
 
 	memset(gszMsgBoxInputString,0,sizeof(gszMsgBoxInputString));
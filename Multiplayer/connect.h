@@ -14,6 +14,8 @@ extern bool is_connected;
 extern bool is_connecting;
 extern bool is_client;
 extern bool is_server;
+// the match host on a dedicated server: is_server is set, but there is no server (client.cpp)
+extern bool gfDedicatedMatchHost;
 extern bool is_networked;
 extern bool is_host; // OJW - added 20081129
 
@@ -124,6 +126,10 @@ void send_disarm_explosive(UINT32 sGridNo, UINT32 uiWorldIndex, SoldierID ubID);
 
 void OpenChatMsgBox(void);
 
+#ifdef JA2TESTVERSION
+void RunReplicationLoopbackTest( void );
+#endif
+
 INT8 FireBullet( SoldierID ubFirer, BULLET * pBullet, BOOLEAN fFake );
 
 void reapplySETTINGS();
@@ -202,10 +208,12 @@ extern BOOLEAN		fClientReceivedAllFiles;
 // OJW - 20090507
 // Add basic version checking, will only work from now on
 // note: this cannot be longer than char[30]
+// v3.2: settings_struct.hostClient for the dedicated server
+// v3.3: tactical messages batched per frame (sendBATCH/recieveBATCH, see replication.h)
 #ifdef JA2UB
-#define MPVERSION	"MP v3.1(UB)"
+#define MPVERSION	"MP v3.3(UB)"
 #else
-#define MPVERSION	"MP v3.1"
+#define MPVERSION	"MP v3.3"
 #endif
 
 // OJW - 2009128 - inline funcs for working with soldiers and teams
@@ -0,0 +1,612 @@
+#include "MessageIdentifiers.h"
+#include "RakNetworkFactory.h"
+#include "RakPeerInterface.h"
+#include "RakNetTypes.h"
+#include "BitStream.h"
+#include "RakSleep.h"
+#include <assert.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+#include "connect.h"
+#include "types.h"
+#include "GameSettings.h"
+#include "Text.h"
+#include "network.h"
+#include "fresh_header.h"
+#include "replication.h"
+#include "relay.h"
+#include <vfs/Core/vfs.h>
+#include <vfs/Tools/vfs_property_container.h>
+
+// JA2MPServer: a windowless server that hosts several multiplayer matches in one process, one port each.
+//
+// It does what server.cpp does for a game hosted match, without the game: it hands out the client numbers and
+// the settings, relays the messages between the clients and keeps the scoreboard. What needs the game (the AI,
+// the turns, starting the battle) is done by the match host, the first client that joins a match, which gets
+// is_server set as if it was hosting (see gfDedicatedMatchHost in client.cpp). startCOMBAT and sendREAL, which
+// server.cpp handles itself, are passed on to it. When the match host leaves, the match is over for everybody.
+//
+// The matches are read from ja2_mp_server.ini (or the file given on the command line):
+//
+//	[JA2 Multiplayer Dedicated Server]
+//	MATCHES = 2
+//
+//	[Match 1]
+//	SERVER_NAME = Deathmatch
+//	SERVER_PORT = 60005
+//	SECTOR_X = 9
+//	SECTOR_Y = 1
+//	... and the other properties of the initial section of ja2_mp.ini
+//
+// Not supported: random mercs (the teams come from the game's xml files) and syncing the clients' game data,
+// every client needs the same _MULTIPLAYER files.
+//
+// It is a relay, not a headless game: nothing of the match is simulated here, the match host's game has the
+// authority. It runs on Windows only, like the game, as RakNet is only here as the prebuilt Windows library.
+
+#define MAX_MATCH_CLIENTS			4
+
+struct MPMatch
+{
+	int					iMatch;
+	RakPeerInterface	*peer;
+	UINT16				usPort;
+	settings_struct		settings;							// what all clients get, the client fields are filled in per client
+	char				szVersion[ 30 ];					// of the host, the other clients must have the same
+	SystemAddress		clients[ MAX_MATCH_CLIENTS ];		// index is the client number - 1
+	bool				fConnected[ MAX_MATCH_CLIENTS ];
+	UINT8				ubHostClient;						// client number of the match host, 0 until somebody joined
+	bool				fStarted;							// the host has unlocked the laptop, nobody can join any more
+	player_stats		stats[ 5 ];
+	ReplicationDecoder	decoder;
+};
+
+static std::vector<MPMatch*>	gMatches;
+static volatile bool			gfServerRunning = true;
+
+static void ServerLog( MPMatch *pMatch, const char *szFormat, ... )
+{
+	char szTime[ 32 ];
+	time_t now = time( NULL );
+	strftime( szTime, sizeof( szTime ), "%Y-%m-%d %H:%M:%S", localtime( &now ) );
+
+	if ( pMatch )
+		printf( "%s [%d:%d] ", szTime, pMatch->iMatch, pMatch->usPort );
+	else
+		printf( "%s ", szTime );
+
+	va_list args;
+	va_start( args, szFormat );
+	vprintf( szFormat, args );
+	va_end( args );
+	printf( "\n" );
+	fflush( stdout );
+}
+
+// replication.cpp asserts through sgp, which isn't linked
+void _FailMessage( const char* message, unsigned lineNum, const char * functionName, const char* sourceFileName )
+{
+	ServerLog( NULL, "Assertion failed in %s, line %u: %s", sourceFileName, lineNum, message ? message : "" );
+	abort();
+}
+
+static MPMatch* FindMatch( RakPeerInterface *peer )
+{
+	for ( size_t cnt = 0; cnt < gMatches.size(); ++cnt )
+	{
+		if ( gMatches[ cnt ]->peer == peer )
+			return gMatches[ cnt ];
+	}
+	return NULL;
+}
+
+// client number of the sender, 0 if it hasn't got one (yet)
+static UINT8 ClientNumber( MPMatch *pMatch, SystemAddress sender )
+{
+	for ( UINT8 ubClient = 0; ubClient < MAX_MATCH_CLIENTS; ++ubClient )
+	{
+		if ( pMatch->fConnected[ ubClient ] && pMatch->clients[ ubClient ] == sender )
+			return ubClient + 1;
+	}
+	return 0;
+}
+
+// shuffles an integer array, as rSortArray() in server.cpp does
+static void ShuffleArray( int *arr, int len )
+{
+	for ( int i = len - 1; i > 0; --i )
+	{
+		int j = rand() % ( i + 1 );
+		int tmp = arr[ i ];
+		arr[ i ] = arr[ j ];
+		arr[ j ] = tmp;
+	}
+}
+
+// back to a match nobody has joined yet, with a new random table and new random edges
+static void ResetMatch( MPMatch *pMatch )
+{
+	memset( pMatch->fConnected, 0, sizeof( pMatch->fConnected ) );
+	memset( pMatch->settings.client_names, 0, sizeof( pMatch->settings.client_names ) );
+	memset( pMatch->settings.client_teams, 0, sizeof( pMatch->settings.client_teams ) );
+	memset( pMatch->stats, 0, sizeof( pMatch->stats ) );
+	pMatch->szVersion[ 0 ] = '\0';
+	pMatch->ubHostClient = 0;
+	pMatch->fStarted = false;
+	pMatch->decoder.Reset();
+
+	for ( int i = 0; i < MAX_PREGENERATED_NUMS; ++i )
+		pMatch->settings.random_table[ i ] = rand();
+
+	if ( pMatch->settings.randomStartingEdge )
+	{
+		int spawns[ 5 ] = { 0 , 1 , 2 , 3, 9 };	// 9 == Center
+		ShuffleArray( spawns, 5 );
+		memcpy( pMatch->settings.client_edges, spawns, sizeof( int ) * 5 );
+	}
+	else if ( pMatch->settings.gameType == MP_TYPE_DEATHMATCH || pMatch->settings.gameType == MP_TYPE_TEAMDEATMATCH )
+	{
+		// each client gets a unique starting edge
+		pMatch->settings.client_edges[ 0 ] = MP_EDGE_NORTH;
+		pMatch->settings.client_edges[ 1 ] = MP_EDGE_SOUTH;
+		pMatch->settings.client_edges[ 2 ] = MP_EDGE_EAST;
+		pMatch->settings.client_edges[ 3 ] = MP_EDGE_WEST;
+		pMatch->settings.client_edges[ 4 ] = MP_EDGE_CENTER;
+	}
+	else
+	{
+		memset( pMatch->settings.client_edges, 0, sizeof( pMatch->settings.client_edges ) );
+	}
+}
+
+//********* RPC SECTION ************
+
+// the relays and the scoreboard are shared with server.cpp (relay.cpp), this only finds the match
+static void RelayToMatch( RPCParameters *rpcParameters )
+{
+	MPMatch *pMatch = FindMatch( rpcParameters->recipient );
+
+	if ( !pMatch || !ClientNumber( pMatch, rpcParameters->sender ) )
+		return;
+
+	CountRPC( pMatch->stats, rpcParameters );
+	RelayRPC( rpcParameters );
+}
+
+// the calls server.cpp handles with the game go to the match host
+static void PassToHost( RPCParameters *rpcParameters )
+{
+	MPMatch *pMatch = FindMatch( rpcParameters->recipient );
+
+	if ( !pMatch || !ClientNumber( pMatch, rpcParameters->sender ) || !pMatch->ubHostClient )
+		return;
+
+	pMatch->peer->RPC(rpcParameters->functionName,(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE_ORDERED, 0, pMatch->clients[ pMatch->ubHostClient - 1 ], false, 0, UNASSIGNED_NETWORK_ID,0);
+}
+
+static void sendBATCH( RPCParameters *rpcParameters )
+{
+	MPMatch *pMatch = FindMatch( rpcParameters->recipient );
+
+	if ( !pMatch || !ClientNumber( pMatch, rpcParameters->sender ) )
+		return;
+
+	if ( !RelayBATCH( pMatch->stats, pMatch->decoder, rpcParameters ) )
+		ServerLog( pMatch, "malformed batch from client %d", ClientNumber( pMatch, rpcParameters->sender ) );
+}
+
+static void sendREADY( RPCParameters *rpcParameters )
+{
+	MPMatch *pMatch = FindMatch( rpcParameters->recipient );
+
+	if ( pMatch && ClientNumber( pMatch, rpcParameters->sender ) && rpcParameters->numberOfBitsOfData >= sizeof( ready_struct ) * 8 )
+	{
+		ready_struct *info = (ready_struct*)rpcParameters->input;
+
+		if ( info->ready_stage == READY_STAGE_ALLOW_LAPTOP && !pMatch->fStarted )
+		{
+			pMatch->fStarted = true;
+			ServerLog( pMatch, "match started" );
+		}
+	}
+
+	RelayToMatch( rpcParameters );
+}
+
+static void sendEDGECHANGE( RPCParameters *rpcParameters )
+{
+	MPMatch *pMatch = FindMatch( rpcParameters->recipient );
+
+	if ( pMatch && rpcParameters->numberOfBitsOfData >= sizeof( edgechange_struct ) * 8 )
+	{
+		edgechange_struct *edge = (edgechange_struct*)rpcParameters->input;
+
+		if ( edge->client_num == ClientNumber( pMatch, rpcParameters->sender ) )
+			pMatch->settings.client_edges[ edge->client_num - 1 ] = edge->newedge;
+	}
+
+	RelayToMatch( rpcParameters );
+}
+
+static void sendTEAMCHANGE( RPCParameters *rpcParameters )
+{
+	MPMatch *pMatch = FindMatch( rpcParameters->recipient );
+
+	if ( pMatch && rpcParameters->numberOfBitsOfData >= sizeof( teamchange_struct ) * 8 )
+	{
+		teamchange_struct *team = (teamchange_struct*)rpcParameters->input;
+
+		if ( team->client_num == ClientNumber( pMatch, rpcParameters->sender ) )
+			pMatch->settings.client_teams[ team->client_num - 1 ] = team->newteam;
+	}
+
+	RelayToMatch( rpcParameters );
+}
+
+static void sendGAMEOVER( RPCParameters *rpcParameters )
+{
+	MPMatch *pMatch = FindMatch( rpcParameters->recipient );
+
+	// ignore the RPCParams and send the server side scoreboard
+	if ( pMatch && ClientNumber( pMatch, rpcParameters->sender ) )
+		pMatch->peer->RPC("recieveGAMEOVER",(const char*)pMatch->stats, sizeof(pMatch->stats)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+}
+
+// the clients only have to know there is nothing to download
+static void requestFILE_TRANSFER_SETTINGS( RPCParameters *rpcParameters )
+{
+	MPMatch *pMatch = FindMatch( rpcParameters->recipient );
+
+	if ( !pMatch )
+		return;
+
+	filetransfersettings_struct fts;
+	memset( &fts, 0, sizeof( fts ) );
+
+	fts.syncClientsDirectory = 0;
+	strcpy(fts.serverName, pMatch->settings.server_name);
+	fts.totalTransferBytes = 0;
+
+	pMatch->peer->RPC("recieveFILE_TRANSFER_SETTINGS",(const char*)&fts, (int)sizeof(filetransfersettings_struct)*8, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, false, 0, UNASSIGNED_NETWORK_ID,0);
+}
+
+static void RejectClient( MPMatch *pMatch, SystemAddress sender, const CHAR16 *szReason )
+{
+	CHAR16 szMessage[ 255 ];
+	memset( szMessage, 0, sizeof( szMessage ) );
+	wcsncpy( szMessage, szReason, 254 );
+
+	// send disconnect reason only to this client
+	pMatch->peer->RPC("recieveDISCONNECTREASON",(const char*)szMessage, (int)sizeof(CHAR16)*255*8, HIGH_PRIORITY, RELIABLE, 0, sender, false, 0, UNASSIGNED_NETWORK_ID,0);
+	pMatch->peer->CloseConnection(sender, true);
+}
+
+// as requestSETTINGS() in server.cpp, the first client to join becomes the match host
+static void requestSETTINGS( RPCParameters *rpcParameters )
+{
+	MPMatch *pMatch = FindMatch( rpcParameters->recipient );
+
+	if ( !pMatch || rpcParameters->numberOfBitsOfData < sizeof( client_info ) * 8 || ClientNumber( pMatch, rpcParameters->sender ) )
+		return;
+
+	client_info* clinf = (client_info*)rpcParameters->input;
+	clinf->client_name[ 29 ] = '\0';
+	clinf->client_version[ 29 ] = '\0';
+
+	if ( pMatch->fStarted )
+	{
+		ServerLog( pMatch, "rejected %s, the match has started", clinf->client_name );
+		RejectClient( pMatch, rpcParameters->sender, L"The match has already started." );
+		return;
+	}
+
+	// the server is built once for JA2 and UB, the version of the host decides which one is played
+	if ( strncmp( clinf->client_version, MPVERSION, strlen( MPVERSION ) ) != 0 || ( pMatch->ubHostClient && strcmp( clinf->client_version, pMatch->szVersion ) != 0 ) )
+	{
+		CHAR16 verErrMsg[ 255 ];
+		swprintf( verErrMsg, 255, L"Cannot connect because your version %S is different from the server version %S.", clinf->client_version, pMatch->ubHostClient ? pMatch->szVersion : MPVERSION );
+
+		ServerLog( pMatch, "rejected %s, the client has version %s", clinf->client_name, clinf->client_version );
+		RejectClient( pMatch, rpcParameters->sender, verErrMsg );
+		return;
+	}
+
+	UINT8 ubSlot;
+	for ( ubSlot = 0; ubSlot < pMatch->settings.maxClients && ubSlot < MAX_MATCH_CLIENTS; ++ubSlot )
+	{
+		if ( !pMatch->fConnected[ ubSlot ] )
+			break;
+	}
+	if ( ubSlot >= pMatch->settings.maxClients || ubSlot >= MAX_MATCH_CLIENTS )
+	{
+		ServerLog( pMatch, "rejected %s, the match is full", clinf->client_name );
+		pMatch->peer->CloseConnection( rpcParameters->sender, true );
+		return;
+	}
+
+	UINT8 ubClient = ubSlot + 1;
+	pMatch->clients[ ubSlot ] = rpcParameters->sender;
+	pMatch->fConnected[ ubSlot ] = true;
+	pMatch->decoder.ResetSender( ubClient );
+
+	if ( !pMatch->ubHostClient )
+	{
+		pMatch->ubHostClient = ubClient;
+		strcpy( pMatch->szVersion, clinf->client_version );
+	}
+
+	settings_struct &lan = pMatch->settings;
+
+	lan.client_num = ubClient;
+	strcpy( lan.client_name, clinf->client_name );
+	strcpy( lan.client_names[ ubSlot ], clinf->client_name );
+	lan.team = clinf->team;
+	lan.client_teams[ ubSlot ] = clinf->team;
+
+	if ( lan.randomStartingEdge || lan.gameType == MP_TYPE_DEATHMATCH || lan.gameType == MP_TYPE_TEAMDEATMATCH )
+	{
+		lan.startingSectorEdge = lan.client_edges[ ubSlot ];
+	}
+	else
+	{
+		lan.startingSectorEdge = clinf->cl_edge;
+		lan.client_edges[ ubSlot ] = clinf->cl_edge;
+	}
+
+	strcpy( lan.server_version, pMatch->szVersion );
+	lan.hostClient = pMatch->ubHostClient;
+
+	ServerLog( pMatch, "%s joined as client %d%s", clinf->client_name, ubClient, ubClient == pMatch->ubHostClient ? ", the match host" : "" );
+
+	pMatch->peer->RPC("recieveSETTINGS",(const char*)&lan, (int)sizeof(settings_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+}
+
+static void HandleDisconnect( MPMatch *pMatch, SystemAddress sender )
+{
+	UINT8 ubClient = ClientNumber( pMatch, sender );
+
+	if ( !ubClient )
+		return;
+
+	ServerLog( pMatch, "client %d (%s) left", ubClient, pMatch->settings.client_names[ ubClient - 1 ] );
+
+	pMatch->fConnected[ ubClient - 1 ] = false;
+	pMatch->settings.client_names[ ubClient - 1 ][ 0 ] = '\0';
+	pMatch->decoder.ResetSender( ubClient );
+
+	if ( ubClient == pMatch->ubHostClient )
+	{
+		// nobody else has the AI and the turns, close the match
+		ServerLog( pMatch, "the match host left, closing the match" );
+
+		for ( UINT8 ubSlot = 0; ubSlot < MAX_MATCH_CLIENTS; ++ubSlot )
+		{
+			if ( pMatch->fConnected[ ubSlot ] )
+				pMatch->peer->CloseConnection( pMatch->clients[ ubSlot ], true );
+		}
+		ResetMatch( pMatch );
+		return;
+	}
+
+	// notify all the clients of the disconnect
+	int cl_number = ubClient;
+	pMatch->peer->RPC("recieveDISCONNECT",(const char*)&cl_number , sizeof(int)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+}
+
+static void ServerPackets( MPMatch *pMatch )
+{
+	Packet* p;
+
+	for ( p = pMatch->peer->Receive(); p; pMatch->peer->DeallocatePacket( p ), p = pMatch->peer->Receive() )
+	{
+		unsigned char ubIdentifier = p->data[ 0 ];
+
+		if ( ubIdentifier == ID_TIMESTAMP && p->length > sizeof( unsigned char ) + sizeof( unsigned long ) )
+			ubIdentifier = p->data[ sizeof( unsigned char ) + sizeof( unsigned long ) ];
+
+		switch ( ubIdentifier )
+		{
+			case ID_NEW_INCOMING_CONNECTION:
+				// clients that come back after the game has started would be out of state
+				if ( pMatch->fStarted )
+				{
+					ServerLog( pMatch, "rejected a connection, the match has started" );
+					pMatch->peer->CloseConnection( p->systemAddress, true );
+				}
+				break;
+			case ID_DISCONNECTION_NOTIFICATION:
+			case ID_CONNECTION_LOST:
+				HandleDisconnect( pMatch, p->systemAddress );
+				break;
+			case ID_MODIFIED_PACKET:
+				ServerLog( pMatch, "ID_MODIFIED_PACKET" );
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+//********* SETUP ************
+
+// the settings of a match from its section, as start_server() reads them from ja2_mp.ini
+static bool ReadMatchSettings( vfs::PropertyContainer &props, MPMatch *pMatch )
+{
+	char szSection[ 64 ];
+	sprintf( szSection, JA2MP_INI_MATCH_SECTION, pMatch->iMatch );
+
+	settings_struct &lan = pMatch->settings;
+	memset( &lan, 0, sizeof( lan ) );
+
+	std::string name = vfs::String::as_utf8( props.getStringProperty( szSection, JA2MP_SERVER_NAME, L"My JA2 Server" ) );
+	std::string kitBag = vfs::String::as_utf8( props.getStringProperty( szSection, JA2MP_KIT_BAG, L"" ) );
+	strncpy( lan.server_name, name.c_str(), 29 );
+	strncpy( lan.kitBag, kitBag.c_str(), 99 );
+
+	pMatch->usPort = (UINT16)props.getIntProperty( szSection, JA2MP_SERVER_PORT, 60005 + pMatch->iMatch - 1 );
+	lan.maxClients = (UINT8)props.getIntProperty( szSection, JA2MP_MAX_CLIENTS, 4, 2, MAX_MATCH_CLIENTS );
+	lan.gameType = (UINT8)props.getIntProperty( szSection, JA2MP_GAME_MODE, MP_TYPE_DEATHMATCH, 0, NUM_MP_GAMETYPE - 1 );
+	lan.soubDifficultyLevel = (UINT8)props.getIntProperty( szSection, JA2MP_DIFFICULT_LEVEL, 3 ) + 1;
+	lan.soubSkillTraits = (UINT8)props.getIntProperty( szSection, JA2MP_NEW_TRAITS, 0 );
+	lan.randomStartingEdge = (UINT8)props.getIntProperty( szSection, JA2MP_RANDOM_EDGES, 0 );
+	lan.reportHiredMerc = (UINT8)props.getIntProperty( szSection, JA2MP_REPORT_NAME, 1 );
+	lan.disableBobbyRay = (UINT8)props.getIntProperty( szSection, JA2MP_DISABLE_BOBBY_RAYS, 0 );
+	lan.maxMercs = (UINT8)props.getIntProperty( szSection, JA2MP_MAX_MERCS, 6 );
+	lan.inventoryAttachment = (UINT8)props.getIntProperty( szSection, JA2MP_ALLOW_CUSTOM_NIV, 0 );
+	lan.gsMercArriveSectorX = (INT16)props.getIntProperty( szSection, JA2MP_SECTOR_X, 9, 1, 16 );
+	lan.gsMercArriveSectorY = (INT16)props.getIntProperty( szSection, JA2MP_SECTOR_Y, 1, 1, 16 );
+	lan.sameMercAllowed = (UINT8)props.getIntProperty( szSection, JA2MP_SAME_MERC, 1 );
+
+	if ( props.getIntProperty( szSection, JA2MP_RANDOM_MERCS, 0 ) )
+		ServerLog( pMatch, "%s is not supported by the dedicated server, the players hire their mercs", JA2MP_RANDOM_MERCS );
+
+	if ( lan.gameType == MP_TYPE_COOP )//only enable ai during coop
+	{
+		lan.enemyEnabled = 1;				// always enable enemies in co-op
+		lan.civEnabled = (UINT8)props.getIntProperty( szSection, JA2MP_CIV_ENABLED, 0 );
+		lan.maxEnemiesEnabled = (UINT8)props.getIntProperty( szSection, JA2MP_OVERRIDE_MAX_AI, 0 );
+	}
+
+	switch ( props.getIntProperty( szSection, JA2MP_DAMAGE_MULTIPLIER, 1 ) )
+	{
+		case 0:		lan.damageMultiplier = 0.2f;	break;	// Very Low
+		case 1:		lan.damageMultiplier = 0.7f;	break;	// Low
+		default:	lan.damageMultiplier = 1.0f;	break;	// Normal
+	}
+
+	switch ( props.getIntProperty( szSection, JA2MP_TIMED_TURN_SECS_PER_TICK, 2 ) )
+	{
+		case 0:		lan.secondsPerTick = 0;		break;	// Never
+		case 1:		lan.secondsPerTick = 5;		break;	// Slow
+		case 2:		lan.secondsPerTick = 100;	break;	// Medium
+		default:	lan.secondsPerTick = 400;	break;	// Fast
+	}
+
+	switch ( props.getIntProperty( szSection, JA2MP_STARTING_BALANCE, 1 ) )
+	{
+		case 0:		lan.startingCash = 5000;		break;	// Low
+		case 1:		lan.startingCash = 50000;		break;	// Medium
+		case 2:		lan.startingCash = 100000;		break;	// High
+		default:	lan.startingCash = 999999999;	break;	// Unlimited
+	}
+
+	switch ( props.getIntProperty( szSection, JA2MP_TIME, 1 ) )
+	{
+		case 0:		lan.startingTime = 7.00f;	break;	// Morning
+		case 1:		lan.startingTime = 13.00f;	break;	// Afternoon
+		default:	lan.startingTime = 2.00f;	break;	// Night
+	}
+
+	// WANNE.MP: Check
+	lan.soubBobbyRayQuality = BR_AWESOME;
+	lan.soubBobbyRayQuantity = BR_AWESOME;
+	lan.sofGunNut = TRUE;
+	lan.soubGameStyle = STYLE_REALISTIC;
+	lan.sofTurnTimeLimit = TRUE;
+	lan.sofIronManMode = FALSE;
+
+	return true;
+}
+
+static bool StartMatch( MPMatch *pMatch )
+{
+	pMatch->peer = RakNetworkFactory::GetRakPeerInterface();
+
+	// WANNE: Set higher timeout than default (30 seconds)
+	pMatch->peer->SetTimeoutTime(120000, UNASSIGNED_SYSTEM_ADDRESS);	// 120 Seconds
+
+	SocketDescriptor socketDescriptor(pMatch->usPort,0);
+	if ( !pMatch->peer->Startup(pMatch->settings.maxClients, 30, &socketDescriptor, 1) )
+	{
+		ServerLog( pMatch, "could not open port %d", pMatch->usPort );
+		RakNetworkFactory::DestroyRakPeerInterface( pMatch->peer );
+		pMatch->peer = NULL;
+		return false;
+	}
+
+	pMatch->peer->SetMaximumIncomingConnections(pMatch->settings.maxClients);
+	pMatch->peer->SetOccasionalPing(true);
+
+	RegisterRelayedRPCs( pMatch->peer, RelayToMatch );
+
+	// registering a name again replaces the relay
+	REGISTER_STATIC_RPC(pMatch->peer, sendBATCH);
+	REGISTER_STATIC_RPC(pMatch->peer, sendREADY);
+	REGISTER_STATIC_RPC(pMatch->peer, sendEDGECHANGE);
+	REGISTER_STATIC_RPC(pMatch->peer, sendTEAMCHANGE);
+	REGISTER_STATIC_RPC(pMatch->peer, sendGAMEOVER);
+	REGISTER_STATIC_RPC(pMatch->peer, requestSETTINGS);
+	REGISTER_STATIC_RPC(pMatch->peer, requestFILE_TRANSFER_SETTINGS);
+	pMatch->peer->RegisterAsRemoteProcedureCall( "startCOMBAT", PassToHost );
+	pMatch->peer->RegisterAsRemoteProcedureCall( "sendREAL", PassToHost );
+
+	ResetMatch( pMatch );
+
+	ServerLog( pMatch, "%s: game type %d, %d players, sector %c%d", pMatch->settings.server_name, pMatch->settings.gameType, pMatch->settings.maxClients,
+				'A' + pMatch->settings.gsMercArriveSectorY - 1, pMatch->settings.gsMercArriveSectorX );
+	return true;
+}
+
+static void StopServer( int )
+{
+	gfServerRunning = false;
+}
+
+int main( int argc, char *argv[] )
+{
+	const char *szIniFile = argc > 1 ? argv[ 1 ] : JA2MP_SERVER_INI_FILENAME;
+
+	srand( (unsigned)time( NULL ) );
+
+	vfs::PropertyContainer props;
+	if ( !props.initFromIniFile( szIniFile ) )
+	{
+		ServerLog( NULL, "could not read %s", szIniFile );
+		return 1;
+	}
+
+	int iNumMatches = (int)props.getIntProperty( JA2MP_INI_DEDICATED_SECTION, JA2MP_MATCHES, 1, 1, 64 );
+
+	for ( int iMatch = 1; iMatch <= iNumMatches; ++iMatch )
+	{
+		MPMatch *pMatch = new MPMatch();
+		pMatch->iMatch = iMatch;
+
+		if ( ReadMatchSettings( props, pMatch ) && StartMatch( pMatch ) )
+			gMatches.push_back( pMatch );
+		else
+			delete pMatch;
+	}
+
+	if ( gMatches.empty() )
+		return 1;
+
+	ServerLog( NULL, "%s, %d matches running, Ctrl+C stops the server", MPVERSION, (int)gMatches.size() );
+
+	signal( SIGINT, StopServer );
+	signal( SIGTERM, StopServer );
+
+	while ( gfServerRunning )
+	{
+		for ( size_t cnt = 0; cnt < gMatches.size(); ++cnt )
+			ServerPackets( gMatches[ cnt ] );
+
+		RakSleep( 5 );
+	}
+
+	for ( size_t cnt = 0; cnt < gMatches.size(); ++cnt )
+	{
+		gMatches[ cnt ]->peer->Shutdown( 300 );
+		RakNetworkFactory::DestroyRakPeerInterface( gMatches[ cnt ]->peer );
+		delete gMatches[ cnt ];
+	}
+	gMatches.clear();
+
+	ServerLog( NULL, "server stopped" );
+	return 0;
+}
@@ -40,6 +40,16 @@ extern unsigned int setID;
 #define JA2MP_TIMED_TURN_SECS_PER_TICK	"TIMED_TURNS"
 #define JA2MP_TIME						"STARTING_TIME"
 #define	JA2MP_NEW_TRAITS				"SKILL_TRAITS"
+#define JA2MP_BATCH_MESSAGES			"BATCH_NETWORK_MESSAGES"
+
+// ja2_mp_server.ini: the matches of the dedicated server (JA2MPServer), one section each ("Match 1", "Match 2", ...)
+// with the properties of the initial section above, and the sector that is played
+#define JA2MP_SERVER_INI_FILENAME		"ja2_mp_server.ini"
+#define JA2MP_INI_DEDICATED_SECTION		"JA2 Multiplayer Dedicated Server"
+#define JA2MP_INI_MATCH_SECTION			"Match %d"
+#define JA2MP_MATCHES					"MATCHES"
+#define JA2MP_SECTOR_X					"SECTOR_X"
+#define JA2MP_SECTOR_Y					"SECTOR_Y"
 
 typedef struct
 {
@@ -97,6 +107,10 @@ typedef struct
 	char	server_version[30];
 	// OJW - added 20091024
 	UINT32	random_table[MAX_PREGENERATED_NUMS];
+	// client number of the match host on a dedicated server, 0 when the server runs in the host's game, and what
+	// only the host needs (the host's game reads it straight from the server otherwise)
+	UINT8	hostClient;
+	UINT8	maxEnemiesEnabled;
 } settings_struct;
 
 // WANNE: FILE TRANSFER
@@ -148,11 +162,24 @@ typedef struct
 	INT8 bteam;
 }real_struct;
 
+typedef struct
+{
+	UINT8 client_num;
+	bool status;
+	UINT8 ready_stage;
+} ready_struct;
+
+// the host has unlocked the laptop, the game has started
+#define READY_STAGE_ALLOW_LAPTOP	36
+
 typedef struct
 {
 	UINT8 ubStartingTeam;
 }sc_struct;
 
+// the match host on a dedicated server asks it to switch everybody to realtime
+void send_gotoRT( real_struct *rData );
+
 namespace ja2
 {
 	namespace mp
@@ -0,0 +1,166 @@
+#include "RakPeerInterface.h"
+#include "RakNetTypes.h"
+#include <string.h>
+#include <vector>
+#include "relay.h"
+#include "connect.h"
+#include "types.h"
+#include "network.h"
+#include "fresh_header.h"
+#include "replication.h"
+
+// use UNASSIGNED_SYSTEM_ADDRESS instead of rpcParameters->sender to send it back to yourself (the sender).
+// They are relayed RELIABLE_ORDERED on channel 0 like the batches, so neither can overtake the other.
+const RelayedRPC gRelayedRPCs[] =
+{
+	{ "sendPATH",				"recievePATH",				false },
+	{ "sendDOWNLOADSTATUS",		"recieveDOWNLOADSTATUS",	false },
+	{ "sendSTANCE",				"recieveSTANCE",			false },
+	{ "sendDIR",				"recieveDIR",				false },
+	{ "sendFIRE",				"recieveFIRE",				false },
+	{ "sendHIT",				"recieveHIT",				false },
+	{ "sendHIRE",				"recieveHIRE",				false },
+	{ "sendDISMISS",			"recieveDISMISS",			false },
+	{ "sendguiPOS",				"recieveguiPOS",			false },
+	{ "sendguiDIR",				"recieveguiDIR",			false },
+	{ "sendEndTurn",			"recieveEndTurn",			false },
+	{ "sendAI",					"recieveAI",				false },
+	{ "sendSTOP",				"recieveSTOP",				false },
+	{ "sendINTERRUPT",			"recieveINTERRUPT",			false },
+	{ "sendREADY",				"recieveREADY",				false },
+	{ "sendGUI",				"recieveGUI",				false },
+	{ "sendBULLET",				"recieveBULLET",			false },
+	{ "sendGRENADE",			"recieveGRENADE",			false },
+	{ "sendGRENADERESULT",		"recieveGRENADERESULT",		false },
+	{ "sendPLANTEXPLOSIVE",		"recievePLANTEXPLOSIVE",	false },
+	{ "sendDETONATEEXPLOSIVE",	"recieveDETONATEEXPLOSIVE",	false },
+	{ "sendDISARMEXPLOSIVE",	"recieveDISARMEXPLOSIVE",	false },
+	{ "sendSPREADEFFECT",		"recieveSPREADEFFECT",		false },
+	{ "sendNEWSMOKEEFFECT",		"recieveNEWSMOKEEFFECT",	false },
+	{ "sendEXPLOSIONDAMAGE",	"recieveEXPLOSIONDAMAGE",	false },
+	{ "sendSTATE",				"recieveSTATE",				false },
+	{ "sendDEATH",				"recieveDEATH",				false },
+	{ "sendhitSTRUCT",			"recievehitSTRUCT",			false },
+	{ "sendhitWINDOW",			"recievehitWINDOW",			false },
+	{ "sendMISS",				"recieveMISS",				false },
+	{ "updatenetworksoldier",	"UpdateSoldierFromNetwork",	false },
+	{ "Snull_team",				"null_team",				true },
+	{ "sendFIREW",				"recieve_fireweapon",		false },
+	{ "sendDOOR",				"recieve_door",				false },
+	{ "endINTERRUPT",			"resume_turn",				false },
+	{ "sendWIPE",				"recieve_wipe",				false },
+	{ "sendHEAL",				"recieve_heal",				false },
+	{ "sendEDGECHANGE",			"recieveEDGECHANGE",		false },
+	{ "sendTEAMCHANGE",			"recieveTEAMCHANGE",		false },
+	{ "sendCHATMSG",			"recieveCHATMSG",			true },
+	{ "sendGOTORT",				"gotoRT",					true },	// the match host on a dedicated server
+};
+
+const UINT32 guiNumRelayedRPCs = sizeof( gRelayedRPCs ) / sizeof( gRelayedRPCs[ 0 ] );
+
+void RegisterRelayedRPCs( RakPeerInterface *peer, void ( *pHandler )( RPCParameters* ) )
+{
+	for ( UINT32 cnt = 0; cnt < guiNumRelayedRPCs; ++cnt )
+		peer->RegisterAsRemoteProcedureCall( gRelayedRPCs[ cnt ].szSend, pHandler );
+}
+
+void RelayRPC( RPCParameters *rpcParameters )
+{
+	for ( UINT32 cnt = 0; cnt < guiNumRelayedRPCs; ++cnt )
+	{
+		const RelayedRPC &relay = gRelayedRPCs[ cnt ];
+
+		if ( strcmp( relay.szSend, rpcParameters->functionName ) == 0 )
+		{
+			rpcParameters->recipient->RPC(relay.szRecieve,(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE_ORDERED, 0, relay.fEverybody ? UNASSIGNED_SYSTEM_ADDRESS : rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
+			return;
+		}
+	}
+}
+
+//********* SCOREBOARD ************
+
+// from the ID, not the soldier's bTeam: the dedicated server has no soldiers, and on the hosting game the AI teams
+// (enemies, militia, civilians) would land on the rows of the clients
+int StatsTeam( UINT16 usSoldier )
+{
+	if ( usSoldier >= MP_FIRST_CLIENT_SOLDIER )
+	{
+		int team = ( usSoldier - MP_FIRST_CLIENT_SOLDIER ) / MP_CLIENT_SOLDIERS;
+		return team < 4 ? team : 3;	// the last client has the IDs up to MAX_NUM_SOLDIERS
+	}
+
+	// AI
+	return 4;
+}
+
+static void CountHit( player_stats *pStats, EV_S_WEAPONHIT *hit )
+{
+	if ( hit->ubAttackerID != NOBODY )
+		pStats[ StatsTeam( hit->ubAttackerID ) ].hits++;
+}
+
+static void CountMiss( player_stats *pStats, SoldierID ubAttackerID )
+{
+	if ( ubAttackerID != NOBODY )
+		pStats[ StatsTeam( ubAttackerID ) ].misses++;
+}
+
+static void CountDeath( player_stats *pStats, death_struct *nDeath )
+{
+	if ( nDeath->soldier_team >= 1 && nDeath->soldier_team <= 5 )
+		pStats[ nDeath->soldier_team - 1 ].deaths++;
+	if ( nDeath->attacker_team >= 1 && nDeath->attacker_team <= 5 )
+		pStats[ nDeath->attacker_team - 1 ].kills++;
+}
+
+void CountRPC( player_stats *pStats, RPCParameters *rpcParameters )
+{
+	const char *szName = rpcParameters->functionName;
+	unsigned char *input = rpcParameters->input;
+	BitSize_t bits = rpcParameters->numberOfBitsOfData;
+
+	if ( strcmp( szName, "sendHIT" ) == 0 && bits >= sizeof( EV_S_WEAPONHIT ) * 8 )
+		CountHit( pStats, (EV_S_WEAPONHIT*)input );
+	else if ( strcmp( szName, "sendhitSTRUCT" ) == 0 && bits >= sizeof( EV_S_STRUCTUREHIT ) * 8 )
+		CountMiss( pStats, ((EV_S_STRUCTUREHIT*)input)->ubAttackerID );
+	else if ( strcmp( szName, "sendhitWINDOW" ) == 0 && bits >= sizeof( EV_S_WINDOWHIT ) * 8 )
+		CountMiss( pStats, ((EV_S_WINDOWHIT*)input)->ubAttackerID );
+	else if ( strcmp( szName, "sendMISS" ) == 0 && bits >= sizeof( EV_S_MISS ) * 8 )
+		CountMiss( pStats, ((EV_S_MISS*)input)->ubAttackerID );
+	else if ( strcmp( szName, "sendDEATH" ) == 0 && bits >= sizeof( death_struct ) * 8 )
+		CountDeath( pStats, (death_struct*)input );
+}
+
+// A frame of tactical messages from one client (see replication.h). The server only reads it for the
+// scoreboard, the batch itself is relayed unchanged and unpacked by each client.
+bool RelayBATCH( player_stats *pStats, ReplicationDecoder &decoder, RPCParameters *rpcParameters )
+{
+	std::vector<ReplicationEntry> entries;
+	UINT8 ubSender;
+	bool fCosmetic = false;
+	bool fRead = decoder.ReadBatch( rpcParameters->input, rpcParameters->numberOfBitsOfData, ubSender, fCosmetic, entries );
+
+	for ( size_t cnt = 0; fRead && cnt < entries.size(); ++cnt )
+	{
+		ReplicationEntry &entry = entries[ cnt ];
+
+		if ( entry.ubMessage == REPL_HIT && entry.data.size() >= sizeof(EV_S_WEAPONHIT) )
+			CountHit( pStats, (EV_S_WEAPONHIT*)&entry.data[ 0 ] );
+		else if ( entry.ubMessage == REPL_HITSTRUCT && entry.data.size() >= sizeof(EV_S_STRUCTUREHIT) )
+			CountMiss( pStats, ((EV_S_STRUCTUREHIT*)&entry.data[ 0 ])->ubAttackerID );
+		else if ( entry.ubMessage == REPL_HITWINDOW && entry.data.size() >= sizeof(EV_S_WINDOWHIT) )
+			CountMiss( pStats, ((EV_S_WINDOWHIT*)&entry.data[ 0 ])->ubAttackerID );
+		else if ( entry.ubMessage == REPL_MISS && entry.data.size() >= sizeof(EV_S_MISS) )
+			CountMiss( pStats, ((EV_S_MISS*)&entry.data[ 0 ])->ubAttackerID );
+		else if ( entry.ubMessage == REPL_DEATH && entry.data.size() >= sizeof(death_struct) )
+			CountDeath( pStats, (death_struct*)&entry.data[ 0 ] );
+	}
+
+	if ( fCosmetic )
+		rpcParameters->recipient->RPC("recieveBATCH",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, UNRELIABLE_SEQUENCED, REPL_COSMETIC_CHANNEL, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
+	else
+		rpcParameters->recipient->RPC("recieveBATCH",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE_ORDERED, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
+
+	return fRead;
+}
@@ -0,0 +1,45 @@
+#ifndef _RELAY_H_
+#define _RELAY_H_
+
+#include "types.h"
+#include "RakNetTypes.h"
+#include "connect.h"
+
+class RakPeerInterface;
+class ReplicationDecoder;
+
+// What the game hosted server (server.cpp) and the dedicated server (dedicated_server.cpp) share: the RPCs they
+// pass on unchanged from one client to the others, and the master copy of the scoreboard kept from the hits,
+// misses and deaths that go through them. Both only call these, so the two can't drift apart again.
+
+// soldier IDs of a multiplayer game (bDefaultTeamRangesMP in Overhead.cpp), seven for each client from 120.
+// The clients send their own mercs with these IDs (ubID_prefix in client.cpp), so they tell the client apart.
+#define MP_FIRST_CLIENT_SOLDIER		120
+#define MP_CLIENT_SOLDIERS			7
+
+typedef struct
+{
+	const char	*szSend;		// what the client calls
+	const char	*szRecieve;		// what the other clients run for it
+	bool		fEverybody;		// the sender runs it as well
+} RelayedRPC;
+
+extern const RelayedRPC	gRelayedRPCs[];
+extern const UINT32		guiNumRelayedRPCs;
+
+// registers pHandler for every relayed RPC, a server registers its own handlers for some of them afterwards
+void RegisterRelayedRPCs( RakPeerInterface *peer, void ( *pHandler )( RPCParameters* ) );
+
+// passes the RPC on under its recieve name, to the other clients or to everybody
+void RelayRPC( RPCParameters *rpcParameters );
+
+// the row of the scoreboard for a soldier ID as the clients send it, 0-3 the clients, 4 the AI
+int StatsTeam( UINT16 usSoldier );
+
+// counts a single sendHIT, sendMISS, sendhitSTRUCT, sendhitWINDOW or sendDEATH into the scoreboard, ignores the others
+void CountRPC( player_stats *pStats, RPCParameters *rpcParameters );
+
+// counts the messages of a batch into the scoreboard and relays the batch unchanged, false if it couldn't be read
+bool RelayBATCH( player_stats *pStats, ReplicationDecoder &decoder, RPCParameters *rpcParameters );
+
+#endif
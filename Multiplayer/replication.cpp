@@ -0,0 +1,219 @@
+#include "builddefines.h"
+#include "types.h"
+#include "replication.h"
+#include "DEBUG.H"
+
+#include <cstring>
+
+// bits used for the message type of an entry, room for 64 types
+#define REPL_MESSAGE_BITS		6
+
+static UINT32 ReplicationKey( UINT8 ubMessage, UINT16 usKey )
+{
+	return ( (UINT32)ubMessage << 16 ) | usKey;
+}
+
+ReplicationEncoder::ReplicationEncoder()
+{
+	Reset();
+}
+
+void ReplicationEncoder::Queue( UINT8 ubMessage, UINT16 usKey, const void *pData, UINT32 uiBytes )
+{
+	Assert( ubMessage < NUM_REPL_MESSAGES && uiBytes > 0 && uiBytes <= 0xFFFF );
+
+	queued.push_back( ReplicationEntry() );
+	ReplicationEntry &entry = queued.back();
+	entry.ubMessage = ubMessage;
+	entry.usKey = usKey;
+	entry.data.assign( (const UINT8*)pData, (const UINT8*)pData + uiBytes );
+
+	++uiMessages;
+	uiPayloadBytes += uiBytes;
+}
+
+void ReplicationEncoder::QueueCosmetic( UINT8 ubMessage, UINT16 usKey, const void *pData, UINT32 uiBytes )
+{
+	Assert( ubMessage < NUM_REPL_MESSAGES && uiBytes > 0 && uiBytes <= 0xFFFF );
+
+	ReplicationEntry entry;
+	entry.ubMessage = ubMessage;
+	entry.usKey = usKey;
+	entry.data.assign( (const UINT8*)pData, (const UINT8*)pData + uiBytes );
+
+	cosmetic[ ReplicationKey( ubMessage, usKey ) ] = entry;
+	unsettled[ ReplicationKey( ubMessage, usKey ) ] = entry;
+
+	++uiMessages;
+	uiPayloadBytes += uiBytes;
+}
+
+void ReplicationEncoder::WriteEntry( RakNet::BitStream &bs, const ReplicationEntry &entry, bool fDelta )
+{
+	UINT16 usBytes = (UINT16)entry.data.size();
+
+	bs.WriteBits( &entry.ubMessage, REPL_MESSAGE_BITS );
+	bs.WriteCompressed( entry.usKey );
+
+	if ( fDelta )
+	{
+		std::vector<UINT8> &baseline = baselines[ ReplicationKey( entry.ubMessage, entry.usKey ) ];
+
+		if ( baseline.size() == usBytes )
+		{
+			bs.Write1();
+			for ( UINT16 cnt = 0; cnt < usBytes; ++cnt )
+			{
+				if ( entry.data[ cnt ] == baseline[ cnt ] )
+				{
+					bs.Write0();
+				}
+				else
+				{
+					bs.Write1();
+					bs.Write( entry.data[ cnt ] );
+				}
+			}
+			baseline = entry.data;
+			return;
+		}
+
+		bs.Write0();
+		baseline = entry.data;
+	}
+
+	bs.WriteCompressed( usBytes );
+	bs.Write( (const char*)&entry.data[ 0 ], usBytes );
+}
+
+void ReplicationEncoder::WriteBatch( UINT8 ubSender, RakNet::BitStream &bs, bool fSettle )
+{
+	std::map<UINT32, ReplicationEntry>::const_iterator it;
+	UINT16 usEntries = (UINT16)queued.size();
+
+	if ( fSettle )
+		usEntries += (UINT16)unsettled.size();
+
+	bs.Reset();
+	bs.Write( ubSender );
+	bs.Write( false );
+	bs.WriteCompressed( usEntries );
+
+	for ( size_t cnt = 0; cnt < queued.size(); ++cnt )
+		WriteEntry( bs, queued[ cnt ], true );
+	queued.clear();
+
+	if ( fSettle )
+	{
+		for ( it = unsettled.begin(); it != unsettled.end(); ++it )
+			WriteEntry( bs, it->second, true );
+		unsettled.clear();
+	}
+
+	++uiBatches;
+	uiBatchBytes += bs.GetNumberOfBytesUsed();
+}
+
+void ReplicationEncoder::WriteCosmeticBatch( UINT8 ubSender, RakNet::BitStream &bs )
+{
+	std::map<UINT32, ReplicationEntry>::const_iterator it;
+
+	bs.Reset();
+	bs.Write( ubSender );
+	bs.Write( true );
+	bs.WriteCompressed( (UINT16)cosmetic.size() );
+
+	for ( it = cosmetic.begin(); it != cosmetic.end(); ++it )
+		WriteEntry( bs, it->second, false );
+	cosmetic.clear();
+
+	++uiBatches;
+	uiBatchBytes += bs.GetNumberOfBytesUsed();
+}
+
+void ReplicationEncoder::Reset()
+{
+	queued.clear();
+	cosmetic.clear();
+	unsettled.clear();
+	baselines.clear();
+
+	uiMessages = 0;
+	uiPayloadBytes = 0;
+	uiBatches = 0;
+	uiBatchBytes = 0;
+}
+
+bool ReplicationDecoder::ReadBatch( const unsigned char *pData, BitSize_t uiBits, UINT8 &ubSender, bool &fCosmetic, std::vector<ReplicationEntry> &entries )
+{
+	RakNet::BitStream bs( (unsigned char*)pData, BITS_TO_BYTES( uiBits ), false );
+	UINT16 usEntries;
+
+	entries.clear();
+
+	if ( !bs.Read( ubSender ) || !bs.Read( fCosmetic ) || !bs.ReadCompressed( usEntries ) )
+		return false;
+
+	entries.resize( usEntries );
+	for ( UINT16 usEntry = 0; usEntry < usEntries; ++usEntry )
+	{
+		ReplicationEntry &entry = entries[ usEntry ];
+		bool fDelta = false;
+		UINT16 usBytes;
+
+		entry.ubMessage = 0;
+		if ( !bs.ReadBits( &entry.ubMessage, REPL_MESSAGE_BITS ) || entry.ubMessage >= NUM_REPL_MESSAGES || !bs.ReadCompressed( entry.usKey ) )
+			return false;
+
+		if ( !fCosmetic && !bs.Read( fDelta ) )
+			return false;
+
+		UINT32 uiKey = ( (UINT32)ubSender << 24 ) | ReplicationKey( entry.ubMessage, entry.usKey );
+
+		if ( fDelta )
+		{
+			std::map<UINT32, std::vector<UINT8> >::iterator it = baselines.find( uiKey );
+
+			if ( it == baselines.end() )
+				return false;
+
+			entry.data = it->second;
+			for ( size_t cnt = 0; cnt < entry.data.size(); ++cnt )
+			{
+				bool fChanged;
+
+				if ( !bs.Read( fChanged ) || ( fChanged && !bs.Read( entry.data[ cnt ] ) ) )
+					return false;
+			}
+			it->second = entry.data;
+		}
+		else
+		{
+			if ( !bs.ReadCompressed( usBytes ) || usBytes == 0 )
+				return false;
+
+			entry.data.resize( usBytes );
+			if ( !bs.Read( (char*)&entry.data[ 0 ], usBytes ) )
+				return false;
+
+			// cosmetic messages may get lost, they are never a baseline
+			if ( !fCosmetic )
+				baselines[ uiKey ] = entry.data;
+		}
+	}
+
+	return true;
+}
+
+void ReplicationDecoder::Reset()
+{
+	baselines.clear();
+}
+
+void ReplicationDecoder::ResetSender( UINT8 ubSender )
+{
+	std::map<UINT32, std::vector<UINT8> >::iterator it = baselines.lower_bound( (UINT32)ubSender << 24 );
+
+	while ( it != baselines.end() && ( it->first >> 24 ) == ubSender )
+		baselines.erase( it++ );
+}
@@ -0,0 +1,122 @@
+#ifndef _REPLICATION_H_
+#define _REPLICATION_H_
+
+#include "types.h"
+#include "BitStream.h"
+
+#include <map>
+#include <vector>
+
+// Tactical messages that the clients collect during a frame and send as one "sendBATCH" RPC at the end of it,
+// instead of one RPC each. The server keeps its own statistics from the batch and relays it unchanged to the
+// other clients, which unpack it and call the same recieve functions the single RPCs would have called.
+//
+// Every message is delta encoded against the previous message with the same type and key (usually the soldier
+// it is about) from the same client: one bit per byte tells if the byte changed, only changed bytes are sent.
+// Reliable batches go RELIABLE_ORDERED, so every client sees every message of a sender in the order it was
+// sent, and the previous message the sender encoded against is always the one the receivers decoded last.
+//
+// Cosmetic updates (the positions and directions of mercs in the tactical placement GUI) only need their latest
+// value. They are kept per soldier, sent as full messages in a separate UNRELIABLE_SEQUENCED batch, and the last
+// value is settled later in a reliable batch so a lost packet can't leave a merc in the wrong place.
+//
+// The numbers are part of the network protocol, new messages go at the end.
+enum
+{
+	REPL_PATH = 0,
+	REPL_STANCE,
+	REPL_DIR,
+	REPL_FIRE,
+	REPL_HIT,
+	REPL_ENDTURN,
+	REPL_STOP,
+	REPL_INTERRUPT,
+	REPL_ENDINTERRUPT,
+	REPL_BULLET,
+	REPL_GRENADE,
+	REPL_GRENADERESULT,
+	REPL_PLANTEXPLOSIVE,
+	REPL_DETONATEEXPLOSIVE,
+	REPL_DISARMEXPLOSIVE,
+	REPL_SPREADEFFECT,
+	REPL_NEWSMOKEEFFECT,
+	REPL_EXPLOSIONDAMAGE,
+	REPL_STATE,
+	REPL_DEATH,
+	REPL_HITSTRUCT,
+	REPL_HITWINDOW,
+	REPL_MISS,
+	REPL_UPDATESOLDIER,
+	REPL_FIREWEAPON,
+	REPL_DOOR,
+	REPL_WIPE,
+	REPL_HEAL,
+	REPL_GUIPOS,
+	REPL_GUIDIR,
+	NUM_REPL_MESSAGES
+};
+
+// ordering channel of the cosmetic batches, so they are sequenced apart from the reliable traffic on channel 0
+#define REPL_COSMETIC_CHANNEL		1
+
+typedef struct
+{
+	UINT8				ubMessage;
+	UINT16				usKey;
+	std::vector<UINT8>	data;
+} ReplicationEntry;
+
+class ReplicationEncoder
+{
+public:
+	ReplicationEncoder();
+
+	// queues a message for the next reliable batch
+	void	Queue( UINT8 ubMessage, UINT16 usKey, const void *pData, UINT32 uiBytes );
+	// replaces the pending cosmetic update with the same type and key
+	void	QueueCosmetic( UINT8 ubMessage, UINT16 usKey, const void *pData, UINT32 uiBytes );
+
+	bool	HasQueued() const			{ return !queued.empty(); }
+	bool	HasCosmetic() const			{ return !cosmetic.empty(); }
+	bool	HasUnsettled() const		{ return !unsettled.empty(); }
+
+	// Writes the queued messages as one batch and empties the queue. With fSettle the cosmetic updates not yet
+	// sent reliably are added to the end of the batch.
+	void	WriteBatch( UINT8 ubSender, RakNet::BitStream &bs, bool fSettle );
+	// writes the pending cosmetic updates as full messages, the delta baselines are not touched
+	void	WriteCosmeticBatch( UINT8 ubSender, RakNet::BitStream &bs );
+
+	// forgets everything, the next message of every type and key is sent in full
+	void	Reset();
+
+	// totals since the last Reset(), for the loopback test
+	UINT32	uiMessages;
+	UINT32	uiPayloadBytes;
+	UINT32	uiBatches;
+	UINT32	uiBatchBytes;
+
+private:
+	void	WriteEntry( RakNet::BitStream &bs, const ReplicationEntry &entry, bool fDelta );
+
+	std::vector<ReplicationEntry>				queued;
+	std::map<UINT32, ReplicationEntry>			cosmetic;		// not sent at all yet
+	std::map<UINT32, ReplicationEntry>			unsettled;		// not sent reliably yet
+	std::map<UINT32, std::vector<UINT8> >		baselines;		// last reliably sent message per type and key
+};
+
+class ReplicationDecoder
+{
+public:
+	// Unpacks a batch into entries, in the order they were queued. Returns false if the batch is malformed, which
+	// can only happen if the sender and we disagree on the baselines.
+	bool	ReadBatch( const unsigned char *pData, BitSize_t uiBits, UINT8 &ubSender, bool &fCosmetic, std::vector<ReplicationEntry> &entries );
+
+	void	Reset();
+	// forgets the baselines of one client, when it disconnects
+	void	ResetSender( UINT8 ubSender );
+
+private:
+	std::map<UINT32, std::vector<UINT8> >		baselines;		// key is ( sender << 24 ) | ( type << 16 ) | key
+};
+
+#endif
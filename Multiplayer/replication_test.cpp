@@ -0,0 +1,239 @@
+#include "builddefines.h"
+#include "types.h"
+#include "replication.h"
+#include "Event Pump.h"
+#include "message.h"
+#include "Font Control.h"
+
+#include <chrono>
+#include <vector>
+
+// The Multiplayer library is built once for all configurations, so the test is always there. Only the
+// hotkey that runs it is limited to the test version.
+
+// what a single RPC adds to its data: the ID_RPC byte, the function name, the bit length and the header of a
+// reliable message (not counting the datagram headers, which RakNet shares between messages anyway)
+#define LOOPBACK_RPC_HEADER_BYTES		12
+#define LOOPBACK_FRAME_MS				33
+#define LOOPBACK_TURN_FRAMES			( 20 * 1000 / LOOPBACK_FRAME_MS )
+#define LOOPBACK_MERCS					6
+
+static UINT32 guiLoopbackSeed;
+
+static UINT32 LoopbackRandom( UINT32 uiRange )
+{
+	guiLoopbackSeed = guiLoopbackSeed * 1103515245 + 12345;
+	return ( ( guiLoopbackSeed >> 16 ) & 0x7FFF ) % uiRange;
+}
+
+typedef struct
+{
+	UINT8		ubMessage;
+	UINT16		usKey;
+	UINT32		uiQueuedMS;
+	const char *szRPC;
+} LoopbackMessage;
+
+// Plays one interrupt heavy turn of six mercs (moving, turning, changing stance, firing bursts, and the state
+// updates every two seconds) through an encoder and a decoder in memory, one batch per frame, and reports the
+// bytes the single RPCs would have needed against the batches, the time spent encoding and decoding, how long
+// messages waited for the end of their frame, and whether every message came out as it went in.
+void RunReplicationLoopbackTest( void )
+{
+	ReplicationEncoder			encoder;
+	ReplicationDecoder			decoder;
+	RakNet::BitStream			bs;
+	std::vector<LoopbackMessage>	sent;
+	std::vector<std::vector<UINT8> >	sentData;
+	std::vector<ReplicationEntry>	received;
+	UINT32						uiRPCBytes = 0;
+	UINT32						uiBatchRPCBytes = 0;
+	UINT32						uiWaitMS = 0;
+	UINT32						uiMismatches = 0;
+	long long					llCodecUS = 0;
+	long long					llMaxCodecUS = 0;
+	INT32						sGridNo[ LOOPBACK_MERCS ];
+	INT8						bBreath[ LOOPBACK_MERCS ];
+	UINT8						ubDirection[ LOOPBACK_MERCS ];
+	UINT8						ubMerc;
+
+	guiLoopbackSeed = 1;
+	for ( ubMerc = 0; ubMerc < LOOPBACK_MERCS; ++ubMerc )
+	{
+		sGridNo[ ubMerc ] = 12000 + ubMerc * 3;
+		bBreath[ ubMerc ] = 100;
+		ubDirection[ ubMerc ] = (UINT8)LoopbackRandom( 8 );
+	}
+
+	for ( UINT32 uiFrame = 0; uiFrame < LOOPBACK_TURN_FRAMES; ++uiFrame )
+	{
+		UINT32 uiFrameMS = uiFrame * LOOPBACK_FRAME_MS;
+		size_t uiFirst = sent.size();
+
+		for ( ubMerc = 0; ubMerc < LOOPBACK_MERCS; ++ubMerc )
+		{
+			UINT16 usSoldier = (UINT16)( ubMerc + 120 );
+			UINT32 uiAction = LoopbackRandom( 100 );
+			LoopbackMessage msg;
+
+			msg.usKey = usSoldier;
+			msg.uiQueuedMS = uiFrameMS + LoopbackRandom( LOOPBACK_FRAME_MS );
+
+			if ( uiAction < 2 )
+			{
+				EV_S_SENDPATHTONETWORK path;
+				memset( &path, 0, sizeof( path ) );
+				path.usSoldierID = usSoldier;
+				path.sAtGridNo = sGridNo[ ubMerc ];
+				path.usPathDataSize = (UINT16)( 2 + LoopbackRandom( 10 ) );
+				for ( UINT16 cnt = 0; cnt < path.usPathDataSize; ++cnt )
+					path.usPathData[ cnt ] = (UINT16)LoopbackRandom( 8 );
+				path.sDestGridNo = sGridNo[ ubMerc ] + path.usPathDataSize * 160;
+				path.ubNewState = 1;
+				sGridNo[ ubMerc ] = path.sDestGridNo;
+
+				msg.ubMessage = REPL_PATH;
+				msg.szRPC = "sendPATH";
+				sentData.push_back( std::vector<UINT8>( (UINT8*)&path, (UINT8*)&path + sizeof( path ) ) );
+			}
+			else if ( uiAction < 4 )
+			{
+				EV_S_SETDESIREDDIRECTION dir;
+				memset( &dir, 0, sizeof( dir ) );
+				dir.usSoldierID = usSoldier;
+				ubDirection[ ubMerc ] = (UINT8)( ( ubDirection[ ubMerc ] + 1 ) % 8 );
+				dir.usDesiredDirection = ubDirection[ ubMerc ];
+
+				msg.ubMessage = REPL_DIR;
+				msg.szRPC = "sendDIR";
+				sentData.push_back( std::vector<UINT8>( (UINT8*)&dir, (UINT8*)&dir + sizeof( dir ) ) );
+			}
+			else if ( uiAction < 5 )
+			{
+				EV_S_CHANGESTANCE stance;
+				memset( &stance, 0, sizeof( stance ) );
+				stance.usSoldierID = usSoldier;
+				stance.sXPos = (INT16)( sGridNo[ ubMerc ] % 160 * 10 + 5 );
+				stance.sYPos = (INT16)( sGridNo[ ubMerc ] / 160 * 10 + 5 );
+				stance.ubNewStance = (UINT8)( 1 << LoopbackRandom( 3 ) );
+
+				msg.ubMessage = REPL_STANCE;
+				msg.szRPC = "sendSTANCE";
+				sentData.push_back( std::vector<UINT8>( (UINT8*)&stance, (UINT8*)&stance + sizeof( stance ) ) );
+			}
+			else if ( uiAction < 7 )
+			{
+				// a burst: the fire event and a hit or miss for every bullet, all in the same frame
+				EV_S_BEGINFIREWEAPON fire;
+				memset( &fire, 0, sizeof( fire ) );
+				fire.usSoldierID = usSoldier;
+				fire.sTargetGridNo = sGridNo[ ( ubMerc + 3 ) % LOOPBACK_MERCS ];
+
+				msg.ubMessage = REPL_FIRE;
+				msg.szRPC = "sendFIRE";
+				sentData.push_back( std::vector<UINT8>( (UINT8*)&fire, (UINT8*)&fire + sizeof( fire ) ) );
+				sent.push_back( msg );
+
+				for ( UINT8 ubBullet = 0; ubBullet < 3; ++ubBullet )
+				{
+					if ( LoopbackRandom( 2 ) )
+					{
+						EV_S_WEAPONHIT hit;
+						memset( &hit, 0, sizeof( hit ) );
+						hit.usSoldierID = (UINT16)( ( ubMerc + 3 ) % LOOPBACK_MERCS + 120 );
+						hit.ubAttackerID = usSoldier;
+						hit.iBullet = (INT32)( uiFrame * 8 + ubBullet );
+						hit.usWeaponIndex = 50;
+						hit.sDamage = (INT16)( 10 + LoopbackRandom( 20 ) );
+						hit.sBreathLoss = (INT16)( hit.sDamage * 50 );
+						hit.sRange = 12;
+						hit.fHit = TRUE;
+
+						msg.ubMessage = REPL_HIT;
+						msg.szRPC = "sendHIT";
+						sentData.push_back( std::vector<UINT8>( (UINT8*)&hit, (UINT8*)&hit + sizeof( hit ) ) );
+					}
+					else
+					{
+						EV_S_MISS miss;
+						memset( &miss, 0, sizeof( miss ) );
+						miss.iBullet = (INT32)( uiFrame * 8 + ubBullet );
+						miss.ubAttackerID = usSoldier;
+
+						msg.ubMessage = REPL_MISS;
+						msg.szRPC = "sendMISS";
+						sentData.push_back( std::vector<UINT8>( (UINT8*)&miss, (UINT8*)&miss + sizeof( miss ) ) );
+					}
+					sent.push_back( msg );
+				}
+				continue;
+			}
+			else if ( uiFrame % ( 2000 / LOOPBACK_FRAME_MS ) == ubMerc )
+			{
+				EV_S_UPDATENETWORKSOLDIER update;
+				memset( &update, 0, sizeof( update ) );
+				update.usSoldierID = usSoldier;
+				update.sAtGridNo = sGridNo[ ubMerc ];
+				bBreath[ ubMerc ] = (INT8)__max( 20, bBreath[ ubMerc ] - (INT8)LoopbackRandom( 3 ) );
+				update.bBreath = bBreath[ ubMerc ];
+				update.bLife = 60;
+				update.ubDirection = ubDirection[ ubMerc ];
+				update.ubNewStance = 2;
+				update.usTactialTurnLimitCounter = (UINT16)uiFrame;
+				update.usTactialTurnLimitMax = LOOPBACK_TURN_FRAMES;
+
+				msg.ubMessage = REPL_UPDATESOLDIER;
+				msg.szRPC = "updatenetworksoldier";
+				sentData.push_back( std::vector<UINT8>( (UINT8*)&update, (UINT8*)&update + sizeof( update ) ) );
+			}
+			else
+			{
+				continue;
+			}
+			sent.push_back( msg );
+		}
+
+		if ( sent.size() == uiFirst )
+			continue;
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		for ( size_t cnt = uiFirst; cnt < sent.size(); ++cnt )
+		{
+			encoder.Queue( sent[ cnt ].ubMessage, sent[ cnt ].usKey, &sentData[ cnt ][ 0 ], (UINT32)sentData[ cnt ].size() );
+			uiRPCBytes += (UINT32)sentData[ cnt ].size() + LOOPBACK_RPC_HEADER_BYTES + (UINT32)strlen( sent[ cnt ].szRPC );
+			uiWaitMS += uiFrameMS + LOOPBACK_FRAME_MS - sent[ cnt ].uiQueuedMS;
+		}
+		encoder.WriteBatch( 3, bs, false );
+
+		// the wire
+		std::vector<unsigned char> wire( bs.GetData(), bs.GetData() + bs.GetNumberOfBytesUsed() );
+		uiBatchRPCBytes += (UINT32)wire.size() + LOOPBACK_RPC_HEADER_BYTES + (UINT32)strlen( "sendBATCH" );
+
+		UINT8 ubSender = 0;
+		bool fCosmetic = true;
+		if ( !decoder.ReadBatch( &wire[ 0 ], bs.GetNumberOfBitsUsed(), ubSender, fCosmetic, received ) || ubSender != 3 || fCosmetic || received.size() != sent.size() - uiFirst )
+		{
+			uiMismatches += (UINT32)( sent.size() - uiFirst );
+		}
+		else
+		{
+			for ( size_t cnt = uiFirst; cnt < sent.size(); ++cnt )
+			{
+				const ReplicationEntry &entry = received[ cnt - uiFirst ];
+				if ( entry.ubMessage != sent[ cnt ].ubMessage || entry.usKey != sent[ cnt ].usKey || entry.data != sentData[ cnt ] )
+					++uiMismatches;
+			}
+		}
+
+		long long llUS = std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - start ).count();
+		llCodecUS += llUS;
+		llMaxCodecUS = __max( llMaxCodecUS, llUS );
+	}
+
+	ScreenMsg( FONT_MCOLOR_LTYELLOW, MSG_INTERFACE, L"Replication loopback: %d messages in %d batches, %d bytes as single RPCs, %d bytes batched (%d%%).",
+				encoder.uiMessages, encoder.uiBatches, uiRPCBytes, uiBatchRPCBytes, uiRPCBytes ? uiBatchRPCBytes * 100 / uiRPCBytes : 0 );
+	ScreenMsg( FONT_MCOLOR_LTYELLOW, MSG_INTERFACE, L"Replication loopback: encode + decode %d us per batch (max %d us), %d ms average wait for the frame end, %s.",
+				encoder.uiBatches ? (INT32)( llCodecUS / encoder.uiBatches ) : 0, (INT32)llMaxCodecUS, sent.empty() ? 0 : uiWaitMS / (UINT32)sent.size(),
+				uiMismatches ? L"MESSAGES CHANGED IN TRANSIT" : L"all messages arrived unchanged" );
+}
@@ -36,6 +36,8 @@
 #include "fresh_header.h"
 #include "Debug Control.h"
 #include "MPXmlTeams.hpp"
+#include "replication.h"
+#include "relay.h"
 
 extern CHAR16 gzFileTransferDirectory[100];
 
@@ -193,170 +195,29 @@ int f_rec_num(int mode, SystemAddress sender)//from client data
 	return(254);
 }
 
-// use UNASSIGNED_SYSTEM_ADDRESS instead of rpcParameters->sender to send it back to yourself (the sender)
 // there is very little in here dependant on the game engine and originally started out as an independant dedicated server .exe, and could if go ther again ... hayden.
+// (it has again, as a relay for several matches: dedicated_server.cpp. The relays and the scoreboard both use are in relay.cpp)
 //********* RPC SECTION ************
 
-void sendPATH(RPCParameters *rpcParameters)
-{
-	server->RPC("recievePATH",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-// OJW - 20090405
-void sendDOWNLOADSTATUS(RPCParameters *rpcParameters)
-{
-	server->RPC("recieveDOWNLOADSTATUS",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendSTANCE(RPCParameters *rpcParameters)
-{
-	server->RPC("recieveSTANCE",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendDIR(RPCParameters *rpcParameters)
-{
-	server->RPC("recieveDIR",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendFIRE(RPCParameters *rpcParameters)
-{
-	server->RPC("recieveFIRE",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendHIT(RPCParameters *rpcParameters)
-{
-	EV_S_WEAPONHIT* hit = (EV_S_WEAPONHIT*)rpcParameters->input;
-	
-	int team = hit->ubAttackerID->bTeam;
-	
-	// AI
-	if (team == 1) 
-		team = 4;
-	// Client
-	else if (team >= 6) 
-		team -= 6;
-	else if (team == 0) 
-		team = CLIENT_NUM-1; // this case should not be possible, including as a precaution
-
-    Assert(team<5); // FIXME
-	gMPPlayerStats[team].hits++;
-
-	server->RPC("recieveHIT",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendDISMISS(RPCParameters *rpcParameters)
-{
-	server->RPC("recieveDISMISS",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendHIRE(RPCParameters *rpcParameters)
-{
-	server->RPC("recieveHIRE",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
+static ReplicationDecoder gServerReplicationDecoder;
 
-void sendguiPOS(RPCParameters *rpcParameters)
+// the master copy of the scoreboard is kept on the server
+static void RelayToClients(RPCParameters *rpcParameters)
 {
-	server->RPC("recieveguiPOS",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendguiDIR(RPCParameters *rpcParameters)
-{
-	server->RPC("recieveguiDIR",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendEndTurn(RPCParameters *rpcParameters)
-{
-	server->RPC("recieveEndTurn",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendAI(RPCParameters *rpcParameters)
-{
-	server->RPC("recieveAI",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendSTOP(RPCParameters *rpcParameters)
-{
-	server->RPC("recieveSTOP",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-void sendINTERRUPT(RPCParameters *rpcParameters)
-{
-	server->RPC("recieveINTERRUPT",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-void sendREADY(RPCParameters *rpcParameters)
-{
-	server->RPC("recieveREADY",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendGUI(RPCParameters *rpcParameters)
-{
-	server->RPC("recieveGUI",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendBULLET(RPCParameters *rpcParameters)
-{
-	server->RPC("recieveBULLET",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendGRENADE(RPCParameters *rpcParameters)
-{
-	server->RPC("recieveGRENADE",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendGRENADERESULT(RPCParameters *rpcParameters)
-{
-	server->RPC("recieveGRENADERESULT",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendPLANTEXPLOSIVE(RPCParameters *rpcParameters)
-{
-	server->RPC("recievePLANTEXPLOSIVE",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendDETONATEEXPLOSIVE(RPCParameters *rpcParameters)
-{
-	server->RPC("recieveDETONATEEXPLOSIVE",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendDISARMEXPLOSIVE(RPCParameters *rpcParameters)
-{
-	server->RPC("recieveDISARMEXPLOSIVE",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendSPREADEFFECT(RPCParameters *rpcParameters)
-{
-	server->RPC("recieveSPREADEFFECT",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendNEWSMOKEEFFECT(RPCParameters *rpcParameters)
-{
-	server->RPC("recieveNEWSMOKEEFFECT",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendEXPLOSIONDAMAGE(RPCParameters *rpcParameters)
-{
-	server->RPC("recieveEXPLOSIONDAMAGE",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendSTATE(RPCParameters *rpcParameters)
-{
-	server->RPC("recieveSTATE",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
+	CountRPC(gMPPlayerStats, rpcParameters);
+	RelayRPC(rpcParameters);
 }
 
 void sendDEATH(RPCParameters *rpcParameters)
 {
-	// the master copy of the scoreboard is kept on the server
+	RelayToClients(rpcParameters);
+
+#ifdef JA2BETAVERSION
 	death_struct* nDeath = (death_struct*)rpcParameters->input;
 
-	// Save Stats on the server side
-	gMPPlayerStats[nDeath->soldier_team-1].deaths++;
-	gMPPlayerStats[nDeath->attacker_team-1].kills++;
-	
 	// get the client number of the client sending the message
 	int iCLnum = f_rec_num(3,rpcParameters->sender)+1;
 
-	server->RPC("recieveDEATH",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-
-#ifdef JA2BETAVERSION
 	wchar_t ateam[5];
 	wchar_t steam[5];
 	wchar_t clnum[5];
@@ -369,120 +230,10 @@ void sendDEATH(RPCParameters *rpcParameters)
 	MPDebugMsg( logmsg );
 #endif
 }
-void sendhitSTRUCT(RPCParameters *rpcParameters)
-{
-	EV_S_STRUCTUREHIT* miss = (EV_S_STRUCTUREHIT*)rpcParameters->input;
-	
-	if ( miss->ubAttackerID != NOBODY)
-	{
-		int team = miss->ubAttackerID->bTeam;
-		
-		// AI
-		if (team == 1) 
-			team = 4;
-		// Clients
-		else if (team >= 6) 
-			team -= 6;
-		else if (team == 0) 
-			team = CLIENT_NUM-1; // this case should not be possible, including as a precaution
-
-        Assert(team<5); // FIXME
-		gMPPlayerStats[team].misses++;
-	}
-
-	server->RPC("recievehitSTRUCT",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-void sendhitWINDOW(RPCParameters *rpcParameters)
-{
-	EV_S_WINDOWHIT* miss = (EV_S_WINDOWHIT*)rpcParameters->input;
-	
-
-	if ( miss->ubAttackerID != NOBODY)
-	{
-		int team = miss->ubAttackerID->bTeam;
-		
-		// AI
-		if (team == 1) 
-			team = 4;
-		// Clients
-		else if (team >= 6) 
-			team -= 6;
-		else if (team == 0) 
-			team = CLIENT_NUM-1; // this case should not be possible, including as a precaution
-
-        Assert(team<5); // FIXME
-		gMPPlayerStats[team].misses++;
-	}
-
-	server->RPC("recievehitWINDOW",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-void sendMISS(RPCParameters *rpcParameters)
-{
-	EV_S_MISS* miss = (EV_S_MISS*)rpcParameters->input;
-
-	if ( miss->ubAttackerID != NOBODY)
-	{
-		int team = miss->ubAttackerID->bTeam;
-		
-		// AI
-		if (team == 1) 
-			team = 4;
-		// Clients
-		else if (team >= 6) 
-			team -= 6;
-		else if (team == 0) 
-			team = CLIENT_NUM-1; // this case should not be possible, including as a precaution
-
-        Assert(team<5); // FIXME
-		gMPPlayerStats[team].misses++;
-	}
-
-	server->RPC("recieveMISS",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-void updatenetworksoldier(RPCParameters *rpcParameters)
-{
-	server->RPC("UpdateSoldierFromNetwork",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
 
-void Snull_team(RPCParameters *rpcParameters)
+void sendBATCH(RPCParameters *rpcParameters)
 {
-	server->RPC("null_team",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendFIREW(RPCParameters *rpcParameters)
-{
-	server->RPC("recieve_fireweapon",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendDOOR(RPCParameters *rpcParameters)
-{
-	server->RPC("recieve_door",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void endINTERRUPT(RPCParameters *rpcParameters)
-{
-	server->RPC("resume_turn",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendWIPE(RPCParameters *rpcParameters)
-{
-	server->RPC("recieve_wipe",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendHEAL(RPCParameters *rpcParameters)
-{
-	server->RPC("recieve_heal",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-// OJW - edge and team changes
-void sendEDGECHANGE(RPCParameters *rpcParameters)
-{
-	server->RPC("recieveEDGECHANGE",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
-void sendTEAMCHANGE(RPCParameters *rpcParameters)
-{
-	server->RPC("recieveTEAMCHANGE",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, rpcParameters->sender, true, 0, UNASSIGNED_NETWORK_ID,0);
+	RelayBATCH(gMPPlayerStats, gServerReplicationDecoder, rpcParameters);
 }
 
 void requestSETID(SystemAddress addr)
@@ -542,7 +293,10 @@ void sendREAL(RPCParameters *rpcParameters)
 			numreadyteams=0;
 			memset( &readyteamreg , 0 , sizeof (int) * 10);
 
-			server->RPC("gotoRT",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+			if (server)
+				server->RPC("gotoRT",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+			else
+				send_gotoRT(rData); // we are the match host on a dedicated server
 		}
 	}
 }
@@ -554,12 +308,6 @@ void sendGAMEOVER(RPCParameters *rpcParameters)
 	server->RPC("recieveGAMEOVER",(const char*)gMPPlayerStats, sizeof(gMPPlayerStats)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 }
 
-void sendCHATMSG(RPCParameters *rpcParameters)
-{
-	// ignore the RPCParams and send the server side scoreboard
-	server->RPC("recieveCHATMSG",(const char*)rpcParameters->input, (*rpcParameters).numberOfBitsOfData, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
-}
-
 // OJW - 20081223
 // fix client disconnecting mid game, allowing the game to proceed
 void HandleDisconnect(SystemAddress sender)
@@ -575,6 +323,7 @@ void HandleDisconnect(SystemAddress sender)
 		{
 			// notify all the clients of the disconnect
 			server->RPC("recieveDISCONNECT",(const char*)&cl_record.cl_number , sizeof(int)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
+			gServerReplicationDecoder.ResetSender( (UINT8)cl_record.cl_number );
 			f_rec_num(2,sender); // remove from server's client list
 			break;
 		}
@@ -778,6 +527,10 @@ void requestSETTINGS(RPCParameters *rpcParameters )
 		// send server version to client
 		strcpy(lan.server_version,MPVERSION);
 
+		// we run in the host's game, it doesn't need a host client
+		lan.hostClient = 0;
+		lan.maxEnemiesEnabled = gMaxEnemiesEnabled;
+
 		server->RPC("recieveSETTINGS",(const char*)&lan, (int)sizeof(settings_struct)*8, HIGH_PRIORITY, RELIABLE, 0, UNASSIGNED_SYSTEM_ADDRESS, true, 0, UNASSIGNED_NETWORK_ID,0);
 
 		// WANNE: FILE TRANSFER: A client connected -> start the file transfer!
@@ -789,7 +542,7 @@ void requestSETTINGS(RPCParameters *rpcParameters )
 // added 081201 by Owen , allow the server to change the map while its still not in laptop mode
 void send_mapchange(void)
 {
-	if (is_server  && !allowlaptop)
+	if (server && !allowlaptop)
 	{
 		mapchange_struct lan;
 
@@ -873,6 +626,7 @@ void start_server (void)
 	if(!is_server)
 	{	
 		f_rec_num(1,blank);//wipe clean
+		gServerReplicationDecoder.Reset();
 				
 		// ----------------------------
 		// Read from ja2_mp.ini
@@ -1032,52 +786,17 @@ void start_server (void)
 		server->SetOccasionalPing(true);
 
 		//RPC's
-		REGISTER_STATIC_RPC(server, sendPATH);
-		REGISTER_STATIC_RPC(server, sendDOWNLOADSTATUS);
-		REGISTER_STATIC_RPC(server, sendSTANCE);
-		REGISTER_STATIC_RPC(server, sendDIR);
-		REGISTER_STATIC_RPC(server, sendFIRE);
-		REGISTER_STATIC_RPC(server, sendHIT);
-		REGISTER_STATIC_RPC(server, sendHIRE);
-		REGISTER_STATIC_RPC(server, sendDISMISS);
-		REGISTER_STATIC_RPC(server, sendguiPOS);
-		REGISTER_STATIC_RPC(server, sendguiDIR);
-		REGISTER_STATIC_RPC(server, sendEndTurn);
-		REGISTER_STATIC_RPC(server, sendAI);
-		REGISTER_STATIC_RPC(server, sendSTOP);
-		REGISTER_STATIC_RPC(server, sendINTERRUPT);
-		REGISTER_STATIC_RPC(server, sendREADY);
-		REGISTER_STATIC_RPC(server, sendGUI);
-		REGISTER_STATIC_RPC(server, sendBULLET);
-		REGISTER_STATIC_RPC(server, sendGRENADE);
-		REGISTER_STATIC_RPC(server, sendGRENADERESULT);
-		REGISTER_STATIC_RPC(server, sendPLANTEXPLOSIVE);
-		REGISTER_STATIC_RPC(server, sendDETONATEEXPLOSIVE);
-		REGISTER_STATIC_RPC(server, sendDISARMEXPLOSIVE);
-		REGISTER_STATIC_RPC(server, sendSPREADEFFECT);
-		REGISTER_STATIC_RPC(server, sendNEWSMOKEEFFECT);
-		REGISTER_STATIC_RPC(server, sendEXPLOSIONDAMAGE);
+		RegisterRelayedRPCs(server, RelayToClients);
+
+		// registering a name again replaces the relay
 		REGISTER_STATIC_RPC(server, requestSETTINGS);
 		REGISTER_STATIC_RPC(server, requestFILE_TRANSFER_SETTINGS);
-		REGISTER_STATIC_RPC(server, sendSTATE);
 		REGISTER_STATIC_RPC(server, sendDEATH);
-		REGISTER_STATIC_RPC(server, sendhitSTRUCT);
-		REGISTER_STATIC_RPC(server, sendhitWINDOW);
-		REGISTER_STATIC_RPC(server, sendMISS);		
-		REGISTER_STATIC_RPC(server, updatenetworksoldier);
-		REGISTER_STATIC_RPC(server, Snull_team);
-		REGISTER_STATIC_RPC(server, sendFIREW);
-		REGISTER_STATIC_RPC(server, sendDOOR);
-		REGISTER_STATIC_RPC(server, endINTERRUPT);
 		REGISTER_STATIC_RPC(server, sendREAL);
 		REGISTER_STATIC_RPC(server, startCOMBAT);
-		REGISTER_STATIC_RPC(server, sendWIPE);
-		REGISTER_STATIC_RPC(server, sendHEAL);
-		REGISTER_STATIC_RPC(server, sendEDGECHANGE);
-		REGISTER_STATIC_RPC(server, sendTEAMCHANGE);
 		REGISTER_STATIC_RPC(server, sendGAMEOVER);
-		REGISTER_STATIC_RPC(server, sendCHATMSG);
 		REGISTER_STATIC_RPC(server, receiveSETID);		
+		REGISTER_STATIC_RPC(server, sendBATCH);
 
 		if (b)
 		{
@@ -1116,7 +835,7 @@ void server_packet ( void )
 	
 	Packet* p;
 
-	if (is_server)
+	if (server)
 	{
 
 	p = server->Receive();
@@ -1216,7 +935,7 @@ unsigned char SGetPacketIdentifier(Packet *p)
 
 void server_disconnect (void)
 {
-	if(is_server)
+	if(server)
 	{
 		server->DetachPlugin(&fltServer);
 	server->Shutdown(300);
@@ -1224,9 +943,10 @@ void server_disconnect (void)
 	fileList.Clear();
 	// We're done with the network
 	RakNetworkFactory::DestroyRakPeerInterface(server);
+	server = NULL;
 	ScreenMsg( FONT_ORANGE, MSG_MPSYSTEM, MPServerMessage[6]);
 	}
-	else
+	else if(!is_server) // the match host on a dedicated server has no server to stop
 	{
 	ScreenMsg( FONT_ORANGE, MSG_MPSYSTEM, MPServerMessage[7]);
 	}
@@ -5160,6 +5160,7 @@ static void DoActualRepair( SOLDIERTYPE * pSoldier, UINT16 usItem, INT16 * pbSta
 
 BOOLEAN RepairObject( SOLDIERTYPE * pSoldier, SOLDIERTYPE * pOwner, OBJECTTYPE * pObj, UINT8 * pubRepairPtsLeft )
 {
+	ObjectStatsChange statsChange;
 	UINT8	ubLoop, ubItemsInPocket, lbeLoop, ubBeforeRepair; // added by SANDRO
 	BOOLEAN fSomethingWasRepaired = FALSE;
 
@@ -5287,6 +5288,7 @@ BOOLEAN RepairObject( SOLDIERTYPE * pSoldier, SOLDIERTYPE * pOwner, OBJECTTYPE *
 
 BOOLEAN CleanObject( SOLDIERTYPE * pSoldier, SOLDIERTYPE * pOwner, OBJECTTYPE * pObj, UINT8 * pubCleaningPtsLeft )
 {
+	ObjectStatsChange statsChange;
 	UINT8 ubDirtPts, ubPtsCleaned, ubLoop, ubItemsInPocket;
 	BOOLEAN bFullyCleaned = FALSE;
 
@@ -1,5 +1,7 @@
 	#include "builddefines.h"
 	#include <stdio.h>
+	#include <map>
+	#include <set>
 	#include "types.h"
 	#include "Game Events.h"
 	#include "Game Clock.h"
@@ -154,6 +156,143 @@ BOOLEAN gfEventDeletionPending = FALSE;
 BOOLEAN gfProcessingGameEvents = FALSE;
 UINT32	guiTimeStampOfCurrentlyExecutingEvent = 0;
 
+// The event list is still the sorted singly linked list that the rest of the game walks through gpEventList, but
+// every node now lives in a pooled wrapper that adds a back link and an insertion sequence number. Two indices sit
+// on top of it:
+//	- gEventTimeIndex maps each timestamp to the LAST node with that timestamp, so a new event is inserted behind
+//		all events of the same second (FIFO) in O(log n) instead of walking the list.
+//	- gEventsOfType holds every node of a callback id ordered by (timestamp, sequence), which is exactly list order,
+//		so lookups by ubCallbackID/uiParam only touch events of that type.
+// STRATEGICEVENT itself is untouched, so the save format does not change.
+typedef struct STRATEGICEVENTNODE
+{
+	STRATEGICEVENT				event;		// must stay first, callers only ever see &event
+	struct STRATEGICEVENTNODE	*prev;
+	UINT64						uiSequence;
+} STRATEGICEVENTNODE;
+
+#define STRATEGIC_EVENT_POOL_BLOCK_SIZE		512
+
+struct StrategicEventOrder
+{
+	bool operator()( const STRATEGICEVENTNODE *a, const STRATEGICEVENTNODE *b ) const
+	{
+		if ( a->event.uiTimeStamp != b->event.uiTimeStamp )
+			return a->event.uiTimeStamp < b->event.uiTimeStamp;
+
+		return a->uiSequence < b->uiSequence;
+	}
+};
+
+typedef std::set<STRATEGICEVENTNODE*, StrategicEventOrder> StrategicEventTypeSet;
+
+static std::vector<STRATEGICEVENTNODE*>			gStrategicEventPoolBlocks;
+static STRATEGICEVENTNODE						*gpFreeStrategicEventNodes = NULL;
+static UINT64									guiStrategicEventSequence = 0;
+static std::map<UINT32, STRATEGICEVENTNODE*>	gEventTimeIndex;
+static StrategicEventTypeSet					gEventsOfType[ 256 ];
+
+static inline STRATEGICEVENTNODE* EventNode( STRATEGICEVENT *pEvent )
+{
+	return (STRATEGICEVENTNODE*)pEvent;
+}
+
+static STRATEGICEVENTNODE* AllocStrategicEventNode()
+{
+	STRATEGICEVENTNODE *pNode;
+
+	if ( !gpFreeStrategicEventNodes )
+	{
+		// grab a whole block at once, the free list is threaded through event.next
+		STRATEGICEVENTNODE *pBlock = (STRATEGICEVENTNODE *) MemAlloc( sizeof( STRATEGICEVENTNODE ) * STRATEGIC_EVENT_POOL_BLOCK_SIZE );
+		Assert( pBlock );
+		if ( !pBlock )
+			return NULL;
+
+		gStrategicEventPoolBlocks.push_back( pBlock );
+
+		for ( UINT32 cnt = 0; cnt < STRATEGIC_EVENT_POOL_BLOCK_SIZE; ++cnt )
+		{
+			pBlock[cnt].event.next = (STRATEGICEVENT*)gpFreeStrategicEventNodes;
+			gpFreeStrategicEventNodes = &pBlock[cnt];
+		}
+	}
+
+	pNode = gpFreeStrategicEventNodes;
+	gpFreeStrategicEventNodes = (STRATEGICEVENTNODE*)pNode->event.next;
+
+	memset( pNode, 0, sizeof( STRATEGICEVENTNODE ) );
+	pNode->uiSequence = guiStrategicEventSequence++;
+
+	return pNode;
+}
+
+static void FreeStrategicEventNode( STRATEGICEVENTNODE *pNode )
+{
+	pNode->event.next = (STRATEGICEVENT*)gpFreeStrategicEventNodes;
+	gpFreeStrategicEventNodes = pNode;
+}
+
+//Links a fresh node into the list behind every event that has the same or an earlier timestamp.
+static void LinkStrategicEvent( STRATEGICEVENTNODE *pNewNode )
+{
+	STRATEGICEVENTNODE *pPrevNode = NULL;
+	UINT32 uiTimeStamp = pNewNode->event.uiTimeStamp;
+
+	std::map<UINT32, STRATEGICEVENTNODE*>::iterator it = gEventTimeIndex.upper_bound( uiTimeStamp );
+	if ( it != gEventTimeIndex.begin() )
+	{
+		--it;
+		pPrevNode = it->second;
+	}
+
+	pNewNode->prev = pPrevNode;
+	if ( pPrevNode )
+	{
+		pNewNode->event.next = pPrevNode->event.next;
+		pPrevNode->event.next = &pNewNode->event;
+	}
+	else
+	{	// It's the head
+		pNewNode->event.next = gpEventList;
+		gpEventList = &pNewNode->event;
+	}
+
+	if ( pNewNode->event.next )
+		EventNode( pNewNode->event.next )->prev = pNewNode;
+
+	gEventTimeIndex[ uiTimeStamp ] = pNewNode;
+	gEventsOfType[ pNewNode->event.ubCallbackID ].insert( pNewNode );
+}
+
+//Detaches an event from the list and both indices, and returns it to the pool.
+static void RemoveStrategicEvent( STRATEGICEVENT *pEvent )
+{
+	STRATEGICEVENTNODE *pNode = EventNode( pEvent );
+	STRATEGICEVENTNODE *pPrevNode = pNode->prev;
+
+	if ( pPrevNode )
+		pPrevNode->event.next = pEvent->next;
+	else
+		gpEventList = pEvent->next;
+
+	if ( pEvent->next )
+		EventNode( pEvent->next )->prev = pPrevNode;
+
+	std::map<UINT32, STRATEGICEVENTNODE*>::iterator it = gEventTimeIndex.find( pEvent->uiTimeStamp );
+	if ( it != gEventTimeIndex.end() && it->second == pNode )
+	{
+		if ( pPrevNode && pPrevNode->event.uiTimeStamp == pEvent->uiTimeStamp )
+			it->second = pPrevNode;
+		else
+			gEventTimeIndex.erase( it );
+	}
+
+	gEventsOfType[ pEvent->ubCallbackID ].erase( pNode );
+
+	FreeStrategicEventNode( pNode );
+}
+
 //Determines if there are any events that will be processed between the current global time,
 //and the beginning of the next global time.
 BOOLEAN GameEventsPending( UINT32 uiAdjustment )
@@ -174,39 +313,22 @@ BOOLEAN GameEventsPending( UINT32 uiAdjustment )
 //returns TRUE if any events were deleted
 BOOLEAN DeleteEventsWithDeletionPending()
 {
-	STRATEGICEVENT *curr, *prev, *temp;
+	STRATEGICEVENT *curr, *temp;
 	BOOLEAN fEventDeleted = FALSE;
 	//ValidateGameEvents();
 	curr = gpEventList;
-	prev = NULL;
 	while( curr )
 	{
 		//ValidateGameEvents();
 		if( curr->ubFlags & SEF_DELETION_PENDING )
 		{
-			if( prev )
-			{ //deleting node in middle
-				prev->next = curr->next;
-				temp = curr;
-				curr = curr->next;
-				MemFree( temp );
-				fEventDeleted = TRUE;
-				//ValidateGameEvents();
-				continue;
-			}
-			else
-			{ //deleting head
-				gpEventList = gpEventList->next;
-				temp = curr;
-				prev = NULL;
-				curr = curr->next;
-				MemFree( temp );
-				fEventDeleted = TRUE;
-				//ValidateGameEvents();
-				continue;
-			}
+			temp = curr;
+			curr = curr->next;
+			RemoveStrategicEvent( temp );
+			fEventDeleted = TRUE;
+			//ValidateGameEvents();
+			continue;
 		}
-		prev = curr;
 		curr = curr->next;
 	}
 	gfEventDeletionPending = FALSE;
@@ -241,13 +363,41 @@ static void AdjustClockToEventStamp( STRATEGICEVENT *pEvent, UINT32 *puiAdjustme
 	swprintf( WORLDTIMESTR, L"%s %d, %02d:%02d", gpGameClockString[ STR_GAMECLOCK_DAY_NAME ], guiDay, guiHour, guiMin );
 }
 
+//Reposts ranged, periodic and everyday events, then removes the processed event from the list.
+//Returns the event that followed it.
+static STRATEGICEVENT* RemoveProcessedStrategicEvent( STRATEGICEVENT *curr )
+{
+	STRATEGICEVENT *pEvent, *next;
+
+	//Determine if event node is a special event requiring reposting
+	switch( curr->ubEventType )
+	{
+		case RANGED_EVENT:
+			AddAdvancedStrategicEvent( ENDRANGED_EVENT, curr->ubCallbackID, curr->uiTimeStamp+curr->uiTimeOffset, curr->uiParam );
+			break;
+		case PERIODIC_EVENT:
+			pEvent = AddAdvancedStrategicEvent( PERIODIC_EVENT, curr->ubCallbackID, curr->uiTimeStamp+curr->uiTimeOffset, curr->uiParam );
+			if( pEvent )
+				pEvent->uiTimeOffset = curr->uiTimeOffset;
+			break;
+		case EVERYDAY_EVENT:
+			AddAdvancedStrategicEvent( EVERYDAY_EVENT, curr->ubCallbackID, curr->uiTimeStamp+NUM_SEC_IN_DAY, curr->uiParam );
+			break;
+	}
+
+	next = curr->next;
+	RemoveStrategicEvent( curr );
+	//ValidateGameEvents();
+	return next;
+}
+
 //If there are any events pending, they are processed, until the time limit is reached, or
 //a major event is processed (one that requires the player's attention).
 void ProcessPendingGameEvents( UINT32 uiAdjustment, UINT8 ubWarpCode )
 {
+	PERFORMANCE_MARKER
 	DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"ProcessPendingGameEvents");
-	STRATEGICEVENT *curr, *pEvent, *prev, *temp;
-	BOOLEAN fDeleteEvent = FALSE, fDeleteQueuedEvent = FALSE;
+	STRATEGICEVENT *curr;
 
 	#ifdef CRIPPLED_VERSION
 	if( guiDay >= 8 )
@@ -259,91 +409,48 @@ void ProcessPendingGameEvents( UINT32 uiAdjustment, UINT8 ubWarpCode )
 	gfTimeInterrupt = FALSE;
 	gfProcessingGameEvents = TRUE;
 
-	//While we have events inside the time range to be updated, process them...
-	curr = gpEventList;
-	prev = NULL; //prev only used when warping time to target time.
-	while( !gfTimeInterrupt && curr && curr->uiTimeStamp <= guiGameClock + uiAdjustment )
+	if( ubWarpCode == WARPTIME_PROCESS_TARGET_TIME_FIRST )
 	{
-		fDeleteEvent = FALSE;
-		//Update the time by the difference, but ONLY if the event comes after the current time.
-		//In the beginning of the game, series of events are created that are placed in the list
-		//BEFORE the start time.	Those events will be processed without influencing the actual time.
-		if( curr->uiTimeStamp > guiGameClock && ubWarpCode != WARPTIME_PROCESS_TARGET_TIME_FIRST )
+		//We are warping time to the target time to process that event first.	Events before it are left alone,
+		//and of several events in the target second only the final one is processed (events are posted FIFO).
+		//The time index hands us that event directly instead of walking the list up to it.
+		std::map<UINT32, STRATEGICEVENTNODE*>::iterator it = gEventTimeIndex.find( guiGameClock + uiAdjustment );
+		if( it != gEventTimeIndex.end() )
 		{
-			AdjustClockToEventStamp( curr, &uiAdjustment );
-		}
-		//Process the event
-		if( ubWarpCode != WARPTIME_PROCESS_TARGET_TIME_FIRST )
-		{
-			fDeleteEvent = ExecuteStrategicEvent( curr );
-		}
-		else if( curr->uiTimeStamp == guiGameClock + uiAdjustment )
-		{ //if we are warping to the target time to process that event first,
-			if( !curr->next || curr->next->uiTimeStamp > guiGameClock + uiAdjustment )
-			{ //make sure that we are processing the last event for that second
-				AdjustClockToEventStamp( curr, &uiAdjustment );
+			curr = &it->second->event;
 
-				fDeleteEvent = ExecuteStrategicEvent( curr );
+			AdjustClockToEventStamp( curr, &uiAdjustment );
 
-				if( curr && prev && fDeleteQueuedEvent )
-				{ //The only case where we are deleting a node in the middle of the list
-					prev->next = curr->next;
-				}
-			}
-			else
-			{ //We are at the current target warp time however, there are still other events following in this time cycle.
-				//We will only target the final event in this time.	NOTE:	Events are posted using a FIFO method
-				prev = curr;
-				curr = curr->next;
-				continue;
+			if( ExecuteStrategicEvent( curr ) )
+			{
+				RemoveProcessedStrategicEvent( curr );
 			}
 		}
-		else
-		{ //We are warping time to the target time.	We haven't found the event yet,
-			//so continuing will keep processing the list until we find it.	NOTE:	Events are posted using a FIFO method
-			prev = curr;
-			curr = curr->next;
-			continue;
-		}
-		if( fDeleteEvent )
+	}
+	else
+	{
+		//While we have events inside the time range to be updated, process them...
+		curr = gpEventList;
+		while( !gfTimeInterrupt && curr && curr->uiTimeStamp <= guiGameClock + uiAdjustment )
 		{
-			//Determine if event node is a special event requiring reposting
-			switch( curr->ubEventType )
+			//Update the time by the difference, but ONLY if the event comes after the current time.
+			//In the beginning of the game, series of events are created that are placed in the list
+			//BEFORE the start time.	Those events will be processed without influencing the actual time.
+			if( curr->uiTimeStamp > guiGameClock )
 			{
-				case RANGED_EVENT:
-					AddAdvancedStrategicEvent( ENDRANGED_EVENT, curr->ubCallbackID, curr->uiTimeStamp+curr->uiTimeOffset, curr->uiParam );
-					break;
-				case PERIODIC_EVENT:
-					pEvent = AddAdvancedStrategicEvent( PERIODIC_EVENT, curr->ubCallbackID, curr->uiTimeStamp+curr->uiTimeOffset, curr->uiParam );
-					if( pEvent )
-						pEvent->uiTimeOffset = curr->uiTimeOffset;
-					break;
-				case EVERYDAY_EVENT:
-					AddAdvancedStrategicEvent( EVERYDAY_EVENT, curr->ubCallbackID, curr->uiTimeStamp+NUM_SEC_IN_DAY, curr->uiParam );
-					break;
+				AdjustClockToEventStamp( curr, &uiAdjustment );
 			}
-			if( curr == gpEventList )
+
+			//Process the event
+			if( ExecuteStrategicEvent( curr ) )
 			{
-				gpEventList = gpEventList->next;
-				MemFree( curr );
-				curr = gpEventList;
-				prev = NULL;
-				//ValidateGameEvents();
+				curr = RemoveProcessedStrategicEvent( curr );
 			}
 			else
 			{
-				temp = curr;
-				prev->next = curr->next;
 				curr = curr->next;
-				MemFree( temp );
-				//ValidateGameEvents();
 			}
 		}
-		else
-		{
-			prev = curr;
-			curr = curr->next;
-		}
 	}
 
 	gfProcessingGameEvents = FALSE;
@@ -359,7 +466,6 @@ void ProcessPendingGameEvents( UINT32 uiAdjustment, UINT8 ubWarpCode )
 	DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"ProcessPendingGameEvents done");
 }
 
-
 BOOLEAN AddSameDayStrategicEvent( UINT8 ubCallbackID, UINT32 uiMinStamp, UINT32 uiParam )
 {
 	return( AddStrategicEvent( ubCallbackID, uiMinStamp + GetWorldDayInMinutes(), uiParam ) );
@@ -386,7 +492,7 @@ BOOLEAN AddFutureDayStrategicEventUsingSeconds( UINT8 ubCallbackID, UINT32 uiSec
 
 STRATEGICEVENT* AddAdvancedStrategicEvent( UINT8 ubEventType, UINT8 ubCallbackID, UINT32 uiTimeStamp, UINT32 uiParam )
 {
-	STRATEGICEVENT		*pNode, *pNewNode, *pPrevNode;
+	STRATEGICEVENTNODE	*pNewNode;
 
 	if( gfProcessingGameEvents && uiTimeStamp <= guiTimeStampOfCurrentlyExecutingEvent )
 	{ //Prevents infinite loops of posting events that are the same time or earlier than the event
@@ -404,61 +510,20 @@ STRATEGICEVENT* AddAdvancedStrategicEvent( UINT8 ubEventType, UINT8 ubCallbackID
 		return NULL;
 	}
 
-	pNewNode = (STRATEGICEVENT *) MemAlloc( sizeof( STRATEGICEVENT ) );
+	pNewNode = AllocStrategicEventNode();
 	Assert( pNewNode );
-	memset( pNewNode, 0, sizeof( STRATEGICEVENT ) );
-	pNewNode->ubCallbackID		= ubCallbackID;
-	pNewNode->uiParam					= uiParam;
-	pNewNode->ubEventType			= ubEventType;
-	pNewNode->uiTimeStamp			= uiTimeStamp;
-	pNewNode->uiTimeOffset			= 0;
-
-	// Search list for a place to insert
-	pNode = gpEventList;
-
-	// If it's the first head, do this!
-	if( !pNode )
-	{
-		gpEventList = pNewNode;
-		pNewNode->next = NULL;
-	}
-	else
-	{
-		pPrevNode = NULL;
-		while( pNode )
-		{
-			if( uiTimeStamp < pNode->uiTimeStamp )
-			{
-				break;
-			}
-			pPrevNode = pNode;
-			pNode = pNode->next;
-		}
+	if( !pNewNode )
+		return NULL;
 
-		// If we are at the end, set at the end!
-		if ( !pNode )
-		{
-			pPrevNode->next = pNewNode;
-			pNewNode->next	= NULL;
-		}
-		else
-		{
-			// We have a previous node here
-			// Insert IN FRONT!
-			if ( pPrevNode )
-			{
-				pNewNode->next = pPrevNode->next;
-				pPrevNode->next = pNewNode;
-			}
-			else
-			{	// It's the head
-				pNewNode->next = gpEventList;
-				gpEventList = pNewNode;
-			}
-		}
-	}
+	pNewNode->event.ubCallbackID	= ubCallbackID;
+	pNewNode->event.uiParam			= uiParam;
+	pNewNode->event.ubEventType		= ubEventType;
+	pNewNode->event.uiTimeStamp		= uiTimeStamp;
+	pNewNode->event.uiTimeOffset	= 0;
+
+	LinkStrategicEvent( pNewNode );
 
-	return pNewNode ;
+	return &pNewNode->event;
 }
 
 BOOLEAN AddStrategicEvent( UINT8 ubCallbackID, UINT32 uiMinStamp, UINT32 uiParam )
@@ -586,53 +651,47 @@ BOOLEAN AddPeriodStrategicEventUsingSecondsWithOffset( UINT8 ubCallbackID, UINT3
 
 void DeleteAllStrategicEventsOfType( UINT8 ubCallbackID )
 {
-	STRATEGICEVENT	*curr, *prev, *temp;
-	prev = NULL;
-	curr = gpEventList;
-	while( curr )
+	StrategicEventTypeSet &events = gEventsOfType[ ubCallbackID ];
+	StrategicEventTypeSet::iterator it = events.begin();
+	while( it != events.end() )
 	{
-		if( curr->ubCallbackID == ubCallbackID && !(curr->ubFlags & SEF_DELETION_PENDING) )
-		{
-			if( gfPreventDeletionOfAnyEvent )
-			{
-				curr->ubFlags |= SEF_DELETION_PENDING;
-				gfEventDeletionPending = TRUE;
-				prev = curr;
-				curr = curr->next;
-				continue;
-			}
-			//Detach the node
-			if( prev )
-				prev->next = curr->next;
-			else
-				gpEventList = curr->next;
+		STRATEGICEVENT *curr = &(*it)->event;
+		++it;
 
-			//isolate and remove curr
-			temp = curr;
-			curr = curr->next;
-			MemFree( temp );
-			//ValidateGameEvents();
-		}
-		else
-		{	//Advance all the nodes
-			prev = curr;
-			curr = curr->next;
+		if( curr->ubFlags & SEF_DELETION_PENDING )
+			continue;
+
+		if( gfPreventDeletionOfAnyEvent )
+		{
+			curr->ubFlags |= SEF_DELETION_PENDING;
+			gfEventDeletionPending = TRUE;
+			continue;
 		}
+
+		//the iterator has already moved on, so curr can safely leave the set
+		RemoveStrategicEvent( curr );
+		//ValidateGameEvents();
 	}
 }
 
 void DeleteAllStrategicEvents()
 {
-	STRATEGICEVENT *temp;
 	while( gpEventList )
 	{
-		temp = gpEventList;
-		gpEventList = gpEventList->next;
-		MemFree( temp );
+		RemoveStrategicEvent( gpEventList );
 		//ValidateGameEvents();
-		temp = NULL;
 	}
 	gpEventList = NULL;
+	guiStrategicEventSequence = 0;
+
+	// no node is in use any more, so the pool can go as well (game reset and shutdown both come here)
+	for( size_t cnt = 0; cnt < gStrategicEventPoolBlocks.size(); ++cnt )
+	{
+		MemFree( gStrategicEventPoolBlocks[ cnt ] );
+	}
+	gStrategicEventPoolBlocks.clear();
+	gpFreeStrategicEventNodes = NULL;
+	gEventTimeIndex.clear();
 }
 
 //Searches for and removes the first event matching the supplied information.	There may very well be a need
@@ -640,36 +699,23 @@ void DeleteAllStrategicEvents()
 //no events were found or if the event wasn't deleted due to delete lock,
 BOOLEAN DeleteStrategicEvent( UINT8 ubCallbackID, UINT32 uiParam )
 {
-	STRATEGICEVENT *curr, *prev;
-	curr = gpEventList;
-	prev = NULL;
-	while( curr )
-	{ //deleting middle
-		if( curr->ubCallbackID == ubCallbackID && curr->uiParam == uiParam )
+	// only events of this type are looked at, and in list order
+	StrategicEventTypeSet &events = gEventsOfType[ ubCallbackID ];
+	for( StrategicEventTypeSet::iterator it = events.begin(); it != events.end(); ++it )
+	{
+		STRATEGICEVENT *curr = &(*it)->event;
+		if( curr->uiParam == uiParam && !(curr->ubFlags & SEF_DELETION_PENDING) )
 		{
-			if( !(curr->ubFlags & SEF_DELETION_PENDING) )
+			if( gfPreventDeletionOfAnyEvent )
 			{
-				if( gfPreventDeletionOfAnyEvent )
-				{
-					curr->ubFlags |= SEF_DELETION_PENDING;
-					gfEventDeletionPending = TRUE;
-					return FALSE;
-				}
-				if( prev )
-				{
-					prev->next = curr->next;
-				}
-				else
-				{
-					gpEventList = gpEventList->next;
-				}
-				MemFree( curr );
-				//ValidateGameEvents();
-				return TRUE;
+				curr->ubFlags |= SEF_DELETION_PENDING;
+				gfEventDeletionPending = TRUE;
+				return FALSE;
 			}
+			RemoveStrategicEvent( curr );
+			//ValidateGameEvents();
+			return TRUE;
 		}
-		prev = curr;
-		curr = curr->next;
 	}
 	return FALSE;
 }
@@ -678,15 +724,12 @@ std::vector< std::pair<UINT32, UINT32> > GetAllStrategicEventsOfType( UINT8 ubCa
 {
 	std::vector< std::pair<UINT32, UINT32> > vec;
 
-	STRATEGICEVENT* curr = gpEventList;
-	while ( curr )
-	{
-		if ( curr->ubCallbackID == ubCallbackID )
-		{
-			vec.push_back( std::pair<UINT32, UINT32>( curr->uiTimeStamp, curr->uiParam ) );
-		}
+	StrategicEventTypeSet &events = gEventsOfType[ ubCallbackID ];
+	vec.reserve( events.size() );
 
-		curr = curr->next;
+	for( StrategicEventTypeSet::iterator it = events.begin(); it != events.end(); ++it )
+	{
+		vec.push_back( std::pair<UINT32, UINT32>( (*it)->event.uiTimeStamp, (*it)->event.uiParam ) );
 	}
 
 	return vec;
@@ -745,7 +788,6 @@ BOOLEAN LoadStrategicEventsFromSavedGame( HWFILE hFile )
 	STRATEGICEVENT sGameEvent;
 	UINT32		cnt;
 	UINT32		uiNumBytesRead=0;
-	STRATEGICEVENT *pTemp = NULL;
 
 
 	//erase the old Game Event queue
@@ -760,17 +802,10 @@ BOOLEAN LoadStrategicEventsFromSavedGame( HWFILE hFile )
 	}
 
 
-	pTemp = NULL;
-
 	//loop through all the events and save them.
 	for( cnt=0; cnt<uiNumGameEvents; cnt++ )
 	{
-		STRATEGICEVENT *pTempEvent = NULL;
-
-		// allocate memory for the event
-		pTempEvent = (STRATEGICEVENT *) MemAlloc( sizeof( STRATEGICEVENT ) );
-		if( pTempEvent == NULL )
-			return( FALSE );
+		STRATEGICEVENTNODE *pTempNode = NULL;
 
 		//Read the current strategic event
 		FileRead( hFile, &sGameEvent, sizeof( STRATEGICEVENT ), &uiNumBytesRead );
@@ -779,31 +814,17 @@ BOOLEAN LoadStrategicEventsFromSavedGame( HWFILE hFile )
 			return(FALSE);
 		}
 
+		// get a node for the event
+		pTempNode = AllocStrategicEventNode();
+		if( pTempNode == NULL )
+			return( FALSE );
 
-		memcpy( pTempEvent, &sGameEvent, sizeof( STRATEGICEVENT ) );
-
-		// Add the new node to the list
-
-		//if its the first node,
-		if( cnt == 0 )
-		{
-			// assign it as the head node
-			gpEventList = pTempEvent;
-
-			//assign the 'current node' to the head node
-			pTemp = gpEventList;
-		}
-		else
-		{
-			// add the new node to the next field of the current node
-			pTemp->next = pTempEvent;
-
-			//advance the current node to the next node
-			pTemp = pTemp->next;
-		}
+		memcpy( &pTempNode->event, &sGameEvent, sizeof( STRATEGICEVENT ) );
 
-		// NULL out the next field ( cause there is no next field yet )
-		pTempEvent->next = NULL;
+		// The events were saved in list order, and each one gets a higher sequence number than the last,
+		// so linking them in one by one restores the exact same order (including ties in the same second).
+		pTempNode->event.next = NULL;
+		LinkStrategicEvent( pTempNode );
 	}
 
 	InitMiniEvents();
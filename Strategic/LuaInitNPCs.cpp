@@ -90,6 +90,7 @@ extern "C" {
 #include "gameloop.h"
 #include "Merc Contract.h"
 #include "message.h"
+#include "Font Control.h"
 #include "Town Militia.h"
 #include <language.hpp>
 
@@ -1809,12 +1810,15 @@ BOOLEAN LetLuaMusicControl(UINT8 Init)
 {
 	const char* filename = "scripts\\Music.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	if (Init == 0)
 	{
@@ -1830,12 +1834,15 @@ BOOLEAN LuaIntro(UINT8 Init, UINT32 uiCurrentVideo, INT8 bIntroType, UINT32 iStr
 {
 	const char* filename = "scripts\\Intro.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	if (Init == 0)
 	{
@@ -1947,12 +1954,15 @@ BOOLEAN LetLuaMakeBadSectorListFromMapsOnHardDrive(UINT8 Init)
 {
 	const char* filename = "scripts\\MakeMapsOnHardDrive.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	if (Init == 0)
 	{
@@ -1966,12 +1976,15 @@ BOOLEAN LuaInitStrategicLayer(UINT8 Init)
 {
 	const char* filename = "scripts\\InitStrategicLayer.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	if (Init == 0)
 	{
@@ -2615,19 +2628,22 @@ BOOLEAN LuaHandleQuestCodeOnSector(INT16 sSectorX, INT16 sSectorY, INT8 bSectorZ
 {
 	const char* filename = "scripts\\strategicmap.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	lua_register(_LS.L(), "CheckFact", l_CheckFact);
-	lua_register(_LS.L(), "CheckForMissingHospitalSupplies", l_CheckForMissingHospitalSupplies);
-	lua_register(_LS.L(), "CheckForKingpinsMoneyMissing", l_FunctionCheckForKingpinsMoneyMissing);
-	lua_register(_LS.L(), "SetProfileStrategicInsertionData", l_ProfilesStrategicInsertionData);
-	lua_register(_LS.L(), "CreateArmedCivilain", l_CreateArmedCivilain);
-	lua_register(_LS.L(), "BuildFortification", l_BuildFortification);
-	lua_register(_LS.L(), "RemoveFortification", l_RemoveFortification);
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		lua_register(_LS.L(), "CheckFact", l_CheckFact);
+		lua_register(_LS.L(), "CheckForMissingHospitalSupplies", l_CheckForMissingHospitalSupplies);
+		lua_register(_LS.L(), "CheckForKingpinsMoneyMissing", l_FunctionCheckForKingpinsMoneyMissing);
+		lua_register(_LS.L(), "SetProfileStrategicInsertionData", l_ProfilesStrategicInsertionData);
+		lua_register(_LS.L(), "CreateArmedCivilain", l_CreateArmedCivilain);
+		lua_register(_LS.L(), "BuildFortification", l_BuildFortification);
+		lua_register(_LS.L(), "RemoveFortification", l_RemoveFortification);
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	if (Init == 0)
 	{
@@ -2646,14 +2662,17 @@ void LuaHandleSectorLiberation(INT16 sSectorX, INT16 sSectorY, INT8 bSectorZ, BO
 {
 	const char* filename = "scripts\\strategicmap.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	lua_register(_LS.L(), "CheckFact", l_CheckFact);
-	lua_register(_LS.L(), "AddVolunteers", l_AddVolunteers);
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		lua_register(_LS.L(), "CheckFact", l_CheckFact);
+		lua_register(_LS.L(), "AddVolunteers", l_AddVolunteers);
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	LuaFunction(_LS.L, "HandleSectorLiberation").Param<int>(sSectorX).Param<int>(sSectorY).Param<int>(bSectorZ).Param<bool>(fFirstTime).Call(4);
 }
@@ -2665,14 +2684,17 @@ void LuaHandleInteractiveActionResult(INT16 sSectorX, INT16 sSectorY,
 {
 	const char* filename = "scripts\\Overhead.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	lua_register(_LS.L(), "CheckFact", l_CheckFact);
-	lua_register(_LS.L(), "AddVolunteers", l_AddVolunteers);
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		lua_register(_LS.L(), "CheckFact", l_CheckFact);
+		lua_register(_LS.L(), "AddVolunteers", l_AddVolunteers);
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	LuaFunction(_LS.L, "HandleInteractiveActionResult").Param<int>(sSectorX).Param<int>(sSectorY).Param<int>(bSectorZ).Param<int>(sGridNo).Param<int>(bLevel).Param<int>(ubId.i).Param<int>(usActionType).Param<int>(sLuaactionid).Param<int>(difficulty).Param<int>(skill).Call(10);
 }
@@ -2681,14 +2703,17 @@ void LuaRecruitRPCAdditionalHandling(UINT8 usProfile)
 {
 	const char* filename = "scripts\\strategicmap.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	lua_register(_LS.L(), "CheckFact", l_CheckFact);
-	lua_register(_LS.L(), "AddVolunteers", l_AddVolunteers);
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		lua_register(_LS.L(), "CheckFact", l_CheckFact);
+		lua_register(_LS.L(), "AddVolunteers", l_AddVolunteers);
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	LuaFunction(_LS.L, "RecruitRPCAdditionalHandling").Param<int>(usProfile).Call(1);
 }
@@ -2697,19 +2722,22 @@ void LuaHandleSectorTacticalEntry(INT16 sSectorX, INT16 sSectorY, INT8 bSectorZ,
 {
 	const char* filename = "scripts\\strategicmap.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	lua_register(_LS.L(), "CheckFact", l_CheckFact);
-	lua_register(_LS.L(), "SECTORX", l_SECTORX);
-	lua_register(_LS.L(), "SECTORY", l_SECTORY);
-	lua_register(_LS.L(), "SECTOR", l_SECTOR);
-	lua_register(_LS.L(), "GetFact", l_GetFact);
-	lua_register(_LS.L(), "SetFact", l_SetFact);
-	lua_register(_LS.L(), "CreateCivilian", l_CreateCivilian);
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		lua_register(_LS.L(), "CheckFact", l_CheckFact);
+		lua_register(_LS.L(), "SECTORX", l_SECTORX);
+		lua_register(_LS.L(), "SECTORY", l_SECTORY);
+		lua_register(_LS.L(), "SECTOR", l_SECTOR);
+		lua_register(_LS.L(), "GetFact", l_GetFact);
+		lua_register(_LS.L(), "SetFact", l_SetFact);
+		lua_register(_LS.L(), "CreateCivilian", l_CreateCivilian);
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	LuaFunction(_LS.L, "HandleSectorTacticalEntry").Param<int>(sSectorX).Param<int>(sSectorY).Param<int>(bSectorZ).Param<bool>(fHasEverBeenPlayerControlled).Call(4);
 }
@@ -2718,15 +2746,18 @@ BOOLEAN LetLuaGameInit(UINT8 Init)
 {
 	const char* filename = "scripts\\GameInit.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	lua_register(_LS.L(), "CheckFact", l_CheckFact);
-	lua_register(_LS.L(), "CheckForMissingHospitalSupplies", l_CheckForMissingHospitalSupplies);
-	//lua_register(_LS.L(), "CheckForKingpinsMoneyMissing", l_FunctionCheckForKingpinsMoneyMissing);
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		lua_register(_LS.L(), "CheckFact", l_CheckFact);
+		lua_register(_LS.L(), "CheckForMissingHospitalSupplies", l_CheckForMissingHospitalSupplies);
+		//lua_register(_LS.L(), "CheckForKingpinsMoneyMissing", l_FunctionCheckForKingpinsMoneyMissing);
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	if (Init == 0)
 	{
@@ -2750,15 +2781,18 @@ BOOLEAN LuaHandleNPCTeamMemberDeath(UINT8 ProfileId, UINT8 Init)
 {
 	const char* filename = "scripts\\Overhead.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	lua_register(_LS.L(), "CheckFact", l_CheckFact);
-	lua_register(_LS.L(), "CheckForMissingHospitalSupplies", l_CheckForMissingHospitalSupplies);
-	lua_register(_LS.L(), "CheckForKingpinsMoneyMissing", l_FunctionCheckForKingpinsMoneyMissing);
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		lua_register(_LS.L(), "CheckFact", l_CheckFact);
+		lua_register(_LS.L(), "CheckForMissingHospitalSupplies", l_CheckForMissingHospitalSupplies);
+		lua_register(_LS.L(), "CheckForKingpinsMoneyMissing", l_FunctionCheckForKingpinsMoneyMissing);
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	if (Init == 0)
 	{
@@ -2772,15 +2806,18 @@ BOOLEAN LuaHandlePlayerTeamMemberDeath(UINT8 ProfileId, UINT8 Init)
 {
 	const char* filename = "scripts\\Overhead.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	lua_register(_LS.L(), "CheckFact", l_CheckFact);
-	lua_register(_LS.L(), "CheckForMissingHospitalSupplies", l_CheckForMissingHospitalSupplies);
-	lua_register(_LS.L(), "CheckForKingpinsMoneyMissing", l_FunctionCheckForKingpinsMoneyMissing);
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		lua_register(_LS.L(), "CheckFact", l_CheckFact);
+		lua_register(_LS.L(), "CheckForMissingHospitalSupplies", l_CheckForMissingHospitalSupplies);
+		lua_register(_LS.L(), "CheckForKingpinsMoneyMissing", l_FunctionCheckForKingpinsMoneyMissing);
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	if (Init == 0)
 	{
@@ -2794,12 +2831,15 @@ BOOLEAN LuaExecuteStrategicEvent(UINT8 EventCallbackID, UINT32 EventTimeStamp, U
 {
 	const char* filename = "scripts\\GameEventHook.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	IniFunction(_LS.L(), FALSE);
+	if (_LS.NeedsBindings())
+	{
+		IniFunction(_LS.L(), FALSE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	if (Init == 0)
 	{
@@ -2813,13 +2853,16 @@ BOOLEAN LuaInternalQuest(UINT8 ubQuest, INT16 sSectorX, INT16 sSectorY, BOOLEAN
 {
 	const char* filename = "scripts\\Quests.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	lua_register(_LS.L(), "CreateArmedCivilain", l_CreateArmedCivilain);
-	IniFunction(_LS.L(), FALSE);
+	if (_LS.NeedsBindings())
+	{
+		lua_register(_LS.L(), "CreateArmedCivilain", l_CreateArmedCivilain);
+		IniFunction(_LS.L(), FALSE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	if (Init == 0)
 	{
@@ -2837,15 +2880,18 @@ BOOLEAN LetLuaMyCustomHandleAtNewGridNo(UINT8 bNewSide, UINT8 ProfileId, UINT8 I
 {
 	const char* filename = "scripts\\Overhead.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	//	lua_register(_LS.L(), "CheckFact", l_CheckFact);	
-	lua_register(_LS.L(), "CheckForMissingHospitalSupplies", l_CheckForMissingHospitalSupplies);
-	//	lua_register(_LS.L(), "CheckForKingpinsMoneyMissing", l_FunctionCheckForKingpinsMoneyMissing);
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		//	lua_register(_LS.L(), "CheckFact", l_CheckFact);	
+		lua_register(_LS.L(), "CheckForMissingHospitalSupplies", l_CheckForMissingHospitalSupplies);
+		//	lua_register(_LS.L(), "CheckForKingpinsMoneyMissing", l_FunctionCheckForKingpinsMoneyMissing);
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	if (Init == 0)
 	{
@@ -2862,12 +2908,15 @@ BOOLEAN LuaIDScripts(UINT8 Init, UINT8 ubTargetNPC, UINT16 usActionCode, UINT8 u
 
 	sprintf(filename, "scripts\\HandleNPCDoAction\\%03d.lua", usActionCode);
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	if (Init == 0)
 	{
@@ -2901,72 +2950,49 @@ static SOLDIERTYPE* FindSoldierByProfileID2(UINT8 ubProfileID, BOOLEAN fPlayerMe
 
 BOOLEAN LuaHandleNPCDoAction(UINT8 ubTargetNPC, UINT16 usActionCode, UINT8 ubQuoteNum, UINT8 InitFunction)
 {
-	char* filename = "scripts\\InterfaceDialogue.lua";
-	UINT32 size, bytesRead;
-	char* buffer;
-
-	HWFILE file = FileOpen(filename, FILE_ACCESS_READ, FALSE);
-
-	if (!file)
-		return false;
-
-	size = FileSize(filename);
-	buffer = new char[size + 1];
-	buffer[size] = 0;
-	FileRead(file, buffer, size, &bytesRead);
-	FileClose(file);
+	const char* filename = "scripts\\InterfaceDialogue.lua";
 
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	lua_State* L = lua_open();
-	luaL_openlibs(L);
-
-	//init function
-	lua_register(L, "CheckFact", l_CheckFact);
-	lua_register(L, "CheckForMissingHospitalSupplies", l_CheckForMissingHospitalSupplies);
-	lua_register(L, "CheckForKingpinsMoneyMissing", l_FunctionCheckForKingpinsMoneyMissing);
-	IniFunction(L, TRUE);
-	IniGlobalGameSetting(L);
+	if (_LS.NeedsBindings())
+	{
+		//init function
+		lua_register(_LS.L(), "CheckFact", l_CheckFact);
+		lua_register(_LS.L(), "CheckForMissingHospitalSupplies", l_CheckForMissingHospitalSupplies);
+		lua_register(_LS.L(), "CheckForKingpinsMoneyMissing", l_FunctionCheckForKingpinsMoneyMissing);
+		IniFunction(_LS.L(), TRUE);
+	}
+	IniGlobalGameSetting(_LS.L());
 
-	if (luaL_dostring(L, buffer))
+	if (!_LS.EvalFile())
 	{
-		// oh noes, error
-		// TODO: write to log or something
 		return false;
 	}
 
 	if (InitFunction == 0)
 	{
-		lua_getglobal(L, "HandleNPCDoAction");
-		lua_pushnumber(L, ubTargetNPC);
-		lua_pushnumber(L, usActionCode);
-		lua_pushnumber(L, ubQuoteNum);
-		lua_call(L, 3, 0);
+		LuaFunction(_LS.L, "HandleNPCDoAction").Param<int>(ubTargetNPC).Param<int>(usActionCode).Param<int>(ubQuoteNum).Call(3);
 	}
 
-
-
-	lua_close(L);
-
-	delete[] buffer;
-
-
 	return true;
-
 }
 
 BOOLEAN LetLuaInterfaceDialogue(UINT8 ubNPC, UINT8 InitFunction)
 {
 	const char* filename = "scripts\\InterfaceDialogue.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	lua_register(_LS.L(), "CheckFact", l_CheckFact);
-	lua_register(_LS.L(), "CheckForMissingHospitalSupplies", l_CheckForMissingHospitalSupplies);
-	lua_register(_LS.L(), "CheckForKingpinsMoneyMissing", l_FunctionCheckForKingpinsMoneyMissing);
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		lua_register(_LS.L(), "CheckFact", l_CheckFact);
+		lua_register(_LS.L(), "CheckForMissingHospitalSupplies", l_CheckForMissingHospitalSupplies);
+		lua_register(_LS.L(), "CheckForKingpinsMoneyMissing", l_FunctionCheckForKingpinsMoneyMissing);
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	if (InitFunction == 0)
 	{
@@ -2985,15 +3011,18 @@ BOOLEAN LetLuaPerformItemAction(UINT32 ActionID, INT32 sGridNo, UINT8 InitFuncti
 {
 	const char* filename = "scripts\\ExplosionControl.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	lua_register(_LS.L(), "CheckFact", l_CheckFact);
-	lua_register(_LS.L(), "CheckForMissingHospitalSupplies", l_CheckForMissingHospitalSupplies);
-	lua_register(_LS.L(), "CheckForKingpinsMoneyMissing", l_FunctionCheckForKingpinsMoneyMissing);
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		lua_register(_LS.L(), "CheckFact", l_CheckFact);
+		lua_register(_LS.L(), "CheckForMissingHospitalSupplies", l_CheckForMissingHospitalSupplies);
+		lua_register(_LS.L(), "CheckForKingpinsMoneyMissing", l_FunctionCheckForKingpinsMoneyMissing);
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	if (InitFunction == 0)
 	{
@@ -3007,21 +3036,24 @@ BOOLEAN LetLuaHourlyQuestUpdate(UINT8 Init)
 {
 	const char* filename = "scripts\\HourlyUpdate.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	//lua_register(_LS.L(), "CheckFact", l_CheckFact);	
-	//lua_register(_LS.L(), "CheckForMissingHospitalSupplies", l_CheckForMissingHospitalSupplies);
-	//lua_register(_LS.L(), "CheckForKingpinsMoneyMissing", l_FunctionCheckForKingpinsMoneyMissing);
-	IniFunction(_LS.L(), TRUE);
-	IniGlobalGameSetting(_LS.L());
+	if (_LS.NeedsBindings())
+	{
+		//lua_register(_LS.L(), "CheckFact", l_CheckFact);	
+		//lua_register(_LS.L(), "CheckForMissingHospitalSupplies", l_CheckForMissingHospitalSupplies);
+		//lua_register(_LS.L(), "CheckForKingpinsMoneyMissing", l_FunctionCheckForKingpinsMoneyMissing);
+		IniFunction(_LS.L(), TRUE);
 
-	//-----boxer------ only hourly quest update 
-	lua_register(_LS.L(), "gfBoxerFought", l_SetgfBoxerFought);
-	lua_register(_LS.L(), "SetgfBoxersResting", l_SetgfBoxersResting);
-	lua_register(_LS.L(), "SetgubBoxersRests", l_SetgubBoxersRests);
-	lua_register(_LS.L(), "GetWorldHour", l_GetWorldHour);
+		//-----boxer------ only hourly quest update 
+		lua_register(_LS.L(), "gfBoxerFought", l_SetgfBoxerFought);
+		lua_register(_LS.L(), "SetgfBoxersResting", l_SetgfBoxersResting);
+		lua_register(_LS.L(), "SetgubBoxersRests", l_SetgubBoxersRests);
+		lua_register(_LS.L(), "GetWorldHour", l_GetWorldHour);
+	}
+	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	if (Init == 0)
 	{
@@ -7601,16 +7633,18 @@ BOOLEAN LetLuaHandleEarlyMorningEvents(UINT8 Init)
 {
 	const char* filename = "scripts\\StrategicEventHandler.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-
-	//	lua_register(_LS.L(), "CheckFact", l_CheckFact);	
-	lua_register(_LS.L(), "CheckForMissingHospitalSupplies", l_CheckForMissingHospitalSupplies);
-	//	lua_register(_LS.L(), "CheckForKingpinsMoneyMissing", l_FunctionCheckForKingpinsMoneyMissing);
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		//	lua_register(_LS.L(), "CheckFact", l_CheckFact);	
+		lua_register(_LS.L(), "CheckForMissingHospitalSupplies", l_CheckForMissingHospitalSupplies);
+		//	lua_register(_LS.L(), "CheckForKingpinsMoneyMissing", l_FunctionCheckForKingpinsMoneyMissing);
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	if (Init == 0)
 	{
@@ -10093,15 +10127,18 @@ BOOLEAN LetHandleLoyaltyChangeForNPCAction(UINT8 ubNPCProfileId, UINT8 Init)
 {
 	const char* filename = "scripts\\StrategicTownLoyalty.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	//lua_register(_LS.L(), "CheckFact", l_CheckFact);	
-	//lua_register(_LS.L(), "CheckForMissingHospitalSupplies", l_CheckForMissingHospitalSupplies);
-	//lua_register(_LS.L(), "CheckForKingpinsMoneyMissing", l_FunctionCheckForKingpinsMoneyMissing);
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		//lua_register(_LS.L(), "CheckFact", l_CheckFact);	
+		//lua_register(_LS.L(), "CheckForMissingHospitalSupplies", l_CheckForMissingHospitalSupplies);
+		//lua_register(_LS.L(), "CheckForKingpinsMoneyMissing", l_FunctionCheckForKingpinsMoneyMissing);
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	if (Init == 0)
 	{
@@ -10115,15 +10152,18 @@ BOOLEAN LuaHandleGlobalLoyaltyEvent(UINT8 ubEventType, INT16 sSectorX, INT16 sSe
 {
 	const char* filename = "scripts\\StrategicTownLoyalty.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	//lua_register(_LS.L(), "CheckFact", l_CheckFact);	
-	//lua_register(_LS.L(), "CheckForMissingHospitalSupplies", l_CheckForMissingHospitalSupplies);
-	//lua_register(_LS.L(), "CheckForKingpinsMoneyMissing", l_FunctionCheckForKingpinsMoneyMissing);
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		//lua_register(_LS.L(), "CheckFact", l_CheckFact);	
+		//lua_register(_LS.L(), "CheckForMissingHospitalSupplies", l_CheckForMissingHospitalSupplies);
+		//lua_register(_LS.L(), "CheckForKingpinsMoneyMissing", l_FunctionCheckForKingpinsMoneyMissing);
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	if (Init == 0)
 	{
@@ -11647,13 +11687,16 @@ void LuaHandleAdditionalDialogue(INT16 sSectorX, INT16 sSectorY, INT8 bSectorZ,
 {
 	const char* filename = "scripts\\Overhead.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	lua_register(_LS.L(), "CheckFact", l_CheckFact);
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		lua_register(_LS.L(), "CheckFact", l_CheckFact);
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	LuaFunction(_LS.L, "HandleAdditionalDialogue").Param<int>(sSectorX).Param<int>(sSectorY).Param<int>(bSectorZ).Param<int>(ubProfile).Param<int>(iFaceIndex).Param<int>(usEventNr).Param<int>(aData1).Param<int>(aData2).Param<int>(aData3).Call(9);
 }
@@ -11662,13 +11705,16 @@ void LuaHandleReplaceQuote(UINT8 ubProfile, UINT16 usQuoteNum)
 {
 	const char* filename = "scripts\\Overhead.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	lua_register(_LS.L(), "CheckFact", l_CheckFact);
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		lua_register(_LS.L(), "CheckFact", l_CheckFact);
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	LuaFunction(_LS.L, "HandleReplaceQuote").Param<int>(ubProfile).Param<int>(usQuoteNum).Call(2);
 }
@@ -11677,12 +11723,15 @@ void LuaHandleNPCMerchantQuote(INT16 sSectorX, INT16 sSectorY, INT8 bSectorZ, UI
 {
 	const char* filename = "scripts\\Overhead.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	LuaFunction(_LS.L, "HandleNPCMerchantQuote").Param<int>(sSectorX).Param<int>(sSectorY).Param<int>(bSectorZ).Param<int>(ubMerchantID).Param<int>(ubBodyType).Param<int>(usQuoteNum).Call(6);
 }
@@ -11691,12 +11740,15 @@ void LuaAddArmsDealerAdditionalIntelData()
 {
 	const char* filename = "scripts\\Overhead.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	LuaFunction(_LS.L, "AddArmsDealerAdditionalIntelData").Call(0);
 }
@@ -11722,12 +11774,15 @@ void LuaAddPhotoData(INT16 sSectorX, INT16 sSectorY, INT8 bSectorZ, INT32 sGridN
 {
 	const char* filename = "scripts\\Overhead.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	LuaFunction(_LS.L, "AddPhotoData").Param<int>(sSectorX).Param<int>(sSectorY).Param<int>(bSectorZ).Param<int>(sGridNo).Param<int>(bLevel).Param<int>(ubPhotographerProfile).Param<int>(room).Param<int>(usTargetProfile).Call(6);
 }
@@ -11736,12 +11791,15 @@ void LuaGetPhotoData(UINT8 aType)
 {
 	const char* filename = "scripts\\Overhead.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	LuaFunction(_LS.L, "GetPhotoData").Param<int>(aType).Call(1);
 }
@@ -11750,12 +11808,15 @@ void LuaSetPhotoState(INT16 asIndex, UINT8 aState)
 {
 	const char* filename = "scripts\\Overhead.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	LuaFunction(_LS.L, "SetPhotoState").Param<int>(asIndex).Param<int>(aState).Call(2);
 }
@@ -11764,12 +11825,15 @@ void LuaVerifyPhotoState(INT16 asIndex)
 {
 	const char* filename = "scripts\\Overhead.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	LuaFunction(_LS.L, "VerifyPhotoState").Param<int>(asIndex).Call(1);
 }
@@ -11818,12 +11882,15 @@ void LuaGetIntelAndQuestMapData(INT32 aLevel)
 {
 	const char* filename = "scripts\\strategicmap.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	LuaFunction(_LS.L, "GetIntelAndQuestMapData").Param<int>(aLevel).Call(1);
 }
@@ -11832,12 +11899,15 @@ void SetFactoryLeftoverProgress(INT16 sSectorX, INT16 sSectorY, INT8 bSectorZ, U
 {
 	const char* filename = "scripts\\strategicmap.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	LuaFunction(_LS.L, "SetFactoryLeftoverProgress").Param<int>(sSectorX).Param<int>(sSectorY).Param<int>(bSectorZ).Param<int>(usFacilityType).Param<int>(usProductionNumber).Param<int>(sProgressLeft).Call(6);
 }
@@ -11846,12 +11916,15 @@ INT32 GetFactoryLeftoverProgress(INT16 sSectorX, INT16 sSectorY, INT8 bSectorZ,
 {
 	const char* filename = "scripts\\strategicmap.lua";
 
-	LuaScopeState _LS(true);
+	LuaScriptScope _LS(filename, __FUNCTION__);
 
-	IniFunction(_LS.L(), TRUE);
+	if (_LS.NeedsBindings())
+	{
+		IniFunction(_LS.L(), TRUE);
+	}
 	IniGlobalGameSetting(_LS.L());
 
-	SGP_THROW_IFFALSE(_LS.L.EvalFile(filename), _BS("Cannot open file: ") << filename << _BS::cget);
+	SGP_THROW_IFFALSE(_LS.EvalFile(), _BS("Cannot open file: ") << filename << _BS::cget);
 
 	LuaFunction(_LS.L, "GetFactoryLeftoverProgress").Param<int>(sSectorX).Param<int>(sSectorY).Param<int>(bSectorZ).Param<int>(usFacilityType).Param<int>(usProductionNumber).Call(5);
 
@@ -11905,3 +11978,18 @@ static int l_SetIntelAndQuestMapDataForSector(lua_State* L)
 
 	return 0;
 }
+
+#ifdef JA2TESTVERSION
+// Writes how often and for how long each lua hook has run to the log, and shows the most expensive ones
+void ReportLuaHookTimings( void )
+{
+	std::vector<std::wstring> top;
+
+	LuaScriptScope::ReportTimings( top, 5 );
+
+	for ( size_t i = 0; i < top.size(); ++i )
+	{
+		ScreenMsg( FONT_MCOLOR_LTYELLOW, MSG_INTERFACE, L"%s", top[i].c_str() );
+	}
+}
+#endif
@@ -101,4 +101,8 @@ void LuaVerifyPhotoState( INT16 asIndex );
 void LuaGetIntelAndQuestMapData( INT32 aLevel );
 void SetFactoryLeftoverProgress( INT16 sSectorX, INT16 sSectorY, INT8 bSectorZ, UINT16 usFacilityType, UINT16 usProductionNumber, INT32 sProgressLeft );
 INT32 GetFactoryLeftoverProgress( INT16 sSectorX, INT16 sSectorY, INT8 bSectorZ, UINT16 usFacilityType, UINT16 usProductionNumber );
+
+#ifdef JA2TESTVERSION
+void ReportLuaHookTimings( void );
+#endif
 #endif
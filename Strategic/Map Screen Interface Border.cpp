@@ -997,7 +997,7 @@ void TurnOnAirSpaceMode( void )
 		}
 
 		// WANNE: Output info text on the airspace for changing maps
-		if (is_server )
+		if (is_server && !gfDedicatedMatchHost )
 		{			
 			STR16 pwString = MPServerMessage[ 13 ];
 
@@ -4960,6 +4960,7 @@ void SortSectorInventoryAmmo(bool useBoxes)
 // as the SHIFT+F function, except it deals directly with the sector inventory pool rather than the WorldItems list.
 void SortSectorInventoryEjectAmmo()
 {
+	ObjectStatsChange statsChange;
 	OBJECTTYPE gTempObject;
 	
 	SOLDIERTYPE * pSoldier = gCharactersList[ bSelectedInfoChar ].usSolID;
@@ -0,0 +1,363 @@
+#include "builddefines.h"
+#include "types.h"
+#include "Sector Preload.h"
+#include "FileMan.h"
+#include "MemMan.h"
+#include "DEBUG.H"
+#include "Sys Globals.h"
+#include "jascreens.h"
+#include "screenids.h"
+#include "GameSettings.h"
+#include "Game Clock.h"
+#include "strategicmap.h"
+#include "Strategic Movement.h"
+#include "Overhead Types.h"
+#include "worlddef.h"
+#include "WorldDat.h"
+#include "TileDat.h"
+#include "Utilities.h"
+#include "LoadScreen.h"
+#include "profiler.h"
+#include <string.h>
+#include <stdio.h>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+// map file read by the worker thread
+typedef struct
+{
+	CHAR16				zDiskPath[ MAX_PATH ];
+	std::vector<BYTE>	data;
+	BOOLEAN				fOk;
+} SECTOR_PRELOAD_JOB;
+
+static std::thread			gSectorPreloadThread;
+static std::atomic<BOOLEAN>	gfSectorPreloadDone( FALSE );
+static SECTOR_PRELOAD_JOB	*gpSectorPreloadJob = NULL;
+
+// the sector being preloaded, -1 for none
+static INT16	gsPreloadSectorX = -1;
+static INT16	gsPreloadSectorY = -1;
+static INT8		gbPreloadSectorZ = -1;
+
+// its map file, once it's in memory
+static CHAR8	gzPreloadMapFile[ 2 * FILENAME_BUFLEN ];
+static INT8		*gpPreloadMapBuffer = NULL;
+static UINT32	guiPreloadMapSize = 0;
+
+// tile surfaces of the map's tileset, loaded one per frame from slot guiNextPreloadTileSurface on
+static INT32			giPreloadTilesetID = -1;
+static UINT32			guiNextPreloadTileSurface = 0;
+static PTILE_IMAGERY	gpPreloadTileSurfaces[ NUMBEROFTILETYPES ];
+static CHAR8			gzPreloadTileSurfaceFiles[ NUMBEROFTILETYPES ][ 128 ];
+
+
+static void SectorPreloadThread( SECTOR_PRELOAD_JOB *pJob )
+{
+	ProfilerSetThreadName( "Sector preload" );
+	PERFORMANCE_MARKER
+
+	pJob->fOk = FileReadFromDisk( pJob->zDiskPath, pJob->data );
+
+	gfSectorPreloadDone = TRUE;
+}
+
+static void WaitForSectorPreloadThread( void )
+{
+	if ( gSectorPreloadThread.joinable() )
+	{
+		gSectorPreloadThread.join();
+	}
+	delete gpSectorPreloadJob;
+	gpSectorPreloadJob = NULL;
+}
+
+// The tileset of a map, from the start of its file as LoadWorld() reads it. -1 if the header is cut short.
+static INT32 GetTilesetOfMap( INT8 *pBuffer, UINT32 uiSize )
+{
+	FLOAT	dMajorMapVersion;
+	UINT32	uiPos = sizeof( FLOAT ) + sizeof( UINT8 );
+	INT32	iTilesetID;
+
+	if ( uiSize < sizeof( FLOAT ) )
+		return( -1 );
+
+	memcpy( &dMajorMapVersion, pBuffer, sizeof( FLOAT ) );
+	if ( dMajorMapVersion >= 7.00 )
+	{
+		// rows and columns
+		uiPos += 2 * sizeof( INT32 );
+	}
+	// flags
+	uiPos += sizeof( INT32 );
+
+	if ( uiSize < uiPos + sizeof( INT32 ) )
+		return( -1 );
+
+	memcpy( &iTilesetID, pBuffer + uiPos, sizeof( INT32 ) );
+	return( iTilesetID );
+}
+
+// Name of the file AddTileSurface() loads for slot uiType of tileset iTilesetID, FALSE if that slot uses the
+// surface of the default tileset
+static BOOLEAN GetTilesetSurfaceFile( INT32 iTilesetID, UINT32 uiType, STR8 pFilename )
+{
+	CHAR8	cFileBPP[ 128 ];
+
+	if ( gTilesets[ iTilesetID ].TileSurfaceFilenames[ uiType ][ 0 ] == '\0' )
+		return( FALSE );
+
+	FilenameForBPP( gTilesets[ iTilesetID ].TileSurfaceFilenames[ uiType ], cFileBPP );
+	sprintf( pFilename, "TILESETS\\%d\\%s", iTilesetID, cFileBPP );
+	return( TRUE );
+}
+
+// The surfaces are only preloaded when LoadTileSurfaces() will ask for them by their tileset names, not when an
+// engine.ini overrides them
+static BOOLEAN TilesetSurfacesCanBePreloaded( INT32 iTilesetID )
+{
+	STRING512	ExeDir;
+	STRING512	INIFile;
+
+	if ( iTilesetID < 0 || iTilesetID >= gubNumSets || iTilesetID == giCurrentTilesetID )
+		return( FALSE );
+
+	GetExecutableDirectory( ExeDir );
+	sprintf( INIFile, "%s\\engine.ini", ExeDir );
+	if ( FileExists( INIFile ) )
+		return( FALSE );
+	sprintf( INIFile, "%s\\engine%d.ini", ExeDir, iTilesetID );
+	if ( FileExists( INIFile ) )
+		return( FALSE );
+
+	return( TRUE );
+}
+
+// The map file is in memory, go on with the tileset
+static void PreloadedMapReady( void )
+{
+	INT32 iTilesetID = GetTilesetOfMap( gpPreloadMapBuffer, guiPreloadMapSize );
+
+	if ( TilesetSurfacesCanBePreloaded( iTilesetID ) )
+	{
+		giPreloadTilesetID = iTilesetID;
+		guiNextPreloadTileSurface = 0;
+	}
+}
+
+static void StartSectorPreload( STR8 pFilename )
+{
+	HWFILE	hFile;
+	UINT32	uiBytesRead = 0;
+
+	strcpy( gzPreloadMapFile, pFilename );
+
+	hFile = FileOpen( pFilename, FILE_ACCESS_READ );
+	if ( !hFile )
+		return;
+
+	gpSectorPreloadJob = new SECTOR_PRELOAD_JOB;
+	if ( FileGetDiskPath( hFile, gpSectorPreloadJob->zDiskPath, MAX_PATH ) )
+	{
+		FileClose( hFile );
+
+		gpSectorPreloadJob->fOk = FALSE;
+		gfSectorPreloadDone = FALSE;
+		gSectorPreloadThread = std::thread( SectorPreloadThread, gpSectorPreloadJob );
+		return;
+	}
+	delete gpSectorPreloadJob;
+	gpSectorPreloadJob = NULL;
+
+	// in a library, read it right away
+	guiPreloadMapSize = FileGetSize( hFile );
+	gpPreloadMapBuffer = (INT8*)MemAlloc( __max( guiPreloadMapSize, 1 ) );
+	if ( !FileRead( hFile, gpPreloadMapBuffer, guiPreloadMapSize, &uiBytesRead ) || uiBytesRead != guiPreloadMapSize )
+	{
+		MemFree( gpPreloadMapBuffer );
+		gpPreloadMapBuffer = NULL;
+	}
+	FileClose( hFile );
+
+	if ( gpPreloadMapBuffer )
+	{
+		PreloadedMapReady();
+	}
+}
+
+// The sector the first of the player groups on the move arrives in, if that's within SECTOR_PRELOAD_MINUTES
+static BOOLEAN GetNextArrivalSector( INT16 *psSectorX, INT16 *psSectorY, INT8 *pbSectorZ )
+{
+	UINT32	uiNow = GetWorldTotalMin();
+	UINT32	uiFirstArrival = uiNow + gGameExternalOptions.ubSectorPreloadMinutes + 1;
+	GROUP	*pGroup;
+
+	for ( pGroup = gpGroupList; pGroup; pGroup = pGroup->next )
+	{
+		if ( pGroup->usGroupTeam != OUR_TEAM || !pGroup->fBetweenSectors || !pGroup->ubGroupSize )
+			continue;
+		if ( pGroup->uiArrivalTime < uiNow || pGroup->uiArrivalTime >= uiFirstArrival )
+			continue;
+		// already there
+		if ( pGroup->ubNextX == gWorldSectorX && pGroup->ubNextY == gWorldSectorY && pGroup->ubSectorZ == gbWorldSectorZ )
+			continue;
+
+		uiFirstArrival = pGroup->uiArrivalTime;
+		*psSectorX = pGroup->ubNextX;
+		*psSectorY = pGroup->ubNextY;
+		*pbSectorZ = pGroup->ubSectorZ;
+	}
+
+	return( uiFirstArrival <= uiNow + gGameExternalOptions.ubSectorPreloadMinutes );
+}
+
+void HandleSectorPreload( void )
+{
+	INT16	sSectorX = -1;
+	INT16	sSectorY = -1;
+	INT8	bSectorZ = -1;
+	CHAR8	zMapFile[ FILENAME_BUFLEN ];
+	CHAR8	zFilename[ 2 * FILENAME_BUFLEN ];
+
+	if ( !gGameExternalOptions.ubSectorPreloadMinutes || gfEditMode || ( guiCurrentScreen != MAP_SCREEN && guiCurrentScreen != GAME_SCREEN ) )
+	{
+		if ( gsPreloadSectorX != -1 )
+		{
+			ReleaseSectorPreload();
+		}
+		return;
+	}
+
+	PERFORMANCE_MARKER
+
+	// the worker thread is done, move its data to where LoadWorld() can take it
+	if ( gpSectorPreloadJob && gfSectorPreloadDone )
+	{
+		gSectorPreloadThread.join();
+		if ( gpSectorPreloadJob->fOk )
+		{
+			guiPreloadMapSize = (UINT32)gpSectorPreloadJob->data.size();
+			gpPreloadMapBuffer = (INT8*)MemAlloc( __max( guiPreloadMapSize, 1 ) );
+			if ( guiPreloadMapSize )
+			{
+				memcpy( gpPreloadMapBuffer, &gpSectorPreloadJob->data[ 0 ], guiPreloadMapSize );
+			}
+		}
+		delete gpSectorPreloadJob;
+		gpSectorPreloadJob = NULL;
+
+		if ( gpPreloadMapBuffer )
+		{
+			PreloadedMapReady();
+		}
+	}
+
+	if ( GetNextArrivalSector( &sSectorX, &sSectorY, &bSectorZ ) &&
+		 ( sSectorX != gsPreloadSectorX || sSectorY != gsPreloadSectorY || bSectorZ != gbPreloadSectorZ ) &&
+		 !gfUseAlternateMap )
+	{
+		ReleaseSectorPreload();
+
+		gsPreloadSectorX = sSectorX;
+		gsPreloadSectorY = sSectorY;
+		gbPreloadSectorZ = bSectorZ;
+
+		// no placeholder, a missing map isn't preloaded
+		GetMapFileName( sSectorX, sSectorY, bSectorZ, zMapFile, FALSE, TRUE );
+		sprintf( zFilename, "MAPS\\%s", zMapFile );
+		if ( FileExists( zFilename ) )
+		{
+			StartSectorPreload( zFilename );
+		}
+		return;
+	}
+
+	// the loaded tileset is the one we wanted to preload, someone else was quicker
+	if ( giPreloadTilesetID != -1 && giPreloadTilesetID == giCurrentTilesetID )
+	{
+		ReleasePreloadedTileSurfaces();
+		return;
+	}
+
+	// one tile surface per frame, and only on the map screen where a frame more or less doesn't show
+	if ( giPreloadTilesetID != -1 && guiCurrentScreen == MAP_SCREEN )
+	{
+		for ( ; guiNextPreloadTileSurface < (UINT32)giNumberOfTileTypes; ++guiNextPreloadTileSurface )
+		{
+			UINT32 uiType = guiNextPreloadTileSurface;
+
+			if ( !GetTilesetSurfaceFile( giPreloadTilesetID, uiType, gzPreloadTileSurfaceFiles[ uiType ] ) || !FileExists( gzPreloadTileSurfaceFiles[ uiType ] ) )
+				continue;
+
+			gpPreloadTileSurfaces[ uiType ] = LoadTileSurface( gzPreloadTileSurfaceFiles[ uiType ] );
+			++guiNextPreloadTileSurface;
+			break;
+		}
+	}
+}
+
+void ReleaseSectorPreload( void )
+{
+	WaitForSectorPreloadThread();
+
+	if ( gpPreloadMapBuffer )
+	{
+		MemFree( gpPreloadMapBuffer );
+		gpPreloadMapBuffer = NULL;
+	}
+	guiPreloadMapSize = 0;
+	gzPreloadMapFile[ 0 ] = '\0';
+
+	ReleasePreloadedTileSurfaces();
+
+	gsPreloadSectorX = -1;
+	gsPreloadSectorY = -1;
+	gbPreloadSectorZ = -1;
+}
+
+BOOLEAN TakePreloadedMap( STR8 pFilename, INT8 **ppBuffer, UINT32 *puiSize )
+{
+	// a map that is still being read is as good as none, it's read again on the main thread
+	if ( !gpPreloadMapBuffer || gfEditMode || _stricmp( pFilename, gzPreloadMapFile ) )
+		return( FALSE );
+
+	*ppBuffer = gpPreloadMapBuffer;
+	*puiSize = guiPreloadMapSize;
+
+	gpPreloadMapBuffer = NULL;
+	guiPreloadMapSize = 0;
+	gzPreloadMapFile[ 0 ] = '\0';
+
+	return( TRUE );
+}
+
+PTILE_IMAGERY TakePreloadedTileSurface( STR8 pFilename, UINT32 uiType )
+{
+	PTILE_IMAGERY pTileSurf;
+
+	if ( uiType >= NUMBEROFTILETYPES || !gpPreloadTileSurfaces[ uiType ] || _stricmp( pFilename, gzPreloadTileSurfaceFiles[ uiType ] ) )
+		return( NULL );
+
+	pTileSurf = gpPreloadTileSurfaces[ uiType ];
+	gpPreloadTileSurfaces[ uiType ] = NULL;
+
+	return( pTileSurf );
+}
+
+void ReleasePreloadedTileSurfaces( void )
+{
+	UINT32 uiType;
+
+	for ( uiType = 0; uiType < NUMBEROFTILETYPES; ++uiType )
+	{
+		if ( gpPreloadTileSurfaces[ uiType ] )
+		{
+			DeleteTileSurface( gpPreloadTileSurfaces[ uiType ] );
+			gpPreloadTileSurfaces[ uiType ] = NULL;
+		}
+	}
+
+	giPreloadTilesetID = -1;
+	guiNextPreloadTileSurface = 0;
+}
@@ -0,0 +1,31 @@
+#ifndef __SECTOR_PRELOAD_H
+#define __SECTOR_PRELOAD_H
+
+#include "types.h"
+#include "Tile Surface.h"
+
+// Preloading of the sector a squad is about to arrive in (SECTOR_PRELOAD_MINUTES)
+//
+// While a player group travels, the sector it reaches next within the set number of game minutes is prepared
+// ahead of time, so entering it doesn't have to wait for the disk:
+// - The map file is read into memory. Map files on disk are read by a worker thread, files in libraries on the
+//   main thread in one go (the VFS isn't thread safe). LoadWorld() takes the buffer instead of reading the file.
+// - If the map uses another tileset than the loaded one, the tile surfaces of that tileset are loaded on the main
+//   thread, one per frame while the map screen is up. AddTileSurface() takes them instead of loading them.
+// Both are found by their file names, so anything that changes in between (another map, an alternate map, another
+// tileset) just isn't found and is loaded as before. What isn't taken is thrown away when the destination changes.
+
+// called every frame by the game loop
+void			HandleSectorPreload( void );
+// drops everything preloaded and waits for the worker thread
+void			ReleaseSectorPreload( void );
+
+// hands the preloaded contents of map file pFilename (as LoadWorld() opens it, "MAPS\\...") over to the caller,
+// which MemFree()s them. FALSE if that map isn't preloaded.
+BOOLEAN			TakePreloadedMap( STR8 pFilename, INT8 **ppBuffer, UINT32 *puiSize );
+// the preloaded tile surface for slot uiType if it was loaded from pFilename, NULL if there's none
+PTILE_IMAGERY	TakePreloadedTileSurface( STR8 pFilename, UINT32 uiType );
+// deletes the preloaded tile surfaces that weren't taken, once the tileset is loaded
+void			ReleasePreloadedTileSurfaces( void );
+
+#endif
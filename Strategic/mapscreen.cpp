@@ -6776,7 +6776,7 @@ UINT32 HandleMapUI( )
 								ChangeSelectedMapSector( sMapX, sMapY, ( INT8 )iCurrentMapSectorZ );
 								// <TODO> OJW - 20081201 - change this state away from allowlaptop to its own field
 								// or something more seperate from that concept
-								if (is_server && !allowlaptop)
+								if (is_server && !gfDedicatedMatchHost && !allowlaptop)
 								{
 									InitializeWorldSize(sMapX, sMapY, 0);
 									send_mapchange();
@@ -16495,7 +16495,7 @@ BOOLEAN CanMoveBullseyeAndClickedOnIt( INT16 sMapX, INT16 sMapY )
 		{
 			// haydent
 			// OJW 080101 - allow map change before laptop unlock
-			if ((!is_server && !is_client) || (is_server && !allowlaptop))
+			if ((!is_server && !is_client) || (is_server && !gfDedicatedMatchHost && !allowlaptop))
 			{
 				// if he clicked on the bullseye, and we're on the surface level
 				if ( ( sMapX == gsMercArriveSectorX ) && ( sMapY == gsMercArriveSectorY ) && ( iCurrentMapSectorZ == 0 ) )
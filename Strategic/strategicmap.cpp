@@ -395,6 +395,7 @@ UINT32 uiNumTablesLoaded;
 UINT32 uiNumImagesReloaded;
 #include "Render Dirty.h"
 #include "TileDat.h"
+#include "shade_palette_store.h"
 #endif
 
 // SAM externalization stuff
@@ -1690,6 +1691,8 @@ void EndLoadScreen( )
 		uiPercentage = 0;
 	}
 	timeResults << "  3)  Of that, " << uiPercentage << "% of the shade tables were generated (not loaded)." << sgp::endl;
+	timeResults << "  4)  " << gShadePaletteStats.uiTables << " shade tables in use, " << gShadePaletteStats.uiReferences << " references, sharing saves " << ShadePaletteBytesSaved( ) / 1024 << " KB." << sgp::endl;
+	timeResults << "  5)  Shade table cache: " << gShadePaletteStats.uiCacheBytes / 1024 << " KB, loaded in " << gShadePaletteStats.uiCacheLoadTime << " ms." << sgp::endl;
 	if ( gfForceBuildShadeTables )
 	{
 		timeResults << "  NOTE:  Force building of shadetables enabled on this local computer." << sgp::endl;
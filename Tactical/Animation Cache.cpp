@@ -5,11 +5,32 @@
 	#include "Animation Data.h"
 	#include "Animation Control.h"
 	#include "Debug Control.h"
+	#include "Soldier Control.h"
+	#include "GameSettings.h"
 
 #define EMPTY_CACHE_ENTRY		65000
 
 UINT32 guiCacheSize		= MIN_CACHE_SIZE;
 
+#define ANIM_PREFETCH_QUEUE_SIZE	64
+
+typedef struct
+{
+	SoldierID	usSoldierID;
+	UINT16		usSurfaceIndex;
+	UINT16		usAnimState;
+
+} ANIM_PREFETCH;
+
+static ANIM_PREFETCH	gAnimPrefetchQueue[ ANIM_PREFETCH_QUEUE_SIZE ];
+static UINT32			guiAnimPrefetchHead = 0;
+static UINT32			guiAnimPrefetchCount = 0;
+
+// animations a soldier can go to from his current height
+static const UINT16 gusAnimPrefetchFromStand[]	= { WALKING, RUNNING, KNEEL_DOWN, CROUCHING };
+static const UINT16 gusAnimPrefetchFromCrouch[]	= { KNEEL_UP, STANDING, SWATTING, PRONE_DOWN, PRONE };
+static const UINT16 gusAnimPrefetchFromProne[]	= { PRONE_UP, CROUCHING, CRAWLING };
+
 void DetermineOptimumAnimationCacheSize( )
 {
 	// If we have lots-a memory, adjust accordingly!
@@ -156,3 +177,99 @@ void UnLoadCachedAnimationSurfaces( SoldierID usSoldierID, AnimationSurfaceCache
 	}
 
 }
+
+
+void QueueAnimationSurfacePrefetch( SOLDIERTYPE *pSoldier, UINT16 usAnimState )
+{
+	const UINT16	*pusAnimStates;
+	UINT32			uiNumAnimStates;
+	UINT32			cnt, cnt2;
+
+	// without a budget a prefetched surface would be unloaded again right away
+	if ( !gGameExternalOptions.uiAnimationCacheBudget )
+	{
+		return;
+	}
+
+	// only the regular bodies have the full set
+	if ( !IS_MERC_BODY_TYPE( pSoldier ) )
+	{
+		return;
+	}
+
+	switch ( gAnimControl[ usAnimState ].ubEndHeight )
+	{
+		case ANIM_STAND:
+			pusAnimStates = gusAnimPrefetchFromStand;
+			uiNumAnimStates = sizeof( gusAnimPrefetchFromStand ) / sizeof( UINT16 );
+			break;
+		case ANIM_CROUCH:
+			pusAnimStates = gusAnimPrefetchFromCrouch;
+			uiNumAnimStates = sizeof( gusAnimPrefetchFromCrouch ) / sizeof( UINT16 );
+			break;
+		case ANIM_PRONE:
+			pusAnimStates = gusAnimPrefetchFromProne;
+			uiNumAnimStates = sizeof( gusAnimPrefetchFromProne ) / sizeof( UINT16 );
+			break;
+		default:
+			return;
+	}
+
+	for ( cnt = 0; cnt < uiNumAnimStates; cnt++ )
+	{
+		UINT16 usAnimSurface = DetermineSoldierAnimationSurface( pSoldier, pusAnimStates[ cnt ] );
+
+		if ( usAnimSurface == INVALID_ANIMATION_SURFACE || gAnimSurfaceDatabase[ usAnimSurface ].hVideoObject != NULL )
+		{
+			continue;
+		}
+
+		for ( cnt2 = 0; cnt2 < guiAnimPrefetchCount; cnt2++ )
+		{
+			if ( gAnimPrefetchQueue[ ( guiAnimPrefetchHead + cnt2 ) % ANIM_PREFETCH_QUEUE_SIZE ].usSurfaceIndex == usAnimSurface )
+			{
+				break;
+			}
+		}
+
+		if ( cnt2 < guiAnimPrefetchCount )
+		{
+			continue;
+		}
+
+		// if the queue is full, the oldest request goes
+		if ( guiAnimPrefetchCount == ANIM_PREFETCH_QUEUE_SIZE )
+		{
+			guiAnimPrefetchHead = ( guiAnimPrefetchHead + 1 ) % ANIM_PREFETCH_QUEUE_SIZE;
+			guiAnimPrefetchCount--;
+		}
+
+		ANIM_PREFETCH *pPrefetch = &gAnimPrefetchQueue[ ( guiAnimPrefetchHead + guiAnimPrefetchCount ) % ANIM_PREFETCH_QUEUE_SIZE ];
+
+		pPrefetch->usSoldierID = pSoldier->ubID;
+		pPrefetch->usSurfaceIndex = usAnimSurface;
+		pPrefetch->usAnimState = pusAnimStates[ cnt ];
+		guiAnimPrefetchCount++;
+	}
+}
+
+void HandleAnimationSurfacePrefetch( void )
+{
+	while ( guiAnimPrefetchCount > 0 )
+	{
+		ANIM_PREFETCH	*pPrefetch = &gAnimPrefetchQueue[ guiAnimPrefetchHead ];
+		SOLDIERTYPE		*pSoldier = MercPtrs[ pPrefetch->usSoldierID ];
+
+		guiAnimPrefetchHead = ( guiAnimPrefetchHead + 1 ) % ANIM_PREFETCH_QUEUE_SIZE;
+		guiAnimPrefetchCount--;
+
+		// skip what has been loaded meanwhile, or whose soldier is gone
+		if ( pSoldier == NULL || !pSoldier->bActive || gAnimSurfaceDatabase[ pPrefetch->usSurfaceIndex ].hVideoObject != NULL )
+		{
+			continue;
+		}
+
+		PrefetchAnimationSurface( pPrefetch->usSoldierID, pPrefetch->usSurfaceIndex, pPrefetch->usAnimState );
+		break;
+	}
+}
@@ -24,6 +24,12 @@ void DeleteAnimationCache( SoldierID usSoldierID, AnimationSurfaceCacheType *pAn
 void DetermineOptimumAnimationCacheSize( );
 void UnLoadCachedAnimationSurfaces( SoldierID usSoldierID, AnimationSurfaceCacheType *pAnimCache );
 
+// Prefetch of the surfaces a soldier can go to next from his current animation (standing -> crouching -> prone and
+// so on). Queued surfaces are loaded one per frame by HandleAnimationSurfacePrefetch, so a whole wave of soldiers
+// starting to move doesn't load them all in the same frame.
+void QueueAnimationSurfacePrefetch( SOLDIERTYPE *pSoldier, UINT16 usAnimState );
+void HandleAnimationSurfacePrefetch( void );
+
 
 
 #endif
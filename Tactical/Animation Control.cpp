@@ -4140,6 +4140,11 @@ UINT16 LoadSoldierAnimationSurface( SOLDIERTYPE *pSoldier, UINT16 usAnimState )
 		{
 			usAnimSurface = INVALID_ANIMATION_SURFACE;
 		}
+		else
+		{
+			// get what he may do next ready
+			QueueAnimationSurfacePrefetch( pSoldier, usAnimState );
+		}
 
 	}
 
@@ -11,6 +11,7 @@
 	#include "Utilities.h"
 	#include "worlddef.h"
 	#include "FileMan.h"
+	#include "GameSettings.h"
 
 //forward declarations of common classes to eliminate includes
 class OBJECTTYPE;
@@ -28,6 +29,7 @@ ANIM_PROF		*gpAnimProfiles = NULL;
 UINT8				gubNumAnimProfiles = 0;
 
 INT8				gbAnimUsageHistory[ NUMANIMATIONSURFACETYPES ][ MAX_NUM_SOLDIERS ];
+static UINT32		guiAnimSurfaceUseCounter = 0;
 
 
 
@@ -1049,6 +1051,7 @@ BOOLEAN LoadAnimationSurface( SoldierID usSoldierID, UINT16 usSurfaceIndex, UINT
 
 		// Set video object index
 		gAnimSurfaceDatabase[ usSurfaceIndex ].hVideoObject = hVObject;
+		gAnimSurfaceDatabase[ usSurfaceIndex ].uiBytes = hVObject->uiSizePixData + hVObject->usNumberOfObjects * sizeof( ETRLEObject );
 
 		// Determine if we have a problem with #frames + directions ( ie mismatch )
 		if (	( gAnimSurfaceDatabase[ usSurfaceIndex ].uiNumDirections * gAnimSurfaceDatabase[ usSurfaceIndex ].uiNumFramesPerDir ) != gAnimSurfaceDatabase[ usSurfaceIndex ].hVideoObject->usNumberOfObjects )
@@ -1102,21 +1105,77 @@ BOOLEAN UnLoadAnimationSurface( SoldierID usSoldierID, UINT16 usSurfaceIndex )
 
 
 
-	// Check if count has reached zero and delet if so
+	// Check if count has reached zero. The surface stays loaded for the next soldier who needs it, unless the
+	// unused surfaces take up too much memory now
 	if ( gAnimSurfaceDatabase[ usSurfaceIndex ].bUsageCount == 0 )
 	{
-		AnimDebugMsg( String( "Surface Database: Unloading Surface: %d", usSurfaceIndex ) );
+		AnimDebugMsg( String( "Surface Database: Surface %d no longer used", usSurfaceIndex ) );
 
 		CHECKF( gAnimSurfaceDatabase[ usSurfaceIndex ].hVideoObject != NULL )
 
-			DeleteVideoObject( gAnimSurfaceDatabase[ usSurfaceIndex ].hVideoObject );
-			gAnimSurfaceDatabase[ usSurfaceIndex ].hVideoObject = NULL;
+		gAnimSurfaceDatabase[ usSurfaceIndex ].uiLastUsed = ++guiAnimSurfaceUseCounter;
+		TrimAnimationSurfaceCache( );
 	}
 
 	return( TRUE );
 
 }
 
+void TrimAnimationSurfaceCache( void )
+{
+	UINT32	uiUnusedBytes = 0;
+	UINT32	cnt;
+
+	for ( cnt = 0; cnt < NUMANIMATIONSURFACETYPES; cnt++ )
+	{
+		if ( gAnimSurfaceDatabase[ cnt ].hVideoObject != NULL && gAnimSurfaceDatabase[ cnt ].bUsageCount == 0 )
+		{
+			uiUnusedBytes += gAnimSurfaceDatabase[ cnt ].uiBytes;
+		}
+	}
+
+	while ( uiUnusedBytes > gGameExternalOptions.uiAnimationCacheBudget )
+	{
+		INT32 iOldest = -1;
+
+		for ( cnt = 0; cnt < NUMANIMATIONSURFACETYPES; cnt++ )
+		{
+			if ( gAnimSurfaceDatabase[ cnt ].hVideoObject != NULL && gAnimSurfaceDatabase[ cnt ].bUsageCount == 0 &&
+				 ( iOldest == -1 || gAnimSurfaceDatabase[ cnt ].uiLastUsed < gAnimSurfaceDatabase[ iOldest ].uiLastUsed ) )
+			{
+				iOldest = cnt;
+			}
+		}
+
+		if ( iOldest == -1 )
+		{
+			break;
+		}
+
+		AnimDebugMsg( String( "Surface Database: Unloading Surface: %d", iOldest ) );
+
+		uiUnusedBytes -= gAnimSurfaceDatabase[ iOldest ].uiBytes;
+		DeleteVideoObject( gAnimSurfaceDatabase[ iOldest ].hVideoObject );
+		gAnimSurfaceDatabase[ iOldest ].hVideoObject = NULL;
+	}
+}
+
+// Loads a surface a soldier is likely to need soon, without him holding on to it.
+BOOLEAN PrefetchAnimationSurface( SoldierID usSoldierID, UINT16 usSurfaceIndex, UINT16 usAnimState )
+{
+	if ( usSurfaceIndex >= NUMANIMATIONSURFACETYPES || gAnimSurfaceDatabase[ usSurfaceIndex ].hVideoObject != NULL ||
+		 !gGameExternalOptions.uiAnimationCacheBudget )
+	{
+		return( TRUE );
+	}
+
+	AnimDebugMsg( String( "Surface Database: Prefetching %d ( Soldier %d )", usSurfaceIndex, usSoldierID ) );
+
+	CHECKF( LoadAnimationSurface( usSoldierID, usSurfaceIndex, usAnimState ) != FALSE );
+
+	return( UnLoadAnimationSurface( usSoldierID, usSurfaceIndex ) );
+}
+
 void ClearAnimationSurfacesUsageHistory( SoldierID usSoldierID )
 {
 	UINT32 cnt;
@@ -667,8 +667,10 @@ typedef struct
 	UINT32									uiNumFramesPerDir;
 	HVOBJECT								hVideoObject;
 	void										*Unused;
-	INT8										bUsageCount;
+	INT16										bUsageCount;			// soldiers using the surface, more than an INT8 can count with big battles
 	INT8										bProfile;
+	UINT32									uiLastUsed;				// when the last soldier stopped using it
+	UINT32									uiBytes;
 
 } AnimationSurfaceType;
 
@@ -690,6 +692,10 @@ BOOLEAN InitAnimationSystem( );
 BOOLEAN DeInitAnimationSystem( );
 BOOLEAN LoadAnimationSurface( SoldierID usSoldierID, UINT16 usSurfaceIndex, UINT16 usAnimState );
 BOOLEAN UnLoadAnimationSurface(	SoldierID usSoldierID, UINT16 usSurfaceIndex );
+// Surfaces no soldier uses stay loaded, the least recently used are unloaded once they need more memory than
+// ANIMATION_CACHE_BUDGET allows.
+void TrimAnimationSurfaceCache( void );
+BOOLEAN PrefetchAnimationSurface( SoldierID usSoldierID, UINT16 usSurfaceIndex, UINT16 usAnimState );
 void ClearAnimationSurfacesUsageHistory( SoldierID usSoldierID );
 
 
@@ -728,11 +728,11 @@ void LimitArmsDealersInventory( UINT8 ubArmsDealer, UINT32 uiDealerItemType, UIN
 	UINT16	usItemIndex=0;
 	std::vector<int> usAvailableItems;
 	std::vector<UINT32> ubNumberOfAvailableItem;
-	//loop through all items of the same class and count the number in stock
-	for ( usItemIndex = 1; usItemIndex < gMAXITEMS_READ; ++usItemIndex )
+	//loop through the items in stock (in item order) and count the ones of the same class
+	for (std::map< UINT16, UINT16>::iterator stock = numTotalItems.begin(); stock != numTotalItems.end(); ++stock)
 	{
-		//if there is some items in stock
-		if (numTotalItems.count(usItemIndex) > 0)
+		usItemIndex = stock->first;
+		if ( usItemIndex >= 1 && usItemIndex < gMAXITEMS_READ )
 		{
 			//if the item is of the same dealer item type
 			if( uiDealerItemType & GetArmsDealerItemTypeFromItemNumber( usItemIndex ) )
@@ -748,7 +748,7 @@ void LimitArmsDealersInventory( UINT8 ubArmsDealer, UINT32 uiDealerItemType, UIN
 				else
 				{
 					// items being repaired don't count against the limit
-					ubNumberOfAvailableItem.push_back(numTotalItems[usItemIndex]);
+					ubNumberOfAvailableItem.push_back(stock->second);
 					uiTotalNumberOfItems += ubNumberOfAvailableItem.back();
 				}
 			}
@@ -5376,6 +5376,7 @@ OBJECTTYPE* GetBetterSectorObject( UINT16 usItem, INT16 status, UINT8& arIndex )
 
 void UpdateGear()
 {
+	ObjectStatsChange statsChange;
 	if ( gTacticalStatus.uiFlags & INCOMBAT )
 		return;
 
@@ -5560,6 +5561,7 @@ void UpdateGear()
 
 void BombMessageBoxCallBack( UINT8 ubExitValue )
 {
+	ObjectStatsChange statsChange;
 	if (gpTempSoldier)
 	{
 		// sevenfm: remember last tripwire network settings
@@ -5757,6 +5759,7 @@ void TacticalFunctionSelectionMessageBoxCallBack( UINT8 ubExitValue )
 // Flugente: callback after deciding what to do with a corpse
 void CorpseMessageBoxCallBack( UINT8 ubExitValue )
 {
+	ObjectStatsChange statsChange;
 	if (gpTempSoldier)
 	{
 		INT32 nextGridNoinSight = gpTempSoldier->sGridNo;
@@ -5820,6 +5823,7 @@ void CorpseMessageBoxCallBack( UINT8 ubExitValue )
 
 BOOLEAN HandItemWorks( SOLDIERTYPE *pSoldier, INT8 bSlot )
 {
+	ObjectStatsChange statsChange;
 	BOOLEAN							fItemJustBroke = FALSE, fItemWorks = TRUE;
 	OBJECTTYPE *				pObj;
 
@@ -7347,6 +7351,7 @@ BOOLEAN IsStructureDeconstructItem( UINT16 usItem, INT32 sGridNo, SOLDIERTYPE* p
 
 BOOLEAN BuildFortification( INT32 sGridNo, SOLDIERTYPE *pSoldier, OBJECTTYPE *pObj )
 {	
+	ObjectStatsChange statsChange;
 	UINT32				fHeadType;
 	UINT16				usUseIndex;
 	INT16				sUseObjIndex = -1;
@@ -9000,6 +9005,7 @@ void HandleFortificationUpdate()
 
 									(gWorldItems[slot].object)[i]->data.objectStatus -= reduce;
 									itemreduction -= reduce;
+									InvalidateObjectStats();
 
 									if ( !(gWorldItems[slot].object)[i]->data.objectStatus )
 									{
@@ -9773,6 +9779,7 @@ void GetEquipmentTemplates()
 
 void ReadEquipmentTable( SOLDIERTYPE* pSoldier, std::string name )
 {
+	ObjectStatsChange statsChange;
 	// make sure the merc is actually in this sector
 	if ( pSoldier )
 	{
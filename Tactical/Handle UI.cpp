@@ -1339,7 +1339,8 @@ UINT32 UIHandleEndTurn( UI_EVENT *pUIEvent )
 		// to an option setting.
 		// So no more need to have a file AutoSave.pls in you ja2 root directory
 		//if( FileExists( "..\\AutoSave.pls" ) && CanGameBeSaved() )
-		if (gGameSettings.fOptions[TOPTION_USE_AUTO_SAVE] == TRUE && CanGameBeSaved() )
+		// a skipped autosave doesn't use up the end turn slot
+		if (gGameSettings.fOptions[TOPTION_USE_AUTO_SAVE] == TRUE && CanGameBeSaved() && !SkipAutoSaveGame() )
 		{
 			SetOptionsPreviousScreen(guiCurrentScreen);
 
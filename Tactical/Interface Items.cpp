@@ -67,8 +67,10 @@
 	#include "random.h"					// added by Flugente
 	#include "Explosion Control.h"		// added by Flugente
 	#include "Sound Control.h"
+	#include "ItemIndex.h"
 
 #include <language.hpp>
+#include <algorithm>
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -2291,8 +2293,11 @@ void addAmmoToPocketPopup( SOLDIERTYPE *pSoldier, INT16 sPocket, POPUP* popup )
 			//o->color_background = COLOR_LTGREY;
 					
 			//find the ammo item we want to try and create
-			for ( UINT32 loop = 0; loop < gMAXITEMS_READ; ++loop )
+			const std::vector<UINT16>& magazines = GetMagazinesOfCalibre( Weapon[ (*gun)->usItem ].ubCalibre );
+			for ( size_t m = 0; m < magazines.size(); ++m )
 			{
+				UINT32 loop = magazines[m];
+
 				if(Item[loop].usItemClass & IC_AMMO)
 				{
 					if(		Magazine[Item[loop].ubClassIndex].ubCalibre == Weapon[ (*gun)->usItem ].ubCalibre 
@@ -5737,10 +5742,14 @@ void UpdateAttachmentTooltips(OBJECTTYPE *pObject, UINT8 ubStatusIndex)
 				//Print all attachments that fit on this item.
 
 				// sevenfm: first check items
-				for (UINT16 usLoop = 0; usLoop < gMAXITEMS_READ; usLoop++)
+				std::vector<UINT16> pointItems;
+				GetItemsOnAttachmentPoints(point, pointItems);
+				for (size_t i = 0; i < pointItems.size(); i++)
 				{
+					UINT16 usLoop = pointItems[i];
+
 					// check that reached end of valid items
-					if (Item[usLoop].usItemClass == 0)
+					if (usLoop >= GetItemIndexEnd())
 						break;
 
 					//We no longer find valid attachments from AttachmentSlots.xml so we need to work a bit harder to get our list
@@ -5759,9 +5768,19 @@ void UpdateAttachmentTooltips(OBJECTTYPE *pObject, UINT8 ubStatusIndex)
 					}
 				}
 
-				// sevenfm: check launchables
-				for (UINT16 usLoop = 0; usLoop < gMAXLAUNCHABLES_READ; usLoop++)
+				// sevenfm: check launchables, of the item and of its attachments
+				std::vector<UINT32> launchableRows = GetLaunchableRowsOfLauncher(pObject->usItem);
+				for (size_t i = 0; i < attachedList.size(); i++)
+				{
+					const std::vector<UINT32>& rows = GetLaunchableRowsOfLauncher(attachedList[i]);
+					launchableRows.insert(launchableRows.end(), rows.begin(), rows.end());
+				}
+				std::sort(launchableRows.begin(), launchableRows.end());
+				launchableRows.erase(std::unique(launchableRows.begin(), launchableRows.end()), launchableRows.end());
+
+				for (size_t i = 0; i < launchableRows.size(); i++)
 				{
+					UINT16 usLoop = (UINT16)launchableRows[i];
 					usAttachment = 0;
 					if (Launchable[usLoop][1] == pObject->usItem && AttachmentSlots[usLoopSlotID].nasAttachmentClass & Item[Launchable[usLoop][0]].nasAttachmentClass)
 					{
@@ -5794,10 +5813,19 @@ void UpdateAttachmentTooltips(OBJECTTYPE *pObject, UINT8 ubStatusIndex)
 					}
 				}
 
-				// check all attachments
-				//TODO: should be optimized using AttachmentBackmap and/or possibly FindAttachmentRange()
-				for (UINT32 uiLoop = 0; uiLoop < gMAXATTACHMENTS_READ; uiLoop++)
+				// check all attachments, of the item and of its attachments
+				std::vector<UINT32> attachmentRows = GetAttachmentRowsOfItem(pObject->usItem);
+				for (size_t i = 0; i < attachedList.size(); i++)
 				{
+					const std::vector<UINT32>& rows = GetAttachmentRowsOfItem(attachedList[i]);
+					attachmentRows.insert(attachmentRows.end(), rows.begin(), rows.end());
+				}
+				std::sort(attachmentRows.begin(), attachmentRows.end());
+				attachmentRows.erase(std::unique(attachmentRows.begin(), attachmentRows.end()), attachmentRows.end());
+
+				for (size_t i = 0; i < attachmentRows.size(); i++)
+				{
+					UINT32 uiLoop = attachmentRows[i];
 					usAttachment = 0;
 					if (Attachment[uiLoop].itemIndex == pObject->usItem && AttachmentSlots[usLoopSlotID].nasAttachmentClass & Item[Attachment[uiLoop].attachmentIndex].nasAttachmentClass)
 					{
@@ -13447,8 +13475,11 @@ void ItemDescTransformRegionCallback( MOUSE_REGION *pRegion, INT32 reason )
 
 				if (fCrateInPool)
 				{
-					for ( UINT16 x = 0; x < gMAXITEMS_READ; ++x )
+					const std::vector<UINT16>& magazines = GetMagazinesOfCalibre( Magazine[Item[gpItemDescObject->usItem].ubClassIndex].ubCalibre );
+					for ( size_t m = 0; m < magazines.size(); ++m )
 					{
+						UINT16 x = magazines[m];
+
 						if ( Item[x].usItemClass & IC_AMMO )
 						{
 							// If this magazine has the same caliber and ammotype as the crate, has a smaller size, and is
@@ -14391,8 +14422,11 @@ void TransformationMenuPopup_SplitCrateInInventory( )
 			UINT32 uiBestRoundCapacity = 0;
 			UINT16 usBestItem = 0;
 
-			for ( UINT16 x = 0; x < gMAXITEMS_READ; ++x )
+			const std::vector<UINT16>& magazines = GetMagazinesOfCalibre( ubCaliber );
+			for ( size_t m = 0; m < magazines.size(); ++m )
 			{
+				UINT16 x = magazines[m];
+
 				if (Item[x].usItemClass & IC_AMMO)
 				{
 					if (Magazine[Item[x].ubClassIndex].ubAmmoType == ubAmmoType &&
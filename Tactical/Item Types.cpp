@@ -626,6 +626,7 @@ void OBJECTTYPE::SpliceData(OBJECTTYPE& sourceObject, unsigned int numToSplice,
 
 int OBJECTTYPE::AddObjectsToStack(int howMany, int objectStatus)
 {
+	ObjectStatsChange statsChange;
 	//This function is never called from a soldier, so get the max size
 	int numToAdd = max(0, ItemSlotLimit( this, STACK_SIZE_LIMIT ) - ubNumberOfObjects);
 
@@ -734,6 +735,7 @@ int OBJECTTYPE::ForceAddObjectsToStack(OBJECTTYPE& sourceObject, int howMany)
 
 int OBJECTTYPE::AddObjectsToStack(OBJECTTYPE& sourceObject, int howMany, SOLDIERTYPE* pSoldier, int slot, int cap, bool allowLBETransfer)
 {
+	ObjectStatsChange statsChange;
 	int freeObjectsInStack;
 
 	//can't add too much, can't take too many
@@ -805,6 +807,7 @@ int OBJECTTYPE::RemoveObjectsFromStack(int howMany)
 
 int OBJECTTYPE::PrivateRemoveObjectsFromStack(int howMany, OBJECTTYPE* destObject, SOLDIERTYPE* pSoldier, int slot, int cap)
 {
+	ObjectStatsChange statsChange;
 	//ADB this function only needs to know soldier and slot
 	//if there is a dest object we are putting the removed objects into
 	//in this case it is acting as a move and has probably been called by MoveThisObjectTo
@@ -1377,12 +1380,14 @@ OLD_OBJECTTYPE_101& OLD_OBJECTTYPE_101::operator=(OBJECTTYPE& src)
 // Constructor
 OBJECTTYPE::OBJECTTYPE()
 {
+	pStatsCache = NULL;
 	initialize();
 }
 void OBJECTTYPE::initialize()
 {
 
 	memset(this, 0, SIZEOF_OBJECTTYPE_POD);
+	DeleteObjectStatsCache(this);
 
 	//this is an easy way to init it and get rid of attachments
 	objectStack.clear();
@@ -1417,6 +1422,7 @@ bool OBJECTTYPE::operator==(OBJECTTYPE& compare)
 //Copy Ctor
 OBJECTTYPE::OBJECTTYPE(const OBJECTTYPE& src)
 {
+	this->pStatsCache = NULL;
 	if ((void*)this != (void*)&src) {
 		this->usItem = src.usItem;
 		this->ubNumberOfObjects = src.ubNumberOfObjects;
@@ -1433,6 +1439,7 @@ OBJECTTYPE::OBJECTTYPE(const OBJECTTYPE& src)
 OBJECTTYPE& OBJECTTYPE::operator=(const OBJECTTYPE& src)
 {
 	if ((void*)this != (void*)&src) {
+		DeleteObjectStatsCache(this);
 		this->usItem = src.usItem;
 		this->ubNumberOfObjects = src.ubNumberOfObjects;
 		//ADB ubWeight has been removed, see comments in OBJECTTYPE
@@ -1814,5 +1821,6 @@ OBJECTTYPE& OBJECTTYPE::operator=(const OLD_OBJECTTYPE_101& src)
 
 OBJECTTYPE::~OBJECTTYPE()
 {
+	DeleteObjectStatsCache(this);
 	objectStack.clear();
 }
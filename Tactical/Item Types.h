@@ -232,6 +232,10 @@ typedef enum
 //forward declaration
 class OBJECTTYPE;
 class SOLDIERTYPE;
+struct OBJECT_STATS_CACHE;
+
+// frees the derived stats kept with an object, see Items.cpp
+void DeleteObjectStatsCache( OBJECTTYPE* pObject );
 
 #define MAX_ITEMS_IN_LBE 12
 
@@ -646,6 +650,10 @@ public:
 #define SIZEOF_OBJECTTYPE_POD	(offsetof(OBJECTTYPE, endOfPOD))
 
 	StackedObjects		objectStack;
+
+	// bonuses and weight worked out from the object and its attachments, see Items.cpp. Not part of the object:
+	// never saved, compared or copied
+	OBJECT_STATS_CACHE*	pStatsCache;
 //	std::vector<UINT16>	usAttachmentSlotIndexVector;	//WarmSteel - This holds the slots indexes this weapon has.  -- CHRISL: Can't have this here because of item stacks
 };
 
@@ -0,0 +1,212 @@
+	#include "types.h"
+	#include "ItemIndex.h"
+	#include "Item Types.h"
+	#include "Items.h"
+	#include "Weapons.h"
+	#include "DEBUG.H"
+
+#include <algorithm>
+#include <unordered_map>
+
+static std::vector<UINT16>	gItemsOfClass[ 32 ];
+static std::vector<UINT16>	gMagazinesOfCalibre[ 256 ];
+static std::vector<UINT16>	gItemsOnAttachmentPoint[ 64 ];
+static UINT64				gAttachmentClassesOnAttachmentPoint[ 64 ];
+static UINT16				gusItemIndexEnd = 0;
+
+static std::unordered_map<UINT16, std::vector<UINT32> >	gAttachmentRowsOfItem;
+static std::unordered_map<UINT32, INT32>					gAttachmentRow;				// key is ( attachment << 16 ) | item
+static std::unordered_map<UINT16, std::vector<UINT32> >	gLaunchableRowsOfLauncher;
+static std::unordered_map<UINT16, std::vector<UINT16> >	gLaunchersOfLaunchable;
+static std::unordered_map<UINT16, INT32>					gAttachmentInfoRow;
+static std::unordered_map<UINT16, std::vector<UINT32> >	gAttachmentInfoClasses;
+
+static const std::vector<UINT16>	gEmptyItemList;
+static const std::vector<UINT32>	gEmptyRowList;
+
+
+void BuildItemIndex( void )
+{
+	UINT32 uiLoop;
+	UINT8 ubBit;
+
+	for ( ubBit = 0; ubBit < 32; ++ubBit )
+		gItemsOfClass[ ubBit ].clear();
+	for ( uiLoop = 0; uiLoop < 256; ++uiLoop )
+		gMagazinesOfCalibre[ uiLoop ].clear();
+	for ( ubBit = 0; ubBit < 64; ++ubBit )
+	{
+		gItemsOnAttachmentPoint[ ubBit ].clear();
+		gAttachmentClassesOnAttachmentPoint[ ubBit ] = 0;
+	}
+	gAttachmentRowsOfItem.clear();
+	gAttachmentRow.clear();
+	gLaunchableRowsOfLauncher.clear();
+	gLaunchersOfLaunchable.clear();
+	gAttachmentInfoRow.clear();
+	gAttachmentInfoClasses.clear();
+
+	// items
+	gusItemIndexEnd = (UINT16)gMAXITEMS_READ;
+	for ( uiLoop = 1; uiLoop < gMAXITEMS_READ; ++uiLoop )
+	{
+		if ( Item[ uiLoop ].usItemClass == 0 )
+		{
+			gusItemIndexEnd = (UINT16)uiLoop;
+			break;
+		}
+	}
+
+	for ( uiLoop = 0; uiLoop < gMAXITEMS_READ; ++uiLoop )
+	{
+		UINT16 usItem = (UINT16)uiLoop;
+
+		for ( ubBit = 0; ubBit < 32; ++ubBit )
+		{
+			if ( Item[ usItem ].usItemClass & ( 1u << ubBit ) )
+				gItemsOfClass[ ubBit ].push_back( usItem );
+		}
+
+		if ( Item[ usItem ].usItemClass & IC_AMMO )
+			gMagazinesOfCalibre[ Magazine[ Item[ usItem ].ubClassIndex ].ubCalibre ].push_back( usItem );
+
+		// the same test IsAttachmentPointAvailable() does
+		if ( usItem > 0 && Item[ usItem ].ulAttachmentPoint && ( ItemIsAttachment( usItem ) || Item[ usItem ].usItemClass & ( IC_GRENADE | IC_BOMB ) ) )
+		{
+			for ( ubBit = 0; ubBit < 64; ++ubBit )
+			{
+				if ( Item[ usItem ].ulAttachmentPoint & ( 1ull << ubBit ) )
+				{
+					gItemsOnAttachmentPoint[ ubBit ].push_back( usItem );
+					gAttachmentClassesOnAttachmentPoint[ ubBit ] |= Item[ usItem ].nasAttachmentClass;
+				}
+			}
+		}
+	}
+
+	// Attachments.xml (sorted by attachment when read)
+	for ( uiLoop = 0; uiLoop < gMAXATTACHMENTS_READ; ++uiLoop )
+	{
+		gAttachmentRowsOfItem[ Attachment[ uiLoop ].itemIndex ].push_back( uiLoop );
+		gAttachmentRow.insert( std::make_pair( ( (UINT32)Attachment[ uiLoop ].attachmentIndex << 16 ) | Attachment[ uiLoop ].itemIndex, (INT32)uiLoop ) );
+	}
+
+	// Launchables.xml, up to the first empty row
+	UINT16 usOpenBlock = 0;
+	for ( uiLoop = 0; uiLoop < MAXITEMS + 1 && Launchable[ uiLoop ][0] != 0; ++uiLoop )
+	{
+		UINT16 usLaunchable = Launchable[ uiLoop ][0];
+
+		if ( uiLoop == 0 || usLaunchable != Launchable[ uiLoop - 1 ][0] )
+			usOpenBlock = gLaunchersOfLaunchable.count( usLaunchable ) ? 0 : usLaunchable;
+
+		if ( usLaunchable == usOpenBlock )
+			gLaunchersOfLaunchable[ usLaunchable ].push_back( Launchable[ uiLoop ][1] );
+
+		gLaunchableRowsOfLauncher[ Launchable[ uiLoop ][1] ].push_back( uiLoop );
+	}
+
+	// AttachmentInfo.xml, up to the first empty row after the first one
+	for ( uiLoop = 0; uiLoop < MAXITEMS + 1 && ( uiLoop == 0 || AttachmentInfo[ uiLoop ].usItem != 0 ); ++uiLoop )
+	{
+		gAttachmentInfoRow.insert( std::make_pair( AttachmentInfo[ uiLoop ].usItem, (INT32)uiLoop ) );
+
+		// see comment for AttachmentInfo array for why we skip IC_NONE
+		if ( AttachmentInfo[ uiLoop ].uiItemClass != IC_NONE )
+			gAttachmentInfoClasses[ AttachmentInfo[ uiLoop ].usItem ].push_back( AttachmentInfo[ uiLoop ].uiItemClass );
+	}
+}
+
+UINT16 GetItemIndexEnd( void )
+{
+	return( gusItemIndexEnd );
+}
+
+const std::vector<UINT16>& GetItemsOfClass( UINT32 uiItemClass )
+{
+	for ( UINT8 ubBit = 0; ubBit < 32; ++ubBit )
+	{
+		if ( uiItemClass == ( 1u << ubBit ) )
+			return( gItemsOfClass[ ubBit ] );
+	}
+
+	AssertMsg( FALSE, String( "GetItemsOfClass(), %d is not a single item class", uiItemClass ) );
+	return( gEmptyItemList );
+}
+
+const std::vector<UINT16>& GetMagazinesOfCalibre( UINT8 ubCalibre )
+{
+	return( gMagazinesOfCalibre[ ubCalibre ] );
+}
+
+const std::vector<UINT32>& GetAttachmentRowsOfItem( UINT16 usItem )
+{
+	std::unordered_map<UINT16, std::vector<UINT32> >::const_iterator it = gAttachmentRowsOfItem.find( usItem );
+
+	return( it != gAttachmentRowsOfItem.end() ? it->second : gEmptyRowList );
+}
+
+INT32 GetAttachmentRow( UINT16 usAttachment, UINT16 usItem )
+{
+	std::unordered_map<UINT32, INT32>::const_iterator it = gAttachmentRow.find( ( (UINT32)usAttachment << 16 ) | usItem );
+
+	return( it != gAttachmentRow.end() ? it->second : -1 );
+}
+
+const std::vector<UINT32>& GetLaunchableRowsOfLauncher( UINT16 usLauncher )
+{
+	std::unordered_map<UINT16, std::vector<UINT32> >::const_iterator it = gLaunchableRowsOfLauncher.find( usLauncher );
+
+	return( it != gLaunchableRowsOfLauncher.end() ? it->second : gEmptyRowList );
+}
+
+const std::vector<UINT16>& GetLaunchersOfLaunchable( UINT16 usLaunchable )
+{
+	std::unordered_map<UINT16, std::vector<UINT16> >::const_iterator it = gLaunchersOfLaunchable.find( usLaunchable );
+
+	return( it != gLaunchersOfLaunchable.end() ? it->second : gEmptyItemList );
+}
+
+void GetItemsOnAttachmentPoints( UINT64 uiPoint, std::vector<UINT16>& items )
+{
+	items.clear();
+
+	for ( UINT8 ubBit = 0; ubBit < 64; ++ubBit )
+	{
+		if ( uiPoint & ( 1ull << ubBit ) )
+			items.insert( items.end(), gItemsOnAttachmentPoint[ ubBit ].begin(), gItemsOnAttachmentPoint[ ubBit ].end() );
+	}
+
+	std::sort( items.begin(), items.end() );
+	items.erase( std::unique( items.begin(), items.end() ), items.end() );
+}
+
+UINT64 GetAttachmentClassesOnAttachmentPoints( UINT64 uiPoint )
+{
+	UINT64 uiClasses = 0;
+
+	for ( UINT8 ubBit = 0; ubBit < 64; ++ubBit )
+	{
+		if ( uiPoint & ( 1ull << ubBit ) )
+			uiClasses |= gAttachmentClassesOnAttachmentPoint[ ubBit ];
+	}
+
+	return( uiClasses );
+}
+
+INT32 GetAttachmentInfoRow( UINT16 usItem )
+{
+	std::unordered_map<UINT16, INT32>::const_iterator it = gAttachmentInfoRow.find( usItem );
+
+	return( it != gAttachmentInfoRow.end() ? it->second : -1 );
+}
+
+BOOLEAN AttachmentInfoAllowsClass( UINT16 usAttachment, UINT32 uiItemClass )
+{
+	std::unordered_map<UINT16, std::vector<UINT32> >::const_iterator it = gAttachmentInfoClasses.find( usAttachment );
+
+	if ( it == gAttachmentInfoClasses.end() )
+		return( FALSE );
+
+	return( std::find( it->second.begin(), it->second.end(), uiItemClass ) != it->second.end() );
+}
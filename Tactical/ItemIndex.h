@@ -0,0 +1,49 @@
+#ifndef __ITEMINDEX_H
+#define __ITEMINDEX_H
+
+#include "types.h"
+#include <vector>
+
+// Lookup tables over the item data read from the xml files (Items, Magazines, Attachments, AttachmentInfo and
+// Launchables). They are built once at the end of LoadExternalGameplayData() and replace the loops over all
+// items or over the whole attachment and launchable tables. All lists are in item number order (or table row
+// order where noted), so code walking a list sees the same items in the same order as the loop it replaces.
+
+void BuildItemIndex( void );
+
+// first item number after the used ones, ie. the first one with usItemClass 0 (loops over Item[] stop there)
+UINT16 GetItemIndexEnd( void );
+
+// items of one item class (a single IC_ flag)
+const std::vector<UINT16>& GetItemsOfClass( UINT32 uiItemClass );
+
+// magazines (IC_AMMO items, ammo boxes and crates included) of a calibre
+const std::vector<UINT16>& GetMagazinesOfCalibre( UINT8 ubCalibre );
+
+// rows of Attachment[] that attach something to usItem, in table order
+const std::vector<UINT32>& GetAttachmentRowsOfItem( UINT16 usItem );
+
+// row of Attachment[] that allows usAttachment on usItem, -1 if there is none
+INT32 GetAttachmentRow( UINT16 usAttachment, UINT16 usItem );
+
+// rows of Launchable[] that fire something from usLauncher, in table order
+const std::vector<UINT32>& GetLaunchableRowsOfLauncher( UINT16 usLauncher );
+
+// Launchers of usLaunchable, in table order. Like ValidLaunchable() always did, only the first block of rows
+// for a launchable counts.
+const std::vector<UINT16>& GetLaunchersOfLaunchable( UINT16 usLaunchable );
+
+// items that can go on attachment points (attachments, grenades and bombs) with any of the bits of uiPoint set,
+// without duplicates
+void GetItemsOnAttachmentPoints( UINT64 uiPoint, std::vector<UINT16>& items );
+
+// nasAttachmentClass of all the items GetItemsOnAttachmentPoints() would return, or'ed together
+UINT64 GetAttachmentClassesOnAttachmentPoints( UINT64 uiPoint );
+
+// first row of AttachmentInfo[] for usItem, -1 if there is none
+INT32 GetAttachmentInfoRow( UINT16 usItem );
+
+// TRUE if AttachmentInfo[] has a row for usAttachment with item class uiItemClass
+BOOLEAN AttachmentInfoAllowsClass( UINT16 usAttachment, UINT32 uiItemClass );
+
+#endif
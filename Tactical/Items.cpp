@@ -40,11 +40,14 @@
 	#include "Debug Control.h"
 	// THE_BOB : added for pocket popup definitions
 	#include <map>
+	#include <algorithm>
+	#include <chrono>
 	#include "popup_definition.h"
 	#include "Drugs And Alcohol.h"
 	#include "Food.h"
 	#include "CampaignStats.h"		// added by Flugente
 	#include "ai.h"					// added by Flugente
+	#include "ItemIndex.h"
 
 #ifdef JA2UB
 #include "Ja25_Tactical.h"
@@ -2195,48 +2198,12 @@ BOOLEAN ItemHasAttachments( OBJECTTYPE * pObj, SOLDIERTYPE * pSoldier, UINT8 ite
 // (i.e. to any item in the class)
 BOOLEAN ValidAttachmentClass( UINT16 usAttachment, UINT16 usItem )
 {
-	INT32 iLoop = 0;
-	while( 1 )
-	{
-		// see comment for AttachmentInfo array for why we skip IC_NONE
-		if ( AttachmentInfo[ iLoop ].uiItemClass != IC_NONE )
-		{
-			if ( AttachmentInfo[ iLoop ].usItem == usAttachment )
-			{
-				if ( AttachmentInfo[ iLoop ].uiItemClass == Item[ usItem ].usItemClass )
-				{
-					return( TRUE );
-				}
-			}
-		}
-		++iLoop;
-		if (AttachmentInfo[iLoop].usItem == 0)
-		{
-			// end of the array
-			break;
-		}
-	}
-	return( FALSE );
+	return( AttachmentInfoAllowsClass( usAttachment, Item[ usItem ].usItemClass ) );
 }
 
 INT32 GetAttachmentInfoIndex( UINT16 usItem )
 {
-	INT32 iLoop = 0;
-
-	while( 1 )
-	{
-		if ( AttachmentInfo[ iLoop ].usItem == usItem )
-		{
-			return( iLoop );
-		}
-		++iLoop;
-		if (AttachmentInfo[iLoop].usItem == 0)
-		{
-			// end of the array
-			break;
-		}
-	}
-	return( -1 );
+	return( GetAttachmentInfoRow( usItem ) );
 }
 
 //Determine if it is possible to add this attachment to the item.
@@ -2258,25 +2225,17 @@ BOOLEAN ValidAttachment( UINT16 usAttachment, UINT16 usItem, UINT8 * pubAPCost )
 		return TRUE;
 	}
 
-	// look for the section of the array pertaining to this attachment...
-	UINT32 startIndex = 0, endIndex = 0;
-	if (FindAttachmentRange(usAttachment, &startIndex, &endIndex) == FALSE)
+	// look for the entry for this attachment and item
+	INT32 iLoop = GetAttachmentRow(usAttachment, usItem);
+	if (iLoop < 0)
 		return FALSE;
 
-	// now look through this section for the item in question
-	for (UINT32 iLoop = startIndex; iLoop <= endIndex; iLoop++)
+	if ( UsingNewAttachmentSystem( ) || Attachment[iLoop].NASOnly != 1 )
 	{
-		if (Attachment[iLoop].itemIndex == usItem)
-		{
-			if ( UsingNewAttachmentSystem( ) || Attachment[iLoop].NASOnly != 1 )
-			{
-				if (pubAPCost)
-					*pubAPCost = (UINT8)Attachment[iLoop].APCost; //Madd: get ap cost of attaching items :)
-			}
-			return TRUE;
-		}
+		if (pubAPCost)
+			*pubAPCost = (UINT8)Attachment[iLoop].APCost; //Madd: get ap cost of attaching items :)
 	}
-	return FALSE;
+	return TRUE;
 }
 
 BOOLEAN ValidAttachment( UINT16 usAttachment, OBJECTTYPE * pObj, UINT8 * pubAPCost, UINT8 subObject, std::vector<UINT16> usAttachmentSlotIndexVector)
@@ -2710,46 +2669,16 @@ BOOLEAN ValidLaunchable( UINT16 usLaunchable, UINT16 usItem )
 	//if (!Item[usLaunchable].attachment && !Item[usLaunchable].hiddenaddon)
 		//return FALSE;
 
-	INT32 iLoop = 0;
 	// Flugente: as this would cause launchers to happily launch attachments around the landscape, we really have to check the list of launchables
 	// if a modder decides to define launchables via attachment points, slap him and tell him not to do that
 	//Madd: Common Attachment Framework
 	//if ( IsAttachmentPointAvailable(usItem, usLaunchable) )
 		//return TRUE;
 
-	//DebugMsg(TOPIC_JA2, DBG_LEVEL_3, String("ValidLaunchable: launchable=%d, item=%d",usLaunchable,usItem));
-	// look for the section of the array pertaining to this launchable item...
-	while( 1 )
-	{
-		if (Launchable[iLoop][0] == usLaunchable)
-		{
-			break;
-		}
-		++iLoop;
-		if (Launchable[iLoop][0] == 0)
-		{
-			// the proposed item cannot be attached to anything!
-			//DebugMsg(TOPIC_JA2, DBG_LEVEL_3, String("ValidLaunchable: launchable=%d, item=%d, return FALSE, launchable not found",usLaunchable,usItem));
-			return( FALSE );
-		}
-	}
-	// now look through this section for the item in question
-	while( 1 )
-	{
-		if (Launchable[iLoop][1] == usItem)
-		{
-			break;
-		}
-		++iLoop;
-		if (Launchable[iLoop][0] != usLaunchable)
-		{
-			// the proposed item cannot be attached to the item in question
-			//DebugMsg(TOPIC_JA2, DBG_LEVEL_3, String("ValidLaunchable: launchable=%d, item=%d, return FALSE, item not found",usLaunchable,usItem));
-			return( FALSE );
-		}
-	}
-	//DebugMsg(TOPIC_JA2, DBG_LEVEL_3, String("ValidLaunchable: launchable=%d, item=%d, return TRUE",usLaunchable,usItem));
-	return( TRUE );
+	// look through the launchers of this launchable item for the item in question
+	const std::vector<UINT16>& launchers = GetLaunchersOfLaunchable( usLaunchable );
+
+	return( std::find( launchers.begin(), launchers.end(), usItem ) != launchers.end() );
 }
 
 BOOLEAN ValidItemLaunchable( OBJECTTYPE * pObj, UINT16 usAttachment )
@@ -2773,23 +2702,15 @@ BOOLEAN ValidItemLaunchable( OBJECTTYPE * pObj, UINT16 usAttachment )
 
 UINT16 GetLauncherFromLaunchable( UINT16 usLaunchable )
 {
-	INT32 iLoop = 0;
-	// look for the section of the array pertaining to this launchable item...
-	while( 1 )
+	const std::vector<UINT16>& launchers = GetLaunchersOfLaunchable( usLaunchable );
+
+	if ( launchers.empty() )
 	{
-		if (Launchable[iLoop][0] == usLaunchable)
-		{
-			break;
-		}
-		iLoop++;
-		if (Launchable[iLoop][0] == 0)
-		{
-			// the proposed item cannot be attached to anything!
-			return( NOTHING );
-		}
+		// the proposed item cannot be attached to anything!
+		return( NOTHING );
 	}
 
-	return( Launchable[iLoop][1] );
+	return( launchers[0] );
 }
 
 
@@ -3036,6 +2957,115 @@ UINT16 CalculateAmmoWeight( UINT16 usGunAmmoItem, UINT16 ubShotsLeft )
 	//Pulmu end
 }
 
+// Object stats cache
+// The modifier, recoil, aim and to-hit bonus functions below add up the object and each of its attachments every time
+// they are asked. NCTH, the AI and the tooltips ask the same things about the same guns thousands of times per turn,
+// so with ITEM_STATS_CACHE on the sums are kept with the object. They only depend on the items, the status of the
+// object and its attachments and the ammo loaded, and every change to those has to call InvalidateObjectStats(), so
+// an entry is trusted as long as that hasn't happened, the item and number of objects are the same, and so are the
+// options that change the sums. Looking an entry up costs a few compares, not a walk over the object.
+// The weight isn't kept: it is barely more work than the lookup and follows every shot fired.
+// Copying an object over another drops the target's cache. Stance and range are part of what's looked up, not a
+// reason to drop anything. With ITEM_STATS_CACHE = 2 every value taken from the cache is checked against a fresh one,
+// which is how a change that doesn't invalidate shows up.
+#define OBJECT_STATS_REFS				3		// see GetStanceModifierRef()
+
+#define OBJECT_STATS_OPTION_NCTH		0x01
+#define OBJECT_STATS_OPTION_SCOPEMODES	0x02
+#define OBJECT_STATS_OPTION_TRACERS		0x04
+
+struct OBJECT_STATS_CACHE
+{
+	UINT32	uiVersion;
+	UINT16	usItem;
+	UINT8	ubNumberOfObjects;
+	UINT8	ubOptions;
+
+	// GetObjectModifier() before the scope mode is applied, by [stance ref][scopes skipped], one bit per type
+	UINT32	uiModifierValid[ OBJECT_STATS_REFS ][ 2 ];
+	INT32	iModifier[ ITEMMODIFIER_MAX ][ OBJECT_STATS_REFS ][ 2 ];
+
+	BOOLEAN	fFlatRecoil;
+	FLOAT	dFlatRecoilX;
+	FLOAT	dFlatRecoilY;
+	BOOLEAN	fAttachmentFlatRecoil;
+	FLOAT	dAttachmentFlatRecoilX;
+	FLOAT	dAttachmentFlatRecoilY;
+	BOOLEAN	fAttachmentPercentRecoil;
+	INT16	sAttachmentPercentRecoil;
+
+	// the attachment part of the last GetAimBonus() and GetToHitBonus() calls, these depend on range
+	BOOLEAN	fAimBonus;
+	INT32	iAimRange;
+	INT16	sAimTime;
+	INT16	sAimBonus;
+	BOOLEAN	fToHitBonus;
+	INT32	iToHitRange;
+	UINT8	bToHitLightLevel;
+	BOOLEAN	fToHitProne;
+	INT16	sToHitBonus;
+};
+
+static UINT32 guiObjectStatsVersion = 1;
+
+void InvalidateObjectStats( void )
+{
+	++guiObjectStatsVersion;
+}
+
+void DeleteObjectStatsCache( OBJECTTYPE* pObject )
+{
+	delete pObject->pStatsCache;
+	pObject->pStatsCache = NULL;
+}
+
+// returns the object's cache entries, emptied if they no longer apply, or NULL if the cache is off
+static OBJECT_STATS_CACHE* GetObjectStatsCache( OBJECTTYPE* pObject )
+{
+	if ( !gGameExternalOptions.ubItemStatsCache )
+		return( NULL );
+
+	UINT8 ubOptions = 0;
+	if ( UsingNewCTHSystem() )
+		ubOptions |= OBJECT_STATS_OPTION_NCTH;
+	if ( gGameExternalOptions.fScopeModes )
+		ubOptions |= OBJECT_STATS_OPTION_SCOPEMODES;
+	if ( gGameExternalOptions.ubRealisticTracers == 1 )
+		ubOptions |= OBJECT_STATS_OPTION_TRACERS;
+
+	if ( pObject->pStatsCache == NULL )
+	{
+		pObject->pStatsCache = new OBJECT_STATS_CACHE;
+		pObject->pStatsCache->uiVersion = 0;
+	}
+
+	OBJECT_STATS_CACHE* pCache = pObject->pStatsCache;
+
+	if ( pCache->uiVersion != guiObjectStatsVersion ||
+		 pCache->usItem != pObject->usItem ||
+		 pCache->ubNumberOfObjects != pObject->ubNumberOfObjects ||
+		 pCache->ubOptions != ubOptions )
+	{
+		memset( pCache, 0, sizeof( OBJECT_STATS_CACHE ) );
+		pCache->uiVersion			= guiObjectStatsVersion;
+		pCache->usItem				= pObject->usItem;
+		pCache->ubNumberOfObjects	= pObject->ubNumberOfObjects;
+		pCache->ubOptions			= ubOptions;
+	}
+
+	return( pCache );
+}
+
+// ITEM_STATS_CACHE = 2: complain if a cached value differs from what the function works out now
+static void VerifyObjectStat( OBJECTTYPE* pObject, const CHAR16* szStat, FLOAT dCached, FLOAT dFresh )
+{
+	if ( gGameExternalOptions.ubItemStatsCache == 2 && dCached != dFresh )
+	{
+		DebugMsg( TOPIC_JA2, DBG_LEVEL_3, String( "Object stats cache out of date, item %d: %f instead of %f", pObject->usItem, dCached, dFresh ) );
+		ScreenMsg( FONT_MCOLOR_LTRED, MSG_INTERFACE, L"Object stats cache out of date, item %d %s: %g instead of %g", pObject->usItem, szStat, dCached, dFresh );
+	}
+}
+
 /*CHRISL: Change to a 16bit integer for a max weight of 6553.5kg.  Also changed to account for
 new inventory system. */
 UINT16 CalculateObjectWeight( OBJECTTYPE *pObject )
@@ -3251,6 +3281,7 @@ void SwapObjs(SOLDIERTYPE* pSoldier, int slot, OBJECTTYPE* pObject, BOOLEAN fPer
 
 void DamageObj( OBJECTTYPE * pObj, INT8 bAmount, UINT8 subObject )
 {
+	ObjectStatsChange statsChange;
 	// Flugente: lower repair threshold
 	(*pObj)[subObject]->data.sRepairThreshold = max(1, (*pObj)[subObject]->data.sRepairThreshold - bAmount/3);
 
@@ -3268,6 +3299,7 @@ void DamageObj( OBJECTTYPE * pObj, INT8 bAmount, UINT8 subObject )
 
 void DistributeStatus(OBJECTTYPE* pSourceObject, OBJECTTYPE* pTargetObject, INT16 bMaxPoints)
 {
+	ObjectStatsChange statsChange;
 	INT16 bPointsToMove;
 	for ( int bLoop = pSourceObject->ubNumberOfObjects - 1; bLoop >= 0; bLoop-- )
 	{
@@ -3358,6 +3390,7 @@ BOOLEAN PlaceObjectAtObjectIndex( OBJECTTYPE * pSourceObj, OBJECTTYPE * pTargetO
 
 BOOLEAN ReloadGun( SOLDIERTYPE * pSoldier, OBJECTTYPE * pGun, OBJECTTYPE * pAmmo, UINT32 subObject )
 {
+	ObjectStatsChange statsChange;
 	UINT16			ubBulletsToMove;
 	INT16			bAPs;
 	UINT16			usReloadSound;
@@ -3676,6 +3709,7 @@ BOOLEAN ReloadGun( SOLDIERTYPE * pSoldier, OBJECTTYPE * pGun, OBJECTTYPE * pAmmo
 
 BOOLEAN EmptyWeaponMagazine( OBJECTTYPE * pWeapon, OBJECTTYPE *pAmmo, UINT32 subObject )
 {
+	ObjectStatsChange statsChange;
 	UINT16 usReloadSound;
 
 	CHECKF( pAmmo != NULL );
@@ -3836,18 +3870,14 @@ INT8 FindAmmoToReload( SOLDIERTYPE * pSoldier, INT8 bWeaponIn, INT8 bExcludeSlot
 	}
 	else
 	{
-		for ( int i = 0; i<gMAXITEMS_READ; ++i )
-		{
-			if ( Launchable[i][0] == 0 && Launchable[i][1] == 0)
-				break;
+		const std::vector<UINT32>& rows = GetLaunchableRowsOfLauncher( pObj->usItem );
 
-			if ( pObj->usItem == Launchable[i][1] )
-			{
-				bSlot = FindObj( pSoldier, Launchable[i][0] );
+		for ( size_t i = 0; i < rows.size(); ++i )
+		{
+			bSlot = FindObj( pSoldier, Launchable[rows[i]][0] );
 
-				if ( bSlot != NO_SLOT )
-					return bSlot;
-			}
+			if ( bSlot != NO_SLOT )
+				return bSlot;
 		}
 		return NO_SLOT;
 
@@ -4170,6 +4200,7 @@ INT8 GetAttachmentComboMerge( OBJECTTYPE * pObj, UINT8 subObject )
 
 void PerformAttachmentComboMerge( OBJECTTYPE * pObj, INT8 bAttachmentComboMerge )
 {
+	ObjectStatsChange statsChange;
 	INT8		bAttachLoop;
 	UINT32	uiStatusTotal = 0;
 	INT8		bNumStatusContributors = 0;
@@ -4205,6 +4236,7 @@ void PerformAttachmentComboMerge( OBJECTTYPE * pObj, INT8 bAttachmentComboMerge
 
 BOOLEAN OBJECTTYPE::AttachObjectOAS( SOLDIERTYPE * pSoldier, OBJECTTYPE * pAttachment, BOOLEAN playSound, UINT8 subObject )
 {
+	ObjectStatsChange statsChange;
 	//CHRISL: This makes it impossible to add attachments to objects in a stack.  Let's remove this and make this possible.
 	//if ( this->ubNumberOfObjects > 1 )
 	//{
@@ -4834,6 +4866,7 @@ BOOLEAN OBJECTTYPE::AttachObject( SOLDIERTYPE * pSoldier, OBJECTTYPE * pAttachme
 //WarmSteel - if uiItemPos is -1, we're not checking for a specific slot, but scrolling through them all. TODO comment the rest
 BOOLEAN OBJECTTYPE::AttachObjectNAS( SOLDIERTYPE * pSoldier, OBJECTTYPE * pAttachment, BOOLEAN playSound, UINT8 subObject, INT32 iItemPos, BOOLEAN fRemoveProhibited, std::vector<UINT16> usAttachmentSlotIndexVector )
 {
+	ObjectStatsChange statsChange;
 	if (pAttachment->exists() == false) {
 		return FALSE;
 	}
@@ -5746,22 +5779,15 @@ UINT64 SetAttachmentSlotsFlag(OBJECTTYPE* pObj)
 			uiSlotFlag |= Item[attachmentId].nasAttachmentClass;
 	}
 
-	for (UINT32 i = 0; i < gMAXLAUNCHABLES_READ; i++)
+	const std::vector<UINT32>& rows = GetLaunchableRowsOfLauncher(pObj->usItem);
+	for (size_t i = 0; i < rows.size(); i++)
 	{
-		if (Launchable[i][1] == pObj->usItem)
-		{
-			UINT16 attachmentId = Launchable[i][0];
-			if (ItemIsLegal(attachmentId, TRUE))
-				uiSlotFlag |= Item[attachmentId].nasAttachmentClass;
-		}
+		UINT16 attachmentId = Launchable[rows[i]][0];
+		if (ItemIsLegal(attachmentId, TRUE))
+			uiSlotFlag |= Item[attachmentId].nasAttachmentClass;
 	}
 
-	UINT64 point = GetAvailableAttachmentPoint(pObj, 0);
-	for (UINT32 itemId = 1; itemId < gMAXITEMS_READ; itemId++)
-	{
-		if (IsAttachmentPointAvailable(point, itemId, TRUE))
-			uiSlotFlag |= Item[itemId].nasAttachmentClass;
-	}
+	uiSlotFlag |= GetAttachmentClassesOnAttachmentPoints(GetAvailableAttachmentPoint(pObj, 0));
 
 	return uiSlotFlag;
 }
@@ -6259,6 +6285,7 @@ attachmentList ReInitMergedItem(SOLDIERTYPE* pSoldier, OBJECTTYPE* pObj, UINT16
 
 void EjectAmmoAndPlace(SOLDIERTYPE* pSoldier, OBJECTTYPE* pObj, UINT8 subObject)
 {
+	ObjectStatsChange statsChange;
 	CreateAmmo((*pObj)[subObject]->data.gun.usGunAmmoItem, &gTempObject, (*pObj)[subObject]->data.gun.ubGunShotsLeft);
 	(*pObj)[subObject]->data.gun.ubGunShotsLeft = 0;
 	(*pObj)[subObject]->data.gun.usGunAmmoItem = NONE;
@@ -6928,15 +6955,13 @@ BOOLEAN PlaceObject( SOLDIERTYPE * pSoldier, INT8 bPos, OBJECTTYPE * pObj )
 								UINT8		capacity=0;
 								UINT8		bLoop;
 								//find the ammo item we want to try and create
-								for ( int loop = 0; loop < gMAXITEMS_READ; ++loop )
+								const std::vector<UINT16>& magazines = GetMagazinesOfCalibre( Weapon[pObjUsed->usItem].ubCalibre );
+								for ( size_t loop = 0; loop < magazines.size(); ++loop )
 								{
-									if(Item[loop].usItemClass & IC_AMMO)
+									if(Magazine[Item[magazines[loop]].ubClassIndex].ubAmmoType == Magazine[Item[pObj->usItem].ubClassIndex].ubAmmoType && Magazine[Item[magazines[loop]].ubClassIndex].ubMagSize == GetMagSize(pObjUsed) && Magazine[Item[magazines[loop]].ubClassIndex].ubMagType < AMMO_BOX )
 									{
-										if(Magazine[Item[loop].ubClassIndex].ubCalibre == Weapon[pObjUsed->usItem].ubCalibre && Magazine[Item[loop].ubClassIndex].ubAmmoType == Magazine[Item[pObj->usItem].ubClassIndex].ubAmmoType && Magazine[Item[loop].ubClassIndex].ubMagSize == GetMagSize(pObjUsed) && Magazine[Item[loop].ubClassIndex].ubMagType < AMMO_BOX )
-										{
-											newItem = loop;
-											break;
-										}
+										newItem = magazines[loop];
+										break;
 									}
 								}
 								//Create a stack of up to 5 "newItem" clips 
@@ -7887,6 +7912,7 @@ UINT16 TotalPoints( OBJECTTYPE * pObj )
 
 UINT16 UseKitPoints( OBJECTTYPE * pObj, UINT16 usPoints, SOLDIERTYPE *pSoldier )
 {
+	ObjectStatsChange statsChange;
 	// start consuming from the last kit in, so we end up with fewer fuller kits rather than
 	// lots of half-empty ones.
 	INT8		bLoop;
@@ -8681,6 +8707,7 @@ BOOLEAN ArmBomb( OBJECTTYPE * pObj, INT8 bSetting )
 // pAttachment will be filled with garbage data, pass a new OBJECTTYPE as pNewObj to get the removed attachment or pass NULL to indicate the attachment is to be deleted
 BOOLEAN OBJECTTYPE::RemoveAttachment( OBJECTTYPE * pAttachment, OBJECTTYPE * pNewObj, UINT8 subObject, SOLDIERTYPE * pSoldier, BOOLEAN fForceInseperable, BOOLEAN fRemoveProhibited )
 {
+	ObjectStatsChange statsChange;
 	BOOLEAN		objDeleted = FALSE;
 	std::vector<UINT16> usAttachmentSlotIndexVector;
 	std::vector<UINT16> usRemAttachmentSlotIndexVector;
@@ -9174,6 +9201,7 @@ BOOLEAN CheckForChainReactionActionItem( OBJECTTYPE * pObj, INT16 bDamage)
 }
 BOOLEAN DamageItem( OBJECTTYPE * pObject, INT32 iDamage, BOOLEAN fOnGround, INT32 sGridNo = -1, INT8 bLevel = 0 )
 {
+	ObjectStatsChange statsChange;
 	INT8		bLoop;
 	INT16		bDamage;
 
@@ -9544,6 +9572,7 @@ void SwapOutHandItem( SOLDIERTYPE * pSoldier )
 
 void WaterDamage( SOLDIERTYPE *pSoldier )
 {
+	ObjectStatsChange statsChange;
 	// damage guy's equipment and camouflage due to water
 	INT8		bLoop, bDamage, bDieSize;
 	UINT32	uiRoll;
@@ -10218,6 +10247,7 @@ BOOLEAN ItemIsCool( OBJECTTYPE * pObj )
 
 void ActivateXRayDevice( SOLDIERTYPE * pSoldier )
 {
+	ObjectStatsChange statsChange;
 	SOLDIERTYPE *	pSoldier2;
 	UINT32				uiSlot;
 
@@ -10370,6 +10400,87 @@ void DumpItemsList( void )
 
 	fclose(FDump);
 }
+
+// Asks the modifier, recoil, aim and to-hit functions what an NCTH shot asks about every gun in hand in the
+// sector, 1000 rounds over, with ITEM_STATS_CACHE off, on, and on but invalidated before every round as if each
+// round were a shot, and reports the times and whether the answers differ.
+void BenchmarkObjectStatsCache( void )
+{
+	UINT8		ubOrigItemStatsCache = gGameExternalOptions.ubItemStatsCache;
+	INT8		bStances[3] = { ANIM_STAND, ANIM_CROUCH, ANIM_PRONE };
+	UINT32		uiMicroseconds[3];
+	INT64		iChecksum[3];
+	std::vector<SOLDIERTYPE*>	soldiers;
+	std::vector<OBJECTTYPE*>	objects;
+
+	for ( UINT32 uiSlot = 0; uiSlot < guiNumMercSlots; ++uiSlot )
+	{
+		SOLDIERTYPE *pSoldier = MercSlots[ uiSlot ];
+
+		if ( pSoldier == NULL )
+			continue;
+
+		for ( INT8 bSlot = HANDPOS; bSlot <= SECONDHANDPOS; ++bSlot )
+		{
+			if ( pSoldier->inv[ bSlot ].exists() && ( Item[ pSoldier->inv[ bSlot ].usItem ].usItemClass & IC_GUN ) )
+			{
+				soldiers.push_back( pSoldier );
+				objects.push_back( &pSoldier->inv[ bSlot ] );
+			}
+		}
+	}
+
+	if ( objects.empty() )
+	{
+		ScreenMsg( FONT_MCOLOR_LTYELLOW, MSG_INTERFACE, L"No guns in hand in this sector." );
+		return;
+	}
+
+	for ( UINT8 ubPass = 0; ubPass < 3; ++ubPass )
+	{
+		gGameExternalOptions.ubItemStatsCache = ( ubPass == 0 ) ? 0 : 1;
+		InvalidateObjectStats();
+		iChecksum[ ubPass ] = 0;
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		for ( UINT32 uiRound = 0; uiRound < 1000; ++uiRound )
+		{
+			if ( ubPass == 2 )
+				InvalidateObjectStats();
+
+			for ( size_t cnt = 0; cnt < objects.size(); ++cnt )
+			{
+				OBJECTTYPE *pObj = objects[ cnt ];
+				FLOAT dRecoilX, dRecoilY;
+
+				for ( UINT8 ubType = 0; ubType < ITEMMODIFIER_MAX; ++ubType )
+				{
+					for ( UINT8 ubStance = 0; ubStance < 3; ++ubStance )
+						iChecksum[ ubPass ] += GetObjectModifier( soldiers[ cnt ], pObj, bStances[ ubStance ], ubType );
+				}
+
+				GetFlatRecoilModifier( pObj, &dRecoilX, &dRecoilY );
+				iChecksum[ ubPass ] += (INT64)( dRecoilX * 1000 ) + (INT64)( dRecoilY * 1000 );
+				GetAttachmentFlatRecoilModifier( pObj, &dRecoilX, &dRecoilY );
+				iChecksum[ ubPass ] += (INT64)( dRecoilX * 1000 ) + (INT64)( dRecoilY * 1000 );
+				iChecksum[ ubPass ] += GetPercentRecoilModifier( pObj ) + GetAttachmentPercentRecoilModifier( pObj );
+				iChecksum[ ubPass ] += GetAimBonus( soldiers[ cnt ], pObj, 20 * CELL_X_SIZE, 1 );
+				iChecksum[ ubPass ] += GetToHitBonus( pObj, 20 * CELL_X_SIZE, NORMAL_LIGHTLEVEL_DAY );
+			}
+		}
+
+		uiMicroseconds[ ubPass ] = (UINT32)std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - start ).count();
+	}
+
+	gGameExternalOptions.ubItemStatsCache = ubOrigItemStatsCache;
+	InvalidateObjectStats();
+
+	ScreenMsg( FONT_MCOLOR_LTYELLOW, MSG_INTERFACE, L"Object stats, %d guns x 1000 rounds: no cache %d us, cache %d us, invalidated every round %d us.",
+				(UINT32)objects.size(), uiMicroseconds[0], uiMicroseconds[1], uiMicroseconds[2] );
+	ScreenMsg( FONT_MCOLOR_LTYELLOW, MSG_INTERFACE, L"Object stats: %s.",
+				( iChecksum[0] == iChecksum[1] && iChecksum[0] == iChecksum[2] ) ? L"same answers with and without the cache" : L"ANSWERS DIFFER WITH THE CACHE" );
+}
 #endif // JA2TESTVERSION
 
 
@@ -10480,6 +10591,23 @@ INT16 GetItemAimBonus( const INVTYPE* pItem, INT32 iRange, INT16 ubAimTime )
 	return(bonus);
 }
 
+// aim bonus of the ammo and attachments
+static INT16 SumAttachmentAimBonus( OBJECTTYPE * pObj, INT32 iRange, INT16 ubAimTime )
+{
+	INT16 bonus = GetItemAimBonus( &Item[(*pObj)[0]->data.gun.usGunAmmoItem], iRange, ubAimTime );
+
+	attachmentList::iterator iterend = (*pObj)[0]->attachments.end();
+	for (attachmentList::iterator iter = (*pObj)[0]->attachments.begin(); iter != iterend; ++iter) 
+	{
+		if(iter->exists() && (!gGameExternalOptions.fScopeModes || !IsAttachmentClass(iter->usItem, AC_SCOPE|AC_SIGHT|AC_IRONSIGHT ) ) )
+		{
+			bonus += BonusReduceMore( GetItemAimBonus( &Item[iter->usItem], iRange, ubAimTime ), (*iter)[0]->data.objectStatus );
+		}
+	}
+
+	return( bonus );
+}
+
 INT16 GetAimBonus( SOLDIERTYPE * pSoldier, OBJECTTYPE * pObj, INT32 iRange, INT16 ubAimTime )
 {
 	INT16 bonus = 0;
@@ -10499,15 +10627,22 @@ INT16 GetAimBonus( SOLDIERTYPE * pSoldier, OBJECTTYPE * pObj, INT32 iRange, INT1
 		else
 			bonus = BonusReduceMore( GetItemAimBonus( &Item[pObj->usItem], iRange, ubAimTime ), (*pObj)[0]->data.objectStatus );
 
-		bonus += GetItemAimBonus( &Item[(*pObj)[0]->data.gun.usGunAmmoItem], iRange, ubAimTime );
-
-		attachmentList::iterator iterend = (*pObj)[0]->attachments.end();
-		for (attachmentList::iterator iter = (*pObj)[0]->attachments.begin(); iter != iterend; ++iter) 
+		OBJECT_STATS_CACHE* pCache = GetObjectStatsCache( pObj );
+		if ( pCache == NULL )
+			bonus += SumAttachmentAimBonus( pObj, iRange, ubAimTime );
+		else
 		{
-			if(iter->exists() && (!gGameExternalOptions.fScopeModes || !IsAttachmentClass(iter->usItem, AC_SCOPE|AC_SIGHT|AC_IRONSIGHT ) ) )
+			if ( !pCache->fAimBonus || pCache->iAimRange != iRange || pCache->sAimTime != ubAimTime )
 			{
-				bonus += BonusReduceMore( GetItemAimBonus( &Item[iter->usItem], iRange, ubAimTime ), (*iter)[0]->data.objectStatus );
+				pCache->sAimBonus = SumAttachmentAimBonus( pObj, iRange, ubAimTime );
+				pCache->iAimRange = iRange;
+				pCache->sAimTime = ubAimTime;
+				pCache->fAimBonus = TRUE;
 			}
+			else
+				VerifyObjectStat( pObj, L"aim bonus", pCache->sAimBonus, SumAttachmentAimBonus( pObj, iRange, ubAimTime ) );
+
+			bonus += pCache->sAimBonus;
 		}
 	}
 
@@ -10659,6 +10794,23 @@ INT16 LaserBonus( const INVTYPE * pItem, INT32 iRange, UINT8 bLightLevel )
 	}
 }
 
+// to hit bonus of the attachments
+static INT16 SumAttachmentToHitBonus( OBJECTTYPE * pObj, INT32 iRange, UINT8 bLightLevel, BOOLEAN fProneStance )
+{
+	INT16 bonus=0;
+
+	for (attachmentList::iterator iter = (*pObj)[0]->attachments.begin(); iter != (*pObj)[0]->attachments.end(); ++iter) {
+		if(iter->exists()){
+			if ( fProneStance )
+				bonus += Item[iter->usItem].bipod;
+
+			bonus += BonusReduceMore( LaserBonus( &Item[iter->usItem], iRange, bLightLevel), (*iter)[0]->data.objectStatus );
+		}
+	}
+
+	return( bonus );
+}
+
 INT16 GetToHitBonus( OBJECTTYPE * pObj, INT32 iRange, UINT8 bLightLevel, BOOLEAN fProneStance )
 {
 	INT16 bonus=0;
@@ -10672,13 +10824,23 @@ INT16 GetToHitBonus( OBJECTTYPE * pObj, INT32 iRange, UINT8 bLightLevel, BOOLEAN
 		bonus += BonusReduceMore( LaserBonus( &Item[pObj->usItem], iRange, bLightLevel), (*pObj)[0]->data.objectStatus );
 		bonus += Item[(*pObj)[0]->data.gun.usGunAmmoItem].tohitbonus;
 
-		for (attachmentList::iterator iter = (*pObj)[0]->attachments.begin(); iter != (*pObj)[0]->attachments.end(); ++iter) {
-			if(iter->exists()){
-				if ( fProneStance )
-					bonus += Item[iter->usItem].bipod;
-
-				bonus += BonusReduceMore( LaserBonus( &Item[iter->usItem], iRange, bLightLevel), (*iter)[0]->data.objectStatus );
+		OBJECT_STATS_CACHE* pCache = GetObjectStatsCache( pObj );
+		if ( pCache == NULL )
+			bonus += SumAttachmentToHitBonus( pObj, iRange, bLightLevel, fProneStance );
+		else
+		{
+			if ( !pCache->fToHitBonus || pCache->iToHitRange != iRange || pCache->bToHitLightLevel != bLightLevel || pCache->fToHitProne != fProneStance )
+			{
+				pCache->sToHitBonus = SumAttachmentToHitBonus( pObj, iRange, bLightLevel, fProneStance );
+				pCache->iToHitRange = iRange;
+				pCache->bToHitLightLevel = bLightLevel;
+				pCache->fToHitProne = fProneStance;
+				pCache->fToHitBonus = TRUE;
 			}
+			else
+				VerifyObjectStat( pObj, L"to hit bonus", pCache->sToHitBonus, SumAttachmentToHitBonus( pObj, iRange, bLightLevel, fProneStance ) );
+
+			bonus += pCache->sToHitBonus;
 		}
 	}
 
@@ -10741,6 +10903,40 @@ INT32 GetItemModifier(OBJECTTYPE* pObj, UINT8 ubRef, UINT8 usType)
 	return iModifier;
 }
 
+// modifier of the object and its attachments, without the scope mode
+static INT32 SumObjectModifier( OBJECTTYPE *pObj, UINT8 ubRef, UINT8 usType, BOOLEAN fSkipScopes )
+{
+	INT32 iModifier=0;
+
+	// simply add the object modifier
+	iModifier += GetItemModifier( pObj, ubRef, usType);
+
+	// silversurfer: add stance based max counter force modifier here and not in function GetItemModifier() because 
+	// that function is called for everything including attachments multiple times giving an insane bonus to max counter force modifier.
+	// An attachment that provides such bonus is not affected by this change. This stance based modifier only applies to guns.
+	if( usType == ITEMMODIFIER_COUNTERFORCEMAX && Item[pObj->usItem].usItemClass & IC_GUN )
+	{
+		if(ubRef == 1)
+			iModifier += (INT32)gGameCTHConstants.RECOIL_MAX_COUNTER_CROUCH;
+		else if (ubRef == 2)
+			iModifier += (INT32)gGameCTHConstants.RECOIL_MAX_COUNTER_PRONE;
+	}
+
+	for (attachmentList::iterator iter = (*pObj)[0]->attachments.begin(); iter != (*pObj)[0]->attachments.end(); ++iter)
+	{
+		if( iter->exists() )
+		{
+			// Flugente: if we use scope modes, are a soldier, this is a gun and the attachment a scope/sight, ignore it for the moment
+			if ( fSkipScopes && IsAttachmentClass(iter->usItem, (AC_SCOPE|AC_SIGHT|AC_IRONSIGHT) ) )
+				continue;
+
+			iModifier += GetItemModifier( (&(*iter)), ubRef, usType);
+		}
+	}
+
+	return (iModifier);
+}
+
 // Flugente: unified function (no need to have 12 functions that all do the same thing and clutter the code)
 INT32 GetObjectModifier( SOLDIERTYPE* pSoldier, OBJECTTYPE *pObj, UINT8 ubStance, UINT8 usType )
 {
@@ -10750,34 +10946,27 @@ INT32 GetObjectModifier( SOLDIERTYPE* pSoldier, OBJECTTYPE *pObj, UINT8 ubStance
 		
 	if (pObj->exists() )
 	{
-		// simply add the object modifier
-		iModifier += GetItemModifier( pObj, ubRef, usType);
-
-		// silversurfer: add stance based max counter force modifier here and not in function GetItemModifier() because 
-		// that function is called for everything including attachments multiple times giving an insane bonus to max counter force modifier.
-		// An attachment that provides such bonus is not affected by this change. This stance based modifier only applies to guns.
-		if( usType == ITEMMODIFIER_COUNTERFORCEMAX && Item[pObj->usItem].usItemClass & IC_GUN )
-		{
-			if(ubRef == 1)
-				iModifier += (INT32)gGameCTHConstants.RECOIL_MAX_COUNTER_CROUCH;
-			else if (ubRef == 2)
-				iModifier += (INT32)gGameCTHConstants.RECOIL_MAX_COUNTER_PRONE;
-		}
+		BOOLEAN fSkipScopes = ( gGameExternalOptions.fScopeModes && pSoldier && Item[pObj->usItem].usItemClass & IC_GUN );
 
-		for (attachmentList::iterator iter = (*pObj)[0]->attachments.begin(); iter != (*pObj)[0]->attachments.end(); ++iter)
+		OBJECT_STATS_CACHE* pCache = GetObjectStatsCache( pObj );
+		if ( pCache == NULL || usType >= ITEMMODIFIER_MAX )
+			iModifier += SumObjectModifier( pObj, ubRef, usType, fSkipScopes );
+		else
 		{
-			if( iter->exists() )
+			INT32* piCached = &pCache->iModifier[usType][ubRef][fSkipScopes];
+			if ( !( pCache->uiModifierValid[ubRef][fSkipScopes] & ( 1 << usType ) ) )
 			{
-				// Flugente: if we use scope modes, are a soldier, this is a gun and the attachment a scope/sight, ignore it for the moment
-				if ( gGameExternalOptions.fScopeModes && pSoldier && Item[pObj->usItem].usItemClass & IC_GUN && IsAttachmentClass(iter->usItem, (AC_SCOPE|AC_SIGHT|AC_IRONSIGHT) ) )
-					continue;
-
-				iModifier += GetItemModifier( (&(*iter)), ubRef, usType);
+				*piCached = SumObjectModifier( pObj, ubRef, usType, fSkipScopes );
+				pCache->uiModifierValid[ubRef][fSkipScopes] |= ( 1 << usType );
 			}
+			else
+				VerifyObjectStat( pObj, L"modifier", (FLOAT)*piCached, (FLOAT)SumObjectModifier( pObj, ubRef, usType, fSkipScopes ) );
+
+			iModifier += *piCached;
 		}
 
 		// Flugente::if we are a soldier and are using a gun, we might be checking for scope modes
-		if ( gGameExternalOptions.fScopeModes && pSoldier && Item[pObj->usItem].usItemClass & IC_GUN )
+		if ( fSkipScopes )
 		{
 			// only apply boni if we are not hip-firing
 			if ( pSoldier->bScopeMode != USE_ALT_WEAPON_HOLD )
@@ -10936,56 +11125,108 @@ void GetBaseFlatRecoilModifier( OBJECTTYPE *pObj, FLOAT *bRecoilModifierX, FLOAT
 	*bRecoilModifierX = bRecoilAdjustX;
 	*bRecoilModifierY = bRecoilAdjustY;
 }
+static void SumAttachmentFlatRecoilModifier( OBJECTTYPE *pObj, FLOAT *bRecoilAdjustX, FLOAT *bRecoilAdjustY )
+{
+	*bRecoilAdjustX = 0;
+	*bRecoilAdjustY = 0;
+
+	// Attachment item modifiers
+	for (attachmentList::iterator iter = (*pObj)[0]->attachments.begin(); iter != (*pObj)[0]->attachments.end(); ++iter)
+	{
+		if (iter->exists())
+		{
+			*bRecoilAdjustX += BonusReduceMoreFloat( Item[iter->usItem].RecoilModifierX, (*iter)[0]->data.objectStatus );
+			*bRecoilAdjustY += BonusReduceMoreFloat( Item[iter->usItem].RecoilModifierY, (*iter)[0]->data.objectStatus );
+		}
+	}
+}
 void GetAttachmentFlatRecoilModifier( OBJECTTYPE *pObj, FLOAT *bRecoilModifierX, FLOAT *bRecoilModifierY )
 {
 	FLOAT bRecoilAdjustX = 0;
 	FLOAT bRecoilAdjustY = 0;
 	if (pObj->exists() == true && UsingNewCTHSystem() == true)
 	{
-		// Attachment item modifiers
-		for (attachmentList::iterator iter = (*pObj)[0]->attachments.begin(); iter != (*pObj)[0]->attachments.end(); ++iter)
+		OBJECT_STATS_CACHE* pCache = GetObjectStatsCache( pObj );
+		if ( pCache == NULL )
+			SumAttachmentFlatRecoilModifier( pObj, &bRecoilAdjustX, &bRecoilAdjustY );
+		else
 		{
-			if (iter->exists())
+			if ( !pCache->fAttachmentFlatRecoil )
 			{
-				bRecoilAdjustX += BonusReduceMoreFloat( Item[iter->usItem].RecoilModifierX, (*iter)[0]->data.objectStatus );
-				bRecoilAdjustY += BonusReduceMoreFloat( Item[iter->usItem].RecoilModifierY, (*iter)[0]->data.objectStatus );
+				SumAttachmentFlatRecoilModifier( pObj, &pCache->dAttachmentFlatRecoilX, &pCache->dAttachmentFlatRecoilY );
+				pCache->fAttachmentFlatRecoil = TRUE;
 			}
+			else if ( gGameExternalOptions.ubItemStatsCache == 2 )
+			{
+				SumAttachmentFlatRecoilModifier( pObj, &bRecoilAdjustX, &bRecoilAdjustY );
+				VerifyObjectStat( pObj, L"recoil x", pCache->dAttachmentFlatRecoilX, bRecoilAdjustX );
+				VerifyObjectStat( pObj, L"recoil y", pCache->dAttachmentFlatRecoilY, bRecoilAdjustY );
+			}
+
+			bRecoilAdjustX = pCache->dAttachmentFlatRecoilX;
+			bRecoilAdjustY = pCache->dAttachmentFlatRecoilY;
 		}
 	}
 
 	*bRecoilModifierX += bRecoilAdjustX;
 	*bRecoilModifierY += bRecoilAdjustY;
 }
-void GetFlatRecoilModifier( OBJECTTYPE *pObj, FLOAT *bRecoilModifierX, FLOAT *bRecoilModifierY )
+static void SumFlatRecoilModifier( OBJECTTYPE *pObj, FLOAT *bRecoilModifierX, FLOAT *bRecoilModifierY )
 {
-
 	FLOAT bRecoilAdjustX = 0;
 	FLOAT bRecoilAdjustY = 0;
 
-	if (pObj->exists() == true && UsingNewCTHSystem() == true)
-	{
-		// Inherent item modifiers
-		bRecoilAdjustX += BonusReduceMoreFloat( Item[pObj->usItem].RecoilModifierX, (*pObj)[0]->data.objectStatus );
-		bRecoilAdjustY += BonusReduceMoreFloat( Item[pObj->usItem].RecoilModifierY, (*pObj)[0]->data.objectStatus );
+	// Inherent item modifiers
+	bRecoilAdjustX += BonusReduceMoreFloat( Item[pObj->usItem].RecoilModifierX, (*pObj)[0]->data.objectStatus );
+	bRecoilAdjustY += BonusReduceMoreFloat( Item[pObj->usItem].RecoilModifierY, (*pObj)[0]->data.objectStatus );
 
-		// Ammo item modifiers
-		bRecoilAdjustX += Item[(*pObj)[0]->data.gun.usGunAmmoItem].RecoilModifierX;
-		bRecoilAdjustY += Item[(*pObj)[0]->data.gun.usGunAmmoItem].RecoilModifierY;
+	// Ammo item modifiers
+	bRecoilAdjustX += Item[(*pObj)[0]->data.gun.usGunAmmoItem].RecoilModifierX;
+	bRecoilAdjustY += Item[(*pObj)[0]->data.gun.usGunAmmoItem].RecoilModifierY;
 
-		// Attachment item modifiers
-		for (attachmentList::iterator iter = (*pObj)[0]->attachments.begin(); iter != (*pObj)[0]->attachments.end(); ++iter)
+	// Attachment item modifiers
+	for (attachmentList::iterator iter = (*pObj)[0]->attachments.begin(); iter != (*pObj)[0]->attachments.end(); ++iter)
+	{
+		if (iter->exists())
 		{
-			if (iter->exists())
-			{
-				bRecoilAdjustX += BonusReduceMoreFloat( Item[iter->usItem].RecoilModifierX, (*iter)[0]->data.objectStatus );
-				bRecoilAdjustY += BonusReduceMoreFloat( Item[iter->usItem].RecoilModifierY, (*iter)[0]->data.objectStatus );
-			}
+			bRecoilAdjustX += BonusReduceMoreFloat( Item[iter->usItem].RecoilModifierX, (*iter)[0]->data.objectStatus );
+			bRecoilAdjustY += BonusReduceMoreFloat( Item[iter->usItem].RecoilModifierY, (*iter)[0]->data.objectStatus );
 		}
 	}
 
 	*bRecoilModifierX = bRecoilAdjustX;
 	*bRecoilModifierY = bRecoilAdjustY;
 }
+void GetFlatRecoilModifier( OBJECTTYPE *pObj, FLOAT *bRecoilModifierX, FLOAT *bRecoilModifierY )
+{
+	*bRecoilModifierX = 0;
+	*bRecoilModifierY = 0;
+
+	if (pObj->exists() == true && UsingNewCTHSystem() == true)
+	{
+		OBJECT_STATS_CACHE* pCache = GetObjectStatsCache( pObj );
+		if ( pCache == NULL )
+		{
+			SumFlatRecoilModifier( pObj, bRecoilModifierX, bRecoilModifierY );
+			return;
+		}
+
+		if ( !pCache->fFlatRecoil )
+		{
+			SumFlatRecoilModifier( pObj, &pCache->dFlatRecoilX, &pCache->dFlatRecoilY );
+			pCache->fFlatRecoil = TRUE;
+		}
+		else if ( gGameExternalOptions.ubItemStatsCache == 2 )
+		{
+			SumFlatRecoilModifier( pObj, bRecoilModifierX, bRecoilModifierY );
+			VerifyObjectStat( pObj, L"recoil x", pCache->dFlatRecoilX, *bRecoilModifierX );
+			VerifyObjectStat( pObj, L"recoil y", pCache->dFlatRecoilY, *bRecoilModifierY );
+		}
+
+		*bRecoilModifierX = pCache->dFlatRecoilX;
+		*bRecoilModifierY = pCache->dFlatRecoilY;
+	}
+}
 
 ///////////////////////////////////////////////////////////////////
 // HEADROCK HAM 4: This calculates the percentile recoil adjustment of a gun.
@@ -11007,19 +11248,39 @@ INT16 GetBasePercentRecoilModifier( OBJECTTYPE *pObj)
 
 	return (sRecoilAdjust);
 }
+static INT16 SumAttachmentPercentRecoilModifier( OBJECTTYPE *pObj )
+{
+	INT16 sRecoilAdjust = 0;
+
+	for (attachmentList::iterator iter = (*pObj)[0]->attachments.begin(); iter != (*pObj)[0]->attachments.end(); ++iter)
+	{
+		if (iter->exists())
+		{
+			sRecoilAdjust += BonusReduceMore( Item[iter->usItem].PercentRecoilModifier, (*iter)[0]->data.objectStatus );
+		}
+	}
+
+	return (sRecoilAdjust);
+}
 INT16 GetAttachmentPercentRecoilModifier( OBJECTTYPE *pObj)
 {
 	INT16 sRecoilAdjust = 0;
 
 	if (pObj->exists() == true && UsingNewCTHSystem() == true)
 	{
-		for (attachmentList::iterator iter = (*pObj)[0]->attachments.begin(); iter != (*pObj)[0]->attachments.end(); ++iter)
+		OBJECT_STATS_CACHE* pCache = GetObjectStatsCache( pObj );
+		if ( pCache == NULL )
+			return( SumAttachmentPercentRecoilModifier( pObj ) );
+
+		if ( !pCache->fAttachmentPercentRecoil )
 		{
-			if (iter->exists())
-			{
-				sRecoilAdjust += BonusReduceMore( Item[iter->usItem].PercentRecoilModifier, (*iter)[0]->data.objectStatus );
-			}
+			pCache->sAttachmentPercentRecoil = SumAttachmentPercentRecoilModifier( pObj );
+			pCache->fAttachmentPercentRecoil = TRUE;
 		}
+		else
+			VerifyObjectStat( pObj, L"recoil", pCache->sAttachmentPercentRecoil, SumAttachmentPercentRecoilModifier( pObj ) );
+
+		sRecoilAdjust = pCache->sAttachmentPercentRecoil;
 	}
 
 	return (sRecoilAdjust);
@@ -11038,13 +11299,7 @@ INT16 GetPercentRecoilModifier( OBJECTTYPE *pObj )
 		sRecoilAdjust += Item[(*pObj)[0]->data.gun.usGunAmmoItem].PercentRecoilModifier;
 
 		// Attachment item modifiers
-		for (attachmentList::iterator iter = (*pObj)[0]->attachments.begin(); iter != (*pObj)[0]->attachments.end(); ++iter)
-		{
-			if (iter->exists())
-			{
-				sRecoilAdjust += BonusReduceMore( Item[iter->usItem].PercentRecoilModifier, (*iter)[0]->data.objectStatus );
-			}
-		}
+		sRecoilAdjust += GetAttachmentPercentRecoilModifier( pObj );
 	}
 
 	sRecoilAdjust = __max(-100, sRecoilAdjust);
@@ -12621,14 +12876,33 @@ INT8 FindRemoteControl( SOLDIERTYPE * pSoldier )
 	return( NO_SLOT );
 }
 
+// launchables that ValidLaunchable() accepts for this launcher, in item number order
+static void GetValidLaunchables( UINT16 launcherIndex, std::vector<UINT16>& launchables )
+{
+	const std::vector<UINT32>& rows = GetLaunchableRowsOfLauncher( launcherIndex );
+
+	launchables.clear();
+	for ( size_t i = 0; i < rows.size(); ++i )
+	{
+		if ( Launchable[rows[i]][0] < gMAXITEMS_READ && ValidLaunchable( Launchable[rows[i]][0], launcherIndex ) )
+			launchables.push_back( Launchable[rows[i]][0] );
+	}
+
+	std::sort( launchables.begin(), launchables.end() );
+	launchables.erase( std::unique( launchables.begin(), launchables.end() ), launchables.end() );
+}
+
 UINT16 LowestLaunchableCoolness(UINT16 launcherIndex)
 {
-	UINT16 i = 0;
 	UINT16 lowestCoolness = 999;
+	std::vector<UINT16> launchables;
 
-	for ( i = 0; i < gMAXITEMS_READ; ++i )
+	GetValidLaunchables( launcherIndex, launchables );
+	for ( size_t j = 0; j < launchables.size(); ++j )
 	{
-		if( ValidLaunchable( i, launcherIndex ) && ItemIsLegal(i) && Item[i].ubCoolness <= lowestCoolness )
+		UINT16 i = launchables[j];
+
+		if( ItemIsLegal(i) && Item[i].ubCoolness <= lowestCoolness )
 		{
 			lowestCoolness = Item[i].ubCoolness;
 		}
@@ -12647,13 +12921,18 @@ UINT16 PickARandomLaunchable(UINT16 itemIndex)
 	UINT16 maxcoolness = max( HighestPlayerProgressPercentage() / 10, lowestCoolness );
 
 	std::vector<UINT16> legalvec;
-	for ( UINT16 i = 0; i < gMAXITEMS_READ; ++i )
+	std::vector<UINT16> launchables;
+
+	GetValidLaunchables( itemIndex, launchables );
+	for ( size_t j = 0; j < launchables.size(); ++j )
 	{
-		if ( Item[i].usItemClass == 0 )
+		UINT16 i = launchables[j];
+
+		if ( i >= GetItemIndexEnd() )
 			break;
 
 		//Madd: quickfix: make it not choose best grenades right away.
-		if ( Item[i].ubCoolness <= maxcoolness && ItemIsLegal( i ) && ValidLaunchable( i, itemIndex ) )
+		if ( Item[i].ubCoolness <= maxcoolness && ItemIsLegal( i ) )
 		{
 			// Flugente: ignore this item if we aren't allowed to pick it at this time of day
 			if ( (isnight && Item[i].usItemChoiceTimeSetting == 1) || (!isnight && Item[i].usItemChoiceTimeSetting == 2) )
@@ -13023,13 +13302,30 @@ void ApplyEquipmentBonuses(SOLDIERTYPE * pSoldier)
 
 UINT16 GetFirstExplosiveOfType(UINT16 expType)
 {
-	for ( int i = 0; i<gMAXITEMS_READ; ++i )
+	const std::vector<UINT16>& explosives = GetItemsOfClass( IC_EXPLOSV );
+	const std::vector<UINT16>& grenades = GetItemsOfClass( IC_GRENADE );
+	UINT16 usFirst = 0;
+
+	// both lists are sorted, so the first match of each is a candidate
+	for ( size_t i = 0; i < explosives.size(); ++i )
 	{
-		if ( Item[i].usItemClass & (IC_EXPLOSV | IC_GRENADE) && Explosive[Item[i].ubClassIndex].ubType == expType )
-			return i;
+		if ( Explosive[Item[explosives[i]].ubClassIndex].ubType == expType )
+		{
+			usFirst = explosives[i];
+			break;
+		}
 	}
 
-	return 0;
+	for ( size_t i = 0; i < grenades.size() && ( !usFirst || grenades[i] < usFirst ); ++i )
+	{
+		if ( Explosive[Item[grenades[i]].ubClassIndex].ubType == expType )
+		{
+			usFirst = grenades[i];
+			break;
+		}
+	}
+
+	return usFirst;
 }
 
 // sevenfm: same as GetFirstExplosiveOfType, but check only hand grenades
@@ -14611,6 +14907,7 @@ BOOLEAN HasExtendedEarOn( SOLDIERTYPE * pSoldier )
 
 BOOLEAN UseTotalMedicalKitPoints( SOLDIERTYPE * pSoldier, UINT16 usPointsToConsume )
 {
+	ObjectStatsChange statsChange;
 	OBJECTTYPE * pObj;
 	UINT8 ubPocket;
 	INT8 bLoop;
@@ -14899,6 +15196,7 @@ extern void HandleSight(SOLDIERTYPE *pSoldier, UINT8 ubSightFlags);
 
 BOOLEAN OBJECTTYPE::TransformObject( SOLDIERTYPE * pSoldier, UINT8 ubStatusIndex, TransformInfoStruct * Transform, OBJECTTYPE *pParent )
 {
+	ObjectStatsChange statsChange;
 	// The argument "Transform" is a pointer to an entry in the Transformation Data array. By looking at the pointer we
 	// can determine all the data we need. Therefore, this pointer must not be null!
 	AssertMsg( Transform != NULL, String( "OBJECTTYPE::TransformObject attempt with invalid Transformation data." ) );
@@ -16040,13 +16338,39 @@ BOOLEAN CanDelayGrenadeExplosion( UINT16 usItem )
 	return TRUE;
 }
 
+// Items that might be valid attachments for usItem, in item number order. The caller still has to check them
+// with ValidAttachment(), this only narrows down which items to look at.
+static void GetPossibleAttachments( UINT16 usItem, std::vector<UINT16>& attachments )
+{
+	const std::vector<UINT32>& rows = GetAttachmentRowsOfItem( usItem );
+
+	GetItemsOnAttachmentPoints( Item[usItem].ulAvailableAttachmentPoint, attachments );
+
+	for ( size_t i = 0; i < rows.size(); ++i )
+		attachments.push_back( Attachment[rows[i]].attachmentIndex );
+
+	//Madd: all guns can be attached to tripwires
+	if ( ItemIsTripwire( usItem ) )
+	{
+		const std::vector<UINT16>& guns = GetItemsOfClass( IC_GUN );
+		attachments.insert( attachments.end(), guns.begin(), guns.end() );
+	}
+
+	std::sort( attachments.begin(), attachments.end() );
+	attachments.erase( std::unique( attachments.begin(), attachments.end() ), attachments.end() );
+}
+
 FLOAT GetBestScopeMagFactorForGun(UINT16 ausItemGun)
 {
 	FLOAT bestscopemagfactor = 1.0f;
+	std::vector<UINT16> attachments;
 
-	for ( UINT16 usItem = 1; usItem < gMAXITEMS_READ; ++usItem )
+	GetPossibleAttachments( ausItemGun, attachments );
+	for ( size_t i = 0; i < attachments.size(); ++i )
 	{
-		if ( ValidAttachment( usItem, ausItemGun )  )
+		UINT16 usItem = attachments[i];
+
+		if ( usItem >= 1 && usItem < gMAXITEMS_READ && ValidAttachment( usItem, ausItemGun )  )
 		{
 			if ( bestscopemagfactor < Item[usItem].scopemagfactor )
 				bestscopemagfactor = Item[usItem].scopemagfactor;
@@ -16058,9 +16382,14 @@ FLOAT GetBestScopeMagFactorForGun(UINT16 ausItemGun)
 
 bool HasScopeMagFactorForGun( UINT16 ausItemGun, FLOAT aFactor )
 {
-	for ( UINT16 usItem = 1; usItem < gMAXITEMS_READ; ++usItem )
+	std::vector<UINT16> attachments;
+
+	GetPossibleAttachments( ausItemGun, attachments );
+	for ( size_t i = 0; i < attachments.size(); ++i )
 	{
-		if ( ValidAttachment( usItem, ausItemGun ) )
+		UINT16 usItem = attachments[i];
+
+		if ( usItem >= 1 && usItem < gMAXITEMS_READ && ValidAttachment( usItem, ausItemGun ) )
 		{
 			if ( std::fabs( Item[usItem].scopemagfactor - aFactor ) < 0.1 )
 				return true;
@@ -16072,18 +16401,14 @@ bool HasScopeMagFactorForGun( UINT16 ausItemGun, FLOAT aFactor )
 
 UINT16 GetLaunchableOfExplosionType(UINT16 launcher, UINT8 explosionType)
 {
-	for (int i = 0; i < MAXITEMS; i++)
-	{
-		UINT16 launchable = Launchable[i][0];
+	const std::vector<UINT32>& rows = GetLaunchableRowsOfLauncher(launcher);
 
-		if (launchable == 0)  // if reached end of Launchable list, then stop
-			break;
+	for (size_t i = 0; i < rows.size(); i++)
+	{
+		UINT16 launchable = Launchable[rows[i]][0];
 
-		if (Launchable[i][1] == launcher)
-		{
-			if (Explosive[Item[launchable].ubClassIndex].ubType == explosionType)
-				return launchable;
-		}
+		if (Explosive[Item[launchable].ubClassIndex].ubType == explosionType)
+			return launchable;
 	}
 	return NOTHING;
 }
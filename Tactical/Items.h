@@ -62,6 +62,25 @@ void CleanUpItemStats( OBJECTTYPE * pObj );
 //Returns true if swapped, false if added to end of stack
 extern BOOLEAN PlaceObjectAtObjectIndex( OBJECTTYPE * pSourceObj, OBJECTTYPE * pTargetObj, UINT8 ubIndex, UINT32 ubCap );
 
+// Bonuses worked out from an object and its attachments are kept with the object if ITEM_STATS_CACHE is on, until
+// this is called. The cache doesn't look at the object again, so call this after changing an attachment, the status
+// of an object or of anything attached, or the ammo loaded, other than through functions that already do.
+void InvalidateObjectStats( void );
+
+// Put at the top of a function that changes objects: calls InvalidateObjectStats() when the function returns, after
+// the changes, whichever way it leaves
+class ObjectStatsChange
+{
+public:
+	ObjectStatsChange()		{}
+	~ObjectStatsChange()	{ InvalidateObjectStats(); }
+};
+
+#ifdef JA2TESTVERSION
+// times the stats NCTH asks about the guns in hand with the stats cache off and on
+void BenchmarkObjectStatsCache( void );
+#endif
+
 UINT16 CalculateAmmoWeight( UINT16 usGunAmmoItem, UINT16 ubShotsLeft );
 UINT16	CalculateObjectWeight( OBJECTTYPE *pObject );
 UINT32 GetTotalWeight( SOLDIERTYPE* pSoldier );
@@ -2212,6 +2212,96 @@ BOOLEAN CalculateSoldierZPos( SOLDIERTYPE * pSoldier, UINT8 ubPosType, FLOAT * p
 	return( TRUE );
 }
 
+// Sight cache
+// LineOfSightTest() only looks at the map (land height, structures, smoke and gas), so as long as the map doesn't
+// change, a ray between the same two points with the same limits always gives the same answer. Opponent list updates
+// ask the same questions over and over (every soldier against everyone else, whenever anyone moves), so
+// results are kept here until a structure or smoke cloud changes. Each end is identified by its gridno and eye/target
+// height, which covers level and stance; light and stealth only enter through the sight limit, which is part of the key.
+#define SIGHT_CACHE_SIZE				4096		// must be a power of 2
+
+typedef struct
+{
+	UINT32	uiGeneration;
+	INT32	sStartGridNo;
+	INT32	sEndGridNo;
+	FLOAT	dStartZ;
+	FLOAT	dEndZ;
+	INT32	iTileSightLimit;
+	INT8	bAware;
+	UINT8	ubFlags;
+	INT32	iResult;
+} SIGHT_CACHE_ENTRY;
+
+#define SIGHT_CACHE_SMELL				0x01
+#define SIGHT_CACHE_ADJUST_FOR_SIGHT	0x02
+#define SIGHT_CACHE_CTH_CALC			0x04
+
+static SIGHT_CACHE_ENTRY	gSightCache[ SIGHT_CACHE_SIZE ];
+static UINT32				guiSightCacheGeneration = 1;
+
+void InvalidateSightCache( void )
+{
+	// entries are only trusted if they were stored in the current generation
+	guiSightCacheGeneration++;
+}
+
+static INT32 CachedLineOfSightTest( INT32 sStartGridNo, FLOAT dStartZ, INT32 sEndGridNo, FLOAT dEndZ, int iTileSightLimit, INT8 bAware, BOOLEAN fSmell, bool adjustForSight, bool cthCalc )
+{
+	INT16		sX, sY, sX2, sY2;
+	UINT8		ubFlags = 0;
+	UINT32		uiHash;
+	SIGHT_CACHE_ENTRY *pEntry;
+
+	ConvertGridNoToCenterCellXY( sStartGridNo, &sX, &sY );
+	ConvertGridNoToCenterCellXY( sEndGridNo, &sX2, &sY2 );
+
+	// DISALLOW_SIGHT is checked first thing in LineOfSightTest(), don't let it end up in the cache
+	if ( !gGameExternalOptions.fSightCache || ( gTacticalStatus.uiFlags & DISALLOW_SIGHT ) )
+	{
+		return( LineOfSightTest( (FLOAT) sX, (FLOAT) sY, dStartZ, (FLOAT) sX2, (FLOAT) sY2, dEndZ, iTileSightLimit, bAware, fSmell, NULL, adjustForSight, cthCalc ) );
+	}
+
+	if ( fSmell )
+		ubFlags |= SIGHT_CACHE_SMELL;
+	if ( adjustForSight )
+		ubFlags |= SIGHT_CACHE_ADJUST_FOR_SIGHT;
+	if ( cthCalc )
+		ubFlags |= SIGHT_CACHE_CTH_CALC;
+
+	uiHash = (UINT32) sStartGridNo * 2654435761u;
+	uiHash ^= (UINT32) sEndGridNo * 40503u + ( uiHash >> 15 );
+	uiHash ^= (UINT32) ( dStartZ * 4 ) * 73u + (UINT32) ( dEndZ * 4 ) * 151u;
+	uiHash ^= (UINT32) iTileSightLimit * 31u + ubFlags + ( (UINT32) bAware << 3 );
+	uiHash ^= uiHash >> 13;
+
+	pEntry = &gSightCache[ uiHash & ( SIGHT_CACHE_SIZE - 1 ) ];
+
+	if ( pEntry->uiGeneration == guiSightCacheGeneration &&
+		 pEntry->sStartGridNo == sStartGridNo &&
+		 pEntry->sEndGridNo == sEndGridNo &&
+		 pEntry->dStartZ == dStartZ &&
+		 pEntry->dEndZ == dEndZ &&
+		 pEntry->iTileSightLimit == iTileSightLimit &&
+		 pEntry->bAware == bAware &&
+		 pEntry->ubFlags == ubFlags )
+	{
+		return( pEntry->iResult );
+	}
+
+	pEntry->iResult			= LineOfSightTest( (FLOAT) sX, (FLOAT) sY, dStartZ, (FLOAT) sX2, (FLOAT) sY2, dEndZ, iTileSightLimit, bAware, fSmell, NULL, adjustForSight, cthCalc );
+	pEntry->uiGeneration	= guiSightCacheGeneration;
+	pEntry->sStartGridNo	= sStartGridNo;
+	pEntry->sEndGridNo		= sEndGridNo;
+	pEntry->dStartZ			= dStartZ;
+	pEntry->dEndZ			= dEndZ;
+	pEntry->iTileSightLimit	= iTileSightLimit;
+	pEntry->bAware			= bAware;
+	pEntry->ubFlags			= ubFlags;
+
+	return( pEntry->iResult );
+}
+
 INT32 SoldierToSoldierLineOfSightTest( SOLDIERTYPE * pStartSoldier, SOLDIERTYPE * pEndSoldier, INT8 bAware, int iTileSightLimit, UINT8 ubAimLocation, bool adjustForSight, bool cthCalc )
 {
 	FLOAT			dStartZPos, dEndZPos;
@@ -2371,15 +2461,12 @@ INT32 SoldierToSoldierLineOfSightTest( SOLDIERTYPE * pStartSoldier, SOLDIERTYPE
 		UINT8  ubNumberOfTiles = pBase->pDBStructureRef->pDBStructure->ubNumberOfTiles;
 
 		INT32 sStructGridNo;
-		INT16 sX, sY, sX2, sY2;
-		ConvertGridNoToCenterCellXY(pStartSoldier->sGridNo, &sX, &sY);
 
 		// loop through all tiles
 		for (UINT8 ubLoop = BASE_TILE; ubLoop < ubNumberOfTiles; ubLoop++)
 		{
 			sStructGridNo = AddPosRelToBase(pBase->sGridNo, ppTile[ubLoop]);
-			ConvertGridNoToCenterCellXY(sStructGridNo, &sX2, &sY2);
-			if( LineOfSightTest( (FLOAT) sX, (FLOAT) sY, dStartZPos, (FLOAT) sX2, (FLOAT) sY2, dEndZPos, iTileSightLimit, bAware, fSmell, NULL, adjustForSight, cthCalc ) )
+			if( CachedLineOfSightTest( pStartSoldier->sGridNo, dStartZPos, sStructGridNo, dEndZPos, iTileSightLimit, bAware, fSmell, adjustForSight, cthCalc ) )
 			{
 				return( TRUE );
 			}
@@ -2387,11 +2474,7 @@ INT32 SoldierToSoldierLineOfSightTest( SOLDIERTYPE * pStartSoldier, SOLDIERTYPE
 		return( FALSE );
 	}
 
-	INT16 sX, sY, sX2, sY2;
-	ConvertGridNoToCenterCellXY(pStartSoldier->sGridNo, &sX, &sY);
-	ConvertGridNoToCenterCellXY(pEndSoldier->sGridNo, &sX2, &sY2);
-
-	return( LineOfSightTest( (FLOAT) sX, (FLOAT) sY, dStartZPos, (FLOAT) sX2, (FLOAT) sY2, dEndZPos, iTileSightLimit, bAware, fSmell, NULL, adjustForSight, cthCalc ) );
+	return( CachedLineOfSightTest( pStartSoldier->sGridNo, dStartZPos, pEndSoldier->sGridNo, dEndZPos, iTileSightLimit, bAware, fSmell, adjustForSight, cthCalc ) );
 	}
 
 INT32 SoldierToLocationWindowTest( SOLDIERTYPE * pStartSoldier, INT32 sEndGridNo )
@@ -3137,6 +3220,7 @@ BOOLEAN BulletHitMerc( BULLET * pBullet, STRUCTURE * pStructure, BOOLEAN fIntend
 		if (bHeadSlot != NO_SLOT)
 		{
 			pTarget->inv[ bHeadSlot ][0]->data.objectStatus -= (INT8) ( (iImpact / 2) + Random( (iImpact / 2) ) );
+			InvalidateObjectStats();
 			if ( pTarget->inv[ bHeadSlot ][0]->data.objectStatus <= USABLE )
 			{
 				if ( pTarget->inv[ bHeadSlot ][0]->data.objectStatus <= 0 )
@@ -3163,6 +3247,7 @@ BOOLEAN BulletHitMerc( BULLET * pBullet, STRUCTURE * pStructure, BOOLEAN fIntend
 
 			// Flugente: also lower the repair threshold
 			pTarget->inv[ bHeadSlot ][0]->data.sRepairThreshold = max(pTarget->inv[ bHeadSlot ][0]->data.objectStatus, pTarget->inv[ bHeadSlot ][0]->data.sRepairThreshold - iImpact / 6);
+			InvalidateObjectStats();
 		}
 	}
 
@@ -5924,6 +6009,7 @@ INT8 FireFragmentGivenTarget( SoldierID ubOwner, FLOAT dStartX, FLOAT dStartY, F
 // Flugente: fire a shot from a gun that has no user (used for traps with attached guns)
 INT8 FireBulletGivenTargetTrapOnly( SOLDIERTYPE* pThrower, OBJECTTYPE* pObj, INT32 gridno, FLOAT dStartZ, FLOAT dEndX, FLOAT dEndY, FLOAT dEndZ, INT16 sHitBy )
 {
+	ObjectStatsChange statsChange;
 	if ( !pObj )
 		return 0;
 
@@ -162,6 +162,10 @@ INT32 LocationToLocationLineOfSightTest( INT32 sStartGridNo, INT8 bStartLevel, I
 
 BOOLEAN CalculateSoldierZPos( SOLDIERTYPE * pSoldier, UINT8 ubPosType, FLOAT * pdZPos );
 
+// Soldier to soldier sight results are remembered (if SIGHT_CACHE is on) until something that can block a line of sight
+// changes: call this whenever a structure or smoke/gas cloud is added to or removed from the map.
+void InvalidateSightCache( void );
+
 #ifdef LOS_DEBUG
 typedef struct LOSResults
 {
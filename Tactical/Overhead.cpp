@@ -956,6 +956,7 @@ BOOLEAN ExecuteOverhead( )
     HandleExplosionQueue(); // BOMBS!!!
     HandleCreatureTenseQuote( );
     CheckHostileOrSayQuoteList();
+    HandleAnimationSurfacePrefetch(); // animations soldiers may need next
 
     if ( gfPauseAllAI && giPauseAllAITimer && ( iTimerVal - giPauseAllAITimer > PAUSE_ALL_AI_DELAY ) )
     {
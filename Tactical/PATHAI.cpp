@@ -36,6 +36,8 @@
 #include "BinaryHeap.hpp"
 #include "opplist.h"
 #include "Weapons.h"
+#include "PathClusters.h"
+#include "AIPathCache.h"
 
 //forward declarations of common classes to eliminate includes
 class OBJECTTYPE;
@@ -383,6 +385,7 @@ UINT16 gusNPCMovementMode;
 UINT8 gubNPCDistLimit = 0;
 BOOLEAN gfNPCCircularDistLimit = FALSE;
 UINT8	gubNPCPathCount;
+INT16	*gpsPathDistanceField = NULL;
 
 BOOLEAN gfPlotDirectPath = FALSE;
 BOOLEAN gfEstimatePath = FALSE;
@@ -1010,6 +1013,10 @@ void AStarPathfinder::ExecuteAStarLogic()
 		//if (GetPrevCost(ParentNode) != TRAVELCOST_FENCE) 
 		{
 			gpWorldLevelData[ParentNode].uiFlags |= MAPELEMENT_REACHABLE;
+			if (gpsPathDistanceField && baseGCost < gpsPathDistanceField[ParentNode])
+			{
+				gpsPathDistanceField[ParentNode] = baseGCost;
+			}
 			if (gubBuildingInfoToSet > 0) 
 			{
 				gubBuildingInfo[ ParentNode ] = gubBuildingInfoToSet;
@@ -1058,6 +1065,12 @@ void AStarPathfinder::ExecuteAStarLogic()
 			continue;
 		}
 
+		//hierarchical search: stay inside the cluster corridor
+		if (gfPathCorridorActive && !GridNoInPathCorridor(CurrentNode))
+		{
+			continue;
+		}
+
 		//has side effects, including setting loop counters
 		int retVal = VehicleObstacleCheck();
 		if (retVal == 1)
@@ -2148,12 +2161,13 @@ void ShutDownPathAI(void)
 	MemFree(trailCostUsed);
 	MemFree(trailCost);
 	MemFree(trailTree);
+	ShutdownAIPathCache();
 }
 
 ///////////////////////////////////////////////////////////////////////
 //	FINDBESTPATH													/
 ////////////////////////////////////////////////////////////////////////
-INT32 FindBestPath(SOLDIERTYPE *s , INT32 sDestination, INT8 bLevel, INT16 usMovementMode, INT8 bCopy, UINT8 fFlags )
+static INT32 InternalFindBestPath(SOLDIERTYPE *s , INT32 sDestination, INT8 bLevel, INT16 usMovementMode, INT8 bCopy, UINT8 fFlags )
 {
 	s->sPlotSrcGrid = s->sGridNo;
 
@@ -2661,6 +2675,10 @@ if(!GridNoOnVisibleWorldTile(iDestination))
 		if (fCopyReachable && prevCost != TRAVELCOST_FENCE)
 		{
 			gpWorldLevelData[curLoc].uiFlags |= MAPELEMENT_REACHABLE;
+			if (gpsPathDistanceField && ubCurAPCost < gpsPathDistanceField[curLoc])
+			{
+				gpsPathDistanceField[curLoc] = ubCurAPCost;
+			}
 			if (gubBuildingInfoToSet > 0)
 			{
 				gubBuildingInfo[ curLoc ] = gubBuildingInfoToSet;
@@ -2802,6 +2820,12 @@ if(!GridNoOnVisibleWorldTile(iDestination))
 				goto NEXTDIR;
 			}
 
+			// hierarchical search: stay inside the cluster corridor
+			if ( gfPathCorridorActive && !GridNoInPathCorridor( newLoc ) )
+			{
+				goto NEXTDIR;
+			}
+
 			if ( fVisitSpotsOnlyOnce && trailCostUsed[newLoc] == gubGlobalPathCount )
 			{
 				// on a "reachable" test, never revisit locations!
@@ -3940,6 +3964,52 @@ ENDOFLOOP:
 	}
 }
 
+INT32 FindBestPath(SOLDIERTYPE *s , INT32 sDestination, INT8 bLevel, INT16 usMovementMode, INT8 bCopy, UINT8 fFlags )
+{
+	PERFORMANCE_MARKER
+
+	RecordPathQuery( s, sDestination, bLevel, usMovementMode, bCopy, fFlags );
+
+	// The cluster graph only knows about plain point to point routes. Reachability floods, distance limited
+	// searches, "close enough" searches and big vehicles all go through the full search as before.
+	if ( gGameExternalOptions.fHierarchicalPathfinding &&
+		 bCopy < COPYREACHABLE &&
+		 !gubNPCDistLimit &&
+		 gfPathAroundObstacles &&
+		 !gfGeneratingMapEdgepoints &&
+		 !TileIsOutOfBounds( sDestination ) &&
+		 !( ( fFlags | gubGlobalPathFlags ) & PATH_CLOSE_GOOD_ENOUGH ) &&
+		 !( s->flags.uiStatusFlags & SOLDIER_MULTITILE ) )
+	{
+		switch ( SetupPathCorridor( s->sGridNo, sDestination, bLevel ) )
+		{
+			case PATHCLUSTER_UNREACHABLE:
+				s->sPlotSrcGrid = s->sGridNo;
+				gubNPCAPBudget = 0;
+				gubNPCDistLimit = 0;
+				return( 0 );
+
+			case PATHCLUSTER_CORRIDOR:
+			{
+				INT16 sAPBudget = gubNPCAPBudget;
+				INT32 iRetVal = InternalFindBestPath( s, sDestination, bLevel, usMovementMode, bCopy, fFlags );
+
+				ClearPathCorridor();
+				if ( iRetVal )
+				{
+					return( iRetVal );
+				}
+
+				// the corridor may be too tight (doors, people in the way), try the whole map
+				gubNPCAPBudget = sAPBudget;
+				break;
+			}
+		}
+	}
+
+	return( InternalFindBestPath( s, sDestination, bLevel, usMovementMode, bCopy, fFlags ) );
+}
+
 void GlobalReachableTest( INT32 sStartGridNo )
 {
 	SOLDIERTYPE s;
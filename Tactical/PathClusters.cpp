@@ -0,0 +1,646 @@
+	#include <vector>
+	#include <algorithm>
+	#include <queue>
+	#include <unordered_map>
+	#include <chrono>
+	#include "types.h"
+	#include "DEBUG.H"
+	#include "MemMan.h"
+	#include "Overhead Types.h"
+	#include "Overhead.h"
+	#include "Isometric Utils.h"
+	#include "worlddef.h"
+	#include "PATHAI.H"
+	#include "GameSettings.h"
+	#include "Font Control.h"
+	#include "message.h"
+	#include "PathClusters.h"
+
+#define PATH_REGION_BLOCKED			0xFF
+#define PATH_REGION_UNASSIGNED		0xFE
+#define PATH_REGION_MAX				0xFD		// a cluster with more regions than this lumps the rest into the last one
+
+#define PATH_REGION_ID( cluster, region )	( ( (UINT32)(cluster) << 8 ) | (region) )
+#define PATH_REGION_CLUSTER( id )			( (id) >> 8 )
+#define PATH_REGION_INDEX( id )				( (id) & 0xFF )
+
+typedef struct
+{
+	INT16					sX;			// rough centre of the region, used for the search estimate
+	INT16					sY;
+	std::vector<UINT32>		links;		// regions in neighbouring clusters we can step into
+} PATH_REGION;
+
+typedef struct
+{
+	std::vector<PATH_REGION>	regions[2];
+	BOOLEAN						fDirty;
+} PATH_CLUSTER;
+
+typedef struct
+{
+	SoldierID	ubSoldierID;
+	INT32		sStartGridNo;
+	INT32		sDestGridNo;
+	INT16		sAPBudget;
+	UINT8		ubDistLimit;
+	INT8		bLevel;
+	INT16		usMovementMode;
+	INT8		bCopy;
+	UINT8		fFlags;
+} PATH_QUERY_RECORD;
+
+static const INT8 gbPathClusterDirX[ NUM_WORLD_DIRECTIONS ] = {  0,  1, 1, 1, 0, -1, -1, -1 };
+static const INT8 gbPathClusterDirY[ NUM_WORLD_DIRECTIONS ] = { -1, -1, 0, 1, 1,  1,  0, -1 };
+
+static std::vector<PATH_CLUSTER>	gPathClusters;
+static UINT8						*gpubPathRegionOfGridNo[2] = { NULL, NULL };
+static UINT16						gusPathClusterCols = 0;
+static UINT16						gusPathClusterRows = 0;
+static INT32						giPathClusterWorldCols = 0;
+static INT32						giPathClusterWorldRows = 0;
+static BOOLEAN						gfPathClustersBuilt = FALSE;
+static BOOLEAN						gfPathClustersDirty = FALSE;
+static std::vector<UINT16>			gPathCorridorClusters;
+
+BOOLEAN		gfPathCorridorActive = FALSE;
+UINT16		*gpusPathClusterOfGridNo = NULL;
+UINT8		*gpubPathCorridor = NULL;
+
+static PATH_QUERY_RECORD			gPathQueryRecord[ PATH_QUERY_RECORD_SIZE ];
+static UINT32						guiNumPathQueriesRecorded = 0;
+static BOOLEAN						gfReplayingPathQueries = FALSE;
+
+
+// The cost checks are generous on purpose: anything the pathfinders might let us through is passable here.
+static inline BOOLEAN PathClusterCostPassable( UINT8 ubCost )
+{
+	return ( ubCost < TRAVELCOST_BLOCKED || ubCost == TRAVELCOST_HIDDENOBSTACLE || ubCost == TRAVELCOST_EXITGRID );
+}
+
+// fences and windows are jumped, which takes us one tile further than the cost suggests
+static inline BOOLEAN PathClusterCostJumpable( UINT8 ubCost )
+{
+	return ( ubCost == TRAVELCOST_FENCE || ( ubCost >= TRAVELCOST_JUMPABLEWINDOW && ubCost <= TRAVELCOST_JUMPABLEWINDOW_W ) );
+}
+
+static BOOLEAN PathClusterTileOpen( INT32 sGridNo, INT8 bLevel )
+{
+	for ( UINT8 ubDir = 0; ubDir < NUM_WORLD_DIRECTIONS; ++ubDir )
+	{
+		if ( PathClusterCostPassable( gubWorldMovementCosts[ sGridNo ][ ubDir ][ bLevel ] ) )
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+// symmetric, so that regions come out the same whichever side the flood starts from
+static BOOLEAN PathClusterStepPossible( INT32 sFromGridNo, INT32 sToGridNo, UINT8 ubDir, INT8 bLevel )
+{
+	UINT8 ubOppositeDir = gOppositeDirection[ ubDir ];
+
+	return ( PathClusterCostPassable( gubWorldMovementCosts[ sToGridNo ][ ubDir ][ bLevel ] ) ||
+			 PathClusterCostPassable( gubWorldMovementCosts[ sFromGridNo ][ ubOppositeDir ][ bLevel ] ) ||
+			 PathClusterCostJumpable( gubWorldMovementCosts[ sFromGridNo ][ ubDir ][ bLevel ] ) ||
+			 PathClusterCostJumpable( gubWorldMovementCosts[ sToGridNo ][ ubOppositeDir ][ bLevel ] ) );
+}
+
+static void GetPathClusterBounds( UINT16 usCluster, INT32 *piLeft, INT32 *piTop, INT32 *piRight, INT32 *piBottom )
+{
+	*piLeft = ( usCluster % gusPathClusterCols ) * PATH_CLUSTER_SIZE;
+	*piTop = ( usCluster / gusPathClusterCols ) * PATH_CLUSTER_SIZE;
+	*piRight = __min( *piLeft + PATH_CLUSTER_SIZE, WORLD_COLS );
+	*piBottom = __min( *piTop + PATH_CLUSTER_SIZE, WORLD_ROWS );
+}
+
+// Splits one cluster into regions of tiles that can reach each other without leaving the cluster.
+static void FloodPathCluster( UINT16 usCluster, INT8 bLevel )
+{
+	std::vector<PATH_REGION>	&regions = gPathClusters[ usCluster ].regions[ bLevel ];
+	std::vector<INT32>			sumX, sumY, count;
+	std::vector<INT32>			stack;
+	UINT8						*pubRegion = gpubPathRegionOfGridNo[ bLevel ];
+	INT32						iLeft, iTop, iRight, iBottom, iX, iY;
+
+	GetPathClusterBounds( usCluster, &iLeft, &iTop, &iRight, &iBottom );
+	regions.clear();
+
+	for ( iY = iTop; iY < iBottom; ++iY )
+	{
+		for ( iX = iLeft; iX < iRight; ++iX )
+		{
+			INT32 sGridNo = iY * WORLD_COLS + iX;
+			pubRegion[ sGridNo ] = PathClusterTileOpen( sGridNo, bLevel ) ? PATH_REGION_UNASSIGNED : PATH_REGION_BLOCKED;
+		}
+	}
+
+	for ( iY = iTop; iY < iBottom; ++iY )
+	{
+		for ( iX = iLeft; iX < iRight; ++iX )
+		{
+			INT32 sGridNo = iY * WORLD_COLS + iX;
+			if ( pubRegion[ sGridNo ] != PATH_REGION_UNASSIGNED )
+				continue;
+
+			// lumping regions together only ever adds connections, which is safe
+			UINT8 ubRegion = (UINT8)__min( regions.size(), PATH_REGION_MAX );
+			if ( ubRegion == regions.size() )
+			{
+				regions.push_back( PATH_REGION() );
+				sumX.push_back( 0 );
+				sumY.push_back( 0 );
+				count.push_back( 0 );
+			}
+
+			pubRegion[ sGridNo ] = ubRegion;
+			stack.push_back( sGridNo );
+
+			while ( !stack.empty() )
+			{
+				INT32 sCurrent = stack.back();
+				INT32 iCurrentX = sCurrent % WORLD_COLS;
+				INT32 iCurrentY = sCurrent / WORLD_COLS;
+				stack.pop_back();
+
+				sumX[ ubRegion ] += iCurrentX;
+				sumY[ ubRegion ] += iCurrentY;
+				++count[ ubRegion ];
+
+				for ( UINT8 ubDir = 0; ubDir < NUM_WORLD_DIRECTIONS; ++ubDir )
+				{
+					INT32 iNewX = iCurrentX + gbPathClusterDirX[ ubDir ];
+					INT32 iNewY = iCurrentY + gbPathClusterDirY[ ubDir ];
+
+					if ( iNewX < iLeft || iNewX >= iRight || iNewY < iTop || iNewY >= iBottom )
+						continue;
+
+					INT32 sNewGridNo = iNewY * WORLD_COLS + iNewX;
+					if ( pubRegion[ sNewGridNo ] == PATH_REGION_UNASSIGNED && PathClusterStepPossible( sCurrent, sNewGridNo, ubDir, bLevel ) )
+					{
+						pubRegion[ sNewGridNo ] = ubRegion;
+						stack.push_back( sNewGridNo );
+					}
+				}
+			}
+		}
+	}
+
+	for ( UINT32 cnt = 0; cnt < regions.size(); ++cnt )
+	{
+		regions[ cnt ].sX = (INT16)( sumX[ cnt ] / count[ cnt ] );
+		regions[ cnt ].sY = (INT16)( sumY[ cnt ] / count[ cnt ] );
+	}
+}
+
+// Links the regions of one cluster to the regions across its border. All clusters involved must be flooded.
+static void LinkPathCluster( UINT16 usCluster, INT8 bLevel )
+{
+	std::vector<PATH_REGION>	&regions = gPathClusters[ usCluster ].regions[ bLevel ];
+	UINT8						*pubRegion = gpubPathRegionOfGridNo[ bLevel ];
+	INT32						iLeft, iTop, iRight, iBottom, iX, iY;
+
+	GetPathClusterBounds( usCluster, &iLeft, &iTop, &iRight, &iBottom );
+
+	for ( UINT32 cnt = 0; cnt < regions.size(); ++cnt )
+	{
+		regions[ cnt ].links.clear();
+	}
+
+	for ( iY = iTop; iY < iBottom; ++iY )
+	{
+		for ( iX = iLeft; iX < iRight; ++iX )
+		{
+			// only the border matters
+			if ( iX != iLeft && iX != iRight - 1 && iY != iTop && iY != iBottom - 1 )
+				continue;
+
+			INT32 sGridNo = iY * WORLD_COLS + iX;
+			UINT8 ubRegion = pubRegion[ sGridNo ];
+			if ( ubRegion == PATH_REGION_BLOCKED )
+				continue;
+
+			for ( UINT8 ubDir = 0; ubDir < NUM_WORLD_DIRECTIONS; ++ubDir )
+			{
+				INT32 iNewX = iX + gbPathClusterDirX[ ubDir ];
+				INT32 iNewY = iY + gbPathClusterDirY[ ubDir ];
+
+				if ( iNewX < 0 || iNewX >= WORLD_COLS || iNewY < 0 || iNewY >= WORLD_ROWS )
+					continue;
+
+				INT32 sNewGridNo = iNewY * WORLD_COLS + iNewX;
+				UINT16 usNewCluster = gpusPathClusterOfGridNo[ sNewGridNo ];
+				UINT8 ubNewRegion = pubRegion[ sNewGridNo ];
+
+				if ( usNewCluster == usCluster || ubNewRegion == PATH_REGION_BLOCKED )
+					continue;
+
+				if ( !PathClusterStepPossible( sGridNo, sNewGridNo, ubDir, bLevel ) )
+					continue;
+
+				UINT32 uiLink = PATH_REGION_ID( usNewCluster, ubNewRegion );
+				std::vector<UINT32> &links = regions[ ubRegion ].links;
+				if ( std::find( links.begin(), links.end(), uiLink ) == links.end() )
+				{
+					links.push_back( uiLink );
+				}
+			}
+		}
+	}
+}
+
+static void FreePathClusters( void )
+{
+	ClearPathCorridor();
+
+	for ( INT8 bLevel = 0; bLevel < 2; ++bLevel )
+	{
+		if ( gpubPathRegionOfGridNo[ bLevel ] )
+		{
+			MemFree( gpubPathRegionOfGridNo[ bLevel ] );
+			gpubPathRegionOfGridNo[ bLevel ] = NULL;
+		}
+	}
+
+	if ( gpusPathClusterOfGridNo )
+	{
+		MemFree( gpusPathClusterOfGridNo );
+		gpusPathClusterOfGridNo = NULL;
+	}
+
+	if ( gpubPathCorridor )
+	{
+		MemFree( gpubPathCorridor );
+		gpubPathCorridor = NULL;
+	}
+
+	gPathClusters.clear();
+	gfPathClustersBuilt = FALSE;
+	gfPathClustersDirty = FALSE;
+}
+
+// Builds the whole cluster graph for the current map. Called from LoadWorld, and lazily after a full recompile.
+void BuildPathClusters( void )
+{
+	UINT16 usCluster, usNumClusters;
+
+	FreePathClusters();
+
+	gusPathClusterCols = (UINT16)( ( WORLD_COLS + PATH_CLUSTER_SIZE - 1 ) / PATH_CLUSTER_SIZE );
+	gusPathClusterRows = (UINT16)( ( WORLD_ROWS + PATH_CLUSTER_SIZE - 1 ) / PATH_CLUSTER_SIZE );
+	giPathClusterWorldCols = WORLD_COLS;
+	giPathClusterWorldRows = WORLD_ROWS;
+	usNumClusters = gusPathClusterCols * gusPathClusterRows;
+
+	gpusPathClusterOfGridNo = (UINT16 *) MemAlloc( WORLD_MAX * sizeof( UINT16 ) );
+	gpubPathRegionOfGridNo[0] = (UINT8 *) MemAlloc( WORLD_MAX );
+	gpubPathRegionOfGridNo[1] = (UINT8 *) MemAlloc( WORLD_MAX );
+	gpubPathCorridor = (UINT8 *) MemAlloc( usNumClusters );
+	if ( !gpusPathClusterOfGridNo || !gpubPathRegionOfGridNo[0] || !gpubPathRegionOfGridNo[1] || !gpubPathCorridor )
+	{
+		FreePathClusters();
+		return;
+	}
+
+	memset( gpubPathCorridor, 0, usNumClusters );
+	for ( INT32 sGridNo = 0; sGridNo < WORLD_MAX; ++sGridNo )
+	{
+		gpusPathClusterOfGridNo[ sGridNo ] = (UINT16)( ( sGridNo / WORLD_COLS ) / PATH_CLUSTER_SIZE * gusPathClusterCols + ( sGridNo % WORLD_COLS ) / PATH_CLUSTER_SIZE );
+	}
+
+	gPathClusters.resize( usNumClusters );
+	for ( usCluster = 0; usCluster < usNumClusters; ++usCluster )
+	{
+		FloodPathCluster( usCluster, 0 );
+		FloodPathCluster( usCluster, 1 );
+		gPathClusters[ usCluster ].fDirty = FALSE;
+	}
+
+	for ( usCluster = 0; usCluster < usNumClusters; ++usCluster )
+	{
+		LinkPathCluster( usCluster, 0 );
+		LinkPathCluster( usCluster, 1 );
+	}
+
+	gfPathClustersBuilt = TRUE;
+}
+
+// The whole map is being recompiled, throw the graph away and rebuild it when it's next needed.
+void InvalidatePathClusters( void )
+{
+	ClearPathCorridor();
+	gfPathClustersBuilt = FALSE;
+}
+
+// A tile's movement costs were recompiled. Compiling a tile can also change the costs of its neighbours,
+// so every cluster touching the 3x3 block around it is flagged.
+void MarkPathClusterDirty( INT32 sGridNo )
+{
+	if ( !gfPathClustersBuilt || giPathClusterWorldCols != WORLD_COLS || giPathClusterWorldRows != WORLD_ROWS )
+		return;
+
+	if ( sGridNo < 0 || sGridNo >= WORLD_MAX )
+		return;
+
+	INT32 iX = sGridNo % WORLD_COLS;
+	INT32 iY = sGridNo / WORLD_COLS;
+
+	for ( INT32 iCheckY = __max( iY - 1, 0 ); iCheckY <= __min( iY + 1, WORLD_ROWS - 1 ); ++iCheckY )
+	{
+		for ( INT32 iCheckX = __max( iX - 1, 0 ); iCheckX <= __min( iX + 1, WORLD_COLS - 1 ); ++iCheckX )
+		{
+			gPathClusters[ gpusPathClusterOfGridNo[ iCheckY * WORLD_COLS + iCheckX ] ].fDirty = TRUE;
+		}
+	}
+
+	gfPathClustersDirty = TRUE;
+}
+
+// Refloods dirty clusters, then relinks them and their neighbours (whose links point at the old regions).
+static void UpdatePathClusters( void )
+{
+	if ( !gfPathClustersBuilt || giPathClusterWorldCols != WORLD_COLS || giPathClusterWorldRows != WORLD_ROWS )
+	{
+		BuildPathClusters();
+		return;
+	}
+
+	if ( !gfPathClustersDirty )
+		return;
+
+	UINT16 usNumClusters = (UINT16)gPathClusters.size();
+	std::vector<UINT8> relink( usNumClusters, 0 );
+
+	for ( UINT16 usCluster = 0; usCluster < usNumClusters; ++usCluster )
+	{
+		if ( !gPathClusters[ usCluster ].fDirty )
+			continue;
+
+		FloodPathCluster( usCluster, 0 );
+		FloodPathCluster( usCluster, 1 );
+		gPathClusters[ usCluster ].fDirty = FALSE;
+
+		INT32 iClusterX = usCluster % gusPathClusterCols;
+		INT32 iClusterY = usCluster / gusPathClusterCols;
+		for ( INT32 iY = __max( iClusterY - 1, 0 ); iY <= __min( iClusterY + 1, gusPathClusterRows - 1 ); ++iY )
+		{
+			for ( INT32 iX = __max( iClusterX - 1, 0 ); iX <= __min( iClusterX + 1, gusPathClusterCols - 1 ); ++iX )
+			{
+				relink[ iY * gusPathClusterCols + iX ] = 1;
+			}
+		}
+	}
+
+	for ( UINT16 usCluster = 0; usCluster < usNumClusters; ++usCluster )
+	{
+		if ( relink[ usCluster ] )
+		{
+			LinkPathCluster( usCluster, 0 );
+			LinkPathCluster( usCluster, 1 );
+		}
+	}
+
+	gfPathClustersDirty = FALSE;
+}
+
+static inline UINT32 PathRegionDistance( const PATH_REGION &a, const PATH_REGION &b )
+{
+	UINT32 dx = abs( a.sX - b.sX );
+	UINT32 dy = abs( a.sY - b.sY );
+
+	// octile distance, diagonals are 1.4 straight steps
+	return ( (dx < dy) ? ( dx * 14 + ( dy - dx ) * 10 ) : ( dy * 14 + ( dx - dy ) * 10 ) ) + 1;
+}
+
+static inline const PATH_REGION& GetPathRegion( UINT32 uiRegionID, INT8 bLevel )
+{
+	return gPathClusters[ PATH_REGION_CLUSTER( uiRegionID ) ].regions[ bLevel ][ PATH_REGION_INDEX( uiRegionID ) ];
+}
+
+static void AddClusterToPathCorridor( INT32 iClusterX, INT32 iClusterY )
+{
+	if ( iClusterX < 0 || iClusterX >= gusPathClusterCols || iClusterY < 0 || iClusterY >= gusPathClusterRows )
+		return;
+
+	UINT16 usCluster = (UINT16)( iClusterY * gusPathClusterCols + iClusterX );
+	if ( !gpubPathCorridor[ usCluster ] )
+	{
+		gpubPathCorridor[ usCluster ] = TRUE;
+		gPathCorridorClusters.push_back( usCluster );
+	}
+}
+
+// Searches the region graph from start to destination. If a route exists, the clusters along it (plus a ring
+// of neighbours, so the detailed search has room to go round things) are marked as the path corridor.
+UINT8 SetupPathCorridor( INT32 sStartGridNo, INT32 sDestGridNo, INT8 bLevel )
+{
+	struct OPENREGION
+	{
+		UINT32	uiF;
+		UINT32	uiG;
+		UINT32	uiRegionID;
+		bool operator<( const OPENREGION &other ) const { return uiF > other.uiF; }
+	};
+
+	ClearPathCorridor();
+
+	if ( bLevel < 0 || bLevel > 1 )
+		return PATHCLUSTER_FULL_SEARCH;
+
+	if ( sStartGridNo < 0 || sStartGridNo >= WORLD_MAX || sDestGridNo < 0 || sDestGridNo >= WORLD_MAX )
+		return PATHCLUSTER_FULL_SEARCH;
+
+	UpdatePathClusters();
+	if ( !gfPathClustersBuilt )
+		return PATHCLUSTER_FULL_SEARCH;
+
+	UINT8 ubStartRegion = gpubPathRegionOfGridNo[ bLevel ][ sStartGridNo ];
+	UINT8 ubDestRegion = gpubPathRegionOfGridNo[ bLevel ][ sDestGridNo ];
+
+	// odd start or destination tiles are left to the pathfinder to judge
+	if ( ubStartRegion == PATH_REGION_BLOCKED || ubDestRegion == PATH_REGION_BLOCKED )
+		return PATHCLUSTER_FULL_SEARCH;
+
+	UINT32 uiStartID = PATH_REGION_ID( gpusPathClusterOfGridNo[ sStartGridNo ], ubStartRegion );
+	UINT32 uiDestID = PATH_REGION_ID( gpusPathClusterOfGridNo[ sDestGridNo ], ubDestRegion );
+
+	// same region, the pathfinder won't go far anyway
+	if ( uiStartID == uiDestID )
+		return PATHCLUSTER_FULL_SEARCH;
+
+	const PATH_REGION &destRegion = GetPathRegion( uiDestID, bLevel );
+
+	std::priority_queue<OPENREGION>							open;
+	std::unordered_map<UINT32, std::pair<UINT32, UINT32> >	visited;		// region -> (G, parent)
+	BOOLEAN													fFound = FALSE;
+
+	OPENREGION start = { PathRegionDistance( GetPathRegion( uiStartID, bLevel ), destRegion ), 0, uiStartID };
+	open.push( start );
+	visited[ uiStartID ] = std::make_pair( 0, uiStartID );
+
+	while ( !open.empty() )
+	{
+		OPENREGION current = open.top();
+		open.pop();
+
+		// stale entry, the region was reached more cheaply since
+		if ( current.uiG != visited[ current.uiRegionID ].first )
+			continue;
+
+		if ( current.uiRegionID == uiDestID )
+		{
+			fFound = TRUE;
+			break;
+		}
+
+		const PATH_REGION &region = GetPathRegion( current.uiRegionID, bLevel );
+		for ( UINT32 cnt = 0; cnt < region.links.size(); ++cnt )
+		{
+			UINT32 uiNextID = region.links[ cnt ];
+			const PATH_REGION &nextRegion = GetPathRegion( uiNextID, bLevel );
+			UINT32 uiG = current.uiG + PathRegionDistance( region, nextRegion );
+
+			std::unordered_map<UINT32, std::pair<UINT32, UINT32> >::iterator it = visited.find( uiNextID );
+			if ( it != visited.end() && it->second.first <= uiG )
+				continue;
+
+			visited[ uiNextID ] = std::make_pair( uiG, current.uiRegionID );
+
+			OPENREGION next = { uiG + PathRegionDistance( nextRegion, destRegion ), uiG, uiNextID };
+			open.push( next );
+		}
+	}
+
+	if ( !fFound )
+		return PATHCLUSTER_UNREACHABLE;
+
+	UINT32 uiRegionID = uiDestID;
+	for (;;)
+	{
+		UINT16 usCluster = (UINT16)PATH_REGION_CLUSTER( uiRegionID );
+		INT32 iClusterX = usCluster % gusPathClusterCols;
+		INT32 iClusterY = usCluster / gusPathClusterCols;
+
+		for ( INT32 iY = iClusterY - 1; iY <= iClusterY + 1; ++iY )
+		{
+			for ( INT32 iX = iClusterX - 1; iX <= iClusterX + 1; ++iX )
+			{
+				AddClusterToPathCorridor( iX, iY );
+			}
+		}
+
+		if ( uiRegionID == uiStartID )
+			break;
+
+		uiRegionID = visited[ uiRegionID ].second;
+	}
+
+	gfPathCorridorActive = TRUE;
+	return PATHCLUSTER_CORRIDOR;
+}
+
+void ClearPathCorridor( void )
+{
+	for ( UINT32 cnt = 0; cnt < gPathCorridorClusters.size(); ++cnt )
+	{
+		gpubPathCorridor[ gPathCorridorClusters[ cnt ] ] = FALSE;
+	}
+
+	gPathCorridorClusters.clear();
+	gfPathCorridorActive = FALSE;
+}
+
+// Keeps the most recent path queries around, so both search modes can be timed against the same workload.
+void RecordPathQuery( SOLDIERTYPE *pSoldier, INT32 sDestGridNo, INT8 bLevel, INT16 usMovementMode, INT8 bCopy, UINT8 fFlags )
+{
+	// reachability floods touch the map flags, they are not worth replaying
+	if ( gfReplayingPathQueries || bCopy >= COPYREACHABLE || pSoldier->ubID >= TOTAL_SOLDIERS )
+		return;
+
+	PATH_QUERY_RECORD &record = gPathQueryRecord[ guiNumPathQueriesRecorded % PATH_QUERY_RECORD_SIZE ];
+
+	record.ubSoldierID		= pSoldier->ubID;
+	record.sStartGridNo		= pSoldier->sGridNo;
+	record.sDestGridNo		= sDestGridNo;
+	record.sAPBudget		= gubNPCAPBudget;
+	record.ubDistLimit		= gubNPCDistLimit;
+	record.bLevel			= bLevel;
+	record.usMovementMode	= usMovementMode;
+	record.bCopy			= bCopy;
+	record.fFlags			= fFlags;
+
+	++guiNumPathQueriesRecorded;
+}
+
+// Replays the recorded queries once with the plain search and once with the hierarchical one, and reports
+// the time taken and how many answers differ in length.
+void BenchmarkRecordedPathQueries( void )
+{
+	UINT32	uiNumQueries = __min( guiNumPathQueriesRecorded, PATH_QUERY_RECORD_SIZE );
+	INT32	iPathLength[2][ PATH_QUERY_RECORD_SIZE ];
+	UINT32	uiMicroseconds[2];
+	UINT32	uiNumReplayed = 0, uiNumDifferent = 0;
+	BOOLEAN	fOrigHierarchical = gGameExternalOptions.fHierarchicalPathfinding;
+
+	if ( !uiNumQueries )
+	{
+		ScreenMsg( FONT_MCOLOR_LTYELLOW, MSG_INTERFACE, L"No path queries recorded." );
+		return;
+	}
+
+	gfReplayingPathQueries = TRUE;
+
+	for ( UINT8 ubPass = 0; ubPass < 2; ++ubPass )
+	{
+		gGameExternalOptions.fHierarchicalPathfinding = ( ubPass == 1 );
+		if ( ubPass == 1 )
+		{
+			// don't bill the one-off graph build to the queries
+			UpdatePathClusters();
+		}
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		for ( UINT32 cnt = 0; cnt < uiNumQueries; ++cnt )
+		{
+			PATH_QUERY_RECORD &record = gPathQueryRecord[ cnt ];
+			SOLDIERTYPE *pSoldier = MercPtrs[ record.ubSoldierID ];
+
+			iPathLength[ ubPass ][ cnt ] = -1;
+			if ( !pSoldier || !pSoldier->bActive || TileIsOutOfBounds( record.sStartGridNo ) )
+				continue;
+
+			// run the query from where it was asked, without touching the soldier's route
+			INT32 sOrigGridNo = pSoldier->sGridNo;
+			INT32 sOrigPlotSrcGrid = pSoldier->sPlotSrcGrid;
+			pSoldier->sGridNo = record.sStartGridNo;
+
+			gubNPCAPBudget = record.sAPBudget;
+			gubNPCDistLimit = record.ubDistLimit;
+			iPathLength[ ubPass ][ cnt ] = FindBestPath( pSoldier, record.sDestGridNo, record.bLevel, record.usMovementMode, NO_COPYROUTE, record.fFlags );
+
+			pSoldier->sGridNo = sOrigGridNo;
+			pSoldier->sPlotSrcGrid = sOrigPlotSrcGrid;
+		}
+
+		uiMicroseconds[ ubPass ] = (UINT32)std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - start ).count();
+	}
+
+	gGameExternalOptions.fHierarchicalPathfinding = fOrigHierarchical;
+	gubNPCAPBudget = 0;
+	gubNPCDistLimit = 0;
+	gfReplayingPathQueries = FALSE;
+
+	for ( UINT32 cnt = 0; cnt < uiNumQueries; ++cnt )
+	{
+		if ( iPathLength[0][ cnt ] < 0 )
+			continue;
+
+		++uiNumReplayed;
+		if ( iPathLength[0][ cnt ] != iPathLength[1][ cnt ] )
+			++uiNumDifferent;
+	}
+
+	ScreenMsg( FONT_MCOLOR_LTYELLOW, MSG_INTERFACE, L"Path benchmark: %d queries, full search %d us, hierarchical %d us, %d differ.",
+				uiNumReplayed, uiMicroseconds[0], uiMicroseconds[1], uiNumDifferent );
+}
@@ -0,0 +1,49 @@
+#ifndef _PATH_CLUSTERS_H
+#define _PATH_CLUSTERS_H
+
+#include "types.h"
+
+class SOLDIERTYPE;
+
+// Hierarchical path search support.
+// The map is split into square clusters, and every cluster into regions (tiles connected inside the cluster).
+// Regions of neighbouring clusters are linked wherever a step across the cluster border is possible.
+// Connectivity is taken from gubWorldMovementCosts and is deliberately generous (closed doors, hidden obstacles,
+// water, fences all count as passable), so if the region graph says "no route", there is no route.
+// A path query first searches the region graph, then the normal pathfinder only expands tiles inside the
+// clusters along that route (the corridor).
+
+#define PATH_CLUSTER_SIZE				16
+
+enum
+{
+	PATHCLUSTER_FULL_SEARCH,		// no help from the cluster graph, search the whole map
+	PATHCLUSTER_CORRIDOR,			// corridor set up, search restricted to it
+	PATHCLUSTER_UNREACHABLE,		// the destination cannot be reached at all
+};
+
+// graph upkeep
+void BuildPathClusters( void );
+void InvalidatePathClusters( void );
+void MarkPathClusterDirty( INT32 sGridNo );
+
+// query support
+UINT8 SetupPathCorridor( INT32 sStartGridNo, INT32 sDestGridNo, INT8 bLevel );
+void ClearPathCorridor( void );
+
+extern BOOLEAN	gfPathCorridorActive;
+extern UINT16	*gpusPathClusterOfGridNo;
+extern UINT8	*gpubPathCorridor;
+
+inline BOOLEAN GridNoInPathCorridor( INT32 sGridNo )
+{
+	return gpubPathCorridor[ gpusPathClusterOfGridNo[ sGridNo ] ];
+}
+
+// recorded path queries, replayed by BenchmarkRecordedPathQueries()
+#define PATH_QUERY_RECORD_SIZE			1024
+
+void RecordPathQuery( SOLDIERTYPE *pSoldier, INT32 sDestGridNo, INT8 bLevel, INT16 usMovementMode, INT8 bCopy, UINT8 fFlags );
+void BenchmarkRecordedPathQueries( void );
+
+#endif
@@ -2696,6 +2696,7 @@ void DeductAmmo( SOLDIERTYPE *pSoldier, INT8 bInvPos )
 
 void DeductAmmo( SOLDIERTYPE *pSoldier, OBJECTTYPE* pObj )
 {
+	ObjectStatsChange statsChange;
 	if ( pSoldier && pObj->exists( ) )
 	{
 		// tanks never run out of MG ammo!
@@ -3040,6 +3040,7 @@ BOOLEAN RepairIsDone(DEALER_SPECIAL_ITEM* pSpecial)
 			(*iter)[0]->data.sRepairThreshold = 100;
 		}
 	}
+	InvalidateObjectStats();
 
 #ifdef JA2UB
 	//no UB
@@ -6304,6 +6305,7 @@ BOOLEAN OfferObjectToDealer( OBJECTTYPE *pComplexObject, UINT8 ubOwnerProfileId,
 
 void SplitComplexObjectIntoSubObjects( OBJECTTYPE *pComplexObject )
 {
+	ObjectStatsChange statsChange;
 	Assert( pComplexObject );
 	Assert( pComplexObject->exists() == true );
 
@@ -395,6 +395,7 @@ BOOLEAN AdjustToNextAnimationFrame( SOLDIERTYPE *pSoldier )
 									{
 										pSoldier->inv[HANDPOS][0]->data.sRepairThreshold--;
 									}
+									InvalidateObjectStats();
 								}
 							}
 						}
@@ -5959,6 +5959,7 @@ void SOLDIERTYPE::EVENT_SoldierGotHit( UINT16 usWeaponIndex, INT16 sDamage, INT1
 						(*pBatteries)[0]->data.objectStatus -= (INT8)((8 + Random( 5 )) * (100 - Item[(*pBatteries)[0]->data.objectStatus].percentstatusdrainreduction) / 100);
 					else
 						(*pBatteries)[0]->data.objectStatus -= (INT8)((8 + Random( 5 )));
+					InvalidateObjectStats();
 					if ( (*pBatteries)[0]->data.objectStatus <= 0 )
 					{
 						// destroy batteries
@@ -14677,6 +14678,7 @@ void SOLDIERTYPE::SoldierInventoryCoolDown( void )
 			{
 				// lose 1 point
 				(*pBattery)[0]->data.objectStatus -= 1;
+				InvalidateObjectStats();
 
 				if ( (*pBattery)[0]->data.objectStatus <= 0 )
 				{
@@ -15105,6 +15107,7 @@ void	SOLDIERTYPE::InventoryExplosion( void )
 							(*iter)[0]->data.sRepairThreshold = max( 1, (INT16)(rtstatus / 2) );
 						}
 					}
+					InvalidateObjectStats();
 				}
 			}
 		}
@@ -20483,6 +20486,7 @@ void	SOLDIERTYPE::DestroyEquippedRiotShield( )
 
 void	SOLDIERTYPE::RiotShieldTakeDamage( INT32 sDamage )
 {
+	ObjectStatsChange statsChange;
 	OBJECTTYPE* pObj = GetEquippedRiotShield();
 
 	if ( pObj  )
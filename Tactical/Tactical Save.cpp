@@ -50,7 +50,6 @@ BOOLEAN gfWasInMeanwhile = FALSE;
 class OBJECTTYPE;
 class SOLDIERTYPE;
 extern WorldItems gAllWorldItems;
-void SaveWorldItemsToTempFiles();
 void LoadWorldItemsFromTempFiles(INT16 sMapX, INT16 sMapY, INT8 bMapZ);
 void ClearAllWorldItems(void);
 bool LoadWorldItemsFromSavedGame(HWFILE hFile, INT16 x, INT16 y, INT8 z);
@@ -160,9 +159,6 @@ BOOLEAN SaveMapTempFilesToSavedGameFile( HWFILE hFile )
 	INT16 sMapX;
 	INT16 sMapY;
 
-	// Save all the global world items to temp files
-	SaveWorldItemsToTempFiles();
-
 	//
 	//Loop though all the array elements to see if there is a data file to be saved
 	//
@@ -173,10 +169,10 @@ BOOLEAN SaveMapTempFilesToSavedGameFile( HWFILE hFile )
 	{
 		for( sMapX=1; sMapX<=16; sMapX++ )
 		{
-			//Save the Temp Item Files to the saved game file
+			//Save the sector's items, straight from gAllWorldItems
 			if( SectorInfo[ SECTOR( sMapX,sMapY) ].uiFlags & SF_ITEM_TEMP_FILE_EXISTS )
 			{
-				if ( !AddTempFileToSavedGame( hFile, SF_ITEM_TEMP_FILE_EXISTS, sMapX, sMapY, 0 ) )
+				if ( !SaveWorldItemsToSavedGame( hFile, sMapX, sMapY, 0 ) )
 					return FALSE;
 			}
 			// Save the Rotting Corpse Temp file to the saved game file
@@ -250,7 +246,7 @@ BOOLEAN SaveMapTempFilesToSavedGameFile( HWFILE hFile )
 	{
 		if( TempNode->uiFlags & SF_ITEM_TEMP_FILE_EXISTS )
 		{
-			if ( !AddTempFileToSavedGame( hFile, SF_ITEM_TEMP_FILE_EXISTS, TempNode->ubSectorX, TempNode->ubSectorY, TempNode->ubSectorZ ) )
+			if ( !SaveWorldItemsToSavedGame( hFile, TempNode->ubSectorX, TempNode->ubSectorY, TempNode->ubSectorZ ) )
 				return FALSE;
 		}
 
@@ -815,25 +811,33 @@ BOOLEAN AddWorldItemsToUnLoadedSector(INT16 sMapX, INT16 sMapY, INT8 bMapZ, INT3
 	UINT32 uiLoop;
 	UINT32 uiLastItemPos;
 	UINT32 uiNumberOfItems;
-	std::vector<WORLDITEM> pWorldItems;//dnl ch75 271013
+	std::vector<WORLDITEM> newWorldItems;//dnl ch75 271013
 	if (uiNumberOfItemsToAdd == 0 && fOverWrite == FALSE)
 	{
 		//Moa: nothing to do, so get out of here!
 		return(TRUE);
 	}
 
+	std::vector<WORLDITEM>* pItemList = &newWorldItems;
 	const auto i = FindWorldItemSector(sMapX, sMapY, bMapZ);
 	if (i == -1)
 	{
 		// Can't find world item sector, add it
 		uiNumberOfItems = uiNumberOfItemsToAdd;
-		pWorldItems.resize(uiNumberOfItems);
+		newWorldItems.resize(uiNumberOfItems);
 	}
 	else
 	{
+		// add to the stored list directly, copying the whole sector inventory out and back in for a few items is slow
 		uiNumberOfItems = gAllWorldItems.NumItems[i];
-		pWorldItems = gAllWorldItems.Items[i];
+		pItemList = &gAllWorldItems.Items[i];
+		if (pItemList == &pWorldItem)
+		{
+			newWorldItems = *pItemList;
+			pItemList = &newWorldItems;
+		}
 	}
+	std::vector<WORLDITEM>& pWorldItems = *pItemList;
 
 	//if we are to replace the entire file
 	if (fOverWrite)
@@ -902,7 +906,8 @@ BOOLEAN AddItemsToUnLoadedSector(INT16 sMapX, INT16 sMapY, INT8 bMapZ, INT32 sGr
 		return(TRUE);
 	}
 
-	std::vector<WORLDITEM> pWorldItems;
+	std::vector<WORLDITEM> newWorldItems;
+	std::vector<WORLDITEM>* pItemList = &newWorldItems;
 	UINT32	uiNumberOfItems = 0;
 	UINT32	cnt;
 	UINT32	uiLoop1 = 0;
@@ -912,13 +917,15 @@ BOOLEAN AddItemsToUnLoadedSector(INT16 sMapX, INT16 sMapY, INT8 bMapZ, INT32 sGr
 	{
 		// Can't find world item sector, add it
 		uiNumberOfItems = uiNumberOfItemsToAdd;
-		pWorldItems.resize(uiNumberOfItems);
+		newWorldItems.resize(uiNumberOfItems);
 	}
 	else
 	{
+		// add to the stored list directly, see AddWorldItemsToUnLoadedSector()
 		uiNumberOfItems = gAllWorldItems.NumItems[i];
-		pWorldItems = gAllWorldItems.Items[i];
+		pItemList = &gAllWorldItems.Items[i];
 	}
+	std::vector<WORLDITEM>& pWorldItems = *pItemList;
 
 	if (fReplaceEntireFile)
 	{
@@ -3143,8 +3150,9 @@ UINT32 UpdateLoadedSectorsItemInventory( INT16 sMapX, INT16 sMapY, INT8 bMapZ, U
 	return( uiItemCounter );
 }
 
-// We no longer use map item temp files except during loading and saving a game to preserve savegame compatibility.
-// LoadWorldItemsFromTempFiles & SaveWorldItemsToTempFiles are used to read and write world items to and from temp files into the global world items struct gAllWorldItems that is used during gameplay
+// We no longer use map item temp files except during loading a game to preserve savegame compatibility.
+// LoadWorldItemsFromTempFiles reads the world items of a sector from its temp file into the global world items struct gAllWorldItems that is used during gameplay,
+// SaveWorldItemsToSavedGame writes them from gAllWorldItems to the saved game, in the same layout the temp file would have had
 void LoadWorldItemsFromTempFiles(INT16 sMapX, INT16 sMapY, INT8 bMapZ)
 {
 	UINT32 nItems = 0;
@@ -3165,16 +3173,35 @@ void LoadWorldItemsFromTempFiles(INT16 sMapX, INT16 sMapY, INT8 bMapZ)
 	}
 }
 
-void SaveWorldItemsToTempFiles()
+bool SaveWorldItemsToSavedGame(HWFILE hFile, INT16 x, INT16 y, INT8 z)
 {
-	for (size_t i = 0; i < gAllWorldItems.sectors.size(); i++)
+	UINT32 uiNumBytesWritten = 0;
+	UINT32 nItems = 0;
+	const auto i = FindWorldItemSector(x, y, z);
+	if (i != -1)
 	{
-		const auto x = gAllWorldItems.sectors[i].x;
-		const auto y = gAllWorldItems.sectors[i].y;
-		const auto z = gAllWorldItems.sectors[i].z;
-		const auto nItems = gAllWorldItems.NumItems[i];
-		auto &Items = gAllWorldItems.Items[i];
+		nItems = gAllWorldItems.NumItems[i];
+	}
 
-		SaveWorldItemsToTempItemFile(x, y, (INT8)z, nItems, Items);
+	// build the whole sector in memory first, the saved game needs its size up front
+	HWFILE hMemFile = FileOpenMemory();
+	if (hMemFile == 0)
+		return false;
+
+	bool fOk = FileWrite(hMemFile, &nItems, sizeof(UINT32), &uiNumBytesWritten) != FALSE;
+	for (UINT32 cnt = 0; fOk && cnt < nItems; ++cnt)
+	{
+		fOk = gAllWorldItems.Items[i][cnt].Save(hMemFile, FALSE) != FALSE;
 	}
+
+	const UINT32 uiSize = FileGetSize(hMemFile);
+	std::vector<UINT8> data(uiSize);
+	fOk = fOk && FileGetMemoryContents(hMemFile, &data[0], uiSize);
+	FileClose(hMemFile);
+
+	// same as SaveFilesToSavedGame() writes for a temp file
+	fOk = fOk && FileWrite(hFile, &uiSize, sizeof(UINT32), &uiNumBytesWritten);
+	fOk = fOk && FileWrite(hFile, &data[0], uiSize, &uiNumBytesWritten);
+
+	return fOk;
 }
@@ -40,6 +40,7 @@
 #include "Reinforcement.h"
 #include "fresh_header.h"
 #include "connect.h"
+#include "AIPathCache.h"
 
 
 #ifdef JA2UB
@@ -501,6 +502,9 @@ void BeginTeamTurn( UINT8 ubTeam )
 	DebugMsg (TOPIC_JA2INTERRUPT,DBG_LEVEL_3,"BeginTeamTurn");
 	SOLDIERTYPE		*pSoldier;
 
+	// AI path costs are built at most once per turn
+	InvalidateAIPathCache();
+
 	//rain
 	if( !LightningEndOfTurn( ubTeam ) )return;
 	//end rain
@@ -51,6 +51,7 @@
 #include "QuestDebug.h"
 #include "Assignments.h"
 #include "SaveLoadGame.h"
+#include "LuaInitNPCs.h"
 #include "WorldDat.h"
 #include "Exit Grids.h"
 #include "Strategic Exit GUI.h"
@@ -92,6 +93,9 @@
 #include "DynamicDialogueWidget.h"		// added by Flugente for DelayBoxDestructionBy(...)
 #include "AIInternals.h"				// sevenfm
 #include "strategic.h"					// shadooow for CreateNewMerc
+#include "PathClusters.h"
+#include "vobject_blitters_sse2.h"
+#include "shading.h"
 
 #ifdef JA2EDITOR
 #include "editscreen.h"
@@ -2678,10 +2682,26 @@ void GetKeyboardInput( UINT32 *puiNewEvent )
 				if( fShift )
 					HandleSelectMercSlot( 6, LOCATE_MERC_ONCE );
 #ifdef JA2TESTVERSION
+				else if( fAlt && fCtrl )
+				{
+					UINT32 uiBlits, uiMismatches;
+
+					if ( !gfBlitterSSE2 )
+						ScreenMsg( FONT_MCOLOR_LTYELLOW, MSG_INTERFACE, L"No SSE2 on this CPU, the asm blitters are used." );
+					else
+					{
+						CompareBlitterSSE2( &uiBlits, &uiMismatches );
+						ScreenMsg( FONT_MCOLOR_LTYELLOW, MSG_INTERFACE, L"SSE2 blitter test: %d blits, %d differ from the asm blitters.", uiBlits, uiMismatches );
+					}
+				}
 				else if( fAlt )
 				{
 					TestMeanWhile( 16 );
 				}
+				else if( fCtrl )
+				{
+					BenchmarkRecordedPathQueries();
+				}
 #endif
 				else
 					HandleSelectMercSlot( 6, LOCATEANDSELECT_MERC );
@@ -2691,10 +2711,22 @@ void GetKeyboardInput( UINT32 *puiNewEvent )
 				if( fShift )
 					HandleSelectMercSlot( 7, LOCATE_MERC_ONCE );
 #ifdef JA2TESTVERSION
+				else if( fAlt && fCtrl )
+				{
+					UINT32 uiMismatches, uiReferenceTime, uiScalarTime, uiSSE2Time;
+
+					CompareFindIndecies( &uiMismatches, &uiReferenceTime, &uiScalarTime, &uiSSE2Time );
+					ScreenMsg( FONT_MCOLOR_LTYELLOW, MSG_INTERFACE, L"Shade table search: %d results differ from the asm search.", uiMismatches );
+					ScreenMsg( FONT_MCOLOR_LTYELLOW, MSG_INTERFACE, L"51 shade tables: asm search %d us, scalar %d us, SSE2 %d us.", uiReferenceTime, uiScalarTime, uiSSE2Time );
+				}
 				else if( fAlt )
 				{
 					TestMeanWhile( 7 );
 				}
+				else if( fCtrl )
+				{
+					BenchmarkSaveGameContainer();
+				}
 #endif
 				else
 					HandleSelectMercSlot( 7, LOCATEANDSELECT_MERC );
@@ -2704,6 +2736,10 @@ void GetKeyboardInput( UINT32 *puiNewEvent )
 				if( fShift )
 					HandleSelectMercSlot( 8, LOCATE_MERC_ONCE );
 #ifdef JA2TESTVERSION
+				else if( fAlt && fCtrl )
+				{
+					BenchmarkObjectStatsCache();
+				}
 				else if( fCtrl )
 				{
 					TestMeanWhile( 8 );
@@ -2724,16 +2760,50 @@ void GetKeyboardInput( UINT32 *puiNewEvent )
 				if( fShift )
 					HandleSelectMercSlot( 9, LOCATE_MERC_ONCE );
 #ifdef JA2TESTVERSION
+				else if( fAlt && fCtrl )
+				{
+					UINT8 ubNumBands = ( gGameExternalOptions.ubRenderBands > 1 ) ? gGameExternalOptions.ubRenderBands : 4;
+					UINT32 uiPixelsDiffer, uiSerialTime, uiBandTime;
+
+					CompareRenderBands( ubNumBands, &uiPixelsDiffer, &uiSerialTime, &uiBandTime );
+					ScreenMsg( FONT_MCOLOR_LTYELLOW, MSG_INTERFACE, L"Render bands: %d pixels differ from the main thread (2-8 bands).", uiPixelsDiffer );
+					ScreenMsg( FONT_MCOLOR_LTYELLOW, MSG_INTERFACE, L"Static world: %d us on the main thread, %d us in %d bands.", uiSerialTime, uiBandTime, ubNumBands );
+				}
 				else if( fAlt )
 				{
 					TestMeanWhile( 9 );
 				}
+				else if( fCtrl )
+				{
+					ReportLuaHookTimings();
+				}
 #endif
 				else
 					HandleSelectMercSlot( 9, LOCATEANDSELECT_MERC );
 				break;
 
 			case F11:
+#ifdef JA2TESTVERSION
+				// only Ctrl or only Shift, every other F11 goes on as before
+				if( fCtrl && !fAlt && !fShift )
+				{
+					RunReplicationLoopbackTest();
+					break;
+				}
+				if( fShift && !fAlt && !fCtrl )
+				{
+					if ( !ProfilerIsRecording() )
+					{
+						ProfilerStart();
+						ScreenMsg( FONT_MCOLOR_LTYELLOW, MSG_INTERFACE, L"Profiler recording." );
+					}
+					else if ( ProfilerStop() )
+						ScreenMsg( FONT_MCOLOR_LTYELLOW, MSG_INTERFACE, L"Profile written to ja2_profile.json and ja2_profile.txt." );
+					else
+						ScreenMsg( FONT_MCOLOR_LTYELLOW, MSG_INTERFACE, L"Could not write the profile." );
+					break;
+				}
+#endif
 				if( fAlt )
 				{
 #ifdef JA2TESTVERSION
@@ -1348,6 +1348,7 @@ void AdjustImpactByHitLocation( INT32 iImpact, UINT8 ubHitLocation, INT32 * piNe
 
 BOOLEAN CheckForGunJam( SOLDIERTYPE * pSoldier ) 
 { 
+	ObjectStatsChange statsChange;
 	OBJECTTYPE * pObj; 
 	// INT32 iChance, iResult; 
  
@@ -2426,6 +2427,7 @@ void PlayWeaponSound(SOLDIERTYPE *pSoldier, OBJECTTYPE *pObjHand, OBJECTTYPE *pO
 // bullets fired in a volley.
 BOOLEAN UseGunNCTH( SOLDIERTYPE *pSoldier , INT32 sTargetGridNo )
 {
+	ObjectStatsChange statsChange;
 	// CTH is now used as a Muzzle Sway value. That is, it determines how wide our shot can go off the "center point"
 	// of the attack. Later on, we'll randomize just how far the shot actually goes within that sway radius.
 	UINT32		uiMuzzleSway;
@@ -3213,6 +3215,7 @@ BOOLEAN UseGunWrapper( SOLDIERTYPE *pSoldier, INT32 sTargetGridNo )
 
 BOOLEAN UseGun( SOLDIERTYPE *pSoldier , INT32 sTargetGridNo )
 {
+	ObjectStatsChange statsChange;
 	if(UsingNewCTHSystem() == true)
 		return UseGunNCTH(pSoldier, sTargetGridNo);
 
@@ -3954,6 +3957,7 @@ BOOLEAN UseGun( SOLDIERTYPE *pSoldier , INT32 sTargetGridNo )
 
 BOOLEAN UseBlade( SOLDIERTYPE *pSoldier , INT32 sTargetGridNo )
 {
+	ObjectStatsChange statsChange;
 	SOLDIERTYPE *				pTargetSoldier;
 	INT32								iHitChance, iDiceRoll;
 	INT16								sXMapPos, sYMapPos;
@@ -5091,6 +5095,7 @@ BOOLEAN UseLauncherWrapper( SOLDIERTYPE *pSoldier, INT32 sTargetGridNo )
 
 BOOLEAN UseLauncher( SOLDIERTYPE *pSoldier, INT32 sTargetGridNo )
 {
+	ObjectStatsChange statsChange;
 	UINT32			uiHitChance;
 	INT16				sAPCost = 0;
 	INT32				iBPCost = 0;
@@ -5547,6 +5552,7 @@ void WeaponHit( SoldierID usSoldierID, UINT16 usWeaponIndex, INT16 sDamage, INT1
 				{
 					pSoldier->inv[pSoldier->ubAttackingHand ][0]->data.gun.usGunAmmoItem = NONE;
 				}
+				InvalidateObjectStats();
 			}
 		    else if ( AmmoTypes[ubAmmoType].explosionSize > 1)
 			{
@@ -5719,6 +5725,7 @@ void StructureHit( INT32 iBullet, UINT16 usWeaponIndex, INT16 bWeaponStatus, Sol
 					{
 						pAttacker->inv[pAttacker->ubAttackingHand ][0]->data.gun.usGunAmmoItem = NONE;
 					}
+					InvalidateObjectStats();
 				}
 				else if ( AmmoTypes[(*pObj)[0]->data.gun.ubGunAmmoType].explosionSize > 1)
 				{
@@ -8186,6 +8193,7 @@ INT32 BulletImpact( SOLDIERTYPE *pFirer, BULLET *pBullet, SOLDIERTYPE * pTarget,
 			damagefactor *= Item[pTarget->inv[ROBOT_CHASSIS_SLOT].usItem].fRobotDamageReductionModifier;
 			OBJECTTYPE* pRobotPlate = &(pTarget->inv[ROBOT_CHASSIS_SLOT]);
 			(*pRobotPlate)[0]->data.objectStatus -= max(1, iOrigImpact/12);
+			InvalidateObjectStats();
 			if((*pRobotPlate)[0]->data.objectStatus <= 0)
 			{
 				ScreenMsg(FONT_MCOLOR_LTYELLOW, MSG_INTERFACE, szRobotText[ROBOT_TEXT_PLATE_DESTROYED]);
@@ -9825,6 +9833,7 @@ UINT32 CalcChanceToSteal(SOLDIERTYPE *pAttacker, SOLDIERTYPE * pDefender, INT16
 
 void ReloadWeapon( SOLDIERTYPE *pSoldier, UINT8 ubHandPos )
 {
+	ObjectStatsChange statsChange;
 	// NB this is a cheat function, don't award experience
 
 	if ( pSoldier->inv[ ubHandPos ].exists() == true )
@@ -84,16 +84,23 @@ void UpdateWorldItems(INT16 x, INT16 y, INT16 z, UINT32 nItems, std::vector<WORL
 		RemoveSectorFromWorldItems(x, y, z);
 		ReSetSectorFlag(x, y, z, SF_ITEM_TEMP_FILE_EXISTS);
 	}
-	else if (SectorIsInWorldItems(x, y, z))
-	{
-		const auto i = FindWorldItemSector(x, y, z);
-		gAllWorldItems.NumItems[i] = nItems;
-		gAllWorldItems.Items[i] = Items;
-	}
 	else
 	{
-		AddSectorItemsToWorldItems(x, y, z, nItems, Items);
-		SetSectorFlag(x, y, z, SF_ITEM_TEMP_FILE_EXISTS);
+		const auto i = FindWorldItemSector(x, y, z);
+		if (i != -1)
+		{
+			gAllWorldItems.NumItems[i] = nItems;
+			// callers may have edited the stored list in place
+			if (&gAllWorldItems.Items[i] != &Items)
+			{
+				gAllWorldItems.Items[i] = Items;
+			}
+		}
+		else
+		{
+			AddSectorItemsToWorldItems(x, y, z, nItems, Items);
+			SetSectorFlag(x, y, z, SF_ITEM_TEMP_FILE_EXISTS);
+		}
 	}
 
 	UINT32 visibleItemCount = 0;
@@ -130,19 +137,28 @@ INT32 GetAmountOfWorldItems(INT16 x, INT16 y, INT16 z)
 
 void PruneWorldItems(void)
 {
-	for (size_t i = 0; i < gAllWorldItems.Items.size(); i++)
+	for (size_t i = 0; i < gAllWorldItems.Items.size(); )
 	{
+		// compact the existing items to the front in one pass, erasing them one by one moved the rest of the list every time
 		std::vector<WORLDITEM>& items = gAllWorldItems.Items[i];
-		for (INT32 j = items.size()-1; j >= 0; j--)
+		size_t uiKept = 0;
+		for (size_t j = 0; j < items.size(); j++)
 		{
-				if (items[j].fExists == false)
+			if (items[j].fExists != false)
+			{
+				if (uiKept != j)
 				{
-					items.erase(items.begin()+j);
+					items[uiKept] = items[j];
 				}
+				uiKept++;
+			}
 		}
+		items.resize(uiKept);
+
 		if (gAllWorldItems.Items[i].size() > 0)
 		{
 			gAllWorldItems.NumItems[i] = gAllWorldItems.Items[i].size();
+			i++;
 		}
 		else
 		{
@@ -796,6 +796,7 @@ void CheckHostileOrSayQuoteList( void )
 
 void HandleSight(SOLDIERTYPE *pSoldier, UINT8 ubSightFlags)
 {
+	PERFORMANCE_MARKER
 	UINT32 uiLoop;
 	SOLDIERTYPE *pThem;
 	INT8			bTempNewSituation;
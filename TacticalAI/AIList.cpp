@@ -8,6 +8,14 @@
  * alert status at the beginning of the turn, in descending order
  * (BLACK, then RED, then YELLOW, then GREEN)
  *
+ * Decisions are made one soldier at a time, in list order, right before
+ * that soldier acts. They can't be evaluated ahead of time or side by side:
+ * the cover code temporarily moves soldiers around (CalcCoverValue), chance
+ * to get through fires fake bullets and fills gLOSTestResults/gUnderFire,
+ * and the pathfinder keeps its queues and AP budget in globals. Anything
+ * that wants to share work between soldiers has to go through caches that
+ * are rebuilt serially (see AIPathCache).
+ *
  */
 
 	#include "AIList.h"
@@ -0,0 +1,275 @@
+	#include "types.h"
+	#include "MemMan.h"
+	#include "ai.h"
+	#include "AIPathCache.h"
+	#include "PATHAI.H"
+	#include "Points.h"
+	#include "Isometric Utils.h"
+	#include "worlddef.h"
+	#include "GameSettings.h"
+
+typedef struct
+{
+	INT16		*psCost;
+	INT32		iSize;
+	UINT32		uiGeneration;
+	UINT32		uiLastUsed;
+	SoldierID	ubSoldierID;
+	INT32		sGridNo;
+	INT8		bLevel;
+	UINT16		usMovementMode;
+	BOOLEAN		fAltPathfinding;
+	INT16		sAPBudget;			// gubNPCAPBudget the field was flooded with, 0 for none
+	UINT8		ubDistLimit;		// gubNPCDistLimit (square) the field was flooded with, 0 for none
+} AI_PATH_FIELD;
+
+static AI_PATH_FIELD	gAIPathFields[ AI_PATH_CACHE_SIZE ];
+static UINT32			guiAIPathCacheGeneration = 1;
+static UINT32			guiAIPathCacheUseCounter = 0;
+
+
+void InvalidateAIPathCache( void )
+{
+	// fields are only trusted if they were built in the current generation
+	guiAIPathCacheGeneration++;
+}
+
+void ShutdownAIPathCache( void )
+{
+	for ( UINT8 cnt = 0; cnt < AI_PATH_CACHE_SIZE; ++cnt )
+	{
+		if ( gAIPathFields[ cnt ].psCost )
+		{
+			MemFree( gAIPathFields[ cnt ].psCost );
+		}
+	}
+
+	memset( gAIPathFields, 0, sizeof( gAIPathFields ) );
+	InvalidateAIPathCache();
+}
+
+// A field covers a search if it was flooded at least as far, in APs and in distance
+static BOOLEAN AIPathFieldCovers( AI_PATH_FIELD *pField, INT16 sAPBudget, UINT8 ubDistLimit )
+{
+	if ( pField->sAPBudget && ( !sAPBudget || sAPBudget > pField->sAPBudget ) )
+		return( FALSE );
+
+	if ( pField->ubDistLimit && ( !ubDistLimit || ubDistLimit > pField->ubDistLimit ) )
+		return( FALSE );
+
+	return( TRUE );
+}
+
+static void BuildAIPathField( AI_PATH_FIELD *pField, SOLDIERTYPE *pSoldier, UINT16 usMovementMode, INT16 sAPBudget, UINT8 ubDistLimit )
+{
+	INT16	sOldAPBudget = gubNPCAPBudget;
+	UINT8	ubOldDistLimit = gubNPCDistLimit;
+	BOOLEAN	fOldCircularDistLimit = gfNPCCircularDistLimit;
+	UINT16	usOldMovementMode = gusNPCMovementMode;
+
+	for ( INT32 cnt = 0; cnt < WORLD_MAX; ++cnt )
+	{
+		pField->psCost[ cnt ] = AI_PATH_COST_UNREACHABLE;
+	}
+
+	// The searches of one soldier differ mostly in their limits, so flood as far as the largest of them can go:
+	// all the APs he has this turn and at least the radius of gubAIPathCosts. An unlimited search stays unlimited.
+	if ( sAPBudget )
+	{
+		sAPBudget = __max( sAPBudget, __max( (INT16)pSoldier->bActionPoints, pSoldier->CalcActionPoints() ) );
+	}
+	if ( ubDistLimit )
+	{
+		ubDistLimit = __max( ubDistLimit, AI_PATHCOST_RADIUS );
+	}
+
+	// without a budget the pathfinder still has to keep track of costs
+	gpsPathDistanceField = pField->psCost;
+	gubNPCAPBudget = sAPBudget ? sAPBudget : AI_PATH_COST_UNREACHABLE - 1;
+	gubNPCDistLimit = ubDistLimit;
+	gfNPCCircularDistLimit = FALSE;
+	gusNPCMovementMode = usMovementMode;
+
+	FindBestPath( pSoldier, GRIDSIZE, pSoldier->pathing.bLevel, usMovementMode, COPYREACHABLE, 0 );
+
+	gpsPathDistanceField = NULL;
+	gubNPCAPBudget = sOldAPBudget;
+	gubNPCDistLimit = ubOldDistLimit;
+	gfNPCCircularDistLimit = fOldCircularDistLimit;
+	gusNPCMovementMode = usOldMovementMode;
+
+	pField->sAPBudget		= sAPBudget;
+	pField->ubDistLimit		= ubDistLimit;
+
+	pField->uiGeneration	= guiAIPathCacheGeneration;
+	pField->ubSoldierID		= pSoldier->ubID;
+	pField->sGridNo			= pSoldier->sGridNo;
+	pField->bLevel			= pSoldier->pathing.bLevel;
+	pField->usMovementMode	= usMovementMode;
+	pField->fAltPathfinding	= gGameSettings.fOptions[ TOPTION_ALT_PATHFINDING ];
+}
+
+// Returns the cached field for this soldier and movement mode that covers the AP budget and distance limit,
+// building it (over the least recently used entry) if necessary and fBuild is set.
+static AI_PATH_FIELD* GetAIPathField( SOLDIERTYPE *pSoldier, UINT16 usMovementMode, INT16 sAPBudget, UINT8 ubDistLimit, BOOLEAN fBuild )
+{
+	AI_PATH_FIELD	*pOldest = &gAIPathFields[0];
+	BOOLEAN			fAltPathfinding = gGameSettings.fOptions[ TOPTION_ALT_PATHFINDING ];
+
+	for ( UINT8 cnt = 0; cnt < AI_PATH_CACHE_SIZE; ++cnt )
+	{
+		AI_PATH_FIELD *pField = &gAIPathFields[ cnt ];
+
+		if ( pField->psCost &&
+			 pField->iSize == WORLD_MAX &&
+			 pField->uiGeneration == guiAIPathCacheGeneration &&
+			 pField->ubSoldierID == pSoldier->ubID &&
+			 pField->sGridNo == pSoldier->sGridNo &&
+			 pField->bLevel == pSoldier->pathing.bLevel &&
+			 pField->usMovementMode == usMovementMode &&
+			 pField->fAltPathfinding == fAltPathfinding &&
+			 AIPathFieldCovers( pField, sAPBudget, ubDistLimit ) )
+		{
+			pField->uiLastUsed = ++guiAIPathCacheUseCounter;
+			return( pField );
+		}
+
+		if ( pField->uiLastUsed < pOldest->uiLastUsed )
+		{
+			pOldest = pField;
+		}
+	}
+
+	if ( !fBuild )
+	{
+		return( NULL );
+	}
+
+	if ( pOldest->iSize != WORLD_MAX )
+	{
+		if ( pOldest->psCost )
+		{
+			MemFree( pOldest->psCost );
+		}
+
+		pOldest->psCost = (INT16 *) MemAlloc( sizeof( INT16 ) * WORLD_MAX );
+		pOldest->iSize = pOldest->psCost ? WORLD_MAX : 0;
+		if ( !pOldest->psCost )
+		{
+			return( NULL );
+		}
+	}
+
+	BuildAIPathField( pOldest, pSoldier, usMovementMode, sAPBudget, ubDistLimit );
+	pOldest->uiLastUsed = ++guiAIPathCacheUseCounter;
+
+	return( pOldest );
+}
+
+void AIFindReachableSpots( SOLDIERTYPE *pSoldier, UINT16 usMovementMode, INT8 bCopy )
+{
+	AI_PATH_FIELD	*pField = NULL;
+	INT16			*psCost;
+	INT32			iBudget = AI_PATH_COST_UNREACHABLE - 1;
+	INT32			iDistLimit = gubNPCDistLimit;
+	INT32			iOriginX, iOriginY, iX, iY;
+
+	if ( bCopy == COPYREACHABLE_AND_APS && ( !iDistLimit || iDistLimit > AI_PATHCOST_RADIUS ) )
+	{
+		iDistLimit = AI_PATHCOST_RADIUS;
+	}
+
+	if ( gGameExternalOptions.fAIPathCache && !TileIsOutOfBounds( pSoldier->sGridNo ) )
+	{
+		pField = GetAIPathField( pSoldier, usMovementMode, gubNPCAPBudget, (UINT8)iDistLimit, TRUE );
+	}
+
+	if ( !pField )
+	{
+		FindBestPath( pSoldier, GRIDSIZE, pSoldier->pathing.bLevel, usMovementMode, bCopy, 0 );
+		return;
+	}
+	psCost = pField->psCost;
+
+	// apply the AP budget the way the pathfinders would
+	if ( gubNPCAPBudget )
+	{
+		if ( gGameSettings.fOptions[ TOPTION_ALT_PATHFINDING ] )
+		{
+			iBudget = gubNPCAPBudget * 100;
+		}
+		else
+		{
+			iBudget = gubNPCAPBudget - MinAPsToStartMovement( pSoldier, usMovementMode );
+		}
+	}
+
+	if ( !iDistLimit )
+	{
+		iDistLimit = __max( WORLD_COLS, WORLD_ROWS );
+	}
+
+	iOriginX = pSoldier->sGridNo % WORLD_COLS;
+	iOriginY = pSoldier->sGridNo / WORLD_COLS;
+
+	for ( iY = __max( iOriginY - iDistLimit, 0 ); iY <= __min( iOriginY + iDistLimit, WORLD_ROWS - 1 ); ++iY )
+	{
+		for ( iX = __max( iOriginX - iDistLimit, 0 ); iX <= __min( iOriginX + iDistLimit, WORLD_COLS - 1 ); ++iX )
+		{
+			INT32 sGridNo = iY * WORLD_COLS + iX;
+
+			if ( psCost[ sGridNo ] > iBudget ||
+				 ( gfNPCCircularDistLimit && PythSpacesAway( pSoldier->sGridNo, sGridNo ) > iDistLimit ) )
+			{
+				gpWorldLevelData[ sGridNo ].uiFlags &= ~(MAPELEMENT_REACHABLE);
+				continue;
+			}
+
+			gpWorldLevelData[ sGridNo ].uiFlags |= MAPELEMENT_REACHABLE;
+
+			if ( bCopy == COPYREACHABLE_AND_APS )
+			{
+				gubAIPathCosts[ AI_PATHCOST_RADIUS + iX - iOriginX ][ AI_PATHCOST_RADIUS + iY - iOriginY ] = psCost[ sGridNo ];
+			}
+		}
+	}
+
+	// like a flood to GRIDSIZE, which never finds its destination
+	gubNPCAPBudget = 0;
+	gubNPCDistLimit = 0;
+}
+
+INT32 AIPathCostToGridNo( SOLDIERTYPE *pSoldier, INT32 sGridNo, UINT16 usMovementMode )
+{
+	AI_PATH_FIELD *pField = NULL;
+
+	// the floods don't know about the extra cost of sneaking or walking backwards, PlotPath() adds it
+	if ( gGameExternalOptions.fAIPathCache && !pSoldier->bStealthMode && !pSoldier->bReverse &&
+		 !TileIsOutOfBounds( pSoldier->sGridNo ) && !TileIsOutOfBounds( sGridNo ) )
+	{
+		// the search before this call has left a field: an unlimited one if there is one, else any
+		pField = GetAIPathField( pSoldier, usMovementMode, 0, 0, FALSE );
+		if ( !pField )
+		{
+			pField = GetAIPathField( pSoldier, usMovementMode, 1, 1, FALSE );
+		}
+	}
+
+	if ( pField && sGridNo == pSoldier->sGridNo )
+	{
+		return( 0 );
+	}
+
+	if ( pField && pField->psCost[ sGridNo ] != AI_PATH_COST_UNREACHABLE )
+	{
+		return( pField->psCost[ sGridNo ] + MinAPsToStartMovement( pSoldier, usMovementMode ) );
+	}
+
+	// only a field flooded without limits knows for sure there's no path
+	if ( pField && !pField->sAPBudget && !pField->ubDistLimit )
+	{
+		return( 0 );
+	}
+
+	return( PlotPath( pSoldier, sGridNo, FALSE, FALSE, FALSE, usMovementMode, pSoldier->bStealthMode, pSoldier->bReverse, 0 ) );
+}
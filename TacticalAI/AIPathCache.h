@@ -0,0 +1,30 @@
+#ifndef __AIPATHCACHE_H
+#define __AIPATHCACHE_H
+
+#include "types.h"
+
+class SOLDIERTYPE;
+
+// Cache of path cost fields for the AI location searches.
+// A field holds the cost to walk from a soldier's position to every tile within its limits, for one movement
+// mode. It's built with a single reachability flood, as far as the soldier's APs this turn (or the search, if
+// that goes further) and at least AI_PATHCOST_RADIUS tiles, the first time it's needed. It's reused by his
+// searches that fit in these limits until he moves, movement costs or structures change or a new turn starts.
+// Other soldiers moving about within a turn don't throw the fields away.
+#define AI_PATH_CACHE_SIZE				8
+#define AI_PATH_COST_UNREACHABLE		0x7FFF
+
+void InvalidateAIPathCache( void );
+void ShutdownAIPathCache( void );
+
+// Same as FindBestPath( pSoldier, GRIDSIZE, pSoldier->pathing.bLevel, usMovementMode, bCopy, 0 ) for bCopy
+// COPYREACHABLE or COPYREACHABLE_AND_APS: sets MAPELEMENT_REACHABLE (and gubAIPathCosts) inside the area
+// given by gubNPCDistLimit, honouring gubNPCAPBudget.
+void AIFindReachableSpots( SOLDIERTYPE *pSoldier, UINT16 usMovementMode, INT8 bCopy );
+
+// Cost of walking to sGridNo, 0 if there's no path. Stands in for PlotPath() when all that's wanted is a cost
+// to compare candidate spots with. Only reads the fields left by the searches before, and asks PlotPath() when
+// they don't know the answer or the soldier sneaks or walks backwards.
+INT32 AIPathCostToGridNo( SOLDIERTYPE *pSoldier, INT32 sGridNo, UINT16 usMovementMode );
+
+#endif
@@ -1344,6 +1344,9 @@ void CalcBestThrow(SOLDIERTYPE *pSoldier, ATTACKTYPE *pBestThrow)
 	DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"calcbestthrow: about to initattacktype");
 	//InitAttackType(pBestThrow);	 // set all structure fields to defaults//dnl ch69 150913
 
+	// the throws at all the squares near an opponent are worked out together, see PrefetchLaunchItemTrajectories()
+	BeginTrajectoryPrefetch();
+
 	// look at the squares near each known opponent and try to find the one
 	// place where a tossed projectile would do the most harm to the opponents
 	// while avoiding one's friends
@@ -1373,6 +1376,27 @@ void CalcBestThrow(SOLDIERTYPE *pSoldier, ATTACKTYPE *pBestThrow)
 		bMaxUp	= ubSearchRange;
 		bMaxDown = ubSearchRange;
 
+		if ( !EXPLOSIVE_GUN( usInHand ) )
+		{
+			INT32	sCandidateTile[ ( 2 * MAX_TOSS_SEARCH_DIST + 3 ) * ( 2 * MAX_TOSS_SEARCH_DIST + 3 ) ];
+			UINT32	uiCandidateCnt = 0;
+
+			for (bYOffset = -bMaxUp; bYOffset <= bMaxDown; bYOffset++)
+			{
+				for (bXOffset = -bMaxLeft; bXOffset <= bMaxRight; bXOffset++)
+				{
+					sGridNo = sOpponentTile[ubLoop] + bXOffset + (MAXCOL * bYOffset);
+
+					if ((sGridNo >= 0) && (sGridNo < GRIDSIZE) && PythSpacesAway( pSoldier->sGridNo, sGridNo ) <= iTossRange)
+					{
+						sCandidateTile[uiCandidateCnt++] = sGridNo;
+					}
+				}
+			}
+
+			PrefetchLaunchItemTrajectories( pSoldier, (pObjGL ? pObjGL : &pSoldier->inv[bPayloadPocket]), sCandidateTile, uiCandidateCnt, bOpponentLevel[ubLoop], 0, TRUE );
+		}
+
 		// evaluate every tile for its opponent-damaging potential
 		for (bYOffset = -bMaxUp; bYOffset <= bMaxDown; bYOffset++)
 		{
@@ -1685,6 +1709,8 @@ void CalcBestThrow(SOLDIERTYPE *pSoldier, ATTACKTYPE *pBestThrow)
 		}
 	}
 
+	EndTrajectoryPrefetch();
+
 	// this is try to minimize enemies wasting their (limited) toss attacks:	
 	UINT8 ubMinChanceToReallyHit;
 
@@ -27,6 +27,7 @@
 	#include "GameSettings.h"
 	#include "Soldier Profile.h"
 	#include "Rotting Corpses.h"	// sevenfm
+	#include "AIPathCache.h"
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -909,7 +910,7 @@ INT32 FindBestNearbyCover(SOLDIERTYPE *pSoldier, INT32 morale, INT32 *piPercentB
 		}
 	}
 
-	FindBestPath( pSoldier, GRIDSIZE, pSoldier->pathing.bLevel, DetermineMovementMode( pSoldier, AI_ACTION_TAKE_COVER ), COPYREACHABLE_AND_APS, 0 );//dnl ch50 071009
+	AIFindReachableSpots( pSoldier, DetermineMovementMode( pSoldier, AI_ACTION_TAKE_COVER ), COPYREACHABLE_AND_APS );//dnl ch50 071009
 
 	// Turn off the "reachable" flag for his current location
 	// so we don't consider it
@@ -1396,7 +1397,7 @@ INT32 FindSpotMaxDistFromOpponents(SOLDIERTYPE *pSoldier)
 		}
 	}
 
-	FindBestPath( pSoldier, GRIDSIZE, pSoldier->pathing.bLevel, DetermineMovementMode( pSoldier, AI_ACTION_RUN_AWAY ), COPYREACHABLE, 0 );//dnl ch50 121009
+	AIFindReachableSpots( pSoldier, DetermineMovementMode( pSoldier, AI_ACTION_RUN_AWAY ), COPYREACHABLE );//dnl ch50 121009
 
 	// Turn off the "reachable" flag for his current location
 	// so we don't consider it
@@ -1571,7 +1572,7 @@ INT32 FindNearestUngassedLand(SOLDIERTYPE *pSoldier)
 		//gubNPCAPBudget = pSoldier->bActionPoints;
 		gubNPCAPBudget = 0;
 		gubNPCDistLimit = (UINT8)iSearchRange;
-		FindBestPath(pSoldier, GRIDSIZE, pSoldier->pathing.bLevel, usMovementMode, COPYREACHABLE, 0);	//dnl ch50 071009
+		AIFindReachableSpots(pSoldier, usMovementMode, COPYREACHABLE);	//dnl ch50 071009
 		gubNPCAPBudget = 0;
 		gubNPCDistLimit = 0;
 
@@ -1626,7 +1627,7 @@ INT32 FindNearestUngassedLand(SOLDIERTYPE *pSoldier)
 					continue;		// skip on to the next potential grid
 				}
 
-				sPathCost = PlotPath(pSoldier, sGridNo, FALSE, FALSE, FALSE, usMovementMode, pSoldier->bStealthMode, pSoldier->bReverse, 0);
+				sPathCost = AIPathCostToGridNo(pSoldier, sGridNo, usMovementMode);
 
 				// check if spot is reachable
 				if(sPathCost == 0)
@@ -1715,7 +1716,7 @@ INT32 FindNearbyDarkerSpot(SOLDIERTYPE *pSoldier)
 		//gubNPCAPBudget = pSoldier->bActionPoints;
 		gubNPCAPBudget = 0;
 		gubNPCDistLimit = (UINT8)iSearchRange;
-		FindBestPath(pSoldier, GRIDSIZE, pSoldier->pathing.bLevel, usMovementMode, COPYREACHABLE, 0);	//dnl ch50 071009
+		AIFindReachableSpots(pSoldier, usMovementMode, COPYREACHABLE);	//dnl ch50 071009
 		gubNPCAPBudget = 0;
 		gubNPCDistLimit = 0;
 
@@ -1791,7 +1792,7 @@ INT32 FindNearbyDarkerSpot(SOLDIERTYPE *pSoldier)
 					continue;		// skip on to the next potential grid
 				}
 
-				sPathCost = PlotPath(pSoldier, sGridNo, FALSE, FALSE, FALSE, usMovementMode, pSoldier->bStealthMode, pSoldier->bReverse, 0);
+				sPathCost = AIPathCostToGridNo(pSoldier, sGridNo, usMovementMode);
 
 				// check if spot is reachable
 				if (sPathCost == 0)
@@ -1929,7 +1930,7 @@ INT8 SearchForItems( SOLDIERTYPE * pSoldier, INT8 bReason, UINT16 usItem )
 		}
 	}
 
-	FindBestPath( pSoldier, GRIDSIZE, pSoldier->pathing.bLevel, DetermineMovementMode( pSoldier, AI_ACTION_PICKUP_ITEM ), COPYREACHABLE, 0 );//dnl ch50 071009
+	AIFindReachableSpots( pSoldier, DetermineMovementMode( pSoldier, AI_ACTION_PICKUP_ITEM ), COPYREACHABLE );//dnl ch50 071009
 
 	// Flugente: if the soldier is 'dumb enough', he may pick up certain items... which can be used to lure the AI into traps
 	if (pSoldier->stats.bWisdom < 70)
@@ -2447,7 +2448,7 @@ INT32 FindNearbyPointOnEdgeOfMap( SOLDIERTYPE * pSoldier, INT8 * pbDirection )
 		}
 	}
 
-	FindBestPath( pSoldier, GRIDSIZE, pSoldier->pathing.bLevel, WALKING, COPYREACHABLE, 0 );//dnl ch50 071009
+	AIFindReachableSpots( pSoldier, WALKING, COPYREACHABLE );//dnl ch50 071009
 
 	// Turn off the "reachable" flag for his current location
 	// so we don't consider it
@@ -2669,7 +2670,7 @@ INT32 FindFlankingSpot(SOLDIERTYPE *pSoldier, INT32 sPos, INT8 bAction )
 		}
 	}
 
-	FindBestPath( pSoldier, GRIDSIZE, pSoldier->pathing.bLevel, DetermineMovementMode( pSoldier, bAction ), COPYREACHABLE, 0 );//dnl ch50 071009
+	AIFindReachableSpots( pSoldier, DetermineMovementMode( pSoldier, bAction ), COPYREACHABLE );//dnl ch50 071009
 
 	// Turn off the "reachable" flag for his current location
 	// so we don't consider it
@@ -3185,7 +3186,7 @@ INT32 FindAdvanceSpot(SOLDIERTYPE *pSoldier, INT32 sTargetSpot, INT8 bAction, UI
 		}
 	}
 
-	FindBestPath(pSoldier, GRIDSIZE, pSoldier->pathing.bLevel, usMovementMode, COPYREACHABLE, 0);
+	AIFindReachableSpots(pSoldier, usMovementMode, COPYREACHABLE);
 
 	// Turn off the "reachable" flag for his current location
 	// so we don't consider it
@@ -3445,7 +3446,7 @@ INT32 FindRetreatSpot(SOLDIERTYPE *pSoldier)
 	}
 
 	usMovementMode = DetermineMovementMode(pSoldier, bAction);
-	FindBestPath(pSoldier, GRIDSIZE, pSoldier->pathing.bLevel, usMovementMode, COPYREACHABLE, 0);
+	AIFindReachableSpots(pSoldier, usMovementMode, COPYREACHABLE);
 
 	// Turn off the "reachable" flag for his current location
 	// so we don't consider it
@@ -2084,6 +2084,7 @@ BOOLEAN DishOutGasDamage( SOLDIERTYPE * pSoldier, EXPLOSIVETYPE * pExplosive, IN
 				sWoundAmt = 0;
 			}
 
+			InvalidateObjectStats();
 		}
 	}
 
@@ -7,21 +7,18 @@
 	#include "video.h"
 	#include "WorldDat.h"
 	#include "FileMan.h"
+	#include "shade_palette_store.h"
 
 #include <vfs/Core/vfs.h>
 
 #define		SHADE_TABLE_DIR				"ShadeTables"
+#define		SHADE_TABLE_CACHE			"ShadeTables.dat"
 
 
 
 extern CHAR8 TileSurfaceFilenames[NUMBEROFTILETYPES][32]; // symbol already declared globally in worlddef.cpp (jonathanl)
 BOOLEAN gfForceBuildShadeTables = FALSE;
 
-#ifdef JA2TESTVERSION
-	extern UINT32 uiNumTablesSaved;
-	extern UINT32 uiNumTablesLoaded;
-#endif
-
 void DetermineRGBDistributionSettings()
 {
 	STRING512			ShadeTableDir;
@@ -111,98 +108,30 @@ void DetermineRGBDistributionSettings()
 	//SetFileManCurrentDirectory( DataDir );
 }
 
-BOOLEAN LoadShadeTable( HVOBJECT pObj, UINT32 uiTileTypeIndex )
+BOOLEAN LoadShadeTableCache( )
 {
-	HWFILE hfile;
-	INT32 i;
-	UINT32 uiNumBytesRead;
-	CHAR8 ShadeFileName[ 100 ];
-	CHAR8 *ptr;
-	//ASSUMPTIONS:
-	//We are assuming that the uiTileTypeIndex is referring to the correct file
-	//stored in the TileSurfaceFilenames[].	If it isn't, then that is a huge problem
-	//and should be fixed.	Also assumes that the directory is set to Data\ShadeTables.
-	
-	//BF
-	//strcpy( ShadeFileName, TileSurfaceFilenames[ uiTileTypeIndex ] );
-	sprintf( ShadeFileName, "%s\\%s", SHADE_TABLE_DIR, TileSurfaceFilenames[ uiTileTypeIndex ] );
-	
-	ptr = strstr( ShadeFileName, "." );
-	if( !ptr )
-	{
-		return FALSE;
-	}
-	ptr++;
-	sprintf( ptr, "sha" );
-
-	//hfile = FileOpen( ShadeFileName, FILE_ACCESS_READ, FALSE );
-	//if( !hfile )
-	//{ //File doesn't exist, so generate it
-	//	FileClose( hfile );
-	if(!FileExists(ShadeFileName))
-	{
-		return FALSE;
-	}
-	hfile = FileOpen( ShadeFileName, FILE_ACCESS_READ, FALSE );
+	CHAR8 sCacheFile[50];
 
-	//MISSING:	Compare time stamps.
+	//The shade tables of all tilesets and all light colours are kept in this one file (the shade palette
+	//store knows them by their palette, so there is no need for one file per tileset image any more). The
+	//old .sha files are left alone.
+	sprintf( sCacheFile, "%s\\%s", SHADE_TABLE_DIR, SHADE_TABLE_CACHE );
 
-	for( i = 0; i < 16; i++ )
-	{
-		pObj->pShades[ i ] = (UINT16 *) MemAlloc( 512 );
-		Assert( pObj->pShades[ i ] );
-		FileRead( hfile, pObj->pShades[ i ], 512, &uiNumBytesRead );
-	}
-
-	//The file exists, now make sure the
-	FileClose( hfile );
-	#ifdef JA2TESTVERSION
-		uiNumTablesLoaded++;
-	#endif
-	return TRUE;
+	return( LoadShadePaletteCache( sCacheFile ) );
 }
 
-BOOLEAN SaveShadeTable( HVOBJECT pObj, UINT32 uiTileTypeIndex )
+BOOLEAN SaveShadeTableCache( )
 {
-	HWFILE hfile;
-	INT32 i;
-	UINT32 uiNumBytesWritten;
-	CHAR8 ShadeFileName[ 100 ];
-	CHAR8 *ptr;
-#ifdef JA2TESTVERSION
-	uiNumTablesSaved++;
-#endif
-	//ASSUMPTIONS:
-	//We are assuming that the uiTileTypeIndex is referring to the correct file
-	//stored in the TileSurfaceFilenames[].	If it isn't, then that is a huge problem
-	//and should be fixed.	Also assumes that the directory is set to Data\ShadeTables.
-	
-	// BF
-	//strcpy( ShadeFileName, TileSurfaceFilenames[ uiTileTypeIndex ] );
-	sprintf_s( ShadeFileName, "%s\\%s", SHADE_TABLE_DIR, TileSurfaceFilenames[ uiTileTypeIndex ] );
+	CHAR8 sCacheFile[50];
 
-	ptr = strstr( ShadeFileName, "." );
-	if( !ptr )
-	{
-		return FALSE;
+	if( !ShadePaletteCacheChanged( ) )
+	{ //Nothing new since it was loaded or saved
+		return TRUE;
 	}
-	ptr++;
-	sprintf( ptr, "sha" );
 
-	hfile = FileOpen( ShadeFileName, FILE_ACCESS_WRITE | FILE_CREATE_ALWAYS, FALSE );
-	if( !hfile )
-	{
-		FileClose( hfile );
-		AssertMsg( 0, String( "Can't create %s", ShadeFileName ) );
-		return FALSE;
-	}
-	for( i = 0; i < 16; i++ )
-	{
-		FileWrite( hfile, pObj->pShades[ i ], 512, &uiNumBytesWritten );
-	}
+	sprintf( sCacheFile, "%s\\%s", SHADE_TABLE_DIR, SHADE_TABLE_CACHE );
 
-	FileClose( hfile );
-	return TRUE;
+	return( SaveShadePaletteCache( sCacheFile ) );
 }
 
 
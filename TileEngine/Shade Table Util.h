@@ -4,8 +4,9 @@
 #include "TileDat.h"
 
 void DetermineRGBDistributionSettings();
-BOOLEAN LoadShadeTable( HVOBJECT pObj, UINT32 uiTileTypeIndex );
-BOOLEAN SaveShadeTable( HVOBJECT pObj, UINT32 uiTileTypeIndex );
+// the cache file of the shade palette store, which holds every shade table built so far
+BOOLEAN LoadShadeTableCache( );
+BOOLEAN SaveShadeTableCache( );
 
 extern CHAR8 TileSurfaceFilenames[NUMBEROFTILETYPES][32]; 
 extern BOOLEAN gfForceBuildShadeTables;
@@ -25,6 +25,7 @@
 	// sevenfm
 	#include "environment.h"
 	#include "Render Fun.h"
+	#include "LOS.h"
 
 #include "SaveLoadGame.h"
 #include "Debug Control.h"
@@ -491,6 +492,7 @@ void AddSmokeEffectToTile( INT32 iSmokeEffectID, INT8 bType, INT32 sGridNo, INT8
 	{
 		// Set world flags
 		gpWorldLevelData[ sGridNo ].ubExtFlags[ bLevel ] |= FromSmokeTypeToWorldFlags( bType );
+		InvalidateSightCache();
 		return;
 	}
 
@@ -641,6 +643,7 @@ void AddSmokeEffectToTile( INT32 iSmokeEffectID, INT8 bType, INT32 sGridNo, INT8
 
 	// Set world flags
 	gpWorldLevelData[ sGridNo ].ubExtFlags[ bLevel ] |= FromSmokeTypeToWorldFlags( bType );
+	InvalidateSightCache();
 
 	// All done...
 
@@ -683,6 +686,7 @@ void RemoveSmokeEffectFromTile( INT32 sGridNo, INT8 bLevel )
 	if ( GetCachedAniTileOfType( sGridNo, ubLevelID, ANITILE_SMOKE_EFFECT ) == NULL )
 	{
 		gpWorldLevelData[ sGridNo ].ubExtFlags[ bLevel ] &= ( ~ANY_SMOKE_EFFECT );
+		InvalidateSightCache();
 	}
 }
 
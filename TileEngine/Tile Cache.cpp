@@ -4,10 +4,17 @@
 	#include "Debug Control.h"
 	#include "Tile Surface.h"
 	#include "Tile Cache.h"
+	#include "GameSettings.h"
 #ifdef JA2TESTVERSION
 	#include "Sys Globals.h"
 #endif
 
+#include <ctype.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+
 UINT32	guiNumTileCacheStructs = 0;
 UINT32 guiMaxTileCacheSize		= 50;
 UINT32 guiCurTileCacheSize		= 0;
@@ -16,6 +23,147 @@ INT32	giDefaultStructIndex	= -1;
 TILE_CACHE_ELEMENT		*gpTileCache = NULL;
 TILE_CACHE_STRUCT			*gpTileCacheStructInfo = NULL;
 
+// lower case filename -> index into gpTileCache, lower case root name -> index into gpTileCacheStructInfo
+static std::unordered_map<std::string, INT32>	gTileCacheIndex;
+static std::unordered_map<std::string, INT16>	gTileCacheStructIndex;
+
+static TILE_CACHE_STATS	gTileCacheStats;
+static UINT32			guiTileCacheClockHand = 0;
+
+// Shade tables are shared between video objects (see shade_palette_store.h), so they are counted once for the
+// whole cache: the tables each cached tile was counted with, and how many cached tiles use each table.
+static std::vector<UINT16*>					gTileCacheShades[ TILE_CACHE_MAX_SIZE ];
+static std::unordered_map<UINT16*, UINT32>	gTileCacheShadeRefs;
+
+static std::string TileCacheKey( const STR8 cFilename )
+{
+	std::string key( cFilename );
+
+	for ( size_t cnt = 0; cnt < key.size(); ++cnt )
+	{
+		key[ cnt ] = (CHAR8)tolower( (UINT8)key[ cnt ] );
+	}
+
+	return( key );
+}
+
+// memory of the imagery itself, without the shade tables
+static UINT32 GetTileImageryBytes( TILE_IMAGERY *pImagery )
+{
+	HVOBJECT	hVObject = pImagery->vo;
+
+	return( hVObject->uiSizePixData + hVObject->usNumberOfObjects * sizeof( ETRLEObject ) );
+}
+
+// Counts the shade tables of a newly cached tile, returns the memory of those no other cached tile uses
+static UINT32 AddTileCacheShades( UINT32 uiIndex )
+{
+	HVOBJECT				hVObject = gpTileCache[ uiIndex ].pImagery->vo;
+	std::vector<UINT16*>	&Shades = gTileCacheShades[ uiIndex ];
+	UINT32					uiBytes = 0;
+
+	for ( UINT32 cnt = 0; cnt < HVOBJECT_SHADE_TABLES; ++cnt )
+	{
+		UINT16 *pTable = hVObject->pShades[ cnt ];
+
+		if ( pTable != NULL && std::find( Shades.begin(), Shades.end(), pTable ) == Shades.end() )
+		{
+			Shades.push_back( pTable );
+			if ( ++gTileCacheShadeRefs[ pTable ] == 1 )
+			{
+				uiBytes += 256 * sizeof( UINT16 );
+			}
+		}
+	}
+
+	return( uiBytes );
+}
+
+// Forgets the shade tables of a tile leaving the cache, returns the memory of those no cached tile uses any more
+static UINT32 RemoveTileCacheShades( UINT32 uiIndex )
+{
+	std::vector<UINT16*>	&Shades = gTileCacheShades[ uiIndex ];
+	UINT32					uiBytes = 0;
+
+	for ( size_t cnt = 0; cnt < Shades.size(); ++cnt )
+	{
+		std::unordered_map<UINT16*, UINT32>::iterator it = gTileCacheShadeRefs.find( Shades[ cnt ] );
+
+		if ( it != gTileCacheShadeRefs.end() && --it->second == 0 )
+		{
+			gTileCacheShadeRefs.erase( it );
+			uiBytes += 256 * sizeof( UINT16 );
+		}
+	}
+	Shades.clear();
+
+	return( uiBytes );
+}
+
+static void EvictCachedTile( UINT32 uiIndex )
+{
+	TILE_CACHE_ELEMENT *pElement = &gpTileCache[ uiIndex ];
+
+	gTileCacheIndex.erase( TileCacheKey( pElement->zName ) );
+	gTileCacheStats.uiBytes -= pElement->uiBytes + RemoveTileCacheShades( uiIndex );
+	gTileCacheStats.uiNumTiles--;
+	gTileCacheStats.uiEvictions++;
+
+	DeleteTileSurface( pElement->pImagery );
+
+	pElement->pImagery = NULL;
+	pElement->sHits = 0;
+	pElement->uiBytes = 0;
+	pElement->sStructRefID = -1;
+}
+
+// Evicts unused tiles, the least recently used first (CLOCK), until the cache fits in its budget. With fFreeSlot
+// one tile is evicted in any case. Tiles still in use are never evicted. Returns FALSE if nothing could be evicted.
+static BOOLEAN TrimTileCache( BOOLEAN fFreeSlot )
+{
+	// two rounds, as the first may only clear the reference bits
+	UINT32 uiSteps = 2 * guiCurTileCacheSize;
+
+	while ( ( fFreeSlot || gTileCacheStats.uiBytes > gGameExternalOptions.uiTileCacheBudget ) && uiSteps-- > 0 )
+	{
+		if ( guiTileCacheClockHand >= guiCurTileCacheSize )
+		{
+			guiTileCacheClockHand = 0;
+		}
+
+		TILE_CACHE_ELEMENT *pElement = &gpTileCache[ guiTileCacheClockHand ];
+
+		if ( pElement->pImagery != NULL && pElement->sHits <= 0 )
+		{
+			if ( pElement->fRecentlyUsed )
+			{
+				pElement->fRecentlyUsed = FALSE;
+			}
+			else
+			{
+				EvictCachedTile( guiTileCacheClockHand );
+				fFreeSlot = FALSE;
+			}
+		}
+
+		guiTileCacheClockHand++;
+	}
+
+	return( !fFreeSlot );
+}
+
+static void InitTileCacheElements( UINT32 uiStart, UINT32 uiEnd )
+{
+	for ( UINT32 cnt = uiStart; cnt < uiEnd; cnt++ )
+	{
+		gpTileCache[ cnt ].pImagery = NULL;
+		gpTileCache[ cnt ].sHits = 0;
+		gpTileCache[ cnt ].uiBytes = 0;
+		gpTileCache[ cnt ].fRecentlyUsed = FALSE;
+		gpTileCache[ cnt ].sStructRefID = -1;
+	}
+}
+
 
 
 BOOLEAN InitTileCache(	)
@@ -27,13 +175,13 @@ BOOLEAN InitTileCache(	)
 	gpTileCache = (TILE_CACHE_ELEMENT *)MemAlloc( sizeof( TILE_CACHE_ELEMENT ) * guiMaxTileCacheSize );
 
 	// Zero entries
-	for ( cnt = 0; cnt < guiMaxTileCacheSize; cnt++ )
-	{
-		gpTileCache[ cnt ].pImagery = NULL;
-		gpTileCache[ cnt ].sStructRefID = -1;
-	}
+	InitTileCacheElements( 0, guiMaxTileCacheSize );
 
 	guiCurTileCacheSize = 0;
+	guiTileCacheClockHand = 0;
+	gTileCacheIndex.clear();
+	gTileCacheStructIndex.clear();
+	memset( &gTileCacheStats, 0, sizeof( gTileCacheStats ) );
 
 
 	// OK, look for JSD files in the tile cache directory and
@@ -80,6 +228,9 @@ BOOLEAN InitTileCache(	)
 			giDefaultStructIndex = cnt;
 		}
 
+				// the first file of a name wins, like with the old linear search
+				gTileCacheStructIndex.insert( std::make_pair( TileCacheKey( gpTileCacheStructInfo[ cnt ].zRootName ), (INT16)cnt ) );
+
 				cnt++;
 			}
 			GetFileClose(&FileInfo);
@@ -103,8 +254,10 @@ void DeleteTileCache( )
 			{
 				DeleteTileSurface( gpTileCache[ cnt ].pImagery );
 			}
+			gTileCacheShades[ cnt ].clear();
 		}
 		MemFree( gpTileCache );
+		gpTileCache = NULL;
 	}
 
 	if ( gpTileCacheStructInfo != NULL )
@@ -113,18 +266,20 @@ void DeleteTileCache( )
 	}
 
 	guiCurTileCacheSize = 0;
+	guiTileCacheClockHand = 0;
+	gTileCacheIndex.clear();
+	gTileCacheStructIndex.clear();
+	gTileCacheShadeRefs.clear();
+	memset( &gTileCacheStats, 0, sizeof( gTileCacheStats ) );
 }
 
 INT16 FindCacheStructDataIndex( STR8 cFilename )
 {
-	UINT32 cnt;
+	std::unordered_map<std::string, INT16>::const_iterator it = gTileCacheStructIndex.find( TileCacheKey( cFilename ) );
 
-	for ( cnt = 0; cnt < guiNumTileCacheStructs; cnt++ )
+	if ( it != gTileCacheStructIndex.end() )
 	{
-		if ( _stricmp( gpTileCacheStructInfo[ cnt ].zRootName, cFilename ) == 0 )
-		{
-			return(	(INT16)cnt );
-		}
+		return( it->second );
 	}
 
 	return( -1 );
@@ -133,120 +288,128 @@ INT16 FindCacheStructDataIndex( STR8 cFilename )
 INT32 GetCachedTile( const STR8 cFilename )
 {
 	UINT32			cnt;
-	UINT32			ubLowestIndex = 0;
-	INT16		sMostHits = (INT16)15000;
 
 	// Check to see if surface exists already
-	for ( cnt = 0; cnt < guiCurTileCacheSize; cnt++ )
+	std::unordered_map<std::string, INT32>::const_iterator it = gTileCacheIndex.find( TileCacheKey( cFilename ) );
+
+	if ( it != gTileCacheIndex.end() )
 	{
-		if ( gpTileCache[ cnt ].pImagery != NULL )
-		{
-			if ( _stricmp( gpTileCache[ cnt ].zName, cFilename ) == 0 )
-			{
-				// Found surface, return
-				gpTileCache[ cnt ].sHits++;
-				return( (INT32)cnt );
-			}
-		}
+		// Found surface, return
+		gpTileCache[ it->second ].sHits++;
+		gpTileCache[ it->second ].fRecentlyUsed = TRUE;
+		gTileCacheStats.uiHits++;
+		return( it->second );
 	}
 
-	// Check if max size has been reached
-	if ( guiCurTileCacheSize == guiMaxTileCacheSize )
+	gTileCacheStats.uiMisses++;
+
+	// Find an empty slot
+	for ( cnt = 0; cnt < guiMaxTileCacheSize; cnt++ )
 	{
-		// cache out least used file
-		for ( cnt = 0; cnt < guiCurTileCacheSize; cnt++ )
+		if ( gpTileCache[ cnt ].pImagery == NULL )
 		{
-			if ( gpTileCache[ cnt ].sHits < sMostHits )
-			{
-					sMostHits = gpTileCache[ cnt ].sHits;
-					ubLowestIndex = cnt;
-			}
+			break;
 		}
-
-		// Bump off lowest index
-		DeleteTileSurface( gpTileCache[ ubLowestIndex ].pImagery );
-
-		// Decrement
-		gpTileCache[ ubLowestIndex ].sHits = 0;
-		gpTileCache[ ubLowestIndex ].pImagery = NULL;
-		gpTileCache[ ubLowestIndex ].sStructRefID = -1;
 	}
 
-	// If here, Insert at an empty slot
-	// Find an empty slot
-	for ( cnt = 0; cnt < guiMaxTileCacheSize; cnt++ )
+	if ( cnt == guiMaxTileCacheSize )
 	{
-		if ( gpTileCache[ cnt ].pImagery == NULL )
+		if ( guiMaxTileCacheSize < TILE_CACHE_MAX_SIZE )
 		{
-			// Insert here
-			gpTileCache[ cnt ].pImagery = LoadTileSurface( cFilename );
+			// Grow the cache, the memory budget decides how much stays cached
+			UINT32 uiNewSize = __min( guiMaxTileCacheSize * 2, TILE_CACHE_MAX_SIZE );
+			TILE_CACHE_ELEMENT *pNewCache = (TILE_CACHE_ELEMENT *)MemRealloc( gpTileCache, sizeof( TILE_CACHE_ELEMENT ) * uiNewSize );
 
-			if ( gpTileCache[ cnt ].pImagery == NULL )
+			if ( pNewCache == NULL )
 			{
 				return( -1 );
 			}
 
-			strcpy( gpTileCache[ cnt ].zName, cFilename );
-			gpTileCache[ cnt ].sHits = 1;
-
-			// Get root name
-			GetRootName( gpTileCache[ cnt ].zRootName, cFilename );
-
-			gpTileCache[ cnt ].sStructRefID = FindCacheStructDataIndex( gpTileCache[ cnt ].zRootName );
-
-			// ATE: Add z-strip info
-			if ( gpTileCache[ cnt ].sStructRefID != -1 )
+			gpTileCache = pNewCache;
+			InitTileCacheElements( guiMaxTileCacheSize, uiNewSize );
+			guiMaxTileCacheSize = uiNewSize;
+		}
+		else
+		{
+			// cache out the least recently used tile nobody is using
+			if ( !TrimTileCache( TRUE ) )
 			{
-				AddZStripInfoToVObject( gpTileCache[ cnt ].pImagery->vo, gpTileCacheStructInfo[	gpTileCache[ cnt ].sStructRefID ].pStructureFileRef, TRUE, 0 );
+				return( -1 );
 			}
 
-			if ( gpTileCache[ cnt ].pImagery->pAuxData != NULL )
-			{
-				gpTileCache[ cnt ].ubNumFrames = gpTileCache[ cnt ].pImagery->	pAuxData->ubNumberOfFrames;
-			}
-			else
+			for ( cnt = 0; cnt < guiMaxTileCacheSize; cnt++ )
 			{
-				gpTileCache[ cnt ].ubNumFrames = 1;
+				if ( gpTileCache[ cnt ].pImagery == NULL )
+				{
+					break;
+				}
 			}
+		}
+	}
 
-			// Has our cache size increased?
-			if ( cnt >= guiCurTileCacheSize )
-			{
-				guiCurTileCacheSize = cnt + 1;;
-			}
+	// Insert here
+	gpTileCache[ cnt ].pImagery = LoadTileSurface( cFilename );
 
-			return( cnt );
-		}
+	if ( gpTileCache[ cnt ].pImagery == NULL )
+	{
+		return( -1 );
 	}
 
-	// Can't find one!
-	return( -1 );
+	strcpy( gpTileCache[ cnt ].zName, cFilename );
+	gpTileCache[ cnt ].sHits = 1;
+	gpTileCache[ cnt ].fRecentlyUsed = TRUE;
+
+	// Get root name
+	GetRootName( gpTileCache[ cnt ].zRootName, cFilename );
+
+	gpTileCache[ cnt ].sStructRefID = FindCacheStructDataIndex( gpTileCache[ cnt ].zRootName );
+
+	// ATE: Add z-strip info
+	if ( gpTileCache[ cnt ].sStructRefID != -1 )
+	{
+		AddZStripInfoToVObject( gpTileCache[ cnt ].pImagery->vo, gpTileCacheStructInfo[	gpTileCache[ cnt ].sStructRefID ].pStructureFileRef, TRUE, 0 );
+	}
+
+	if ( gpTileCache[ cnt ].pImagery->pAuxData != NULL )
+	{
+		gpTileCache[ cnt ].ubNumFrames = gpTileCache[ cnt ].pImagery->	pAuxData->ubNumberOfFrames;
+	}
+	else
+	{
+		gpTileCache[ cnt ].ubNumFrames = 1;
+	}
+
+	// Has our cache size increased?
+	if ( cnt >= guiCurTileCacheSize )
+	{
+		guiCurTileCacheSize = cnt + 1;
+	}
+
+	gpTileCache[ cnt ].uiBytes = GetTileImageryBytes( gpTileCache[ cnt ].pImagery );
+	gTileCacheStats.uiBytes += gpTileCache[ cnt ].uiBytes + AddTileCacheShades( cnt );
+	gTileCacheStats.uiNumTiles++;
+	gTileCacheIndex[ TileCacheKey( gpTileCache[ cnt ].zName ) ] = (INT32)cnt;
+
+	// make room for it if we're over budget now
+	TrimTileCache( FALSE );
+
+	return( cnt );
 }
 
 
 BOOLEAN RemoveCachedTile( INT32 iCachedTile )
 {
-	UINT32			cnt;
-
 	// Find tile
-	for ( cnt = 0; cnt < guiCurTileCacheSize; cnt++ )
+	if ( iCachedTile >= 0 && (UINT32)iCachedTile < guiCurTileCacheSize && gpTileCache[ iCachedTile ].pImagery != NULL )
 	{
-		if ( gpTileCache[ cnt ].pImagery != NULL )
-		{
-			if ( cnt == (UINT32)iCachedTile )
-			{
-				// Found surface, decrement hits
-				gpTileCache[ cnt ].sHits--;
+		// Found surface, decrement hits
+		gpTileCache[ iCachedTile ].sHits--;
 
-				// Are we at zero?
-				if ( gpTileCache[ cnt ].sHits == 0 )
-				{
-						DeleteTileSurface( gpTileCache[ cnt ].pImagery );
-						gpTileCache[ cnt ].pImagery = NULL;
-						gpTileCache[ cnt ].sStructRefID = -1;
-						return( TRUE );;
-				}
-			}
+		// Are we at zero? Then it's only kept as long as the memory budget allows
+		if ( gpTileCache[ iCachedTile ].sHits == 0 )
+		{
+			TrimTileCache( FALSE );
+			return( TRUE );
 		}
 	}
 
@@ -254,6 +417,12 @@ BOOLEAN RemoveCachedTile( INT32 iCachedTile )
 }
 
 
+void GetTileCacheStats( TILE_CACHE_STATS *pStats )
+{
+	*pStats = gTileCacheStats;
+}
+
+
 HVOBJECT GetCachedTileVideoObject( INT32 iIndex )
 {
 	if ( iIndex == -1 )
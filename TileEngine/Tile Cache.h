@@ -3,13 +3,17 @@
 
 
 #define	TILE_CACHE_START_INDEX		36000
+// the cache grows as needed, but cached tile IDs have to stay below 65536 - TILE_CACHE_START_INDEX
+#define	TILE_CACHE_MAX_SIZE			4096
 
 typedef struct
 {
 	CHAR8					zName[ 128 ];			// Name of tile ( filename and directory here )
 	CHAR8					zRootName[ 30 ];	// Root name
 	TILE_IMAGERY	*pImagery;				// Tile imagery
-	INT16					sHits;
+	INT16					sHits;					// number of users (animations, corpses); unused tiles stay cached until evicted
+	UINT32				uiBytes;				// memory used by the imagery, without the shade tables
+	BOOLEAN				fRecentlyUsed;	// reference bit for the CLOCK eviction
 	UINT8					ubNumFrames;
 	INT16					sStructRefID;
 
@@ -23,6 +27,16 @@ typedef struct
 
 } TILE_CACHE_STRUCT;
 
+typedef struct
+{
+	UINT32					uiHits;
+	UINT32					uiMisses;
+	UINT32					uiEvictions;
+	UINT32					uiBytes;				// memory used by all cached tiles, each shared shade table counted once
+	UINT32					uiNumTiles;
+
+} TILE_CACHE_STATS;
+
 
 extern TILE_CACHE_ELEMENT		*gpTileCache;
 
@@ -45,4 +59,6 @@ void CheckForAndDeleteTileCacheStructInfo( LEVELNODE *pNode, UINT16 usIndex );
 
 void GetRootName( STR8 pDestStr, const STR8 pSrcStr );
 
+void GetTileCacheStats( TILE_CACHE_STATS *pStats );
+
 #endif
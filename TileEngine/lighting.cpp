@@ -26,6 +26,7 @@
 	#include "lighting.h"
 	#include "Structure Wrap.h"
 	#include "Shade Table Util.h"
+	#include "shade_palette_store.h"
 	#include "Rotting Corpses.h"
 	#include "PATHAI.H"
 
@@ -3492,14 +3493,18 @@ BOOLEAN LightSpriteDirty(INT32 iSprite)
 BOOLEAN CreateObjectPalette(HVOBJECT pObj, UINT32 uiBase, SGPPaletteEntry *pShadePal)
 {
 UINT32 uiCount;
+UINT64 uiPaletteHash;
 
-	pObj->pShades[uiBase]=Create16BPPPaletteShaded( pShadePal, gusShadeLevels[0][0],
+	// tiles with the same palette under the same light share their tables
+	uiPaletteHash = HashShadePalette( pShadePal );
+
+	pObj->pShades[uiBase]=AcquireShadePalette( pShadePal, uiPaletteHash, gusShadeLevels[0][0],
 																															gusShadeLevels[0][1],
 																															gusShadeLevels[0][2], TRUE);
 
 	for(uiCount=1; uiCount < 16; uiCount++)
 	{
-		pObj->pShades[uiBase+uiCount]=Create16BPPPaletteShaded( pShadePal, gusShadeLevels[uiCount][0],
+		pObj->pShades[uiBase+uiCount]=AcquireShadePalette( pShadePal, uiPaletteHash, gusShadeLevels[uiCount][0],
 																																				gusShadeLevels[uiCount][1],
 																																				gusShadeLevels[uiCount][2], FALSE);
 	}
@@ -3536,51 +3541,25 @@ BOOLEAN CreateSoldierShadedPalette( SOLDIERTYPE *pSoldier, UINT32 uiBase, SGPPal
 	adjust automagically.
 
 **********************************************************************************************/
-#ifdef JA2TESTVERSION
-	extern UINT32 uiNumTablesSaved;
-#endif
-
-UINT16 CreateTilePaletteTables(HVOBJECT pObj, UINT32 uiTileIndex, BOOLEAN fForce )
+UINT16 CreateTilePaletteTables(HVOBJECT pObj)
 {
 		UINT32 uiCount;
 		SGPPaletteEntry LightPal[256];
-		BOOLEAN fLoaded = FALSE;
 
 		Assert(pObj!=NULL);
 
 		// create the basic shade table
-		if( !gfForceBuildShadeTables && !fForce )
-		{ //The overwhelming majority of maps use the neutral 0,0,0 light for outdoors.	These shadetables
-			//are extremely time consuming to generate, so we will attempt to load them.	If we do, then
-			//we skip the generation process altogether.
-			if( LoadShadeTable( pObj, uiTileIndex ) )
-			{
-				fLoaded = TRUE;
-			}
-		}
-		if( !fLoaded )
-		{ //This is expensive as hell to call!
-			for(uiCount=0; uiCount < 256; uiCount++)
-			{
-				// combine the rgb of the light color with the object's palette
-				LightPal[uiCount].peRed=(UINT8)(__min((UINT16)pObj->pPaletteEntry[uiCount].peRed+(UINT16)gpLightColors[0].peRed, 255));
-				LightPal[uiCount].peGreen=(UINT8)(__min((UINT16)pObj->pPaletteEntry[uiCount].peGreen+(UINT16)gpLightColors[0].peGreen, 255));
-				LightPal[uiCount].peBlue=(UINT8)(__min((UINT16)pObj->pPaletteEntry[uiCount].peBlue+(UINT16)gpLightColors[0].peBlue, 255));
-			}
-			// build the shade tables
-			CreateObjectPalette(pObj, 0, LightPal);
-
-			//We paid to generate the shade table, so now save it, so we don't have to regenerate it ever
-			//again!
-			if( !gfForceBuildShadeTables && !gpLightColors[0].peRed && !gpLightColors[0].peGreen && !gpLightColors[0].peBlue )
-			{
-				SaveShadeTable( pObj, uiTileIndex );
-			}
-			#ifdef JA2TESTVERSION
-			else
-				uiNumTablesSaved++;
-			#endif
+		//The tables come from the shade palette store, which only computes the ones that no other tile
+		//uses and that aren't in the shade table cache, see BuildTileShadeTables().
+		for(uiCount=0; uiCount < 256; uiCount++)
+		{
+			// combine the rgb of the light color with the object's palette
+			LightPal[uiCount].peRed=(UINT8)(__min((UINT16)pObj->pPaletteEntry[uiCount].peRed+(UINT16)gpLightColors[0].peRed, 255));
+			LightPal[uiCount].peGreen=(UINT8)(__min((UINT16)pObj->pPaletteEntry[uiCount].peGreen+(UINT16)gpLightColors[0].peGreen, 255));
+			LightPal[uiCount].peBlue=(UINT8)(__min((UINT16)pObj->pPaletteEntry[uiCount].peBlue+(UINT16)gpLightColors[0].peBlue, 255));
 		}
+		// build the shade tables
+		CreateObjectPalette(pObj, 0, LightPal);
 
 		// if two lights are active
 		if(gubNumLightColors==2)
@@ -167,7 +167,7 @@ BOOLEAN		LightHideRays(INT16 iX, INT16 iY);
 
 
 // makes the 16-bit palettes
-UINT16		CreateTilePaletteTables(HVOBJECT pObj, UINT32 uiType, BOOLEAN fForce );
+UINT16		CreateTilePaletteTables(HVOBJECT pObj);
 BOOLEAN		CreateSoldierShadedPalette( SOLDIERTYPE *pSoldier, UINT32 uiBase, SGPPaletteEntry *pShadePal);
 UINT16		CreateSoldierPaletteTables(SOLDIERTYPE *pSoldier, UINT32 uiType);
 
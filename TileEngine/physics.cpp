@@ -21,6 +21,11 @@
 	#include "Map Information.h"	// added by Shadooow
 #include "connect.h"
 #include "PATHAI.H"
+#include "vobject_blitters_sse2.h"
+
+#include <emmintrin.h>
+#include <map>
+#include <vector>
 
 
 //forward declarations of common classes to eliminate includes
@@ -79,6 +84,7 @@ real						Kdl	= (float)( 0.1 * TIME_MULTI );					// LINEAR DAMPENING ( WIND RESI
 #define					SCALE_HORZ_VAL_TO_VERT( f )				( ( f / CELL_X_SIZE ) * HEIGHT_UNITS )
 
 void SimulateObject( REAL_OBJECT *pObject, real deltaT );
+static void SimulateObjectMotion( REAL_OBJECT *pObject, real deltaT );
 
 void CheckForObjectHittingMerc( REAL_OBJECT *pObject, UINT16 usStructureID );
 extern void DoGenericHit( SOLDIERTYPE *pSoldier, UINT8 ubSpecial, INT16 bDirection );
@@ -363,60 +369,66 @@ void SimulateObject( REAL_OBJECT *pObject, real deltaT )
 	//	DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"SimulateObject: check life");
 	if ( pObject->fAlive )
 	{
-		//DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"SimulateObject: do subtime");
-		// Do subtime here....
-
-		if ( !PhysicsComputeForces( pObject ) )
-		{
-			//			DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"SimulateObject: couldn't compute forces");
-			return;
-		}
+		SimulateObjectMotion( pObject, deltaT );
+	}
+}
 
-		real CurrentTime = 0;
-		real DeltaTime = (float)deltaT / 10.0f;
-		real TargetTime = (float)deltaT;
-		INT32			iCollisionID;
-		BOOLEAN		fEndThisObject = FALSE;
 
-		while( CurrentTime < TargetTime )
-		{
-			//MADD TO KAIDEN: HERE IS THE PROBLEM:	For some reason fEndThisObject is never set to true
-			//			DebugMsg (TOPIC_JA2,DBG_LEVEL_3,String("SimulateObject: in loop while CurrentTime < TargetTime: %d < %d",CurrentTime,TargetTime));
+// The frame of SimulateObject after the life check: forces, integration and collisions, and the move to the new gridno
+static void SimulateObjectMotion( REAL_OBJECT *pObject, real deltaT )
+{
+	//DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"SimulateObject: do subtime");
+	// Do subtime here....
 
-			if ( !PhysicsIntegrate( pObject, DeltaTime ) )
-			{
-				fEndThisObject = TRUE;
-				break;
-			}
+	if ( !PhysicsComputeForces( pObject ) )
+	{
+		//			DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"SimulateObject: couldn't compute forces");
+		return;
+	}
 
-			if ( !PhysicsHandleCollisions( pObject, &iCollisionID, DeltaTime	) )
-			{
-				fEndThisObject = TRUE;
-				break;
-			}
+	real CurrentTime = 0;
+	real DeltaTime = (float)deltaT / 10.0f;
+	real TargetTime = (float)deltaT;
+	INT32			iCollisionID;
+	BOOLEAN		fEndThisObject = FALSE;
 
-			if ( iCollisionID != COLLISION_NONE )
-			{
-				break;
-			}
+	while( CurrentTime < TargetTime )
+	{
+		//MADD TO KAIDEN: HERE IS THE PROBLEM:	For some reason fEndThisObject is never set to true
+		//			DebugMsg (TOPIC_JA2,DBG_LEVEL_3,String("SimulateObject: in loop while CurrentTime < TargetTime: %d < %d",CurrentTime,TargetTime));
 
-			CurrentTime += DeltaTime;
+		if ( !PhysicsIntegrate( pObject, DeltaTime ) )
+		{
+			fEndThisObject = TRUE;
+			break;
 		}
 
-		//DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"SimulateObject: check if ending this object");
-		if ( fEndThisObject )
+		if ( !PhysicsHandleCollisions( pObject, &iCollisionID, DeltaTime	) )
 		{
-			//DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"SimulateObject: object ended, returning");
-			return;
+			fEndThisObject = TRUE;
+			break;
 		}
 
-		//DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"SimulateObject: try moving the object");
-		if ( !PhysicsMoveObject( pObject ) )
+		if ( iCollisionID != COLLISION_NONE )
 		{
-			//DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"SimulateObject: couldn't move object, returning");
-			return;
+			break;
 		}
 
+		CurrentTime += DeltaTime;
+	}
+
+	//DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"SimulateObject: check if ending this object");
+	if ( fEndThisObject )
+	{
+		//DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"SimulateObject: object ended, returning");
+		return;
+	}
+
+	//DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"SimulateObject: try moving the object");
+	if ( !PhysicsMoveObject( pObject ) )
+	{
+		//DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"SimulateObject: couldn't move object, returning");
+		return;
 	}
 }
 
@@ -1472,89 +1484,218 @@ void ObjectHitWindow( INT32 sGridNo, UINT16 usStructureID, BOOLEAN fBlowWindowSo
 }
 
 
-vector_3 FindBestForceForTrajectory( INT32 sSrcGridNo, INT32 sGridNo,INT16 sStartZ, INT16 sEndZ, real dzDegrees, OBJECTTYPE *pItem, INT32 *psGridNo, real *pdMagForce )
+// One search of FindBestForceForTrajectory, so that searches for many targets can be run side by side
+typedef struct
 {
-	vector_3		vDirNormal, vPosition, vForce;
-	INT16				sDestX, sDestY, sSrcX, sSrcY;
-	real				dForce		= 20;
+	vector_3		vPosition;
+	vector_3		vDirNormal;
+	vector_3		vForce;
+	real				dForce;
 	real				dRange;
-	real				dPercentDiff = 0;
-	real				dTestRange, dTestDiff;
-	INT32				iNumChecks = 0;
+	INT32				iNumChecks;
+	INT32				sFinalGridNo;
+} FORCE_SEARCH;
+
+static void StartForceSearch( FORCE_SEARCH *pSearch, INT32 sSrcGridNo, INT32 sGridNo, INT16 sStartZ, real dzDegrees )
+{
+	INT16				sDestX, sDestY, sSrcX, sSrcY;
 
 	// Get XY from gridno
 	ConvertGridNoToCenterCellXY( sGridNo, &sDestX, &sDestY );
 	ConvertGridNoToCenterCellXY( sSrcGridNo, &sSrcX, &sSrcY );
 
 	// Set position
-	vPosition.x = sSrcX;
-	vPosition.y = sSrcY;
-	vPosition.z = sStartZ;
+	pSearch->vPosition.x = sSrcX;
+	pSearch->vPosition.y = sSrcY;
+	pSearch->vPosition.z = sStartZ;
 
 	// OK, get direction normal
-	vDirNormal.x = (float)(sDestX - sSrcX);
-	vDirNormal.y = (float)(sDestY - sSrcY);
-	vDirNormal.z = 0;
+	pSearch->vDirNormal.x = (float)(sDestX - sSrcX);
+	pSearch->vDirNormal.y = (float)(sDestY - sSrcY);
+	pSearch->vDirNormal.z = 0;
 
 	// NOmralize
-	vDirNormal = VGetNormal( &vDirNormal );
+	pSearch->vDirNormal = VGetNormal( &(pSearch->vDirNormal) );
 
 	// From degrees, calculate Z portion of normal
-	vDirNormal.z	= (float)sin( dzDegrees );
+	pSearch->vDirNormal.z	= (float)sin( dzDegrees );
 
 	// Get range
-	dRange = (float)GetRangeInCellCoordsFromGridNoDiff( sGridNo, sSrcGridNo );
+	pSearch->dRange = (float)GetRangeInCellCoordsFromGridNoDiff( sGridNo, sSrcGridNo );
 
 	//calculate force needed
-	dForce = (float)( 12.0 * ( sqrt( ( GRAVITY * dRange ) / sin( 2.0 * dzDegrees ) ) ) );
+	pSearch->dForce = (float)( 12.0 * ( sqrt( ( GRAVITY * pSearch->dRange ) / sin( 2.0 * dzDegrees ) ) ) );
 
-	do
+	pSearch->iNumChecks = 0;
+	pSearch->sFinalGridNo = NOWHERE;
+}
+
+// Sets vForce to the next force to try
+static void NextForceSearchThrow( FORCE_SEARCH *pSearch )
+{
+	// This first force is just an estimate...
+	// now di a binary search to find best value....
+	pSearch->iNumChecks++;
+
+	// Now use a force
+	pSearch->vForce.x = pSearch->dForce * pSearch->vDirNormal.x;
+	pSearch->vForce.y = pSearch->dForce * pSearch->vDirNormal.y;
+	pSearch->vForce.z = pSearch->dForce * pSearch->vDirNormal.z;
+}
+
+// Takes the range the last throw went, returns TRUE if its force is the one to use
+static BOOLEAN ForceSearchDone( FORCE_SEARCH *pSearch, real dTestRange )
+{
+	real				dPercentDiff, dTestDiff;
+
+	// What's the diff?
+	dTestDiff = dTestRange - pSearch->dRange;
+
+	// How have we done?
+	// < 5% off...
+	if ( fabs( ( dTestDiff / pSearch->dRange ) ) < .01 )
 	{
-		// This first force is just an estimate...
-		// now di a binary search to find best value....
-		iNumChecks++;
+		return( TRUE );
+	}
 
+	if ( pSearch->iNumChecks > MAX_INTEGRATIONS )
+	{
+		return( TRUE );
+	}
 
-		// Now use a force
-		vForce.x = dForce * vDirNormal.x;
-		vForce.y = dForce * vDirNormal.y;
-		vForce.z = dForce * vDirNormal.z;
+	// What is the Percentage difference?
+	dPercentDiff = pSearch->dForce * ( dTestDiff / pSearch->dRange );
 
-		dTestRange = CalculateObjectTrajectory( sEndZ, pItem, &vPosition, &vForce, psGridNo );
+	// Adjust force accordingly
+	pSearch->dForce = pSearch->dForce - ( ( dPercentDiff ) / 2 );
 
-		// What's the diff?
-		dTestDiff = dTestRange - dRange;
+	return( FALSE );
+}
 
-		// How have we done?
-		// < 5% off...
-		if ( fabs( ( dTestDiff / dRange ) ) < .01 )
-		{
-			break;
-		}
+// While a trajectory prefetch is on, FindBestForceForTrajectory remembers its results here. The AI looks at the
+// same throws again and again while it compares targets (the max force of a soldier is searched for every target),
+// and PrefetchLaunchItemTrajectories fills in the first search of many targets at once. Nothing that moves a
+// test flight changes while the AI thinks, so the table is simply thrown away when the prefetch ends.
+struct TRAJECTORY_KEY
+{
+	INT32				sSrcGridNo;
+	INT32				sGridNo;
+	INT16				sStartZ;
+	INT16				sEndZ;
+	real				dzDegrees;
+	UINT16			usItem;
 
-		if ( iNumChecks > MAX_INTEGRATIONS )
+	bool operator<( const TRAJECTORY_KEY &other ) const
+	{
+		if ( sSrcGridNo != other.sSrcGridNo )	return( sSrcGridNo < other.sSrcGridNo );
+		if ( sGridNo != other.sGridNo )			return( sGridNo < other.sGridNo );
+		if ( sStartZ != other.sStartZ )			return( sStartZ < other.sStartZ );
+		if ( sEndZ != other.sEndZ )				return( sEndZ < other.sEndZ );
+		if ( dzDegrees != other.dzDegrees )		return( dzDegrees < other.dzDegrees );
+		return( usItem < other.usItem );
+	}
+};
+
+typedef struct
+{
+	vector_3		vForce;
+	real				dMagForce;
+	INT32				sFinalGridNo;
+} TRAJECTORY_RESULT;
+
+static BOOLEAN										gfTrajectoryPrefetch = FALSE;
+static std::map<TRAJECTORY_KEY, TRAJECTORY_RESULT>	gTrajectoryPrefetch;
+
+// a test flight only looks at the item to see if it detonates on impact
+static TRAJECTORY_KEY MakeTrajectoryKey( INT32 sSrcGridNo, INT32 sGridNo, INT16 sStartZ, INT16 sEndZ, real dzDegrees, OBJECTTYPE *pItem )
+{
+	TRAJECTORY_KEY Key;
+
+	Key.sSrcGridNo = sSrcGridNo;
+	Key.sGridNo = sGridNo;
+	Key.sStartZ = sStartZ;
+	Key.sEndZ = sEndZ;
+	Key.dzDegrees = dzDegrees;
+	Key.usItem = pItem->usItem;
+
+	return( Key );
+}
+
+static void StoreTrajectoryResult( const TRAJECTORY_KEY &Key, FORCE_SEARCH *pSearch )
+{
+	TRAJECTORY_RESULT &Result = gTrajectoryPrefetch[ Key ];
+
+	Result.vForce = pSearch->vForce;
+	Result.dMagForce = pSearch->dForce;
+	Result.sFinalGridNo = pSearch->sFinalGridNo;
+}
+
+void BeginTrajectoryPrefetch( void )
+{
+	gfTrajectoryPrefetch = TRUE;
+}
+
+void EndTrajectoryPrefetch( void )
+{
+	gfTrajectoryPrefetch = FALSE;
+	gTrajectoryPrefetch.clear();
+}
+
+vector_3 FindBestForceForTrajectory( INT32 sSrcGridNo, INT32 sGridNo,INT16 sStartZ, INT16 sEndZ, real dzDegrees, OBJECTTYPE *pItem, INT32 *psGridNo, real *pdMagForce )
+{
+	FORCE_SEARCH	Search;
+	real				dTestRange;
+	TRAJECTORY_KEY	Key;
+
+	if ( gfTrajectoryPrefetch )
+	{
+		Key = MakeTrajectoryKey( sSrcGridNo, sGridNo, sStartZ, sEndZ, dzDegrees, pItem );
+
+		std::map<TRAJECTORY_KEY, TRAJECTORY_RESULT>::const_iterator it = gTrajectoryPrefetch.find( Key );
+		if ( it != gTrajectoryPrefetch.end() )
 		{
-			break;
+			if ( psGridNo )
+			{
+				(*psGridNo) = it->second.sFinalGridNo;
+			}
+			if ( pdMagForce )
+			{
+				(*pdMagForce) = it->second.dMagForce;
+			}
+			return( it->second.vForce );
 		}
+	}
 
-		// What is the Percentage difference?
-		dPercentDiff = dForce * ( dTestDiff / dRange );
+	StartForceSearch( &Search, sSrcGridNo, sGridNo, sStartZ, dzDegrees );
 
-		// Adjust force accordingly
-		dForce = dForce - ( ( dPercentDiff ) / 2 );
+	do
+	{
+		NextForceSearchThrow( &Search );
 
-	} while( TRUE );
+		dTestRange = CalculateObjectTrajectory( sEndZ, pItem, &(Search.vPosition), &(Search.vForce), &(Search.sFinalGridNo) );
+
+	} while( !ForceSearchDone( &Search, dTestRange ) );
+
+	if ( gfTrajectoryPrefetch )
+	{
+		StoreTrajectoryResult( Key, &Search );
+	}
+
+	if ( psGridNo )
+	{
+		(*psGridNo) = Search.sFinalGridNo;
+	}
 
 	if ( pdMagForce )
 	{
-		(*pdMagForce) = dForce;
+		(*pdMagForce) = Search.dForce;
 	}
 
 #ifdef JA2TESTVERSION
-	//ScreenMsg( FONT_MCOLOR_LTYELLOW, MSG_TESTVERSION, L"Number of integration: %d", iNumChecks );
+	//ScreenMsg( FONT_MCOLOR_LTYELLOW, MSG_TESTVERSION, L"Number of integration: %d", Search.iNumChecks );
 #endif
 
-	return( vForce );
+	return( Search.vForce );
 }
 
 
@@ -1747,20 +1888,10 @@ void FindTrajectory( INT32 sSrcGridNo, INT32 sGridNo, INT16 sStartZ, INT16 sEndZ
 // OK, this will, given a target Z, INVTYPE, source, target gridnos, initial force vector, will
 // return range
 
-FLOAT CalculateObjectTrajectory( INT16 sTargetZ, OBJECTTYPE *pItem, vector_3 *vPosition, vector_3 *vForce, INT32 *psFinalGridNo )
+static REAL_OBJECT *CreateTrajectoryTestObject( INT16 sTargetZ, OBJECTTYPE *pItem, vector_3 *vPosition, vector_3 *vForce )
 {
-	DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"CalculateObjectTrajectory");
 	INT32 iID;
 	REAL_OBJECT *pObject;
-	FLOAT	dDiffX, dDiffY;
-	INT32 sGridNo;
-	//int cnt=0;
-
-	if ( psFinalGridNo )
-	{
-		(*psFinalGridNo) = NOWHERE;
-	}
-
 
 	DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"CalculateObjectTrajectory: createphysicalobject");
 	// OK, create a physics object....
@@ -1768,8 +1899,7 @@ FLOAT CalculateObjectTrajectory( INT16 sTargetZ, OBJECTTYPE *pItem, vector_3 *vP
 
 	if ( iID == -1 )
 	{
-		DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"CalculateObjectTrajectory: returning -1");
-		return( -1 );
+		return( NULL );
 	}
 
 	pObject = &( ObjectSlots[ iID ] );
@@ -1780,13 +1910,14 @@ FLOAT CalculateObjectTrajectory( INT16 sTargetZ, OBJECTTYPE *pItem, vector_3 *vP
 	pObject->fTestPositionNotSet = TRUE;
 	pObject->fVisible		= FALSE;
 
-	// Alrighty, move this beast until it dies....
-	while( pObject->fAlive )
-	{
-		//cnt = cnt + 1;
-		//		DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"CalculateObjectTrajectory: calling simulateobject - this object never fucking dies!!!!");
-		SimulateObject( pObject, (float)DELTA_T );
-	}
+	return( pObject );
+}
+
+// Deletes a test object that has come to rest, returns the range it went
+static FLOAT FinishTrajectoryTestObject( REAL_OBJECT *pObject, vector_3 *vPosition, INT32 *psFinalGridNo )
+{
+	FLOAT	dDiffX, dDiffY;
+	INT32 sGridNo;
 
 	// Calculate gridno from last position
 	sGridNo = MAPROWCOLTOPOS( ( (INT16)pObject->Position.y / CELL_Y_SIZE ), ( (INT16)pObject->Position.x / CELL_X_SIZE ) );
@@ -1805,7 +1936,305 @@ FLOAT CalculateObjectTrajectory( INT16 sTargetZ, OBJECTTYPE *pItem, vector_3 *vP
 
 	DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"CalculateObjectTrajectory: done");
 	return( (FLOAT)sqrt( ( dDiffX * dDiffX ) + ( dDiffY * dDiffY ) ) );
+}
+
+FLOAT CalculateObjectTrajectory( INT16 sTargetZ, OBJECTTYPE *pItem, vector_3 *vPosition, vector_3 *vForce, INT32 *psFinalGridNo )
+{
+	DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"CalculateObjectTrajectory");
+	REAL_OBJECT *pObject;
+	//int cnt=0;
+
+	if ( psFinalGridNo )
+	{
+		(*psFinalGridNo) = NOWHERE;
+	}
+
+	pObject = CreateTrajectoryTestObject( sTargetZ, pItem, vPosition, vForce );
+
+	if ( pObject == NULL )
+	{
+		DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"CalculateObjectTrajectory: returning -1");
+		return( -1 );
+	}
+
+	// Alrighty, move this beast until it dies....
+	while( pObject->fAlive )
+	{
+		//cnt = cnt + 1;
+		//		DebugMsg (TOPIC_JA2,DBG_LEVEL_3,"CalculateObjectTrajectory: calling simulateobject - this object never fucking dies!!!!");
+		SimulateObject( pObject, (float)DELTA_T );
+	}
+
+	return( FinishTrajectoryTestObject( pObject, vPosition, psFinalGridNo ) );
+}
+
+
+// Test flights side by side, one per lane. A test flight without collisions (TEST_OBJECT_NO_COLLISIONS) is pure
+// arithmetic until it comes down through its target height: no world lookups, and every frame takes the same
+// integration steps. That part is done for TRAJECTORY_LANES flights at once, with SSE2 if the CPU has it. The
+// frame in which a flight comes down is thrown away and done again by SimulateObject, which also flies the few
+// bounces after it, so the results are exactly those of CalculateObjectTrajectory.
+#define TRAJECTORY_LANES		4
+
+typedef struct
+{
+	REAL_OBJECT		*pObject[ TRAJECTORY_LANES ];
+	UINT32			uiFlight[ TRAJECTORY_LANES ];
+
+	// copied in and out of the objects every frame
+	FLOAT				dPosX[ TRAJECTORY_LANES ], dPosY[ TRAJECTORY_LANES ], dPosZ[ TRAJECTORY_LANES ];
+	FLOAT				dOldPosX[ TRAJECTORY_LANES ], dOldPosY[ TRAJECTORY_LANES ], dOldPosZ[ TRAJECTORY_LANES ];
+	FLOAT				dVelX[ TRAJECTORY_LANES ], dVelY[ TRAJECTORY_LANES ], dVelZ[ TRAJECTORY_LANES ];
+	FLOAT				dOldVelX[ TRAJECTORY_LANES ], dOldVelY[ TRAJECTORY_LANES ], dOldVelZ[ TRAJECTORY_LANES ];
+	FLOAT				dForceX[ TRAJECTORY_LANES ], dForceY[ TRAJECTORY_LANES ], dForceZ[ TRAJECTORY_LANES ];
+	FLOAT				dForceScale[ TRAJECTORY_LANES ];		// DeltaTime * OneOverMass
+	FLOAT				dTargetZ[ TRAJECTORY_LANES ];
+} TRAJECTORY_BATCH;
+
+// The number of steps SimulateObjectMotion integrates in a frame without collisions
+static UINT32 CountSimulationSteps( real deltaT )
+{
+	real CurrentTime = 0;
+	real DeltaTime = (float)deltaT / 10.0f;
+	real TargetTime = (float)deltaT;
+	UINT32 uiSteps = 0;
+
+	while( CurrentTime < TargetTime )
+	{
+		uiSteps++;
+		CurrentTime += DeltaTime;
+	}
+
+	return( uiSteps );
+}
+
+// uiSteps times PhysicsIntegrate and the target height test PhysicsCheckForCollisions does for TEST_OBJECT_NO_COLLISIONS,
+// in every lane. Returns a bit for each lane that came down below its target height in one of the steps, whatever
+// is left in such a lane afterwards is of no use.
+static UINT32 IntegrateTrajectoryLanes( TRAJECTORY_BATCH *pBatch, real DeltaTime, UINT32 uiSteps )
+{
+	UINT32 uiLanding = 0;
+	UINT32 uiStep, uiLane;
+
+	// the blitters have already asked the CPU about SSE2
+	if ( gfBlitterSSE2 )
+	{
+		__m128 vDeltaTime = _mm_set1_ps( DeltaTime );
+		__m128 vZero = _mm_setzero_ps();
+		__m128 vForceScale = _mm_loadu_ps( pBatch->dForceScale );
+		__m128 vTargetZ = _mm_loadu_ps( pBatch->dTargetZ );
+		__m128 vForceX = _mm_mul_ps( _mm_loadu_ps( pBatch->dForceX ), vForceScale );
+		__m128 vForceY = _mm_mul_ps( _mm_loadu_ps( pBatch->dForceY ), vForceScale );
+		__m128 vForceZ = _mm_mul_ps( _mm_loadu_ps( pBatch->dForceZ ), vForceScale );
+		__m128 vPosX = _mm_loadu_ps( pBatch->dPosX );
+		__m128 vPosY = _mm_loadu_ps( pBatch->dPosY );
+		__m128 vPosZ = _mm_loadu_ps( pBatch->dPosZ );
+		__m128 vVelX = _mm_loadu_ps( pBatch->dVelX );
+		__m128 vVelY = _mm_loadu_ps( pBatch->dVelY );
+		__m128 vVelZ = _mm_loadu_ps( pBatch->dVelZ );
+		__m128 vOldPosX = vPosX, vOldPosY = vPosY, vOldPosZ = vPosZ;
+		__m128 vOldVelX = vVelX, vOldVelY = vVelY, vOldVelZ = vVelZ;
+
+		for ( uiStep = 0; uiStep < uiSteps; uiStep++ )
+		{
+			vOldPosX = vPosX;
+			vOldPosY = vPosY;
+			vOldPosZ = vPosZ;
+			vOldVelX = vVelX;
+			vOldVelY = vVelY;
+			vOldVelZ = vVelZ;
+
+			// same operations in the same order as PhysicsIntegrate, so the lanes round the same way
+			vPosX = _mm_add_ps( vPosX, _mm_mul_ps( vVelX, vDeltaTime ) );
+			vPosY = _mm_add_ps( vPosY, _mm_mul_ps( vVelY, vDeltaTime ) );
+			vPosZ = _mm_add_ps( vPosZ, _mm_mul_ps( vVelZ, vDeltaTime ) );
+
+			vVelX = _mm_add_ps( vVelX, vForceX );
+			vVelY = _mm_add_ps( vVelY, vForceY );
+			vVelZ = _mm_add_ps( vVelZ, vForceZ );
+
+			// below the target height and on the way down?
+			uiLanding |= _mm_movemask_ps( _mm_and_ps( _mm_cmplt_ps( vPosZ, vTargetZ ), _mm_cmplt_ps( _mm_sub_ps( vPosZ, vOldPosZ ), vZero ) ) );
+		}
+
+		_mm_storeu_ps( pBatch->dPosX, vPosX );
+		_mm_storeu_ps( pBatch->dPosY, vPosY );
+		_mm_storeu_ps( pBatch->dPosZ, vPosZ );
+		_mm_storeu_ps( pBatch->dOldPosX, vOldPosX );
+		_mm_storeu_ps( pBatch->dOldPosY, vOldPosY );
+		_mm_storeu_ps( pBatch->dOldPosZ, vOldPosZ );
+		_mm_storeu_ps( pBatch->dVelX, vVelX );
+		_mm_storeu_ps( pBatch->dVelY, vVelY );
+		_mm_storeu_ps( pBatch->dVelZ, vVelZ );
+		_mm_storeu_ps( pBatch->dOldVelX, vOldVelX );
+		_mm_storeu_ps( pBatch->dOldVelY, vOldVelY );
+		_mm_storeu_ps( pBatch->dOldVelZ, vOldVelZ );
+
+		return( uiLanding );
+	}
+
+	for ( uiLane = 0; uiLane < TRAJECTORY_LANES; uiLane++ )
+	{
+		FLOAT dForceX = pBatch->dForceX[ uiLane ] * pBatch->dForceScale[ uiLane ];
+		FLOAT dForceY = pBatch->dForceY[ uiLane ] * pBatch->dForceScale[ uiLane ];
+		FLOAT dForceZ = pBatch->dForceZ[ uiLane ] * pBatch->dForceScale[ uiLane ];
+
+		for ( uiStep = 0; uiStep < uiSteps; uiStep++ )
+		{
+			pBatch->dOldPosX[ uiLane ] = pBatch->dPosX[ uiLane ];
+			pBatch->dOldPosY[ uiLane ] = pBatch->dPosY[ uiLane ];
+			pBatch->dOldPosZ[ uiLane ] = pBatch->dPosZ[ uiLane ];
+			pBatch->dOldVelX[ uiLane ] = pBatch->dVelX[ uiLane ];
+			pBatch->dOldVelY[ uiLane ] = pBatch->dVelY[ uiLane ];
+			pBatch->dOldVelZ[ uiLane ] = pBatch->dVelZ[ uiLane ];
+
+			pBatch->dPosX[ uiLane ] += pBatch->dVelX[ uiLane ] * DeltaTime;
+			pBatch->dPosY[ uiLane ] += pBatch->dVelY[ uiLane ] * DeltaTime;
+			pBatch->dPosZ[ uiLane ] += pBatch->dVelZ[ uiLane ] * DeltaTime;
+
+			pBatch->dVelX[ uiLane ] += dForceX;
+			pBatch->dVelY[ uiLane ] += dForceY;
+			pBatch->dVelZ[ uiLane ] += dForceZ;
+
+			if ( pBatch->dPosZ[ uiLane ] < pBatch->dTargetZ[ uiLane ] && ( pBatch->dPosZ[ uiLane ] - pBatch->dOldPosZ[ uiLane ] ) < 0 )
+			{
+				uiLanding |= ( 1 << uiLane );
+				break;
+			}
+		}
+	}
+
+	return( uiLanding );
+}
+
+// CalculateObjectTrajectory for uiCount throws with the same item and target height
+static void CalculateObjectTrajectories( UINT32 uiCount, INT16 sTargetZ, OBJECTTYPE *pItem, vector_3 *pvPosition, vector_3 *pvForce, INT32 *psFinalGridNo, FLOAT *pdRange )
+{
+	TRAJECTORY_BATCH	Batch;
+	REAL_OBJECT			*pObject;
+	UINT32				uiNext = 0, uiLane, uiFlight, uiSteps, uiLanding;
+	BOOLEAN				fActive;
+	real				deltaT = (float)DELTA_T;
+	real				DeltaTime = (float)deltaT / 10.0f;
+
+	if ( fDampingActive )
+	{
+		// PhysicsComputeForces has more to do then
+		for ( uiFlight = 0; uiFlight < uiCount; uiFlight++ )
+		{
+			pdRange[ uiFlight ] = CalculateObjectTrajectory( sTargetZ, pItem, &pvPosition[ uiFlight ], &pvForce[ uiFlight ], &psFinalGridNo[ uiFlight ] );
+		}
+		return;
+	}
+
+	memset( &Batch, 0, sizeof( Batch ) );
+	uiSteps = CountSimulationSteps( deltaT );
+
+	do
+	{
+		fActive = FALSE;
+
+		for ( uiLane = 0; uiLane < TRAJECTORY_LANES; uiLane++ )
+		{
+			// start the next flight in a free lane
+			while ( Batch.pObject[ uiLane ] == NULL && uiNext < uiCount )
+			{
+				psFinalGridNo[ uiNext ] = NOWHERE;
+				pdRange[ uiNext ] = -1;
+
+				Batch.pObject[ uiLane ] = CreateTrajectoryTestObject( sTargetZ, pItem, &pvPosition[ uiNext ], &pvForce[ uiNext ] );
+				Batch.uiFlight[ uiLane ] = uiNext;
+				uiNext++;
+			}
+
+			pObject = Batch.pObject[ uiLane ];
+			if ( pObject == NULL )
+			{
+				continue;
+			}
+
+			uiFlight = Batch.uiFlight[ uiLane ];
+
+			if ( !PhysicsUpdateLife( pObject, deltaT ) )
+			{
+				// off the visible map
+				pdRange[ uiFlight ] = FinishTrajectoryTestObject( pObject, &pvPosition[ uiFlight ], &psFinalGridNo[ uiFlight ] );
+				Batch.pObject[ uiLane ] = NULL;
+				continue;
+			}
+
+			// what PhysicsComputeForces does for a flying object
+			Batch.dForceX[ uiLane ] = pObject->InitialForce.x;
+			Batch.dForceY[ uiLane ] = pObject->InitialForce.y;
+			Batch.dForceZ[ uiLane ] = pObject->InitialForce.z;
+			Batch.dForceZ[ uiLane ] -= (real)GRAVITY;
+			Batch.dForceScale[ uiLane ] = DeltaTime * pObject->OneOverMass;
+			Batch.dTargetZ[ uiLane ] = pObject->TestZTarget;
+
+			Batch.dPosX[ uiLane ] = pObject->Position.x;
+			Batch.dPosY[ uiLane ] = pObject->Position.y;
+			Batch.dPosZ[ uiLane ] = pObject->Position.z;
+			Batch.dVelX[ uiLane ] = pObject->Velocity.x;
+			Batch.dVelY[ uiLane ] = pObject->Velocity.y;
+			Batch.dVelZ[ uiLane ] = pObject->Velocity.z;
+
+			fActive = TRUE;
+		}
+
+		if ( !fActive )
+		{
+			continue;
+		}
+
+		uiLanding = IntegrateTrajectoryLanes( &Batch, DeltaTime, uiSteps );
+
+		for ( uiLane = 0; uiLane < TRAJECTORY_LANES; uiLane++ )
+		{
+			pObject = Batch.pObject[ uiLane ];
+			if ( pObject == NULL )
+			{
+				continue;
+			}
+
+			if ( uiLanding & ( 1 << uiLane ) )
+			{
+				// the object is still as it was at the start of the frame, fly the rest of the way the slow way
+				uiFlight = Batch.uiFlight[ uiLane ];
+
+				SimulateObjectMotion( pObject, deltaT );
+				while( pObject->fAlive )
+				{
+					SimulateObject( pObject, deltaT );
+				}
 
+				pdRange[ uiFlight ] = FinishTrajectoryTestObject( pObject, &pvPosition[ uiFlight ], &psFinalGridNo[ uiFlight ] );
+				Batch.pObject[ uiLane ] = NULL;
+				continue;
+			}
+
+			pObject->Force.x = Batch.dForceX[ uiLane ];
+			pObject->Force.y = Batch.dForceY[ uiLane ];
+			pObject->Force.z = Batch.dForceZ[ uiLane ];
+			pObject->InitialForce = VMultScalar( &(pObject->InitialForce ), 0 );
+
+			pObject->OldPosition.x = Batch.dOldPosX[ uiLane ];
+			pObject->OldPosition.y = Batch.dOldPosY[ uiLane ];
+			pObject->OldPosition.z = Batch.dOldPosZ[ uiLane ];
+			pObject->OldVelocity.x = Batch.dOldVelX[ uiLane ];
+			pObject->OldVelocity.y = Batch.dOldVelY[ uiLane ];
+			pObject->OldVelocity.z = Batch.dOldVelZ[ uiLane ];
+			pObject->Position.x = Batch.dPosX[ uiLane ];
+			pObject->Position.y = Batch.dPosY[ uiLane ];
+			pObject->Position.z = Batch.dPosZ[ uiLane ];
+			pObject->Velocity.x = Batch.dVelX[ uiLane ];
+			pObject->Velocity.y = Batch.dVelY[ uiLane ];
+			pObject->Velocity.z = Batch.dVelZ[ uiLane ];
+			pObject->TestTargetPosition = VSetEqual( &(pObject->Position) );
+
+			PhysicsMoveObject( pObject );
+		}
+
+	} while ( fActive || uiNext < uiCount );
 }
 
 
@@ -1887,16 +2316,13 @@ FLOAT CalculateLaunchItemAngle( SOLDIERTYPE *pSoldier, INT32 sGridNo, UINT8 ubHe
 
 
 
-void CalculateLaunchItemBasicParams( SOLDIERTYPE *pSoldier, OBJECTTYPE *pItem, INT32 sGridNo, UINT8 ubLevel, INT16 sEndZ,  FLOAT *pdMagForce, FLOAT *pdDegrees, INT32 *psFinalGridNo, BOOLEAN fArmed )
+// The angle and start height CalculateLaunchItemBasicParams searches the force for
+static void CalculateLaunchItemStartParams( SOLDIERTYPE *pSoldier, OBJECTTYPE *pItem, INT32 sGridNo, UINT8 ubLevel, BOOLEAN fArmed, FLOAT *pdDegrees, INT16 *psStartZ, INT16 *psMinRange, BOOLEAN *pfIndoors, BOOLEAN *pfMortar, BOOLEAN *pfGLauncher )
 {
-	INT32		sInterGridNo = NOWHERE;
 	INT16		sStartZ;
-	FLOAT		dMagForce, dMaxForce, dMinForce;
-	FLOAT		dDegrees, dNewDegrees;
-	BOOLEAN	fThroughIntermediateGridNo = FALSE;
+	FLOAT		dDegrees;
 	UINT16	usLauncher;
 	BOOLEAN	fIndoors = FALSE;
-	BOOLEAN	fLauncher = FALSE;
 	BOOLEAN	fMortar		= FALSE;
 	BOOLEAN	fGLauncher = FALSE;
 	INT16		sMinRange = 0;
@@ -1981,6 +2407,29 @@ void CalculateLaunchItemBasicParams( SOLDIERTYPE *pSoldier, OBJECTTYPE *pItem, I
 		fIndoors = TRUE;
 	}
 
+	(*pdDegrees)	= dDegrees;
+	(*psStartZ)		= sStartZ;
+	(*psMinRange)	= sMinRange;
+	(*pfIndoors)	= fIndoors;
+	(*pfMortar)		= fMortar;
+	(*pfGLauncher)	= fGLauncher;
+}
+
+
+void CalculateLaunchItemBasicParams( SOLDIERTYPE *pSoldier, OBJECTTYPE *pItem, INT32 sGridNo, UINT8 ubLevel, INT16 sEndZ,  FLOAT *pdMagForce, FLOAT *pdDegrees, INT32 *psFinalGridNo, BOOLEAN fArmed )
+{
+	INT32		sInterGridNo = NOWHERE;
+	INT16		sStartZ;
+	FLOAT		dMagForce, dMaxForce, dMinForce;
+	FLOAT		dDegrees, dNewDegrees;
+	BOOLEAN	fThroughIntermediateGridNo = FALSE;
+	BOOLEAN	fIndoors;
+	BOOLEAN	fLauncher = FALSE;
+	BOOLEAN	fMortar;
+	BOOLEAN	fGLauncher;
+	INT16		sMinRange;
+
+	CalculateLaunchItemStartParams( pSoldier, pItem, sGridNo, ubLevel, fArmed, &dDegrees, &sStartZ, &sMinRange, &fIndoors, &fMortar, &fGLauncher );
 
 	// OK, look if we can go through a windows here...
 	if ( ubLevel == 0 )
@@ -2088,6 +2537,110 @@ void CalculateLaunchItemBasicParams( SOLDIERTYPE *pSoldier, OBJECTTYPE *pItem, I
 	(*pdDegrees )	= dDegrees;
 }
 
+// Runs the searches of FindBestForceForTrajectory side by side, every throw of a round in one CalculateObjectTrajectories
+static void RunForceSearches( std::vector<FORCE_SEARCH> &Searches, INT16 sEndZ, OBJECTTYPE *pItem )
+{
+	std::vector<UINT32>		Open, StillOpen;
+	std::vector<vector_3>	vPositions, vForces;
+	std::vector<INT32>		sFinalGridNos;
+	std::vector<FLOAT>		dRanges;
+	UINT32					uiOpen;
+
+	for ( uiOpen = 0; uiOpen < Searches.size(); uiOpen++ )
+	{
+		Open.push_back( uiOpen );
+	}
+
+	while ( !Open.empty() )
+	{
+		vPositions.resize( Open.size() );
+		vForces.resize( Open.size() );
+		sFinalGridNos.resize( Open.size() );
+		dRanges.resize( Open.size() );
+
+		for ( uiOpen = 0; uiOpen < Open.size(); uiOpen++ )
+		{
+			FORCE_SEARCH &Search = Searches[ Open[ uiOpen ] ];
+
+			NextForceSearchThrow( &Search );
+			vPositions[ uiOpen ] = Search.vPosition;
+			vForces[ uiOpen ] = Search.vForce;
+		}
+
+		CalculateObjectTrajectories( (UINT32)Open.size(), sEndZ, pItem, &vPositions[ 0 ], &vForces[ 0 ], &sFinalGridNos[ 0 ], &dRanges[ 0 ] );
+
+		StillOpen.clear();
+		for ( uiOpen = 0; uiOpen < Open.size(); uiOpen++ )
+		{
+			FORCE_SEARCH &Search = Searches[ Open[ uiOpen ] ];
+
+			Search.sFinalGridNo = sFinalGridNos[ uiOpen ];
+			if ( !ForceSearchDone( &Search, dRanges[ uiOpen ] ) )
+			{
+				StillOpen.push_back( Open[ uiOpen ] );
+			}
+		}
+		Open.swap( StillOpen );
+	}
+}
+
+void PrefetchLaunchItemTrajectories( SOLDIERTYPE *pSoldier, OBJECTTYPE *pItem, INT32 *psGridNo, UINT32 uiCount, UINT8 ubLevel, INT16 sEndZ, BOOLEAN fArmed )
+{
+	std::vector<FORCE_SEARCH>		Searches;
+	std::vector<TRAJECTORY_KEY>		Keys;
+	FORCE_SEARCH					Search;
+	TRAJECTORY_KEY					Key;
+	FLOAT							dDegrees;
+	INT16							sStartZ, sMinRange;
+	BOOLEAN							fIndoors, fMortar, fGLauncher;
+	UINT32							uiLoop, uiKey;
+
+	if ( !gfTrajectoryPrefetch )
+	{
+		return;
+	}
+
+	for ( uiLoop = 0; uiLoop < uiCount; uiLoop++ )
+	{
+		// CalculateLaunchItemChanceToGetThrough doesn't get that far
+		if ( psGridNo[ uiLoop ] == pSoldier->sGridNo )
+		{
+			continue;
+		}
+
+		CalculateLaunchItemStartParams( pSoldier, pItem, psGridNo[ uiLoop ], ubLevel, fArmed, &dDegrees, &sStartZ, &sMinRange, &fIndoors, &fMortar, &fGLauncher );
+		Key = MakeTrajectoryKey( pSoldier->sGridNo, psGridNo[ uiLoop ], sStartZ, sEndZ, dDegrees, pItem );
+
+		if ( gTrajectoryPrefetch.find( Key ) != gTrajectoryPrefetch.end() )
+		{
+			continue;
+		}
+
+		for ( uiKey = 0; uiKey < Keys.size(); uiKey++ )
+		{
+			if ( !( Keys[ uiKey ] < Key ) && !( Key < Keys[ uiKey ] ) )
+			{
+				break;
+			}
+		}
+		if ( uiKey < Keys.size() )
+		{
+			continue;
+		}
+
+		StartForceSearch( &Search, pSoldier->sGridNo, psGridNo[ uiLoop ], sStartZ, dDegrees );
+		Searches.push_back( Search );
+		Keys.push_back( Key );
+	}
+
+	RunForceSearches( Searches, sEndZ, pItem );
+
+	for ( uiKey = 0; uiKey < Keys.size(); uiKey++ )
+	{
+		StoreTrajectoryResult( Keys[ uiKey ], &Searches[ uiKey ] );
+	}
+}
+
 BOOLEAN GrenadeRollingPossible(SOLDIERTYPE *pSoldier, INT32 sGridNo, INT16 *sXPos, INT16 *sYPos)
 {
 	if (!(pSoldier->bWeaponMode == WM_ATTACHED_GL || pSoldier->bWeaponMode == WM_ATTACHED_GL_BURST || pSoldier->bWeaponMode == WM_ATTACHED_GL_AUTO))
@@ -166,6 +166,16 @@ BOOLEAN CalculateLaunchItemChanceToGetThrough( SOLDIERTYPE *pSoldier, OBJECTTYPE
 
 void CalculateLaunchItemParamsForThrow( SOLDIERTYPE *pSoldier, INT32 sGridNo, UINT8 ubLevel, INT16 sZPos, OBJECTTYPE *pItem, UINT32 uiHitChance, UINT8 ubActionCode, UINT32 uiActionData, UINT16 usItemNum = 0 );
 
+// For the AI, which tries the same throw at many targets. Between BeginTrajectoryPrefetch() and EndTrajectoryPrefetch()
+// the force searches of CalculateLaunchItemChanceToGetThrough() are remembered, so the searches that don't depend on the
+// target (max and min force) are done once. PrefetchLaunchItemTrajectories() searches the forces for a list of targets
+// in one go, with the test flights integrated side by side, and the following CalculateLaunchItemChanceToGetThrough()
+// calls for these targets find them done. The results are the same as without the prefetch. Nothing may change the
+// map while the prefetch is on.
+void BeginTrajectoryPrefetch( void );
+void EndTrajectoryPrefetch( void );
+void PrefetchLaunchItemTrajectories( SOLDIERTYPE *pSoldier, OBJECTTYPE *pItem, INT32 *psGridNo, UINT32 uiCount, UINT8 ubLevel, INT16 sEndZ, BOOLEAN fArmed );
+
 
 
 
@@ -24,6 +24,15 @@
 
 #include "Utilities.h"
 
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#ifdef JA2TESTVERSION
+#include <chrono>
+#endif
+
 UINT32 guiShieldGraphic = 0;
 BOOLEAN fShieldGraphicInit = FALSE;
 #define WALLDAMAGEGRAPHICS_MAX		2
@@ -1181,6 +1190,251 @@ inline static UINT16 * GetShadeTable(LEVELNODE * pNode, SOLDIERTYPE * pSoldier,
 
 
 
+// Banded rendering
+// With RENDER_BANDS above 1, RenderTiles doesn't draw the plain tile blits right away but records them. The list
+// is drawn whenever something else has to go into the frame buffer first (mercs, items, text, decals) and when
+// RenderTiles is done, once for every horizontal band of the viewport, each band on its own thread with the
+// clipping rect cut down to the band. A band only touches its own rows of the frame and z buffer and draws the
+// blits in recorded order, so the result is the same as drawing them one after the other.
+//
+// What the bands share, and why that's safe:
+// - pDestBuf, gpZBuffer: written, but only the band's own rows.
+// - The video objects: read. Their shade (pShadeCurrent) is switched by RenderTiles from tile to tile, so every band
+//   draws through a copy of the object with the shade that was recorded (see DrawRenderBand).
+// - pShadeTable and the other blit parameters: captured by value when the blit is recorded.
+// - ShadeTable, IntensityTable (shadow and intensity blitters) and gfBlitterSSE2: read only. The tables are rebuilt
+//   by BuildShadeTable()/BuildIntensityTable() on the main thread, which can't happen while FlushRenderBands()
+//   waits for the bands.
+// - gLeftSkip etc. and gfUsePreCalcSkips: written by BltIsClippedOrOffScreen(), so the recorded blits use
+//   BltIsClippedOrOffScreenNoPreCalc() instead.
+// - guiTranslucentMask and the pixelate/obscured dither: only used by blits that aren't recorded.
+// - The save buffer: only locked by blits that aren't recorded (mercs, LEVELNODE_UPDATESAVEBUFFERONCE).
+typedef std::function<void( HVOBJECT hVObject, SGPRect *pClipRect )>	RENDER_BAND_BLIT_FUNC;
+
+typedef struct
+{
+	RENDER_BAND_BLIT_FUNC	Blit;
+	HVOBJECT				hVObject;
+	UINT16					*pShadeCurrent;		// the shade set on hVObject when the blit was recorded
+} RENDER_BAND_BLIT;
+
+#define MAX_RENDER_BANDS				8
+#define MIN_RENDER_BAND_BLITS			16		// shorter lists aren't worth waking up the other threads for
+
+static std::vector<RENDER_BAND_BLIT>	gRenderBandBlits;
+static std::vector<std::thread>			gRenderBandThreads;
+static std::mutex						gRenderBandMutex;
+static std::condition_variable			gRenderBandStart;
+static std::condition_variable			gRenderBandDone;
+static UINT32							guiRenderBandJob = 0;
+static UINT8							gubRenderBandsInJob = 0;
+static UINT8							gubRenderBandsPending = 0;
+static BOOLEAN							gfRenderBandsShutdown = FALSE;
+
+static UINT8 GetNumRenderBands( void )
+{
+	return( __min( gGameExternalOptions.ubRenderBands, MAX_RENDER_BANDS ) );
+}
+
+static void DrawRenderBand( UINT8 ubBand, UINT8 ubNumBands )
+{
+	SGPRect		BandRect = gClippingRect;
+	INT32		iHeight = gClippingRect.iBottom - gClippingRect.iTop;
+	SGPVObject	VObject;
+	HVOBJECT	hLastVObject = NULL;
+
+	PERFORMANCE_MARKER
+
+	BandRect.iTop = gClippingRect.iTop + iHeight * ubBand / ubNumBands;
+	BandRect.iBottom = gClippingRect.iTop + iHeight * ( ubBand + 1 ) / ubNumBands;
+
+	for ( size_t cnt = 0; cnt < gRenderBandBlits.size(); ++cnt )
+	{
+		RENDER_BAND_BLIT *pBlit = &gRenderBandBlits[ cnt ];
+
+		// tiles share their video object and RenderTiles switches its shade from tile to tile, so every band
+		// draws through a copy of its own with the shade that was recorded
+		if ( pBlit->hVObject != hLastVObject )
+		{
+			VObject = *pBlit->hVObject;
+			hLastVObject = pBlit->hVObject;
+		}
+		VObject.pShadeCurrent = pBlit->pShadeCurrent;
+
+		pBlit->Blit( &VObject, &BandRect );
+	}
+}
+
+static void RenderBandThread( UINT8 ubBand, UINT32 uiJob )
+{
+	UINT8	ubNumBands;
+	CHAR8	zThreadName[ 32 ];
+
+	sprintf( zThreadName, "Render band %d", ubBand );
+	ProfilerSetThreadName( zThreadName );
+
+	for ( ;; )
+	{
+		{
+			std::unique_lock<std::mutex> lock( gRenderBandMutex );
+
+			gRenderBandStart.wait( lock, [&]{ return gfRenderBandsShutdown || guiRenderBandJob != uiJob; } );
+			if ( gfRenderBandsShutdown )
+			{
+				return;
+			}
+
+			uiJob = guiRenderBandJob;
+			ubNumBands = gubRenderBandsInJob;
+		}
+
+		if ( ubBand < ubNumBands )
+		{
+			DrawRenderBand( ubBand, ubNumBands );
+		}
+
+		{
+			std::lock_guard<std::mutex> lock( gRenderBandMutex );
+
+			if ( --gubRenderBandsPending == 0 )
+			{
+				gRenderBandDone.notify_one();
+			}
+		}
+	}
+}
+
+static void RecordRenderBandBlit( HVOBJECT hVObject, const RENDER_BAND_BLIT_FUNC &Blit )
+{
+	RENDER_BAND_BLIT BandBlit;
+
+	BandBlit.Blit = Blit;
+	BandBlit.hVObject = hVObject;
+	BandBlit.pShadeCurrent = hVObject->pShadeCurrent;
+
+	gRenderBandBlits.push_back( BandBlit );
+}
+
+// Draws the recorded blits. Has to be called before anything else draws to the frame buffer or the z buffer.
+static void FlushRenderBands( void )
+{
+	UINT8	ubNumBands = GetNumRenderBands();
+
+	if ( gRenderBandBlits.empty() )
+	{
+		return;
+	}
+
+	if ( ubNumBands < 2 || gRenderBandBlits.size() < MIN_RENDER_BAND_BLITS )
+	{
+		DrawRenderBand( 0, 1 );
+	}
+	else
+	{
+		// band 0 is drawn here, the others by threads started the first time they are needed
+		while ( gRenderBandThreads.size() < (size_t)( ubNumBands - 1 ) )
+		{
+			gRenderBandThreads.push_back( std::thread( RenderBandThread, (UINT8)( gRenderBandThreads.size() + 1 ), guiRenderBandJob ) );
+		}
+
+		{
+			std::lock_guard<std::mutex> lock( gRenderBandMutex );
+
+			guiRenderBandJob++;
+			gubRenderBandsInJob = ubNumBands;
+			gubRenderBandsPending = (UINT8)gRenderBandThreads.size();
+		}
+		gRenderBandStart.notify_all();
+
+		DrawRenderBand( 0, ubNumBands );
+
+		{
+			std::unique_lock<std::mutex> lock( gRenderBandMutex );
+
+			gRenderBandDone.wait( lock, []{ return gubRenderBandsPending == 0; } );
+		}
+	}
+
+	gRenderBandBlits.clear();
+}
+
+void ShutdownRenderBands( void )
+{
+	{
+		std::lock_guard<std::mutex> lock( gRenderBandMutex );
+
+		gfRenderBandsShutdown = TRUE;
+	}
+	gRenderBandStart.notify_all();
+
+	for ( size_t cnt = 0; cnt < gRenderBandThreads.size(); ++cnt )
+	{
+		gRenderBandThreads[ cnt ].join();
+	}
+
+	gRenderBandThreads.clear();
+	gRenderBandBlits.clear();
+	gfRenderBandsShutdown = FALSE;
+}
+
+#ifdef JA2TESTVERSION
+// Draws the static world (RenderStaticWorld) on the main thread, then in 2 to MAX_RENDER_BANDS bands, and counts the
+// pixels of the frame and z buffer that differ from the first time. Times the main thread and ubNumBands bands, in
+// microseconds. The world is drawn again as usual on the next frame.
+void CompareRenderBands( UINT8 ubNumBands, UINT32 *puiPixelsDiffer, UINT32 *puiSerialTime, UINT32 *puiBandTime )
+{
+	UINT8				ubSavedBands = gGameExternalOptions.ubRenderBands;
+	UINT32				uiDestPitchBYTES;
+	UINT16				*pDestBuf;
+	INT32				iWidth, iTop, iBottom;
+	std::vector<UINT16>	SerialFrame, SerialZ;
+
+	*puiPixelsDiffer = 0;
+	*puiSerialTime = *puiBandTime = 0;
+
+	FlushRenderBands();
+
+	for ( UINT8 ubBands = 1; ubBands <= MAX_RENDER_BANDS; ++ubBands )
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		gGameExternalOptions.ubRenderBands = ubBands;
+		RenderStaticWorld();
+
+		UINT32 uiTime = (UINT32)std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - start ).count();
+		if ( ubBands == 1 )
+			*puiSerialTime = uiTime;
+		else if ( ubBands == ubNumBands )
+			*puiBandTime = uiTime;
+
+		pDestBuf = (UINT16 *)LockVideoSurface( FRAME_BUFFER, &uiDestPitchBYTES );
+		iWidth = uiDestPitchBYTES / 2;
+		iTop = gsVIEWPORT_WINDOW_START_Y * iWidth;
+		iBottom = gsVIEWPORT_WINDOW_END_Y * iWidth;
+
+		if ( ubBands == 1 )
+		{
+			SerialFrame.assign( pDestBuf + iTop, pDestBuf + iBottom );
+			SerialZ.assign( gpZBuffer + iTop, gpZBuffer + iBottom );
+		}
+		else
+		{
+			for ( INT32 cnt = iTop; cnt < iBottom; ++cnt )
+			{
+				if ( pDestBuf[ cnt ] != SerialFrame[ cnt - iTop ] || gpZBuffer[ cnt ] != SerialZ[ cnt - iTop ] )
+					(*puiPixelsDiffer)++;
+			}
+		}
+
+		UnLockVideoSurface( FRAME_BUFFER );
+	}
+
+	gGameExternalOptions.ubRenderBands = ubSavedBands;
+	SetRenderFlags( RENDER_FLAG_FULL );
+}
+#endif
+
+
 /* 
 MONSTERS BE HERE!
 */
@@ -1263,6 +1517,7 @@ static void RenderTiles(UINT32 uiFlags, INT32 iStartPointX_M, INT32 iStartPointY
 	BOOLEAN				fHiddenTile = FALSE;
 	UINT32        uiAniTileFlags = 0;
 	INT16					sZStripIndex;
+	BOOLEAN				fRecordBlits;
 
 	//Init some variables
 	usImageIndex = 0;
@@ -1282,6 +1537,9 @@ static void RenderTiles(UINT32 uiFlags, INT32 iStartPointX_M, INT32 iStartPointY
 	if (!(uiFlags&TILES_DIRTY))
 		pDestBuf = LockVideoSurface(FRAME_BUFFER, &uiDestPitchBYTES);
 
+	// put off the plain tile blits and draw them in bands (see FlushRenderBands)
+	fRecordBlits = ( GetNumRenderBands() > 1 && !(uiFlags&TILES_DIRTY) );
+
 
 	if (uiFlags & TILES_DYNAMIC_CHECKFOR_INT_TILE)
 	{
@@ -2229,6 +2487,8 @@ static void RenderTiles(UINT32 uiFlags, INT32 iStartPointX_M, INT32 iStartPointY
 								}
 								else if (uiLevelNodeFlags & LEVELNODE_DISPLAY_AP && !(uiFlags&TILES_DIRTY))
 								{
+									FlushRenderBands();
+
 									pTrav = &(hVObject->pETRLEObject[usImageIndex]);
 									sXPos += pTrav->sOffsetX;
 									sYPos += pTrav->sOffsetY;
@@ -2258,6 +2518,7 @@ static void RenderTiles(UINT32 uiFlags, INT32 iStartPointX_M, INT32 iStartPointY
 								}
 								else if ((uiLevelNodeFlags  & LEVELNODE_ERASEZ) && !(uiFlags&TILES_DIRTY))
 								{
+									FlushRenderBands();
 									Zero8BPPDataTo16BPPBufferTransparent((UINT16*)pDestBuf, uiDestPitchBYTES, hVObject, sXPos, sYPos, usImageIndex);
 									//Zero8BPPDataTo16BPPBufferTransparent( (UINT16*)gpZBuffer, uiDestPitchBYTES, hVObject, sXPos, sYPos, usImageIndex );
 								}
@@ -2265,6 +2526,8 @@ static void RenderTiles(UINT32 uiFlags, INT32 iStartPointX_M, INT32 iStartPointY
 								{
 									BOOLEAN fZBlit = FALSE;
 
+									FlushRenderBands();
+
 									if (uiRowFlags == TILES_STATIC_ONROOF || uiRowFlags == TILES_DYNAMIC_ONROOF)
 									{
 										usOutlineColor = gusYellowItemOutlineColor;
@@ -2348,6 +2611,8 @@ static void RenderTiles(UINT32 uiFlags, INT32 iStartPointX_M, INT32 iStartPointY
 								// ATE: Check here for a lot of conditions!
 								else if ( (uiLevelNodeFlags & LEVELNODE_PHYSICSOBJECT) && !(uiFlags&TILES_DIRTY) )
 								{
+									FlushRenderBands();
+
 									bItemOutline = FALSE;
 
 									bBlitClipVal = BltIsClippedOrOffScreen(hVObject, sXPos, sYPos, usImageIndex, &gClippingRect);
@@ -2405,351 +2670,336 @@ static void RenderTiles(UINT32 uiFlags, INT32 iStartPointX_M, INT32 iStartPointY
 										}
 									}*/
 
-									if (fMultiTransShadowZBlitter)
+									// everything but mercs, save buffer updates and the pixelated blitters (their dither pattern would move if
+									// they were clipped to a band) can be drawn in bands later
+									auto TileBlit = [=]( HVOBJECT hVObject, SGPRect *pClipRect )
 									{
-										if (fZBlitter)
+										UINT8		bBlitClipVal;
+										UINT8		*pSaveBuf;
+										UINT32		uiSaveBufferPitchBYTES;
+
+										if (fMultiTransShadowZBlitter)
 										{
-											if (fObscuredBlitter)
+											if (fZBlitter)
 											{
-												if (hVObjectAlpha == NULL) {
-													Blt8BPPDataTo16BPPBufferTransZTransShadowIncObscureClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, &gClippingRect, sMultiTransShadowZBlitterIndex, pShadeTable, fIgnoreShadows);
+												if (fObscuredBlitter)
+												{
+													if (hVObjectAlpha == NULL) {
+														Blt8BPPDataTo16BPPBufferTransZTransShadowIncObscureClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, pClipRect, sMultiTransShadowZBlitterIndex, pShadeTable, fIgnoreShadows);
+													}
+													else {
+														Blt8BPPDataTo16BPPBufferTransZTransShadowIncObscureClipAlpha((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, hVObjectAlpha, sXPos, sYPos, usImageIndex, pClipRect, sMultiTransShadowZBlitterIndex, pShadeTable, fIgnoreShadows);
+													}
 												}
-												else {
-													Blt8BPPDataTo16BPPBufferTransZTransShadowIncObscureClipAlpha((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, hVObjectAlpha, sXPos, sYPos, usImageIndex, &gClippingRect, sMultiTransShadowZBlitterIndex, pShadeTable, fIgnoreShadows);
+												else
+												{
+													if (hVObjectAlpha == NULL) {
+														Blt8BPPDataTo16BPPBufferTransZTransShadowIncClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, pClipRect, sMultiTransShadowZBlitterIndex, pShadeTable, fIgnoreShadows);
+													}
+													else {
+														Blt8BPPDataTo16BPPBufferTransZTransShadowIncClipAlpha((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, hVObjectAlpha, sXPos, sYPos, usImageIndex, pClipRect, sMultiTransShadowZBlitterIndex, pShadeTable, fIgnoreShadows);
+													}
 												}
 											}
 											else
 											{
-												if (hVObjectAlpha == NULL) {
-													Blt8BPPDataTo16BPPBufferTransZTransShadowIncClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, &gClippingRect, sMultiTransShadowZBlitterIndex, pShadeTable, fIgnoreShadows);
-												}
-												else {
-													Blt8BPPDataTo16BPPBufferTransZTransShadowIncClipAlpha((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, hVObjectAlpha, sXPos, sYPos, usImageIndex, &gClippingRect, sMultiTransShadowZBlitterIndex, pShadeTable, fIgnoreShadows);
-												}
+												//Blt8BPPDataTo16BPPBufferTransparentClip((UINT16*)pDestBuf, uiDestPitchBYTES, hVObject, sXPos, sYPos, usImageIndex, pClipRect );
 											}
 										}
-										else
-										{
-											//Blt8BPPDataTo16BPPBufferTransparentClip((UINT16*)pDestBuf, uiDestPitchBYTES, hVObject, sXPos, sYPos, usImageIndex, &gClippingRect );
-										}
-									}
-									else if (fMultiZBlitter)
-									{
-										if (fZBlitter)
+										else if (fMultiZBlitter)
 										{
-											if (fObscuredBlitter)
-											{
-												Blt8BPPDataTo16BPPBufferTransZIncObscureClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, &gClippingRect);
-											}
-											else
+											if (fZBlitter)
 											{
-												if (fWallTile)
+												if (fObscuredBlitter)
 												{
-													if (sZStripIndex == -1)
+													Blt8BPPDataTo16BPPBufferTransZIncObscureClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, pClipRect);
+												}
+												else
+												{
+													if (fWallTile)
 													{
-														Blt8BPPDataTo16BPPBufferTransZIncClipZSameZBurnsThrough((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, &gClippingRect, usImageIndex);
+														if (sZStripIndex == -1)
+														{
+															Blt8BPPDataTo16BPPBufferTransZIncClipZSameZBurnsThrough((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, pClipRect, usImageIndex);
+														}
+														else
+														{
+															Blt8BPPDataTo16BPPBufferTransZIncClipZSameZBurnsThrough((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, pClipRect, sZStripIndex);
+														}
 													}
 													else
 													{
-														Blt8BPPDataTo16BPPBufferTransZIncClipZSameZBurnsThrough((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, &gClippingRect, sZStripIndex);
+														Blt8BPPDataTo16BPPBufferTransZIncClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, pClipRect);
 													}
 												}
-												else
-												{
-													Blt8BPPDataTo16BPPBufferTransZIncClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, &gClippingRect);
-												}
+											}
+											else
+											{
+												Blt8BPPDataTo16BPPBufferTransparentClip((UINT16*)pDestBuf, uiDestPitchBYTES, hVObject, sXPos, sYPos, usImageIndex, pClipRect);
 											}
 										}
 										else
 										{
-											Blt8BPPDataTo16BPPBufferTransparentClip((UINT16*)pDestBuf, uiDestPitchBYTES, hVObject, sXPos, sYPos, usImageIndex, &gClippingRect);
-										}
-									}
-									else
-									{
-										bBlitClipVal = BltIsClippedOrOffScreen(hVObject, sXPos, sYPos, usImageIndex, &gClippingRect);
+											bBlitClipVal = BltIsClippedOrOffScreenNoPreCalc(hVObject, sXPos, sYPos, usImageIndex, pClipRect);
 
-										if (bBlitClipVal == TRUE)
-										{
-											if (fPixelate)
+											if (bBlitClipVal == TRUE)
 											{
-												if (fTranslucencyType)
-												{
-													//if(fZWrite)
-													//	Blt8BPPDataTo16BPPBufferTransZClipTranslucent((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, &gClippingRect);
-													//else
-													Blt8BPPDataTo16BPPBufferTransZNBClipTranslucent((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, &gClippingRect);
-												}
-												else
+												if (fPixelate)
 												{
-													//if(fZWrite)
-													//	Blt8BPPDataTo16BPPBufferTransZClipPixelate((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, &gClippingRect);
-													//else
-													Blt8BPPDataTo16BPPBufferTransZNBClipPixelate((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, &gClippingRect);
-												}
-											}
-											else if (fMerc)
-											{
-												if (fZBlitter)
-												{
-													if (fZWrite)
+													if (fTranslucencyType)
 													{
-														if (hVObjectAlpha != NULL)
-														{
-															Blt8BPPDataTo16BPPBufferTransShadowZClipAlpha((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel,
-																hVObject,
-																hVObjectAlpha,
-																sXPos, sYPos,
-																usImageIndex,
-																&gClippingRect,
-																pShadeTable,
-																fIgnoreShadows);
-														}
-														else
-														{
-															Blt8BPPDataTo16BPPBufferTransShadowZClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel,
-																hVObject,
-																sXPos, sYPos,
-																usImageIndex,
-																&gClippingRect,
-																pShadeTable,
-																fIgnoreShadows);
-														}
+														//if(fZWrite)
+														//	Blt8BPPDataTo16BPPBufferTransZClipTranslucent((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, pClipRect);
+														//else
+														Blt8BPPDataTo16BPPBufferTransZNBClipTranslucent((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, pClipRect);
 													}
 													else
 													{
-														if (fObscuredBlitter)
+														//if(fZWrite)
+														//	Blt8BPPDataTo16BPPBufferTransZClipPixelate((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, pClipRect);
+														//else
+														Blt8BPPDataTo16BPPBufferTransZNBClipPixelate((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, pClipRect);
+													}
+												}
+												else if (fMerc)
+												{
+													if (fZBlitter)
+													{
+														if (fZWrite)
 														{
 															if (hVObjectAlpha != NULL)
 															{
-																Blt8BPPDataTo16BPPBufferTransShadowZNBObscuredClipAlpha((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel,
+																Blt8BPPDataTo16BPPBufferTransShadowZClipAlpha((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel,
 																	hVObject,
 																	hVObjectAlpha,
 																	sXPos, sYPos,
 																	usImageIndex,
-																	&gClippingRect,
+																	pClipRect,
 																	pShadeTable,
 																	fIgnoreShadows);
 															}
 															else
 															{
-																Blt8BPPDataTo16BPPBufferTransShadowZNBObscuredClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel,
+																Blt8BPPDataTo16BPPBufferTransShadowZClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel,
 																	hVObject,
 																	sXPos, sYPos,
 																	usImageIndex,
-																	&gClippingRect,
+																	pClipRect,
 																	pShadeTable,
 																	fIgnoreShadows);
 															}
 														}
 														else
 														{
+															if (fObscuredBlitter)
+															{
+																if (hVObjectAlpha != NULL)
+																{
+																	Blt8BPPDataTo16BPPBufferTransShadowZNBObscuredClipAlpha((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel,
+																		hVObject,
+																		hVObjectAlpha,
+																		sXPos, sYPos,
+																		usImageIndex,
+																		pClipRect,
+																		pShadeTable,
+																		fIgnoreShadows);
+																}
+																else
+																{
+																	Blt8BPPDataTo16BPPBufferTransShadowZNBObscuredClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel,
+																		hVObject,
+																		sXPos, sYPos,
+																		usImageIndex,
+																		pClipRect,
+																		pShadeTable,
+																		fIgnoreShadows);
+																}
+															}
+															else
+															{
+																if (hVObjectAlpha != NULL)
+																{
+																	Blt8BPPDataTo16BPPBufferTransShadowZNBClipAlpha((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel,
+																		hVObject,
+																		hVObjectAlpha,
+																		sXPos, sYPos,
+																		usImageIndex,
+																		pClipRect,
+																		pShadeTable,
+																		fIgnoreShadows);
+																}
+																else
+																{
+																	Blt8BPPDataTo16BPPBufferTransShadowZNBClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel,
+																		hVObject,
+																		sXPos, sYPos,
+																		usImageIndex,
+																		pClipRect,
+																		pShadeTable,
+																		fIgnoreShadows);
+																}
+															}
+														}
+
+														if ((uiLevelNodeFlags & LEVELNODE_UPDATESAVEBUFFERONCE))
+														{
+															pSaveBuf = LockVideoSurface(guiSAVEBUFFER, &uiSaveBufferPitchBYTES);
+
+															// BLIT HERE
 															if (hVObjectAlpha != NULL)
 															{
-																Blt8BPPDataTo16BPPBufferTransShadowZNBClipAlpha((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel,
+																Blt8BPPDataTo16BPPBufferTransShadowClipAlpha((UINT16*)pSaveBuf, uiSaveBufferPitchBYTES,
 																	hVObject,
 																	hVObjectAlpha,
 																	sXPos, sYPos,
 																	usImageIndex,
-																	&gClippingRect,
+																	pClipRect,
 																	pShadeTable,
 																	fIgnoreShadows);
 															}
 															else
 															{
-																Blt8BPPDataTo16BPPBufferTransShadowZNBClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel,
+																Blt8BPPDataTo16BPPBufferTransShadowClip((UINT16*)pSaveBuf, uiSaveBufferPitchBYTES,
 																	hVObject,
 																	sXPos, sYPos,
 																	usImageIndex,
-																	&gClippingRect,
+																	pClipRect,
 																	pShadeTable,
 																	fIgnoreShadows);
 															}
+
+															UnLockVideoSurface(guiSAVEBUFFER);
+
+															// Turn it off!
+															pNode->uiFlags &= (~LEVELNODE_UPDATESAVEBUFFERONCE);
 														}
-													}
 
-													if ((uiLevelNodeFlags & LEVELNODE_UPDATESAVEBUFFERONCE))
+													}
+													else
 													{
-														pSaveBuf = LockVideoSurface(guiSAVEBUFFER, &uiSaveBufferPitchBYTES);
-
-														// BLIT HERE
 														if (hVObjectAlpha != NULL)
 														{
-															Blt8BPPDataTo16BPPBufferTransShadowClipAlpha((UINT16*)pSaveBuf, uiSaveBufferPitchBYTES,
+															Blt8BPPDataTo16BPPBufferTransShadowClipAlpha((UINT16*)pDestBuf, uiDestPitchBYTES,
 																hVObject,
 																hVObjectAlpha,
 																sXPos, sYPos,
 																usImageIndex,
-																&gClippingRect,
+																pClipRect,
 																pShadeTable,
 																fIgnoreShadows);
 														}
-														else
+														else 
 														{
-															Blt8BPPDataTo16BPPBufferTransShadowClip((UINT16*)pSaveBuf, uiSaveBufferPitchBYTES,
+															Blt8BPPDataTo16BPPBufferTransShadowClip((UINT16*)pDestBuf, uiDestPitchBYTES,
 																hVObject,
 																sXPos, sYPos,
 																usImageIndex,
-																&gClippingRect,
+																pClipRect,
 																pShadeTable,
 																fIgnoreShadows);
 														}
-
-														UnLockVideoSurface(guiSAVEBUFFER);
-
-														// Turn it off!
-														pNode->uiFlags &= (~LEVELNODE_UPDATESAVEBUFFERONCE);
 													}
-
 												}
-												else
+												else if (fShadowBlitter)
 												{
-													if (hVObjectAlpha != NULL)
+													if (fZBlitter)
 													{
-														Blt8BPPDataTo16BPPBufferTransShadowClipAlpha((UINT16*)pDestBuf, uiDestPitchBYTES,
-															hVObject,
-															hVObjectAlpha,
-															sXPos, sYPos,
-															usImageIndex,
-															&gClippingRect,
-															pShadeTable,
-															fIgnoreShadows);
+														if (fZWrite)
+															Blt8BPPDataTo16BPPBufferShadowZClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, pClipRect);
+														else
+															Blt8BPPDataTo16BPPBufferShadowZClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, pClipRect);
 													}
-													else 
+													else
 													{
-														Blt8BPPDataTo16BPPBufferTransShadowClip((UINT16*)pDestBuf, uiDestPitchBYTES,
-															hVObject,
-															sXPos, sYPos,
-															usImageIndex,
-															&gClippingRect,
-															pShadeTable,
-															fIgnoreShadows);
+														Blt8BPPDataTo16BPPBufferShadowClip((UINT16*)pDestBuf, uiDestPitchBYTES, hVObject, sXPos, sYPos, usImageIndex, pClipRect);
 													}
 												}
-											}
-											else if (fShadowBlitter)
-											{
-												if (fZBlitter)
+												else if (fIntensityBlitter)
 												{
-													if (fZWrite)
-														Blt8BPPDataTo16BPPBufferShadowZClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, &gClippingRect);
+													if (fZBlitter)
+													{
+														if (fZWrite)
+															Blt8BPPDataTo16BPPBufferIntensityZClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, pClipRect);
+														else
+															Blt8BPPDataTo16BPPBufferIntensityZClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, pClipRect);
+													}
 													else
-														Blt8BPPDataTo16BPPBufferShadowZClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, &gClippingRect);
-												}
-												else
-												{
-													Blt8BPPDataTo16BPPBufferShadowClip((UINT16*)pDestBuf, uiDestPitchBYTES, hVObject, sXPos, sYPos, usImageIndex, &gClippingRect);
+													{
+														Blt8BPPDataTo16BPPBufferIntensityClip((UINT16*)pDestBuf, uiDestPitchBYTES, hVObject, sXPos, sYPos, usImageIndex, pClipRect);
+													}
 												}
-											}
-											else if (fIntensityBlitter)
-											{
-												if (fZBlitter)
+												else if (fZBlitter)
 												{
 													if (fZWrite)
-														Blt8BPPDataTo16BPPBufferIntensityZClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, &gClippingRect);
-													else
-														Blt8BPPDataTo16BPPBufferIntensityZClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, &gClippingRect);
-												}
-												else
-												{
-													Blt8BPPDataTo16BPPBufferIntensityClip((UINT16*)pDestBuf, uiDestPitchBYTES, hVObject, sXPos, sYPos, usImageIndex, &gClippingRect);
-												}
-											}
-											else if (fZBlitter)
-											{
-												if (fZWrite)
-												{
-													if (fObscuredBlitter)
 													{
-														Blt8BPPDataTo16BPPBufferTransZClipPixelateObscured((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, &gClippingRect);
+														if (fObscuredBlitter)
+														{
+															Blt8BPPDataTo16BPPBufferTransZClipPixelateObscured((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, pClipRect);
+														}
+														else
+														{
+															Blt8BPPDataTo16BPPBufferTransZClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, pClipRect);
+														}
 													}
 													else
 													{
-														Blt8BPPDataTo16BPPBufferTransZClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, &gClippingRect);
+														Blt8BPPDataTo16BPPBufferTransZNBClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, pClipRect);
 													}
-												}
-												else
-												{
-													Blt8BPPDataTo16BPPBufferTransZNBClip((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, &gClippingRect);
-												}
-
-												if ((uiLevelNodeFlags & LEVELNODE_UPDATESAVEBUFFERONCE))
-												{
-													pSaveBuf = LockVideoSurface(guiSAVEBUFFER, &uiSaveBufferPitchBYTES);
 
-													// BLIT HERE
-													Blt8BPPDataTo16BPPBufferTransZClip((UINT16*)pSaveBuf, uiSaveBufferPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, &gClippingRect);
+													if ((uiLevelNodeFlags & LEVELNODE_UPDATESAVEBUFFERONCE))
+													{
+														pSaveBuf = LockVideoSurface(guiSAVEBUFFER, &uiSaveBufferPitchBYTES);
 
-													UnLockVideoSurface(guiSAVEBUFFER);
-												}
+														// BLIT HERE
+														Blt8BPPDataTo16BPPBufferTransZClip((UINT16*)pSaveBuf, uiSaveBufferPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex, pClipRect);
 
-											}
-											else
-												Blt8BPPDataTo16BPPBufferTransparentClip((UINT16*)pDestBuf, uiDestPitchBYTES, hVObject, sXPos, sYPos, usImageIndex, &gClippingRect);
+														UnLockVideoSurface(guiSAVEBUFFER);
+													}
 
-										}
-										else if (bBlitClipVal == FALSE)
-										{
-											if (fPixelate)
-											{
-												if (fTranslucencyType)
-												{
-													if (fZWrite)
-														Blt8BPPDataTo16BPPBufferTransZTranslucent((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
-													else
-														Blt8BPPDataTo16BPPBufferTransZNBTranslucent((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
 												}
 												else
-												{
-													if (fZWrite)
-														Blt8BPPDataTo16BPPBufferTransZPixelate((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
-													else
-														Blt8BPPDataTo16BPPBufferTransZNBPixelate((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
-												}
+													Blt8BPPDataTo16BPPBufferTransparentClip((UINT16*)pDestBuf, uiDestPitchBYTES, hVObject, sXPos, sYPos, usImageIndex, pClipRect);
+
 											}
-											else if (fMerc)
+											else if (bBlitClipVal == FALSE)
 											{
-												// Flugente: draw riot shield UNDER the soldier
-												if ( pSoldier &&
-													pSoldier->bVisible != -1 &&
-													( pSoldier->ubDirection == NORTH ||
-														pSoldier->ubDirection == NORTHWEST ||
-														pSoldier->ubDirection == WEST )
-													&& pSoldier->IsRiotShieldEquipped() )
-												{
-													ShowRiotShield( pSoldier, (UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel );
-												}
-
-												if (fZBlitter)
+												if (fPixelate)
 												{
-													if (fZWrite)
+													if (fTranslucencyType)
 													{
-														if (hVObjectAlpha != NULL)
-														{
-															Blt8BPPDataTo16BPPBufferTransShadowZAlpha((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel,
-																hVObject,
-																hVObjectAlpha,
-																sXPos, sYPos,
-																usImageIndex,
-																pShadeTable,
-																fIgnoreShadows);
-														}
+														if (fZWrite)
+															Blt8BPPDataTo16BPPBufferTransZTranslucent((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
 														else
-														{
-															Blt8BPPDataTo16BPPBufferTransShadowZ((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel,
-																hVObject,
-																sXPos, sYPos,
-																usImageIndex,
-																pShadeTable,
-																fIgnoreShadows);
-														}
+															Blt8BPPDataTo16BPPBufferTransZNBTranslucent((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
 													}
 													else
 													{
-														if (fObscuredBlitter)
+														if (fZWrite)
+															Blt8BPPDataTo16BPPBufferTransZPixelate((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
+														else
+															Blt8BPPDataTo16BPPBufferTransZNBPixelate((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
+													}
+												}
+												else if (fMerc)
+												{
+													// Flugente: draw riot shield UNDER the soldier
+													if ( pSoldier &&
+														pSoldier->bVisible != -1 &&
+														( pSoldier->ubDirection == NORTH ||
+															pSoldier->ubDirection == NORTHWEST ||
+															pSoldier->ubDirection == WEST )
+														&& pSoldier->IsRiotShieldEquipped() )
+													{
+														ShowRiotShield( pSoldier, (UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel );
+													}
+
+													if (fZBlitter)
+													{
+														if (fZWrite)
 														{
-															if (hVObjectAlpha != NULL) {
-																Blt8BPPDataTo16BPPBufferTransShadowZNBObscuredAlpha((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel,
+															if (hVObjectAlpha != NULL)
+															{
+																Blt8BPPDataTo16BPPBufferTransShadowZAlpha((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel,
 																	hVObject,
 																	hVObjectAlpha,
 																	sXPos, sYPos,
@@ -2757,8 +3007,9 @@ static void RenderTiles(UINT32 uiFlags, INT32 iStartPointX_M, INT32 iStartPointY
 																	pShadeTable,
 																	fIgnoreShadows);
 															}
-															else {
-																Blt8BPPDataTo16BPPBufferTransShadowZNBObscured((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel,
+															else
+															{
+																Blt8BPPDataTo16BPPBufferTransShadowZ((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel,
 																	hVObject,
 																	sXPos, sYPos,
 																	usImageIndex,
@@ -2768,9 +3019,58 @@ static void RenderTiles(UINT32 uiFlags, INT32 iStartPointX_M, INT32 iStartPointY
 														}
 														else
 														{
+															if (fObscuredBlitter)
+															{
+																if (hVObjectAlpha != NULL) {
+																	Blt8BPPDataTo16BPPBufferTransShadowZNBObscuredAlpha((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel,
+																		hVObject,
+																		hVObjectAlpha,
+																		sXPos, sYPos,
+																		usImageIndex,
+																		pShadeTable,
+																		fIgnoreShadows);
+																}
+																else {
+																	Blt8BPPDataTo16BPPBufferTransShadowZNBObscured((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel,
+																		hVObject,
+																		sXPos, sYPos,
+																		usImageIndex,
+																		pShadeTable,
+																		fIgnoreShadows);
+																}
+															}
+															else
+															{
+																if (hVObjectAlpha != NULL)
+																{
+																	Blt8BPPDataTo16BPPBufferTransShadowZNBAlpha((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel,
+																		hVObject,
+																		hVObjectAlpha,
+																		sXPos, sYPos,
+																		usImageIndex,
+																		pShadeTable,
+																		fIgnoreShadows);
+																}
+																else
+																{
+																	Blt8BPPDataTo16BPPBufferTransShadowZNB((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel,
+																		hVObject,
+																		sXPos, sYPos,
+																		usImageIndex,
+																		pShadeTable,
+																		fIgnoreShadows);
+																}
+															}
+														}
+
+														if ((uiLevelNodeFlags & LEVELNODE_UPDATESAVEBUFFERONCE))
+														{
+															pSaveBuf = LockVideoSurface(guiSAVEBUFFER, &uiSaveBufferPitchBYTES);
+
+															// BLIT HERE
 															if (hVObjectAlpha != NULL)
 															{
-																Blt8BPPDataTo16BPPBufferTransShadowZNBAlpha((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel,
+																Blt8BPPDataTo16BPPBufferTransShadowAlpha((UINT16*)pSaveBuf, uiSaveBufferPitchBYTES,
 																	hVObject,
 																	hVObjectAlpha,
 																	sXPos, sYPos,
@@ -2780,24 +3080,24 @@ static void RenderTiles(UINT32 uiFlags, INT32 iStartPointX_M, INT32 iStartPointY
 															}
 															else
 															{
-																Blt8BPPDataTo16BPPBufferTransShadowZNB((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel,
+																Blt8BPPDataTo16BPPBufferTransShadow((UINT16*)pSaveBuf, uiSaveBufferPitchBYTES,
 																	hVObject,
 																	sXPos, sYPos,
 																	usImageIndex,
 																	pShadeTable,
 																	fIgnoreShadows);
 															}
+
+															UnLockVideoSurface(guiSAVEBUFFER);
+
 														}
-													}
 
-													if ((uiLevelNodeFlags & LEVELNODE_UPDATESAVEBUFFERONCE))
+													}
+													else
 													{
-														pSaveBuf = LockVideoSurface(guiSAVEBUFFER, &uiSaveBufferPitchBYTES);
-
-														// BLIT HERE
 														if (hVObjectAlpha != NULL)
 														{
-															Blt8BPPDataTo16BPPBufferTransShadowAlpha((UINT16*)pSaveBuf, uiSaveBufferPitchBYTES,
+															Blt8BPPDataTo16BPPBufferTransShadowAlpha((UINT16*)pDestBuf, uiDestPitchBYTES,
 																hVObject,
 																hVObjectAlpha,
 																sXPos, sYPos,
@@ -2807,7 +3107,7 @@ static void RenderTiles(UINT32 uiFlags, INT32 iStartPointX_M, INT32 iStartPointY
 														}
 														else
 														{
-															Blt8BPPDataTo16BPPBufferTransShadow((UINT16*)pSaveBuf, uiSaveBufferPitchBYTES,
+															Blt8BPPDataTo16BPPBufferTransShadow((UINT16*)pDestBuf, uiDestPitchBYTES,
 																hVObject,
 																sXPos, sYPos,
 																usImageIndex,
@@ -2815,115 +3115,104 @@ static void RenderTiles(UINT32 uiFlags, INT32 iStartPointX_M, INT32 iStartPointY
 																fIgnoreShadows);
 														}
 
-														UnLockVideoSurface(guiSAVEBUFFER);
-
 													}
 
+													// Flugente: draw riot shield OVER the soldier
+													if ( pSoldier &&
+														pSoldier->bVisible != -1 &&
+														( pSoldier->ubDirection == EAST ||
+															pSoldier->ubDirection == SOUTHEAST ||
+															pSoldier->ubDirection == SOUTH ||
+															pSoldier->ubDirection == SOUTHWEST ||
+															pSoldier->ubDirection == NORTHEAST )
+														&& pSoldier->IsRiotShieldEquipped() )
+													{
+														ShowRiotShield( pSoldier, (UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel );
+													}
 												}
-												else
+												else if (fShadowBlitter)
 												{
-													if (hVObjectAlpha != NULL)
+													if (fZBlitter)
 													{
-														Blt8BPPDataTo16BPPBufferTransShadowAlpha((UINT16*)pDestBuf, uiDestPitchBYTES,
-															hVObject,
-															hVObjectAlpha,
-															sXPos, sYPos,
-															usImageIndex,
-															pShadeTable,
-															fIgnoreShadows);
+														if (fZWrite)
+															Blt8BPPDataTo16BPPBufferShadowZ((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
+														else
+															Blt8BPPDataTo16BPPBufferShadowZNB((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
 													}
 													else
 													{
-														Blt8BPPDataTo16BPPBufferTransShadow((UINT16*)pDestBuf, uiDestPitchBYTES,
-															hVObject,
-															sXPos, sYPos,
-															usImageIndex,
-															pShadeTable,
-															fIgnoreShadows);
+														Blt8BPPDataTo16BPPBufferShadow((UINT16*)pDestBuf, uiDestPitchBYTES, hVObject, sXPos, sYPos, usImageIndex);
 													}
-
 												}
-
-												// Flugente: draw riot shield OVER the soldier
-												if ( pSoldier &&
-													pSoldier->bVisible != -1 &&
-													( pSoldier->ubDirection == EAST ||
-														pSoldier->ubDirection == SOUTHEAST ||
-														pSoldier->ubDirection == SOUTH ||
-														pSoldier->ubDirection == SOUTHWEST ||
-														pSoldier->ubDirection == NORTHEAST )
-													&& pSoldier->IsRiotShieldEquipped() )
-												{
-													ShowRiotShield( pSoldier, (UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel );
-												}
-											}
-											else if (fShadowBlitter)
-											{
-												if (fZBlitter)
+												else if (fIntensityBlitter)
 												{
-													if (fZWrite)
-														Blt8BPPDataTo16BPPBufferShadowZ((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
+													if (fZBlitter)
+													{
+														if (fZWrite)
+															Blt8BPPDataTo16BPPBufferIntensityZ((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
+														else
+															Blt8BPPDataTo16BPPBufferIntensityZNB((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
+													}
 													else
-														Blt8BPPDataTo16BPPBufferShadowZNB((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
-												}
-												else
-												{
-													Blt8BPPDataTo16BPPBufferShadow((UINT16*)pDestBuf, uiDestPitchBYTES, hVObject, sXPos, sYPos, usImageIndex);
+													{
+														Blt8BPPDataTo16BPPBufferIntensity((UINT16*)pDestBuf, uiDestPitchBYTES, hVObject, sXPos, sYPos, usImageIndex);
+													}
 												}
-											}
-											else if (fIntensityBlitter)
-											{
-												if (fZBlitter)
+												else if (fZBlitter)
 												{
 													if (fZWrite)
-														Blt8BPPDataTo16BPPBufferIntensityZ((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
-													else
-														Blt8BPPDataTo16BPPBufferIntensityZNB((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
-												}
-												else
-												{
-													Blt8BPPDataTo16BPPBufferIntensity((UINT16*)pDestBuf, uiDestPitchBYTES, hVObject, sXPos, sYPos, usImageIndex);
-												}
-											}
-											else if (fZBlitter)
-											{
-												if (fZWrite)
-												{
-													// TEST
-													//Blt8BPPDataTo16BPPBufferTransZPixelate( (UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
-
-													if (fObscuredBlitter)
 													{
-														Blt8BPPDataTo16BPPBufferTransZPixelateObscured((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
+														// TEST
+														//Blt8BPPDataTo16BPPBufferTransZPixelate( (UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
+
+														if (fObscuredBlitter)
+														{
+															Blt8BPPDataTo16BPPBufferTransZPixelateObscured((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
+														}
+														else
+														{
+															Blt8BPPDataTo16BPPBufferTransZ((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
+														}
 													}
 													else
-													{
-														Blt8BPPDataTo16BPPBufferTransZ((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
-													}
-												}
-												else
-													Blt8BPPDataTo16BPPBufferTransZNB((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
+														Blt8BPPDataTo16BPPBufferTransZNB((UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
 
 
-												if ((uiLevelNodeFlags & LEVELNODE_UPDATESAVEBUFFERONCE))
-												{
-													pSaveBuf = LockVideoSurface(guiSAVEBUFFER, &uiSaveBufferPitchBYTES);
+													if ((uiLevelNodeFlags & LEVELNODE_UPDATESAVEBUFFERONCE))
+													{
+														pSaveBuf = LockVideoSurface(guiSAVEBUFFER, &uiSaveBufferPitchBYTES);
 
-													// BLIT HERE
-													Blt8BPPDataTo16BPPBufferTransZ((UINT16*)pSaveBuf, uiSaveBufferPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
+														// BLIT HERE
+														Blt8BPPDataTo16BPPBufferTransZ((UINT16*)pSaveBuf, uiSaveBufferPitchBYTES, gpZBuffer, sZLevel, hVObject, sXPos, sYPos, usImageIndex);
 
-													UnLockVideoSurface(guiSAVEBUFFER);
-												}
+														UnLockVideoSurface(guiSAVEBUFFER);
+													}
 
+												}
+												else
+													Blt8BPPDataTo16BPPBufferTransparent((UINT16*)pDestBuf, uiDestPitchBYTES, hVObject, sXPos, sYPos, usImageIndex);
 											}
-											else
-												Blt8BPPDataTo16BPPBufferTransparent((UINT16*)pDestBuf, uiDestPitchBYTES, hVObject, sXPos, sYPos, usImageIndex);
 										}
+									};
+
+									if ( fRecordBlits && !fMerc && !fPixelate && !fObscuredBlitter && !(uiLevelNodeFlags & LEVELNODE_UPDATESAVEBUFFERONCE) )
+									{
+										RecordRenderBandBlit( hVObject, TileBlit );
+									}
+									else
+									{
+										FlushRenderBands();
+										TileBlit( hVObject, &gClippingRect );
 									}
 
 									// Flugente: additional decals
 									if ( fWallTile )
 									{
+										if ( !TileIsOutOfBounds( uiTileIndex ) && ( gpWorldLevelData[ uiTileIndex ].uiFlags & MAPELEMENT_STRUCTURE_DAMAGED ) )
+										{
+											FlushRenderBands();
+										}
+
 										ShowDecal( (UINT16*)pDestBuf, uiDestPitchBYTES, gpZBuffer, sZLevel, uiTileIndex );
 									}
 								}
@@ -3000,6 +3289,7 @@ static void RenderTiles(UINT32 uiFlags, INT32 iStartPointX_M, INT32 iStartPointY
 							//	end of the world if it would be drawn on the editor's taskbar.
 							if (iTempPosY_S < INTERFACE_START_Y)
 							{
+								FlushRenderBands();
 								if (!(uiFlags&TILES_DIRTY))
 									UnLockVideoSurface(FRAME_BUFFER);
 								ColorFillVideoSurfaceArea(FRAME_BUFFER, iTempPosX_S, iTempPosY_S, (iTempPosX_S + 40),
@@ -3045,6 +3335,8 @@ static void RenderTiles(UINT32 uiFlags, INT32 iStartPointX_M, INT32 iStartPointY
 	}
 	while (!fEndRenderCol);
 
+	FlushRenderBands();
+
 	if (!(uiFlags&TILES_DIRTY))
 		UnLockVideoSurface(FRAME_BUFFER);
 
@@ -3143,6 +3435,8 @@ TILE_ELEMENT					*TileElem;
 TILE_ANIMATION_DATA		*pAnimData;
 UINT32 cnt = 0;
 
+	PERFORMANCE_MARKER
+
 	gfRenderFullThisFrame = FALSE;
 
 	// If we are testing renderer, set background to pink!
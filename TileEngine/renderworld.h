@@ -160,6 +160,13 @@ void ScrollWorld( );
 void InitRenderParams( UINT8 ubRestrictionID );
 void RenderWorld( );
 
+// stops the threads drawing the bands of the view (RENDER_BANDS)
+void ShutdownRenderBands( void );
+#ifdef JA2TESTVERSION
+// the bands against drawing on the main thread only
+void CompareRenderBands( UINT8 ubNumBands, UINT32 *puiPixelsDiffer, UINT32 *puiSerialTime, UINT32 *puiBandTime );
+#endif
+
 /*	This procedure will initialize gsVIEWPORT_xxx variables
  *	they ware declared with static initializer 
  *	any question? joker
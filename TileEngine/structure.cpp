@@ -32,6 +32,7 @@
 #include "Animation Control.h"
 #include "ASD.h"		// added by Flugente
 #include "renderworld.h"		// added by Flugente for SetRenderFlags( RENDER_FLAG_FULL );
+#include "LOS.h"
 #include <vfs/Core/vfs.h>
 #include "XML_StructureData.hpp"
 
@@ -1185,6 +1186,12 @@ static STRUCTURE * InternalAddStructureToWorld( INT32 sBaseGridNo, INT8 bLevel,
 	pLevelNode->pStructureData = pBaseStructure;
 
 	MemFree( ppStructure );
+
+	// transparent structures (people, small corpses) are skipped by line of sight tests
+	if ( !(pBaseStructure->fFlags & STRUCTURE_TRANSPARENT) )
+	{
+		InvalidateSightCache();
+	}
 	// And we're done! return a pointer to the base structure!
 
 	return( pBaseStructure );
@@ -1280,6 +1287,11 @@ BOOLEAN DeleteStructureFromWorld( STRUCTURE * pStructure )
 		fRecompileExtraRadius = FALSE;
 	}
 
+	if ( !(pBaseStructure->fFlags & STRUCTURE_TRANSPARENT) )
+	{
+		InvalidateSightCache();
+	}
+
 	pBaseMapElement = &gpWorldLevelData[pBaseStructure->sGridNo];
 	ppTile = pBaseStructure->pDBStructureRef->ppTile;
 	sBaseGridNo = pBaseStructure->sGridNo;
@@ -24,6 +24,7 @@
 	#include "EditorBuildings.h"
 	#include "Map Edgepoints.h"
 	#include "Shade Table Util.h"
+	#include "shade_palette_store.h"
 	#include "Structure Wrap.h"
 	#include "Scheduling.h"
 	#include "EditorMapInfo.h"
@@ -43,6 +44,10 @@
 	#include "GameSettings.h"
 	#include "editscreen.h"
 	#include "Editor Taskbar Utils.h"
+	#include "PathClusters.h"
+	#include "AIPathCache.h"
+	#include "LOS.h"
+	#include "Sector Preload.h"
 
 #ifdef JA2EDITOR
 	#include "Summary Info.h"
@@ -315,6 +320,8 @@ BOOLEAN InitializeWorld( )
 void DeinitializeWorld()
 {
 	TrashWorld();
+	ReleaseLevelNodePool();
+	ReleaseSectorPreload();
 	if(gubGridNoMarkers)
 		MemFree(gubGridNoMarkers);
 	if(gsCoverValue)
@@ -583,7 +590,9 @@ BOOLEAN AddTileSurface( STR8  cFilename, UINT32 ubType, UINT8 ubTilesetID, BOOLE
 		sprintf( cAdjustedFile, "%s", cFileBPP );
 	}
 
-	TileSurf = LoadTileSurface( cAdjustedFile );
+	TileSurf = TakePreloadedTileSurface( cAdjustedFile, ubType );
+	if ( TileSurf == NULL )
+		TileSurf = LoadTileSurface( cAdjustedFile );
 
 	if ( TileSurf == NULL )
 		return( FALSE );
@@ -630,13 +639,13 @@ void BuildTileShadeTables(  )
 	//STRING512			DataDir;
 	//STRING512			ShadeTableDir;
 	UINT32				uiLoop;
-	CHAR8 				cRootFile[ 128 ];
-	BOOLEAN				fForceRebuildForSlot = FALSE;
+	static BOOLEAN		fCacheLoaded = FALSE;
 
 #ifdef JA2TESTVERSION
 	UINT32				uiStartTime;
+	UINT32				uiCreatedBefore = gShadePaletteStats.uiCreated;
+	UINT32				uiFromCacheBefore = gShadePaletteStats.uiFromCache;
 #endif
-	static UINT8 ubLastRed = 255, ubLastGreen = 255, ubLastBlue = 255;
 
 	#ifdef JA2TESTVERSION
 		uiNumTablesLoaded = 0;
@@ -667,20 +676,12 @@ void BuildTileShadeTables(  )
 	{
 		gfForceBuildShadeTables = FALSE;
 	}
-	//now, determine if we are using specialized colors.
-	if( gpLightColors[0].peRed || gpLightColors[0].peGreen ||	gpLightColors[0].peBlue )
-	{ //we are, which basically means we force build the shadetables.	However, the one
-		//exception is if we are loading another map and the colors are the same.
-		if( gpLightColors[0].peRed != ubLastRed ||
-				gpLightColors[0].peGreen != ubLastGreen ||
-				gpLightColors[0].peBlue != ubLastBlue )
-		{	//Same tileset, but colors are different, so set things up to regenerate the shadetables.
-			gfForceBuildShadeTables = TRUE;
-		}
-		else
-		{ //same colors, same tileset, so don't rebuild shadetables -- much faster!
-			gfForceBuildShadeTables = FALSE;
-		}
+	//The shade tables are shared by palette and light color, and the cache file holds the ones of every
+	//tileset and light color seen so far, so a change of colors just picks other tables.
+	if( !fCacheLoaded && !gfForceBuildShadeTables )
+	{
+		LoadShadeTableCache( );
+		fCacheLoaded = TRUE;
 	}
 
 	if( gfLoadShadeTablesFromTextFile )
@@ -700,20 +701,11 @@ void BuildTileShadeTables(  )
 				if( gbNewTileSurfaceLoaded[ uiLoop ]  )
 			#endif
 				{
-					fForceRebuildForSlot = FALSE;
-
-					GetRootName( cRootFile, TileSurfaceFilenames[ uiLoop ] );
-
-					if ( strcmp( cRootFile, "grass2" ) == 0 )
-					{
-						fForceRebuildForSlot = TRUE;
-					}
-
 					#ifdef JA2TESTVERSION
 						uiNumImagesReloaded++;
 					#endif
 					RenderProgressBar( 0, uiLoop * 100 / giNumberOfTileTypes );
-					CreateTilePaletteTables( gTileSurfaceArray[ uiLoop ]->vo, uiLoop, fForceRebuildForSlot );
+					CreateTilePaletteTables( gTileSurfaceArray[ uiLoop ]->vo );
 				}
 		}
 	}
@@ -722,11 +714,15 @@ void BuildTileShadeTables(  )
 	////Restore the data directory once we are finished.
 	//SetFileManCurrentDirectory( DataDir );
 
-	ubLastRed = gpLightColors[0].peRed;
-	ubLastGreen = gpLightColors[0].peGreen;
-	ubLastBlue = gpLightColors[0].peBlue;
+	//We paid to generate the new tables, so now save them, so we don't have to regenerate them ever again!
+	if( !gfForceBuildShadeTables )
+	{
+		SaveShadeTableCache( );
+	}
 
 	#ifdef JA2TESTVERSION
+		uiNumTablesSaved = gShadePaletteStats.uiCreated - uiCreatedBefore;
+		uiNumTablesLoaded = gShadePaletteStats.uiFromCache - uiFromCacheBefore;
 		uiBuildShadeTableTime = GetJA2Clock() - uiStartTime;
 	#endif
 }
@@ -873,6 +869,10 @@ static void CompileTileMovementCosts( INT32 usGridNo )
 
 	UINT8			ubDirLoop;
 
+	// the cluster graph has to be refreshed around this tile, and cached AI path costs are stale
+	MarkPathClusterDirty( usGridNo );
+	InvalidateAIPathCache();
+
 	if ( GridNoOnVisibleWorldTile( usGridNo ) )
 	{
 		// check for land of a different height in adjacent locations
@@ -1778,6 +1778,8 @@ void RecompileLocalMovementCostsForWall( INT32 sGridNo, UINT8 ubOrientation )
 // GLOBAL WORLD MANIPULATION FUNCTIONS
 void CompileWorldMovementCosts(void)//dnl ch56 151009
 {
+	InvalidatePathClusters();
+	InvalidateAIPathCache();
 	memset(gubWorldMovementCosts, 0, sizeof(UINT8)*WORLD_MAX*MAXDIR*2);
 	CompileWorldTerrainIDs();
  	for(INT32 usGridNo=0; usGridNo<WORLD_MAX; usGridNo++)
@@ -2860,11 +2862,19 @@ BOOLEAN LoadWorld(const STR8 puiFilename, FLOAT* pMajorMapVersion, UINT8* pMinor
 		return(FALSE);
 	}
 	// Get the file size and alloc one huge buffer for it. We will use this buffer to transfer all of the data from.
-	uiFileSize = FileGetSize(hfile);
-	pBuffer = (INT8*)MemAlloc(uiFileSize);
+	// If the map was preloaded while the squad was on its way, that buffer is ready already.
+	if(TakePreloadedMap(aFilename, &pBuffer, &uiFileSize))
+	{
+		FileClose(hfile);
+	}
+	else
+	{
+		uiFileSize = FileGetSize(hfile);
+		pBuffer = (INT8*)MemAlloc(uiFileSize);
+		FileRead(hfile, pBuffer, uiFileSize, &uiBytesRead);
+		FileClose(hfile);
+	}
 	pBufferHead = pBuffer;
-	FileRead(hfile, pBuffer, uiFileSize, &uiBytesRead);
-	FileClose(hfile);
 
 	// RESET FLAGS FOR OUTDOORS/INDOORS
 	gfBasement = FALSE;
@@ -3119,6 +3129,10 @@ BOOLEAN LoadWorld(const STR8 puiFilename, FLOAT* pMajorMapVersion, UINT8* pMinor
 		}
 	}
 
+	// All tile layers are in and nothing but the tiles points to their nodes yet
+	if(gGameExternalOptions.fCompactLevelNodes)
+		CompactLevelNodes();
+
 	// For old Russian Maps which have version 6.0
 	if(dMajorMapVersion == 6.00 && ubMinorMapVersion < 27)
 	{
@@ -3277,6 +3291,9 @@ BOOLEAN LoadWorld(const STR8 puiFilename, FLOAT* pMajorMapVersion, UINT8* pMinor
 		GenerateMapEdgepoints();
 	}
 
+	if(gGameExternalOptions.fHierarchicalPathfinding)
+		BuildPathClusters();
+
 	RenderProgressBar(0, 20);
 	SetRelativeStartAndEndPercentage(0, 95, 100, L"General initialization...");
 	// RESET AI!
@@ -3667,6 +3684,9 @@ void TrashWorld( void )
 	//Reset the light effects
 	ResetLightEffects();
 
+	// remembered lines of sight belong to this map
+	InvalidateSightCache();
+
 	// Set soldiers to not active!
 	//ATE: FOR NOW, ONLY TRASH FROM NPC UP!!!!
 	//cnt = gTacticalStatus.Team[ gbPlayerNum ].bLastID + 1;
@@ -3725,7 +3745,7 @@ void TrashWorld( void )
 		while ( pLandNode != NULL )
 		{
 			pMapTile->pLandHead = pLandNode->pNext;
-			MemFree( pLandNode );
+			FreeLevelNode( pLandNode );
 			pLandNode = pMapTile->pLandHead;
 		}
 
@@ -3733,7 +3753,7 @@ void TrashWorld( void )
 		while ( pObjectNode != NULL )
 		{
 			pMapTile->pObjectHead = pObjectNode->pNext;
-			MemFree( pObjectNode );
+			FreeLevelNode( pObjectNode );
 			pObjectNode = pMapTile->pObjectHead;
 		}
 
@@ -3741,7 +3761,7 @@ void TrashWorld( void )
 		while ( pStructNode != NULL )
 		{
 			pMapTile->pStructHead = pStructNode->pNext;
-			MemFree( pStructNode );
+			FreeLevelNode( pStructNode );
 			pStructNode = pMapTile->pStructHead;
 		}
 
@@ -3749,7 +3769,7 @@ void TrashWorld( void )
 		while ( pShadowNode != NULL )
 		{
 			pMapTile->pShadowHead = pShadowNode->pNext;
-			MemFree( pShadowNode );
+			FreeLevelNode( pShadowNode );
 			pShadowNode = pMapTile->pShadowHead;
 		}
 
@@ -3757,7 +3777,7 @@ void TrashWorld( void )
 		while ( pMercNode != NULL )
 		{
 			pMapTile->pMercHead = pMercNode->pNext;
-			MemFree( pMercNode );
+			FreeLevelNode( pMercNode );
 			pMercNode = pMapTile->pMercHead;
 		}
 
@@ -3765,7 +3785,7 @@ void TrashWorld( void )
 		while ( pRoofNode != NULL )
 		{
 			pMapTile->pRoofHead = pRoofNode->pNext;
-			MemFree( pRoofNode );
+			FreeLevelNode( pRoofNode );
 			pRoofNode = pMapTile->pRoofHead;
 		}
 
@@ -3773,7 +3793,7 @@ void TrashWorld( void )
 		while ( pOnRoofNode != NULL )
 		{
 			pMapTile->pOnRoofHead = pOnRoofNode->pNext;
-			MemFree( pOnRoofNode );
+			FreeLevelNode( pOnRoofNode );
 			pOnRoofNode = pMapTile->pOnRoofHead;
 		}
 
@@ -3781,7 +3801,7 @@ void TrashWorld( void )
 		while ( pTopmostNode != NULL )
 		{
 			pMapTile->pTopmostHead = pTopmostNode->pNext;
-			MemFree( pTopmostNode );
+			FreeLevelNode( pTopmostNode );
 			pTopmostNode = pMapTile->pTopmostHead;
 		}
 
@@ -3836,7 +3856,7 @@ void TrashMapTile(INT32 MapTile)
 	while ( pLandNode != NULL )
 	{
 		pMapTile->pLandHead = pLandNode->pNext;
-		MemFree( pLandNode );
+		FreeLevelNode( pLandNode );
 		pLandNode = pMapTile->pLandHead;
 	}
 	pMapTile->pLandHead = pMapTile->pLandStart = NULL;
@@ -3845,7 +3865,7 @@ void TrashMapTile(INT32 MapTile)
 	while ( pObjectNode != NULL )
 	{
 		pMapTile->pObjectHead = pObjectNode->pNext;
-		MemFree( pObjectNode );
+		FreeLevelNode( pObjectNode );
 		pObjectNode = pMapTile->pObjectHead;
 	}
 	pMapTile->pObjectHead = NULL;
@@ -3854,7 +3874,7 @@ void TrashMapTile(INT32 MapTile)
 	while ( pStructNode != NULL )
 	{
 		pMapTile->pStructHead = pStructNode->pNext;
-		MemFree( pStructNode );
+		FreeLevelNode( pStructNode );
 		pStructNode = pMapTile->pStructHead;
 	}
 	pMapTile->pStructHead = NULL;
@@ -3863,7 +3883,7 @@ void TrashMapTile(INT32 MapTile)
 	while ( pShadowNode != NULL )
 	{
 		pMapTile->pShadowHead = pShadowNode->pNext;
-		MemFree( pShadowNode );
+		FreeLevelNode( pShadowNode );
 		pShadowNode = pMapTile->pShadowHead;
 	}
 	pMapTile->pShadowHead = NULL;
@@ -3872,7 +3892,7 @@ void TrashMapTile(INT32 MapTile)
 	while ( pMercNode != NULL )
 	{
 		pMapTile->pMercHead = pMercNode->pNext;
-		MemFree( pMercNode );
+		FreeLevelNode( pMercNode );
 		pMercNode = pMapTile->pMercHead;
 	}
 	pMapTile->pMercHead = NULL;
@@ -3881,7 +3901,7 @@ void TrashMapTile(INT32 MapTile)
 	while ( pRoofNode != NULL )
 	{
 		pMapTile->pRoofHead = pRoofNode->pNext;
-		MemFree( pRoofNode );
+		FreeLevelNode( pRoofNode );
 		pRoofNode = pMapTile->pRoofHead;
 	}
 	pMapTile->pRoofHead = NULL;
@@ -3890,7 +3910,7 @@ void TrashMapTile(INT32 MapTile)
 	while ( pOnRoofNode != NULL )
 	{
 		pMapTile->pOnRoofHead = pOnRoofNode->pNext;
-		MemFree( pOnRoofNode );
+		FreeLevelNode( pOnRoofNode );
 		pOnRoofNode = pMapTile->pOnRoofHead;
 	}
 	pMapTile->pOnRoofHead =		NULL;
@@ -3899,7 +3919,7 @@ void TrashMapTile(INT32 MapTile)
 	while ( pTopmostNode != NULL )
 	{
 		pMapTile->pTopmostHead = pTopmostNode->pNext;
-		MemFree( pTopmostNode );
+		FreeLevelNode( pTopmostNode );
 		pTopmostNode = pMapTile->pTopmostHead;
 	}
 	pMapTile->pTopmostHead =	NULL;
@@ -3938,6 +3958,7 @@ giOldTilesetUsed = giCurrentTilesetID;
 
 	// LOAD SURFACES
 	CHECKF( LoadTileSurfaces( &(gTilesets[ iTilesetID ].TileSurfaceFilenames[0] ), (UINT8)iTilesetID ) != FALSE );
+	ReleasePreloadedTileSurfaces( );
 
 	// SET TERRAIN COSTS
 	if ( gTilesets[ iTilesetID ].MovementCostFnc != NULL )
@@ -38,12 +38,194 @@ void RemoveWorldFlagsFromNewNode( INT32 sGridNo, UINT16 usIndex );
 
 BOOLEAN RemoveLandEx( INT32 iMapIndex, UINT16 usIndex );
 
+// level nodes in use
 UINT32 guiLevelNodes = 0;
 
+// LEVELNODEs are cut from slabs of LEVELNODE_SLAB_SIZE nodes instead of being MemAlloc()ed one by one, and freed
+// nodes go onto a free list for the next ones. When the last node is freed (TrashWorld() frees them all), the
+// free list is dropped and the next map cuts its nodes from the start of the slabs again, in the order it adds
+// them. The slabs themselves are kept for the next map and freed by ReleaseLevelNodePool().
+#define LEVELNODE_SLAB_SIZE		4096
+
+typedef struct LEVELNODE_SLAB
+{
+	struct LEVELNODE_SLAB	*pNext;
+	UINT32					uiUsed;			// nodes cut from the start of the slab so far
+	LEVELNODE				Nodes[ LEVELNODE_SLAB_SIZE ];
+} LEVELNODE_SLAB;
+
+static LEVELNODE_SLAB	*gpLevelNodeSlabs = NULL;		// all slabs, in the order they were made
+static LEVELNODE_SLAB	*gpLevelNodeSlab = NULL;		// the one nodes are cut from, the ones after it are unused
+static LEVELNODE		*gpFreeLevelNodes = NULL;
+
+LEVELNODE_POOL_STATS	gLevelNodePoolStats;
+
+static LEVELNODE *CutLevelNode( void )
+{
+	LEVELNODE_SLAB *pSlab;
+
+	if ( gpLevelNodeSlab == NULL || gpLevelNodeSlab->uiUsed == LEVELNODE_SLAB_SIZE )
+	{
+		if ( gpLevelNodeSlab != NULL && gpLevelNodeSlab->pNext != NULL )
+		{
+			gpLevelNodeSlab = gpLevelNodeSlab->pNext;
+		}
+		else
+		{
+			pSlab = (LEVELNODE_SLAB *)MemAlloc( sizeof( LEVELNODE_SLAB ) );
+			if ( pSlab == NULL )
+				return( NULL );
+
+			pSlab->pNext = NULL;
+			pSlab->uiUsed = 0;
+			if ( gpLevelNodeSlab != NULL )
+				gpLevelNodeSlab->pNext = pSlab;
+			else
+				gpLevelNodeSlabs = pSlab;
+			gpLevelNodeSlab = pSlab;
+
+			gLevelNodePoolStats.uiSlabs++;
+		}
+	}
+
+	return( &gpLevelNodeSlab->Nodes[ gpLevelNodeSlab->uiUsed++ ] );
+}
+
 // LEVEL NODE MANIPLULATION FUNCTIONS
+LEVELNODE *AllocLevelNode( void )
+{
+	LEVELNODE *pNode;
+
+	if ( gpFreeLevelNodes != NULL )
+	{
+		pNode = gpFreeLevelNodes;
+		gpFreeLevelNodes = pNode->pNext;
+	}
+	else
+	{
+		pNode = CutLevelNode();
+		if ( pNode == NULL )
+			return( NULL );
+	}
+
+	guiLevelNodes++;
+	gLevelNodePoolStats.uiAllocations++;
+	gLevelNodePoolStats.uiPeak = __max( gLevelNodePoolStats.uiPeak, guiLevelNodes );
+
+	return( pNode );
+}
+
+void FreeLevelNode( LEVELNODE *pNode )
+{
+	LEVELNODE_SLAB *pSlab;
+
+	Assert( guiLevelNodes > 0 );
+
+	pNode->pNext = gpFreeLevelNodes;
+	gpFreeLevelNodes = pNode;
+
+	guiLevelNodes--;
+	gLevelNodePoolStats.uiFrees++;
+
+	// all nodes are free, start over from the first slab
+	if ( guiLevelNodes == 0 )
+	{
+		for ( pSlab = gpLevelNodeSlabs; pSlab != NULL; pSlab = pSlab->pNext )
+			pSlab->uiUsed = 0;
+		gpLevelNodeSlab = gpLevelNodeSlabs;
+		gpFreeLevelNodes = NULL;
+	}
+}
+
+void ReleaseLevelNodePool( void )
+{
+	LEVELNODE_SLAB *pSlab;
+
+	// nodes still in use (the editor's undo copies) keep their slabs
+	if ( guiLevelNodes != 0 )
+		return;
+
+	while ( gpLevelNodeSlabs != NULL )
+	{
+		pSlab = gpLevelNodeSlabs;
+		gpLevelNodeSlabs = pSlab->pNext;
+		MemFree( pSlab );
+	}
+	gpLevelNodeSlab = NULL;
+	gpFreeLevelNodes = NULL;
+	gLevelNodePoolStats.uiSlabs = 0;
+}
+
+// Nodes that something other than the tile lists points to stay where they are
+#define LEVELNODE_REFERENCED	( LEVELNODE_SOLDIER | LEVELNODE_MERCPLACEHOLDER | LEVELNODE_CACHEDANITILE | LEVELNODE_ROTTINGCORPSE | LEVELNODE_ANIMATION | LEVELNODE_ITEM | LEVELNODE_PHYSICSOBJECT | LEVELNODE_EXITGRID )
+
+void CompactLevelNodes( void )
+{
+	MAP_ELEMENT		*pME;
+	LEVELNODE		**ppLink;
+	LEVELNODE		*pOld, *pNew, *pPrevLand;
+	INT32			cnt;
+	UINT32			uiLevel;
+	UINT32			uiStartTime = GetJA2Clock();
+
+	gLevelNodePoolStats.uiCompacted = 0;
+
+	// Copy the nodes to fresh slab space tile by tile, layer by layer, so the nodes of a tile lie next to each other
+	// in the order RenderTiles() and the lighting walk them, instead of spread over the whole map layer by layer
+	// as the map file added them.
+	for ( cnt = 0; cnt < WORLD_MAX; cnt++ )
+	{
+		pME = &gpWorldLevelData[ cnt ];
+
+		for ( uiLevel = 0; uiLevel < 9; uiLevel++ )
+		{
+			// pLandStart points into the land list, soldiers point to their merc nodes
+			if ( uiLevel == LAND_START_INDEX || uiLevel == MERC_START_INDEX )
+				continue;
+
+			pPrevLand = NULL;
+			ppLink = &pME->pLevelNodes[ uiLevel ];
+			while ( *ppLink != NULL )
+			{
+				pOld = *ppLink;
+
+				if ( uiLevel != 0 && ( pOld->uiFlags & LEVELNODE_REFERENCED ) )
+				{
+					ppLink = &pOld->pNext;
+					continue;
+				}
+
+				pNew = CutLevelNode();
+				if ( pNew == NULL )
+					return;
+
+				*pNew = *pOld;
+				// land is linked both ways
+				if ( uiLevel == 0 )
+				{
+					pNew->pPrevNode = pPrevLand;
+					pPrevLand = pNew;
+					if ( pME->pLandStart == pOld )
+						pME->pLandStart = pNew;
+				}
+				*ppLink = pNew;
+				ppLink = &pNew->pNext;
+
+				// the copy takes over the count of the original
+				pOld->pNext = gpFreeLevelNodes;
+				gpFreeLevelNodes = pOld;
+
+				gLevelNodePoolStats.uiCompacted++;
+			}
+		}
+	}
+
+	gLevelNodePoolStats.uiCompactTime = GetJA2Clock() - uiStartTime;
+}
+
 BOOLEAN	CreateLevelNode( LEVELNODE **ppNode )
 {
-	*ppNode = (LEVELNODE *)MemAlloc( sizeof( LEVELNODE ) );
+	*ppNode = AllocLevelNode();
 	CHECKF( *ppNode != NULL );
 
 	// Clear all values
@@ -57,8 +239,6 @@ BOOLEAN	CreateLevelNode( LEVELNODE **ppNode )
 	(*ppNode)->sRelativeX		= 0;
 	(*ppNode)->sRelativeY		= 0;
 
-	guiLevelNodes++;
-
 	return( TRUE );
 }
 
@@ -105,6 +285,9 @@ void DebugLevelNodePage( void )
 	gprintf( 0, LINE_HEIGHT * 12, L"%d land nodes in excess of world max", guiLNCount[1] - WORLD_MAX);
 	gprintf( 0, LINE_HEIGHT * 13, L"Total # levelnodes %d, %d bytes each", guiLNCount[0], sizeof( LEVELNODE ) );
 	gprintf( 0, LINE_HEIGHT * 14, L"Total memory for levelnodes %d", guiLNCount[0] * sizeof( LEVELNODE ) );
+	gprintf( 0, LINE_HEIGHT * 16, L"Pool: %d in use, %d peak, %d slabs (%d KB)", guiLevelNodes, gLevelNodePoolStats.uiPeak, gLevelNodePoolStats.uiSlabs, gLevelNodePoolStats.uiSlabs * sizeof( LEVELNODE_SLAB ) / 1024 );
+	gprintf( 0, LINE_HEIGHT * 17, L"Pool: %d allocations, %d frees", gLevelNodePoolStats.uiAllocations, gLevelNodePoolStats.uiFrees );
+	gprintf( 0, LINE_HEIGHT * 18, L"Compacted %d nodes in %d ms on load", gLevelNodePoolStats.uiCompacted, gLevelNodePoolStats.uiCompactTime );
 }
 
 BOOLEAN TypeExistsInLevel( LEVELNODE *pStartNode, UINT32 fType, UINT16 *pusIndex )
@@ -317,8 +500,7 @@ BOOLEAN RemoveObject( INT32 iMapIndex, UINT16 usIndex )
 			CheckForAndDeleteTileCacheStructInfo( pObject, usIndex );
 
 			// Delete memory assosiated with item
-			MemFree( pObject );
-			guiLevelNodes--;
+			FreeLevelNode( pObject );
 
 			//Add the index to the maps temp file so we can remove it after reloading the map
 			AddRemoveObjectToMapTempFile( iMapIndex, usIndex );
@@ -586,8 +768,7 @@ BOOLEAN RemoveLandEx( INT32 iMapIndex, UINT16 usIndex )
 			}
 
 			// Delete memory assosiated with item
-			MemFree( pLand );
-			guiLevelNodes--;
+			FreeLevelNode( pLand );
 
 			break;
 
@@ -1095,8 +1276,7 @@ LEVELNODE *AddStructToTailCommon( INT32 iMapIndex, UINT16 usIndex, BOOLEAN fAddS
 				{
 					if (AddStructureToWorld( iMapIndex, 0, gTileDatabase[usIndex].pDBStructureRef, pNextStruct ) == FALSE)
 					{
-						MemFree( pNextStruct );
-						guiLevelNodes--;
+						FreeLevelNode( pNextStruct );
 						return( NULL );
 					}
 				}
@@ -1133,8 +1313,7 @@ LEVELNODE *AddStructToTailCommon( INT32 iMapIndex, UINT16 usIndex, BOOLEAN fAddS
 				{
 					if (AddStructureToWorld( iMapIndex, 0, gTileDatabase[usIndex].pDBStructureRef, pNextStruct ) == FALSE)
 					{
-						MemFree( pNextStruct );
-						guiLevelNodes--;
+						FreeLevelNode( pNextStruct );
 						return( NULL );
 					}
 					else
@@ -1204,8 +1383,7 @@ BOOLEAN AddStructToHead( INT32 iMapIndex, UINT16 usIndex )
 		{
 			if (AddStructureToWorld( iMapIndex, 0, gTileDatabase[usIndex].pDBStructureRef, pNextStruct ) == FALSE)
 			{
-				MemFree( pNextStruct );
-				guiLevelNodes--;
+				FreeLevelNode( pNextStruct );
 				return( FALSE );
 			}
 		}
@@ -1294,8 +1472,7 @@ BOOLEAN InsertStructIndex( INT32 iMapIndex, UINT16 usIndex, UINT8 ubLevel )
 	// Check if level has been macthed
 	if ( !CanInsert )
 	{
-		MemFree( pNextStruct );
-		guiLevelNodes--;
+		FreeLevelNode( pNextStruct );
 		return( FALSE );
 	}
 
@@ -1305,8 +1482,7 @@ BOOLEAN InsertStructIndex( INT32 iMapIndex, UINT16 usIndex, UINT8 ubLevel )
 		{
 			if (AddStructureToWorld( iMapIndex, 0, gTileDatabase[usIndex].pDBStructureRef, pNextStruct ) == FALSE)
 			{
-				MemFree( pNextStruct );
-				guiLevelNodes--;
+				FreeLevelNode( pNextStruct );
 				return( FALSE );
 			}
 		}
@@ -1376,8 +1552,7 @@ BOOLEAN RemoveStructFromTailCommon( INT32 iMapIndex, BOOLEAN fRemoveStructDBInfo
 			RemoveStructFromMapTempFile( iMapIndex, usIndex );
 
 
-			MemFree( pStruct );
-			guiLevelNodes--;
+			FreeLevelNode( pStruct );
 
 			if ( usIndex < giNumberOfTiles )
 			{
@@ -1450,8 +1625,7 @@ BOOLEAN RemoveStruct( INT32 iMapIndex, UINT16 usIndex )
 					RemoveShadow( iMapIndex, gTileDatabase[ usIndex ].sBuddyNum );
 				}
 			}
-			MemFree( pStruct );
-			--guiLevelNodes;
+			FreeLevelNode( pStruct );
 
 			return( TRUE );
 		}
@@ -1570,8 +1744,7 @@ BOOLEAN RemoveOnRoofStruct( INT32 iMapIndex, UINT16 usIndex )
 					RemoveShadow( iMapIndex, gTileDatabase[usIndex].sBuddyNum );
 				}
 			}
-			MemFree( pStruct );
-			--guiLevelNodes;
+			FreeLevelNode( pStruct );
 
 			return(TRUE);
 		}
@@ -1618,8 +1791,7 @@ BOOLEAN RemoveRoofAdjustSavefile( INT32 iMapIndex, UINT16 usIndex )
 			//If we have to, make sure to remove this node when we reload the map from a saved game
 			RemoveRoofFromMapTempFile( iMapIndex, usIndex );
 
-			MemFree( pStruct );
-			--guiLevelNodes;
+			FreeLevelNode( pStruct );
 
 			return(TRUE);
 		}
@@ -1665,8 +1837,7 @@ BOOLEAN RemoveOnRoofAdjustSavefile( INT32 iMapIndex, UINT16 usIndex )
 			//If we have to, make sure to remove this node when we reload the map from a saved game
 			RemoveOnRoofFromMapTempFile( iMapIndex, usIndex );
 
-			MemFree( pStruct );
-			--guiLevelNodes;
+			FreeLevelNode( pStruct );
 
 			return(TRUE);
 		}
@@ -1724,8 +1895,7 @@ BOOLEAN RemoveStructFromLevelNode( INT32 iMapIndex, LEVELNODE *pNode )
 					RemoveShadow( iMapIndex, gTileDatabase[ usIndex ].sBuddyNum );
 				}
 			}
-			MemFree( pStruct );
-			guiLevelNodes--;
+			FreeLevelNode( pStruct );
 
 			return( TRUE );
 		}
@@ -2294,8 +2464,7 @@ BOOLEAN RemoveShadow( INT32 iMapIndex, UINT16 usIndex )
 				pOldShadow->pNext = pShadow->pNext;
 			}
 			// Delete memory assosiated with item
-			MemFree( pShadow );
-			guiLevelNodes--;
+			FreeLevelNode( pShadow );
 
 			return( TRUE );
 		}
@@ -2338,8 +2507,7 @@ BOOLEAN RemoveShadowFromLevelNode( INT32 iMapIndex, LEVELNODE *pNode )
 			}
 
 			// Delete memory assosiated with item
-			MemFree( pShadow );
-			guiLevelNodes--;
+			FreeLevelNode( pShadow );
 
 			return( TRUE );
 		}
@@ -2382,8 +2550,7 @@ BOOLEAN RemoveStructShadowPartner( INT32 iMapIndex, UINT16 usIndex )
 			}
 
 			// Delete memory assosiated with item
-			MemFree( pShadow );
-			guiLevelNodes--;
+			FreeLevelNode( pShadow );
 
 			return( TRUE );
 		}
@@ -2728,8 +2895,7 @@ BOOLEAN RemoveMerc( INT32 iMapIndex, SOLDIERTYPE *pSoldier, BOOLEAN fPlaceHolder
 				}
 
 				// Delete memory assosiated with item
-				MemFree( pMerc );
-				guiLevelNodes--;
+				FreeLevelNode( pMerc );
 
 				return( TRUE );
 			}
@@ -2767,8 +2933,7 @@ LEVELNODE *AddRoofToTail( INT32 iMapIndex, UINT16 usIndex )
 			{
 				if (AddStructureToWorld( iMapIndex, 1, gTileDatabase[usIndex].pDBStructureRef, pRoof ) == FALSE)
 				{
-					MemFree( pRoof );
-					guiLevelNodes--;
+					FreeLevelNode( pRoof );
 					return( FALSE );
 				}
 			}
@@ -2794,8 +2959,7 @@ LEVELNODE *AddRoofToTail( INT32 iMapIndex, UINT16 usIndex )
 					{
 						if (AddStructureToWorld( iMapIndex, 1, gTileDatabase[usIndex].pDBStructureRef, pNextRoof ) == FALSE)
 						{
-							MemFree( pNextRoof );
-							guiLevelNodes--;
+							FreeLevelNode( pNextRoof );
 							return( FALSE );
 						}
 					}
@@ -2837,8 +3001,7 @@ BOOLEAN AddRoofToHead( INT32 iMapIndex, UINT16 usIndex )
 		{
 			if (AddStructureToWorld( iMapIndex, 1, gTileDatabase[usIndex].pDBStructureRef, pNextRoof ) == FALSE)
 			{
-				MemFree( pNextRoof );
-				guiLevelNodes--;
+				FreeLevelNode( pNextRoof );
 				return( FALSE );
 			}
 		}
@@ -2883,8 +3046,7 @@ BOOLEAN RemoveRoof( INT32 iMapIndex, UINT16 usIndex )
 			}
 			// Delete memory assosiated with item
 			DeleteStructureFromWorld( pRoof->pStructureData );
-			MemFree( pRoof );
-			guiLevelNodes--;
+			FreeLevelNode( pRoof );
 
 			return( TRUE );
 		}
@@ -3120,8 +3282,7 @@ LEVELNODE *AddOnRoofToTail( INT32 iMapIndex, UINT16 usIndex )
 			{
 				if (AddStructureToWorld( iMapIndex, 1, gTileDatabase[usIndex].pDBStructureRef, pOnRoof ) == FALSE)
 				{
-					MemFree( pOnRoof );
-					guiLevelNodes--;
+					FreeLevelNode( pOnRoof );
 					return( FALSE );
 				}
 			}
@@ -3149,8 +3310,7 @@ LEVELNODE *AddOnRoofToTail( INT32 iMapIndex, UINT16 usIndex )
 					{
 						if (AddStructureToWorld( iMapIndex, 1, gTileDatabase[usIndex].pDBStructureRef, pNextOnRoof ) == FALSE)
 						{
-							MemFree( pNextOnRoof );
-							guiLevelNodes--;
+							FreeLevelNode( pNextOnRoof );
 							return( NULL );
 						}
 					}
@@ -3189,8 +3349,7 @@ BOOLEAN AddOnRoofToHead( INT32 iMapIndex, UINT16 usIndex )
 		{
 			if (AddStructureToWorld( iMapIndex, 1, gTileDatabase[usIndex].pDBStructureRef, pNextOnRoof ) == FALSE)
 			{
-				MemFree( pNextOnRoof );
-				guiLevelNodes--;
+				FreeLevelNode( pNextOnRoof );
 				return( FALSE );
 			}
 		}
@@ -3235,8 +3394,7 @@ BOOLEAN RemoveOnRoof( INT32 iMapIndex, UINT16 usIndex )
 			}
 
 			// REMOVE ONROOF!
-			MemFree( pOnRoof );
-			guiLevelNodes--;
+			FreeLevelNode( pOnRoof );
 
 			return( TRUE );
 		}
@@ -3279,8 +3437,7 @@ BOOLEAN RemoveOnRoofFromLevelNode( INT32 iMapIndex, LEVELNODE *pNode )
 			}
 
 			// REMOVE ONROOF!
-			MemFree( pOnRoof );
-			guiLevelNodes--;
+			FreeLevelNode( pOnRoof );
 
 			return( TRUE );
 		}
@@ -3523,8 +3680,7 @@ BOOLEAN RemoveTopmost( INT32 iMapIndex, UINT16 usIndex )
 			}
 
 			// Delete memory assosiated with item
-			MemFree( pTopmost );
-			guiLevelNodes--;
+			FreeLevelNode( pTopmost );
 
 			return( TRUE );
 		}
@@ -3570,8 +3726,7 @@ BOOLEAN RemoveTopmostFromLevelNode( INT32 iMapIndex, LEVELNODE *pNode )
 			}
 
 			// Delete memory assosiated with item
-			MemFree( pTopmost );
-			guiLevelNodes--;
+			FreeLevelNode( pTopmost );
 
 			return( TRUE );
 		}
@@ -4,6 +4,28 @@
 // memory-accounting function
 void CountLevelNodes( void );
 
+// LEVELNODEs come from a pool (see worldman.cpp), never MemAlloc() or MemFree() one
+typedef struct
+{
+	UINT32	uiSlabs;			// slabs allocated
+	UINT32	uiPeak;				// most nodes in use at once
+	UINT32	uiAllocations;		// nodes handed out so far
+	UINT32	uiFrees;			// nodes given back so far
+	UINT32	uiCompacted;		// nodes moved by the last CompactLevelNodes()
+	UINT32	uiCompactTime;		// milliseconds it took
+} LEVELNODE_POOL_STATS;
+
+extern UINT32				guiLevelNodes;
+extern LEVELNODE_POOL_STATS	gLevelNodePoolStats;
+
+// a node with undefined contents, CreateLevelNode() gives a cleared one
+LEVELNODE *AllocLevelNode( void );
+void FreeLevelNode( LEVELNODE *pNode );
+// frees the slabs, if no nodes are in use
+void ReleaseLevelNodePool( void );
+// moves the nodes of the loaded map together tile by tile, see COMPACT_LEVELNODES
+void CompactLevelNodes( void );
+
 
 // Object manipulation functions
 BOOLEAN RemoveObject( INT32 iMapIndex, UINT16 usIndex );
@@ -2,6 +2,7 @@
 	#include <time.h>
 	#include "sgp.h"
 	#include "himage.h"
+	#include "shade_palette_store.h"
 	#include "vsurface.h"
 	#include "WCheck.h"
 	#include "Font Control.h"
@@ -289,6 +290,7 @@ UINT16 CreateFontPaletteTables(HVOBJECT pObj )
 {
 	UINT32 count;
 	SGPPaletteEntry Pal[256];
+	UINT64 uiPaletteHash;
 
 	for( count = 0; count < 16; count++ )
 	{
@@ -296,11 +298,14 @@ UINT16 CreateFontPaletteTables(HVOBJECT pObj )
 			pObj->pShades[ count ] = NULL;
 		else if ( pObj->pShades[ count ] != NULL )
 		{
-			MemFree( pObj->pShades[ count ] );
+			ReleaseShadePalette( pObj->pShades[ count ] );
 			pObj->pShades[ count ] = NULL;
 		}
 	}
 
+	// most fonts have the same palette, so they share the tables
+	uiPaletteHash = HashShadePalette( pObj->pPaletteEntry );
+
 	// Build white palette
 	for(count=0; count < 256; count++)
 	{
@@ -309,26 +314,26 @@ UINT16 CreateFontPaletteTables(HVOBJECT pObj )
 		Pal[count].peBlue=(UINT8)255;
 	}
 
-	pObj->pShades[ FONT_SHADE_RED ]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 255, 0, 0, TRUE);
-	pObj->pShades[ FONT_SHADE_BLUE ]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 0, 0, 255, TRUE);
-	pObj->pShades[ FONT_SHADE_GREEN ]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 0, 255, 0, TRUE);
-	pObj->pShades[ FONT_SHADE_YELLOW ]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 255, 255, 0, TRUE);
-	pObj->pShades[ FONT_SHADE_NEUTRAL ]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 255, 255, 255, FALSE);
+	pObj->pShades[ FONT_SHADE_RED ]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 255, 0, 0, TRUE);
+	pObj->pShades[ FONT_SHADE_BLUE ]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 0, 0, 255, TRUE);
+	pObj->pShades[ FONT_SHADE_GREEN ]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 0, 255, 0, TRUE);
+	pObj->pShades[ FONT_SHADE_YELLOW ]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 255, 255, 0, TRUE);
+	pObj->pShades[ FONT_SHADE_NEUTRAL ]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 255, 255, 255, FALSE);
 
-	pObj->pShades[ FONT_SHADE_WHITE ]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 255, 255, 255, TRUE);
+	pObj->pShades[ FONT_SHADE_WHITE ]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 255, 255, 255, TRUE);
 
 
 	// the rest are darkening tables, right down to all-black.
-	pObj->pShades[0]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 165, 165, 165, FALSE);
-	pObj->pShades[7]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 135, 135, 135, FALSE);
-	pObj->pShades[8]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 105, 105, 105, FALSE);
-	pObj->pShades[9]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 75, 75, 75, FALSE);
-	pObj->pShades[10]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 45, 45, 45, FALSE);
-	pObj->pShades[11]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 36, 36, 36, FALSE);
-	pObj->pShades[12]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 27, 27, 27, FALSE);
-	pObj->pShades[13]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 18, 18, 18, FALSE);
-	pObj->pShades[14]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 9, 9, 9, FALSE);
-	pObj->pShades[15]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 0, 0, 0, FALSE);
+	pObj->pShades[0]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 165, 165, 165, FALSE);
+	pObj->pShades[7]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 135, 135, 135, FALSE);
+	pObj->pShades[8]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 105, 105, 105, FALSE);
+	pObj->pShades[9]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 75, 75, 75, FALSE);
+	pObj->pShades[10]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 45, 45, 45, FALSE);
+	pObj->pShades[11]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 36, 36, 36, FALSE);
+	pObj->pShades[12]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 27, 27, 27, FALSE);
+	pObj->pShades[13]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 18, 18, 18, FALSE);
+	pObj->pShades[14]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 9, 9, 9, FALSE);
+	pObj->pShades[15]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 0, 0, 0, FALSE);
 
 	// Set current shade table to neutral color
 	pObj->pShadeCurrent=pObj->pShades[4];
@@ -7,11 +7,30 @@
 
 #include <language.hpp>
 
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #define		SINGLE_CHARACTER_WORD_FOR_WORDWRAP
 
 
 BOOLEAN	gfUseSingleCharWordsForWordWrap = FALSE;
 
+// The lines LineWrap() broke a string into, by font, width and string. The same texts get wrapped again every
+// time a screen is drawn, and measuring them character by character is most of what it costs. The cache starts
+// over when the fonts or the language change, or when it gets too big.
+#define		LINE_WRAP_CACHE_SIZE		1024
+
+typedef struct
+{
+	UINT16						usLineWidthPixels;		// what *pusLineWidthIfWordIsWiderThenWidth was set to
+	std::vector<std::wstring>	Lines;
+} LINE_WRAP_RESULT;
+
+static std::unordered_map<std::wstring, LINE_WRAP_RESULT> gLineWrapCache;
+static UINT32			guiLineWrapCacheGeneration = 0;
+static i18n::Lang		geLineWrapCacheLang = i18n::Lang::en;
+
 
 void UseSingleCharWordsForWordWrap( BOOLEAN fUseSingleCharWords )
 {
@@ -136,16 +155,14 @@ WRAPPED_STRING *LineWrapForSingleCharWords(INT32 iFont, UINT16 usLineWidthPixels
 
 
 
-WRAPPED_STRING *LineWrap(INT32 iFont, UINT16 usLineWidthPixels, UINT16 *pusLineWidthIfWordIsWiderThenWidth, STR16 pString, ...)
+static WRAPPED_STRING *WrapString(INT32 iFont, UINT16 usLineWidthPixels, UINT16 *pusLineWidthIfWordIsWiderThenWidth, STR16 pString, CHAR16 *TempString)
 {
 	WRAPPED_STRING FirstWrappedString;
 	WRAPPED_STRING *pWrappedString = NULL;
-	CHAR16					TempString[1024];
 	CHAR16		 pNullString[2];
 	INT16					usCurIndex, usEndIndex, usDestIndex, usLastMaxWidthIndex;
 	STR16						pCurrentStringLoc;
 	CHAR16					DestString[1024];
-	va_list					argptr;
 	BOOLEAN					fDone = FALSE;
 	UINT16					usCurrentWidthPixels=0;
 	CHAR16					OneChar[2];
@@ -156,21 +173,8 @@ WRAPPED_STRING *LineWrap(INT32 iFont, UINT16 usLineWidthPixels, UINT16 *pusLineW
 	pNullString[0]=L' ';
 	pNullString[1]=0;
 
-	DebugMsg (TOPIC_JA2,DBG_LEVEL_3,String("LineWrap: %s", pString));
-
 	memset(&FirstWrappedString, 0, sizeof(WRAPPED_STRING) );
 
-	*pusLineWidthIfWordIsWiderThenWidth = usLineWidthPixels;
-
-	if(pString == NULL)
-	{
-		DebugMsg (TOPIC_JA2,DBG_LEVEL_3,String("LineWrap: done"));
-		return(FALSE);
-	}
-	va_start(argptr, pString);			// Set up variable argument pointer
-	vswprintf(TempString, pString, argptr);	// process string (get output str)
-	va_end(argptr);
-
 	usCurIndex = usEndIndex = usDestIndex = usLastMaxWidthIndex = 0;
 	OneChar[1] = L'\0';
 
@@ -408,6 +412,78 @@ WRAPPED_STRING *LineWrap(INT32 iFont, UINT16 usLineWidthPixels, UINT16 *pusLineW
 	return(FirstWrappedString.pNextWrappedString);
 }
 
+WRAPPED_STRING *LineWrap(INT32 iFont, UINT16 usLineWidthPixels, UINT16 *pusLineWidthIfWordIsWiderThenWidth, STR16 pString, ...)
+{
+	static std::wstring	Key;
+	WRAPPED_STRING		FirstWrappedString;
+	WRAPPED_STRING		*pWrappedString;
+	CHAR16				TempString[1024];
+	va_list				argptr;
+	size_t				uiLine;
+
+	DebugMsg (TOPIC_JA2,DBG_LEVEL_3,String("LineWrap: %s", pString));
+
+	*pusLineWidthIfWordIsWiderThenWidth = usLineWidthPixels;
+
+	if(pString == NULL)
+	{
+		DebugMsg (TOPIC_JA2,DBG_LEVEL_3,String("LineWrap: done"));
+		return(FALSE);
+	}
+	va_start(argptr, pString);			// Set up variable argument pointer
+	vswprintf(TempString, pString, argptr);	// process string (get output str)
+	va_end(argptr);
+
+	if ( guiLineWrapCacheGeneration != guiFontCacheGeneration || geLineWrapCacheLang != g_lang || gLineWrapCache.size() >= LINE_WRAP_CACHE_SIZE )
+	{
+		gLineWrapCache.clear();
+		guiLineWrapCacheGeneration = guiFontCacheGeneration;
+		geLineWrapCacheLang = g_lang;
+	}
+
+	Key.clear();
+	Key.push_back( (wchar_t)iFont );
+	Key.push_back( (wchar_t)usLineWidthPixels );
+	Key.append( TempString );
+
+	std::unordered_map<std::wstring, LINE_WRAP_RESULT>::iterator it = gLineWrapCache.find( Key );
+	if ( it == gLineWrapCache.end() )
+	{
+		LINE_WRAP_RESULT Result;
+
+		// WrapString() writes into TempString, the key has its own copy
+		pWrappedString = WrapString( iFont, usLineWidthPixels, pusLineWidthIfWordIsWiderThenWidth, pString, TempString );
+		if ( pWrappedString == NULL )
+			return( NULL );
+
+		Result.usLineWidthPixels = *pusLineWidthIfWordIsWiderThenWidth;
+		for ( WRAPPED_STRING *pLine = pWrappedString; pLine != NULL; pLine = pLine->pNextWrappedString )
+			Result.Lines.push_back( pLine->sString );
+
+		gLineWrapCache[ Key ] = Result;
+		return( pWrappedString );
+	}
+
+	// hand out a new copy, the caller frees it
+	*pusLineWidthIfWordIsWiderThenWidth = it->second.usLineWidthPixels;
+
+	FirstWrappedString.pNextWrappedString = NULL;
+	pWrappedString = &FirstWrappedString;
+	for ( uiLine = 0; uiLine < it->second.Lines.size(); uiLine++ )
+	{
+		const std::wstring &Line = it->second.Lines[ uiLine ];
+
+		pWrappedString->pNextWrappedString = (WRAPPED_STRING *) MemAlloc( sizeof(WRAPPED_STRING) );
+		pWrappedString = pWrappedString->pNextWrappedString;
+		pWrappedString->sString = (STR16) MemAlloc( (Line.size() + 2) * sizeof(CHAR16) );
+		wcscpy( pWrappedString->sString, Line.c_str() );
+		pWrappedString->pNextWrappedString = NULL;
+	}
+
+	DebugMsg (TOPIC_JA2,DBG_LEVEL_3,String("LineWrap: done"));
+	return(FirstWrappedString.pNextWrappedString);
+}
+
 
 
 
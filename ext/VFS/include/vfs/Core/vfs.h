@@ -31,6 +31,7 @@
 #include <vfs/Core/vfs_vfile.h>
 
 #include <map>
+#include <unordered_map>
 
 namespace vfs
 {
@@ -39,6 +40,8 @@ namespace vfs
 	class VFS_API CVirtualFileSystem
 	{
 		typedef std::map<vfs::Path,CVirtualLocation*,vfs::Path::Less> tVFS;
+		// same locations, for lookups only (m_mapFS keeps the sorted order the iterators rely on)
+		typedef std::unordered_map<vfs::Path,CVirtualLocation*,vfs::Path::Hash,vfs::Path::Equal> tVFSIndex;
 
 		class CRegularIterator;
 		class CMatchingIterator;
@@ -76,6 +79,7 @@ namespace vfs
 	private:
 		vfs::CProfileStack		m_oProfileStack;
 		tVFS					m_mapFS;
+		tVFSIndex				m_indexFS;
 	private:
 		CVirtualFileSystem();
 		static CVirtualFileSystem* m_pSingleton;
@@ -28,6 +28,8 @@
 #include <vfs/vfs_config.h>
 #include <vfs/Core/vfs_types.h>
 
+#include <cstddef>
+
 namespace vfs
 {
 	class VFS_API Path
@@ -37,10 +39,15 @@ namespace vfs
 		public:
 			bool operator()(vfs::Path const& s1, vfs::Path const& s2) const;
 		};
-		class Equal{
+		class VFS_API Equal{
 		public:
 			bool operator()(vfs::Path const& s1, vfs::Path const& s2) const;
 		};
+		// case-insensitive, consistent with Less and Equal
+		class VFS_API Hash{
+		public:
+			std::size_t operator()(vfs::Path const& s) const;
+		};
 	public:
 		Path();
 		Path(const char* sPath);
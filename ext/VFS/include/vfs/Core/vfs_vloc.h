@@ -29,6 +29,7 @@
 #include <vfs/Core/Interface/vfs_iterator_interface.h>
 
 #include <map>
+#include <unordered_map>
 
 namespace vfs
 {
@@ -38,6 +39,7 @@ namespace vfs
 	{
 		class VFileIterator;
 		typedef std::map<vfs::Path, CVirtualFile*, vfs::Path::Less> tVFiles;
+		typedef std::unordered_map<vfs::Path, CVirtualFile*, vfs::Path::Hash, vfs::Path::Equal> tVFileIndex;
 	public:
 		typedef vfs::TIterator<CVirtualFile> Iterator;
 
@@ -61,6 +63,7 @@ namespace vfs
 
 		bool				m_exclusive;
 		tVFiles				m_VFiles;
+		tVFileIndex			m_VFileIndex;	// m_VFiles hashed, for lookups
 	};
 } // end namespace
 
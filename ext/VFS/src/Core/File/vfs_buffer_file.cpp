@@ -87,13 +87,18 @@ vfs::size_t vfs::CBufferFile::getSize()
 {
 	IS_FILE_VALID();
 
-	std::streampos size = 0;
-	if(!m_buffer.str().empty())
+	// ask the stream buffer directly, m_buffer.str() would copy the whole contents
+	// and seeking the stream itself fails (and sets the fail bit) while the buffer is empty
+	std::streambuf* buf = m_buffer.rdbuf();
+	std::streampos current_position = buf->pubseekoff(0, std::ios::cur, std::ios::in);
+	std::streampos size = buf->pubseekoff(0, std::ios::end, std::ios::in);
+	if(size < 0)
 	{
-		std::streampos current_position = m_buffer.tellg();
-		m_buffer.seekg(0,std::ios::end);
-		size = m_buffer.tellg();
-		m_buffer.seekg(current_position,std::ios::beg);
+		size = 0;
+	}
+	if(current_position >= 0)
+	{
+		buf->pubseekpos(current_position, std::ios::in);
 	}
 
 	IS_FILE_VALID();
@@ -184,10 +189,10 @@ vfs::size_t vfs::CBufferFile::write(const vfs::Byte* data, vfs::size_t bytesToWr
 	IS_FILE_VALID();
 	VFS_THROW_IFF( m_isOpen_write || this->openWrite(), ERROR_FILE(L"open error") );
 
-	std::streampos start = 0;
-	if(!m_buffer.str().empty())
+	std::streampos start = m_buffer.tellp();
+	if(start < 0)
 	{
-		start = m_buffer.tellp();
+		start = 0;
 	}
 	VFS_THROW_IFF( m_buffer.write(data, bytesToWrite), ERROR_FILE(L"write error") );
 	std::streampos bytesWritten = m_buffer.tellp() - start;
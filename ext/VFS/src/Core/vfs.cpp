@@ -368,6 +368,7 @@ vfs::CVirtualFileSystem::~CVirtualFileSystem()
 		delete it->second;
 	}
 	m_mapFS.clear();
+	m_indexFS.clear();
 }
 
 vfs::CProfileStack* vfs::CVirtualFileSystem::getProfileStack()
@@ -460,12 +461,7 @@ vfs::IBaseFile* vfs::CVirtualFileSystem::getFile(vfs::Path const& rLocalFilePath
 	vfs::Path sDir,sFile;
 	rLocalFilePath.splitLast(sDir,sFile);
 
-	tVFS::iterator it_loc = m_mapFS.find(sDir);
-	if(it_loc == m_mapFS.end())
-	{
-		return NULL;
-	}
-	vfs::CVirtualLocation* pVLoc = it_loc->second;
+	vfs::CVirtualLocation* pVLoc = this->getVirtualLocation(sDir);
 	if(pVLoc)
 	{
 		return pVLoc->getFile(sFile,sProfileName);
@@ -485,13 +481,14 @@ bool vfs::CVirtualFileSystem::fileExists(vfs::Path const& rLocalFilePath, vfs::C
 
 vfs::CVirtualLocation* vfs::CVirtualFileSystem::getVirtualLocation(vfs::Path const& sPath, bool bCreate)
 {
-	tVFS::iterator it = m_mapFS.find(sPath);
-	if(it == m_mapFS.end())
+	tVFSIndex::iterator it = m_indexFS.find(sPath);
+	if(it == m_indexFS.end())
 	{
 		if(bCreate)
 		{
 			vfs::CVirtualLocation* pVLoc = new vfs::CVirtualLocation(sPath);
 			m_mapFS.insert(std::make_pair(sPath,pVLoc));
+			m_indexFS.insert(std::make_pair(sPath,pVLoc));
 			return pVLoc;
 		}
 		return NULL;
@@ -29,6 +29,7 @@
 #include <vfs/Aspects/vfs_settings.h>
 
 #include <stack>
+#include <cctype>
 #include <vector>
 
 typedef struct{ vfs::String::size_t start, end; } t_env;
@@ -301,6 +302,19 @@ bool vfs::Path::Equal::operator ()(vfs::Path const& s1, vfs::Path const& s2) con
 {
 	return vfs::String::equal(s1._path.c_str(), s2._path.c_str());
 }
+std::size_t vfs::Path::Hash::operator ()(vfs::Path const& s) const
+{
+	// FNV-1a over the upper cased characters (vfs::String::equal compares with 'toupper' too)
+	std::size_t hash = 2166136261u;
+	const vfs::String::char_t* ptr = s._path.c_str();
+	while(*ptr != 0)
+	{
+		hash ^= (std::size_t)toupper(*ptr);
+		hash *= 16777619u;
+		ptr++;
+	}
+	return hash;
+}
 //////////////////////////////////////////////////////////////////////
 
 vfs::Path::Path()
@@ -84,6 +84,7 @@ vfs::CVirtualLocation::~CVirtualLocation()
 		it->second->destroy();
 	}
 	m_VFiles.clear();
+	m_VFileIndex.clear();
 }
 
 void vfs::CVirtualLocation::setIsExclusive(bool exclusive)
@@ -98,21 +99,22 @@ bool vfs::CVirtualLocation::getIsExclusive()
 void vfs::CVirtualLocation::addFile(vfs::IBaseFile* file, vfs::String const& profileName)
 {
 	vfs::CVirtualFile *pVFile = NULL;
-	tVFiles::iterator it = m_VFiles.find(file->getName());
-	if(it == m_VFiles.end())
+	tVFileIndex::iterator it = m_VFileIndex.find(file->getName());
+	if(it == m_VFileIndex.end())
 	{
 		vfs::Path fp = file->getPath();
 		vfs::CProfileStack& stack = *(getVFS()->getProfileStack());
 		pVFile = vfs::CVirtualFile::create(fp,stack);
-		it = m_VFiles.insert(m_VFiles.end(), std::pair<vfs::Path,vfs::CVirtualFile*>(file->getName(),pVFile));
+		m_VFiles.insert(m_VFiles.end(), std::pair<vfs::Path,vfs::CVirtualFile*>(file->getName(),pVFile));
+		it = m_VFileIndex.insert(std::pair<vfs::Path,vfs::CVirtualFile*>(file->getName(),pVFile)).first;
 	}
 	it->second->add(file,profileName,true);
 }
 
 vfs::IBaseFile* vfs::CVirtualLocation::getFile(vfs::Path const& filename, vfs::String const& profileName) const
 {
-	tVFiles::const_iterator cit = m_VFiles.find(filename);
-	if(cit != m_VFiles.end() && cit->second)
+	tVFileIndex::const_iterator cit = m_VFileIndex.find(filename);
+	if(cit != m_VFileIndex.end() && cit->second)
 	{
 		if(profileName.empty())
 		{
@@ -135,8 +137,8 @@ vfs::IBaseFile* vfs::CVirtualLocation::getFile(vfs::Path const& filename, vfs::S
 }
 vfs::CVirtualFile* vfs::CVirtualLocation::getVirtualFile(vfs::Path const& filename)
 {
-	tVFiles::const_iterator cit = m_VFiles.find(filename);
-	if(cit != m_VFiles.end())
+	tVFileIndex::const_iterator cit = m_VFileIndex.find(filename);
+	if(cit != m_VFileIndex.end())
 	{
 		return cit->second;
 	}
@@ -157,6 +159,7 @@ bool vfs::CVirtualLocation::removeFile(vfs::IBaseFile* file)
 				//CVirtualFile* vfile = it->second;
 				//delete vfile;
 				m_VFiles.erase(it);
+				m_VFileIndex.erase(sFile);
 			}
 			return true;
 		}
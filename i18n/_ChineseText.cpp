@@ -7184,6 +7184,7 @@ STR16 pMessageStrings[] =
 	L"%s抽了只%s。", //L"%s smoked %s.",
 	L"激活作弊？", //L"Activate cheats?",
 	L"关闭作弊？", //L"Deactivate cheats?",
+	L"自动存档已跳过，上一个仍在写入。", //L"Autosave skipped, the last one is still being written.",
 };
 
 
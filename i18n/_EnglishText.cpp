@@ -7183,6 +7183,7 @@ STR16 pMessageStrings[] =
 	L"%s smoked %s.",
 	L"Activate cheats?",
 	L"Deactivate cheats?",
+	L"Autosave skipped, the last one is still being written.",
 };
 
 
@@ -7053,6 +7053,7 @@ STR16 pMessageStrings[] =
 	L"%s hat %s geraucht.",
 	L"Cheats aktivieren?",
 	L"Cheats deaktivieren?",
+	L"Automatisches Speichern übersprungen, das letzte wird noch geschrieben.",
 };
 
 CHAR16 ItemPickupHelpPopup[][40] =
@@ -7180,6 +7180,7 @@ STR16 pMessageStrings[] =
 	L"%s курит %s.",
 	L"Активировать чит-коды?",
 	L"Деактивировать чит-коды?",
+	L"Автосохранение пропущено, предыдущее ещё записывается.",
 };
 
 
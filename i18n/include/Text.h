@@ -504,6 +504,8 @@ enum
 	MSG_PROMPT_CHEATS_ACTIVATE,
 	MSG_PROMPT_CHEATS_DEACTIVATE,
 
+	MSG_AUTOSAVE_SKIPPED,
+
 	TEXT_NUM_MSG,
 };
 extern STR16* pMessageStrings;
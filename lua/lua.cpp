@@ -2,6 +2,7 @@
 #include <string.h>
 #include <iostream>
 #include "Lua Interpreter.h"
+#include "lua_state.h"
 #include <windows.h>
 #include "MemMan.h"
 
@@ -233,4 +234,5 @@ void ShutdownLua( )
 	{
 		lua_close(L);
 	}
+	LuaScriptScope::CLOSE_ALL();
 }
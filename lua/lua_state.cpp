@@ -287,7 +287,255 @@ LuaState LuaState::GET(lua::State state_id)
 	return LuaStateManager::instance().GetState(state_id);
 }
 
+/************************************************************************************/
+
+#include <vfs/Core/vfs.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <chrono>
+
+// how often (in microseconds) a pooled script looks at its file to see if it has changed
+#define LUA_SCRIPT_CHECK_INTERVAL	1000000
+
+struct LuaScriptEntry
+{
+	LuaScriptEntry() : L(NULL), chunk(LUA_NOREF), globals(LUA_NOREF), bound(false), in_use(false),
+		file_size(0), file_time(0), last_check(0), calls(0), total_us(0), max_us(0)
+	{
+	}
+
+	lua_State*			L;
+	int					chunk;		// registry reference of the compiled script
+	int					globals;	// registry reference of the state's own globals (libraries, bindings, settings)
+	bool				bound;
+	bool				in_use;
+	long long			file_size;
+	long long			file_time;
+	unsigned long long	last_check;
+
+	std::string			filename;
+	std::string			hook;
+	unsigned int		calls;
+	unsigned long long	total_us;
+	unsigned long long	max_us;
+};
+
+typedef std::map<std::string, LuaScriptEntry> tLuaScripts;
+static tLuaScripts s_luaScripts;
+
+static unsigned long long LuaScriptClock()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// size and time of the file on disk, both 0 for files in libraries (which don't change while the game runs)
+static void GetLuaScriptStamp(const char* filename, long long& size, long long& time)
+{
+	size = time = 0;
+
+	vfs::IBaseFile* file = getVFS()->getFile(vfs::Path(filename));
+	vfs::Path path;
+	if(file && file->_getRealPath(path))
+	{
+		struct _stat64 st;
+		if(_wstat64(path.c_str(), &st) == 0)
+		{
+			size = st.st_size;
+			time = st.st_mtime;
+		}
+	}
+}
+
+// compiles the script and keeps the chunk in the registry, in place of the previous one
+static bool CompileLuaScript(LuaScriptEntry& entry)
+{
+	std::vector<vfs::Byte> buffer;
+	vfs::UInt32 size = 0;
+	try
+	{
+		vfs::COpenReadFile rfile(entry.filename.c_str());
+		size = rfile.file().getSize();
+		buffer.resize(size+1);
+		rfile.file().read(&buffer[0], size);
+		buffer[size] = 0;
+	}
+	catch(std::exception &ex)
+	{
+		SGP_ERROR(ex.what());
+		return false;
+	}
+
+	if(luaL_loadbuffer(entry.L, (char*)&buffer[0], size, entry.filename.c_str()))
+	{
+		const char *error = lua_tostring(entry.L, -1);
+		int len = strlen(error);
+		if (len >= 7 && !strcmp( error + len - 7, "'<eof>'"))
+		{
+			lua_pop(entry.L, 1);
+			return false;
+		}
+		std::string s = error;
+		lua_pop(entry.L, 1);
+		SGP_THROW(s);
+	}
+
+	if(entry.chunk != LUA_NOREF)
+	{
+		luaL_unref(entry.L, LUA_REGISTRYINDEX, entry.chunk);
+	}
+	entry.chunk = luaL_ref(entry.L, LUA_REGISTRYINDEX);
+	return true;
+}
+
+LuaScriptScope::LuaScriptScope(const char* filename, const char* hook)
+: _entry(NULL), _temporary(false), _bound(false), _filename(filename), _start(LuaScriptClock())
+{
+	std::string key = std::string(hook) + "|" + filename;
+	_entry = &s_luaScripts[key];
+	if(_entry->hook.empty())
+	{
+		_entry->hook = hook;
+		_entry->filename = filename;
+	}
+
+	if(_entry->in_use)
+	{
+		// the hook calls itself (through a binding), the running state can't be reused
+		_temporary = true;
+		L = LuaState::INIT(true);
+		return;
+	}
+	if(!_entry->L)
+	{
+		_entry->L = lua_open();
+		luaL_openlibs(_entry->L);
+		lua_pushvalue(_entry->L, LUA_GLOBALSINDEX);
+		_entry->globals = luaL_ref(_entry->L, LUA_REGISTRYINDEX);
+	}
+	_entry->in_use = true;
+	L = LuaState(_entry->L, false);
+}
 
+LuaScriptScope::~LuaScriptScope()
+{
+	unsigned long long us = LuaScriptClock() - _start;
+	_entry->calls++;
+	_entry->total_us += us;
+	_entry->max_us = std::max(_entry->max_us, us);
 
+	if(_temporary)
+	{
+		LuaState::CLOSE(L);
+	}
+	else
+	{
+		// back to the state's own globals, for the next call's bindings and settings
+		lua_rawgeti(_entry->L, LUA_REGISTRYINDEX, _entry->globals);
+		lua_replace(_entry->L, LUA_GLOBALSINDEX);
+		lua_settop(_entry->L, 0);
+		_entry->in_use = false;
+	}
+}
 
+bool LuaScriptScope::NeedsBindings()
+{
+	bool& bound = _temporary ? _bound : _entry->bound;
+	if(bound)
+	{
+		return false;
+	}
+	bound = true;
+	return true;
+}
 
+bool LuaScriptScope::EvalFile()
+{
+	if(_temporary)
+	{
+		return L.EvalFile(_filename);
+	}
+
+	unsigned long long now = LuaScriptClock();
+	if(_entry->chunk == LUA_NOREF || now - _entry->last_check >= LUA_SCRIPT_CHECK_INTERVAL)
+	{
+		long long size, time;
+		GetLuaScriptStamp(_filename, size, time);
+		_entry->last_check = now;
+
+		if(_entry->chunk == LUA_NOREF || size != _entry->file_size || time != _entry->file_time)
+		{
+			if(!CompileLuaScript(*_entry))
+			{
+				return false;
+			}
+			_entry->file_size = size;
+			_entry->file_time = time;
+		}
+	}
+
+	// The call gets a new globals table, which reads through to the state's own globals. Whatever the script
+	// sets, when it is run and in the functions called afterwards, ends up in there and not in the next call.
+	lua_newtable(_entry->L);
+	lua_newtable(_entry->L);
+	lua_rawgeti(_entry->L, LUA_REGISTRYINDEX, _entry->globals);
+	lua_setfield(_entry->L, -2, "__index");
+	lua_setmetatable(_entry->L, -2);
+	// the thread's globals, for LuaFunction and the bindings, and the chunk's environment, for the script
+	lua_pushvalue(_entry->L, -1);
+	lua_replace(_entry->L, LUA_GLOBALSINDEX);
+	lua_rawgeti(_entry->L, LUA_REGISTRYINDEX, _entry->chunk);
+	lua_insert(_entry->L, -2);
+	lua_setfenv(_entry->L, -2);
+	if(lua_pcall(_entry->L, 0, 0, 0))
+	{
+		std::string s = lua_tostring(_entry->L, -1);
+		lua_pop(_entry->L, 1);
+		SGP_THROW(s);
+	}
+	return true;
+}
+
+static bool LuaScriptMoreExpensive(const LuaScriptEntry* a, const LuaScriptEntry* b)
+{
+	return a->total_us > b->total_us;
+}
+
+void LuaScriptScope::ReportTimings(std::vector<std::wstring>& top, size_t num_top)
+{
+	std::vector<const LuaScriptEntry*> entries;
+	for(tLuaScripts::const_iterator it = s_luaScripts.begin(); it != s_luaScripts.end(); ++it)
+	{
+		if(it->second.calls)
+		{
+			entries.push_back(&it->second);
+		}
+	}
+	std::sort(entries.begin(), entries.end(), LuaScriptMoreExpensive);
+
+	SGP_INFO(L"Lua hook timings (calls, total ms, average us, max us):");
+	for(size_t i = 0; i < entries.size(); ++i)
+	{
+		const LuaScriptEntry& e = *entries[i];
+		std::wstringstream wss;
+		wss << vfs::String::as_utf16(e.hook) << L" (" << vfs::String::as_utf16(e.filename) << L"): "
+			<< e.calls << L", " << e.total_us / 1000 << L", " << e.total_us / e.calls << L", " << e.max_us;
+		SGP_INFO(wss.str().c_str());
+		if(i < num_top)
+		{
+			top.push_back(wss.str());
+		}
+	}
+}
+
+void LuaScriptScope::CLOSE_ALL()
+{
+	for(tLuaScripts::iterator it = s_luaScripts.begin(); it != s_luaScripts.end(); ++it)
+	{
+		if(it->second.L)
+		{
+			lua_close(it->second.L);
+		}
+	}
+	s_luaScripts.clear();
+}
@@ -3,6 +3,9 @@
 
 #include <Lua Interpreter.h>
 
+#include <string>
+#include <vector>
+
 namespace lua
 {
 	enum State
@@ -137,4 +140,52 @@ public:
 	}
 };
 
+struct LuaScriptEntry;
+
+/**
+ * Like LuaScopeState, but the lua state lives on in a pool, one per script and hook (the caller's name).
+ * The first time a hook runs, it gets a new state, registers its bindings (NeedsBindings() returns true once)
+ * and the script is compiled. From then on EvalFile() only runs the compiled chunk again. Bindings and everything
+ * set before EvalFile() go into the state's own globals, the script runs in a new globals table for each call that
+ * reads through to those, so nothing the script sets carries over to the next call. The script is compiled again
+ * when the file changes on disk. Per hook calls and times are counted for ReportTimings().
+ * If a hook runs again while it is already running, that call gets a state of its own, like LuaScopeState.
+ */
+class LuaScriptScope
+{
+public:
+	LuaState L;
+
+	LuaScriptScope(const char* filename, const char* hook);
+	~LuaScriptScope();
+
+	/**
+	 * true if the state is new and the caller has to register its C functions
+	 */
+	bool NeedsBindings();
+
+	/**
+	 * runs the script, compiling it first if necessary
+	 * @return false if the file doesn't exist or could not be read
+	 */
+	bool EvalFile();
+
+	/**
+	 * writes calls and times of all hooks to the log, most expensive first
+	 * @param top receives a line for each of the num_top most expensive hooks
+	 */
+	static void ReportTimings(std::vector<std::wstring>& top, size_t num_top);
+
+	/**
+	 * closes all pooled states
+	 */
+	static void CLOSE_ALL();
+private:
+	LuaScriptEntry*	_entry;
+	bool			_temporary;
+	bool			_bound;
+	const char*		_filename;
+	unsigned long long	_start;
+};
+
 #endif // _LUA_STATE_H_
@@ -157,3 +157,27 @@ void CompressFini( PTR pCompPtr )
 	deflateEnd( pZStream );
 	MemFree( pZStream );
 }
+
+UINT32 CompressBuffer( BYTE * pDest, UINT32 uiDestLen, const BYTE * pSrc, UINT32 uiSrcLen, INT32 iLevel )
+{
+	uLongf	ulDestLen = uiDestLen;
+
+	if( compress2( pDest, &ulDestLen, pSrc, uiSrcLen, iLevel ) != Z_OK )
+	{ // out of memory or the output doesn't fit
+		return( 0 );
+	}
+
+	return( (UINT32)ulDestLen );
+}
+
+BOOLEAN DecompressBuffer( BYTE * pDest, UINT32 uiDestLen, const BYTE * pSrc, UINT32 uiSrcLen )
+{
+	uLongf	ulDestLen = uiDestLen;
+
+	if( uncompress( pDest, &ulDestLen, pSrc, uiSrcLen ) != Z_OK )
+	{
+		return( FALSE );
+	}
+
+	return( ulDestLen == uiDestLen );
+}
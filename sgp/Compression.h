@@ -49,4 +49,12 @@ PTR CompressInit( BYTE * pUncompressedData, UINT32 uiDataSize );
 UINT32 Compress( PTR pCompPtr, BYTE * pBuffer, UINT32 uiBufferLen );
 void CompressFini( PTR pCompPtr );
 
+// One call versions for data that fits into memory as a whole. They use zlib's own allocator instead of
+// MemAlloc, so they may be called from any thread.
+// CompressBuffer() returns the number of bytes of output, 0 if it doesn't fit into uiDestLen.
+// DecompressBuffer() returns TRUE if the data decompressed to exactly uiDestLen bytes.
+
+UINT32 CompressBuffer( BYTE * pDest, UINT32 uiDestLen, const BYTE * pSrc, UINT32 uiSrcLen, INT32 iLevel );
+BOOLEAN DecompressBuffer( BYTE * pDest, UINT32 uiDestLen, const BYTE * pSrc, UINT32 uiSrcLen );
+
 #endif
@@ -46,6 +46,7 @@ using namespace std;
 
 
 #include <vfs/Core/vfs_file_raii.h>
+#include <vfs/Core/File/vfs_buffer_file.h>
 #include <vfs/Tools/vfs_parser_tools.h>
 #include <map>
 
@@ -56,7 +57,8 @@ struct SOperation
 		UNKNOWN, READ, WRITE,
 	};
 	EOperation op;
-	SOperation() : op(UNKNOWN) {};
+	bool memory;	// opened with FileOpenMemory(), deleted on close
+	SOperation() : op(UNKNOWN), memory(false) {};
 };
 
 typedef std::map<vfs::IBaseFile*, SOperation> tFILEMAP;
@@ -352,9 +354,239 @@ void FileClose( HWFILE hFile )
 	vfs::IBaseFile *pFile = (vfs::IBaseFile*)hFile;
 	if(pFile)
 	{
+		bool fMemory = s_mapFiles[pFile].memory;
+
 		pFile->close();
 		s_mapFiles.erase(pFile);
+
+		if(fMemory)
+		{
+			delete pFile;
+		}
+	}
+}
+
+//**************************************************************************
+//
+// FileOpenMemory
+//
+//		Opens a file that only lives in memory. It can be written with
+//		FileWrite, FileSeek etc. like a file opened with FILE_ACCESS_WRITE,
+//		and its contents are fetched with FileGetMemoryContents. The data is
+//		gone once the file is closed.
+//
+// Return Value :
+//
+//		HWFILE	->handle of opened file
+//
+//**************************************************************************
+HWFILE FileOpenMemory( void )
+{
+	vfs::CBufferFile *pFile = new vfs::CBufferFile();
+	if(!pFile->openWrite(true, true))
+	{
+		delete pFile;
+		return 0;
+	}
+	s_mapFiles[pFile].op = SOperation::WRITE;
+	s_mapFiles[pFile].memory = true;
+	return (HWFILE)pFile;
+}
+
+//**************************************************************************
+//
+// FileOpenMemoryRead
+//
+//		Opens a memory file holding a copy of uiSize bytes from pData, to be
+//		read with FileRead, FileSeek etc. like a file opened with
+//		FILE_ACCESS_READ.
+//
+// Return Value :
+//
+//		HWFILE	->handle of opened file
+//
+//**************************************************************************
+HWFILE FileOpenMemoryRead( PTR pData, UINT32 uiSize )
+{
+	vfs::CBufferFile *pFile = new vfs::CBufferFile();
+	try
+	{
+		if(!pFile->openWrite(true, true) || pFile->write((vfs::Byte*)pData, uiSize) != uiSize)
+		{
+			delete pFile;
+			return 0;
+		}
+		pFile->setReadPosition(0);
+	}
+	catch(vfs::Exception& ex)
+	{
+		SGP_ERROR(ex.what());
+		delete pFile;
+		return 0;
+	}
+	s_mapFiles[pFile].op = SOperation::READ;
+	s_mapFiles[pFile].memory = true;
+	return (HWFILE)pFile;
+}
+
+//**************************************************************************
+//
+// FileGetMemoryContents
+//
+//		Copies the first uiBytesToRead bytes of a memory file to pDest.
+//		Use FileGetSize to find out how much was written.
+//
+//**************************************************************************
+BOOLEAN FileGetMemoryContents( HWFILE hFile, PTR pDest, UINT32 uiBytesToRead )
+{
+	vfs::IBaseFile *pFile = (vfs::IBaseFile*)hFile;
+	if(!pFile || !s_mapFiles[pFile].memory || uiBytesToRead > pFile->getSize())
+	{
+		return FALSE;
+	}
+
+	vfs::CBufferFile *pBuffer = static_cast<vfs::CBufferFile*>(pFile);
+	try
+	{
+		pBuffer->setReadPosition(0);
+		return pBuffer->read((vfs::Byte*)pDest, uiBytesToRead) == uiBytesToRead;
+	}
+	catch(vfs::Exception& ex)
+	{
+		SGP_ERROR(ex.what());
+	}
+	return FALSE;
+}
+
+//**************************************************************************
+//
+// FileGetDiskPath
+//
+//		Gets the path of the real file behind an open file, for
+//		FileReplaceOnDisk. Fails for memory files and files in libraries.
+//
+//**************************************************************************
+BOOLEAN FileGetDiskPath( HWFILE hFile, STR16 pzPath, UINT32 uiMaxLength )
+{
+	vfs::IBaseFile *pFile = (vfs::IBaseFile*)hFile;
+	vfs::Path path;
+	if(!pFile || s_mapFiles[pFile].memory || !pFile->_getRealPath(path) || path.length() >= uiMaxLength)
+	{
+		return FALSE;
+	}
+	wcscpy(pzPath, path.c_str());
+	return TRUE;
+}
+
+//**************************************************************************
+//
+// FileGetWriteDiskPath
+//
+//		Gets the path on disk that FileOpen would write strFilename to,
+//		without opening the file. A file that doesn't exist yet is only
+//		entered into the file system (in the writable profile, like
+//		FileOpen does), nothing is created on disk, that is left to
+//		FileReplaceOnDisk.
+//
+//**************************************************************************
+BOOLEAN FileGetWriteDiskPath( STR strFilename, STR16 pzPath, UINT32 uiMaxLength )
+{
+	vfs::Path path(strFilename);
+	vfs::Path realPath;
+	try
+	{
+		vfs::IBaseFile *pFile = getVFS()->getFile(path, vfs::CVirtualFile::SF_STOP_ON_WRITABLE_PROFILE);
+		if(!pFile && getVFS()->createNewFile(path))
+		{
+			pFile = getVFS()->getFile(path, vfs::CVirtualFile::SF_STOP_ON_WRITABLE_PROFILE);
+		}
+		if(!pFile || !vfs::tWritableFile::cast(pFile) || !pFile->_getRealPath(realPath) || realPath.length() >= uiMaxLength)
+		{
+			return FALSE;
+		}
+	}
+	catch(vfs::Exception& ex)
+	{
+		SGP_ERROR(ex.what());
+		return FALSE;
+	}
+	wcscpy(pzPath, realPath.c_str());
+	return TRUE;
+}
+
+//**************************************************************************
+//
+// FileReplaceOnDisk
+//
+//		Writes pData to a temp file next to the disk file pzPath, then
+//		moves it over pzPath in one step, so pzPath always holds either the
+//		old or the complete new contents. Doesn't touch the file manager or
+//		the VFS, so it may be called from any thread.
+//
+//**************************************************************************
+BOOLEAN FileReplaceOnDisk( const CHAR16 *pzPath, const void *pData, UINT32 uiSize )
+{
+	CHAR16 zTempPath[MAX_PATH + 8];
+	if(wcslen(pzPath) >= MAX_PATH)
+	{
+		return FALSE;
+	}
+	wcscpy(zTempPath, pzPath);
+	wcscat(zTempPath, L".tmp");
+
+	HANDLE hFile = CreateFileW(zTempPath, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(hFile == INVALID_HANDLE_VALUE)
+	{
+		return FALSE;
+	}
+
+	DWORD dwBytesWritten = 0;
+	BOOL fOk = WriteFile(hFile, pData, uiSize, &dwBytesWritten, NULL) && dwBytesWritten == uiSize && FlushFileBuffers(hFile);
+	CloseHandle(hFile);
+
+	if(fOk)
+	{
+		fOk = MoveFileExW(zTempPath, pzPath, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+	}
+	if(!fOk)
+	{
+		DeleteFileW(zTempPath);
+	}
+	return fOk ? TRUE : FALSE;
+}
+
+//**************************************************************************
+//
+// FileReadFromDisk
+//
+//		Reads all of the disk file pzPath (see FileGetDiskPath) into data.
+//		Doesn't touch the file manager or the VFS, so it may be called from
+//		any thread.
+//
+//**************************************************************************
+BOOLEAN FileReadFromDisk( const CHAR16 *pzPath, std::vector<BYTE>& data )
+{
+	HANDLE hFile = CreateFileW(pzPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if(hFile == INVALID_HANDLE_VALUE)
+	{
+		return FALSE;
+	}
+
+	LARGE_INTEGER liSize;
+	BOOL fOk = GetFileSizeEx(hFile, &liSize) && liSize.HighPart == 0;
+	if(fOk)
+	{
+		DWORD dwBytesRead = 0;
+		data.resize(liSize.LowPart);
+		fOk = data.empty() || (ReadFile(hFile, &data[0], liSize.LowPart, &dwBytesRead, NULL) && dwBytesRead == liSize.LowPart);
+	}
+	CloseHandle(hFile);
+
+	if(!fOk)
+	{
+		data.clear();
 	}
+	return fOk ? TRUE : FALSE;
 }
 
 //**************************************************************************
@@ -21,6 +21,7 @@
 
 #include "types.h"
 #include "windows.h"
+#include <vector>
 
 
 
@@ -88,6 +89,20 @@ extern HWFILE	FileOpen( STR strFilename, UINT32 uiOptions, BOOLEAN fDeleteOnClos
 
 extern void		FileClose( HWFILE );
 
+// files that are only kept in memory, for data that is built up piece by piece and then written in one go
+extern HWFILE	FileOpenMemory( void );
+extern HWFILE	FileOpenMemoryRead( PTR pData, UINT32 uiSize );
+extern BOOLEAN	FileGetMemoryContents( HWFILE hFile, PTR pDest, UINT32 uiBytesToRead );
+
+// for writing files from other threads, which must not use the file manager: look up where the file is on disk
+// first, then FileReplaceOnDisk() can write it from anywhere
+extern BOOLEAN	FileGetDiskPath( HWFILE hFile, STR16 pzPath, UINT32 uiMaxLength );
+// the same for a file to be written, which needn't exist yet and isn't opened
+extern BOOLEAN	FileGetWriteDiskPath( STR strFilename, STR16 pzPath, UINT32 uiMaxLength );
+extern BOOLEAN	FileReplaceOnDisk( const CHAR16 *pzPath, const void *pData, UINT32 uiSize );
+// and the other way round, reads all of a disk file from any thread
+extern BOOLEAN	FileReadFromDisk( const CHAR16 *pzPath, std::vector<BYTE>& data );
+
 extern BOOLEAN	FileRead( HWFILE hFile, PTR pDest, UINT32 uiBytesToRead, UINT32 *puiBytesRead );
 extern BOOLEAN	FileReadLine( HWFILE hFile, std::string* pDest );
 extern BOOLEAN	FileWrite( HWFILE hFile, const void* pDest, UINT32 uiBytesToWrite, UINT32 *puiBytesWritten );
@@ -2,6 +2,7 @@
 	#include "types.h"
 	#include <stdio.h>
 	#include <stdarg.h>
+	#include <limits.h>
 	#include <malloc.h>
 	#include <windows.h>
 	#include <stdarg.h>
@@ -20,6 +21,10 @@
 	#include "vobject_blitters.h"
 
 	#include <sstream>
+	#include <list>
+	#include <string>
+	#include <unordered_map>
+	#include <vector>
 //*******************************************************
 //
 //	Defines
@@ -81,6 +86,330 @@ UINT16		SaveFontBackground16=0;
 UINT8			SaveFontForeground8=0;
 UINT8			SaveFontBackground8=0;
 
+//*******************************************************
+//
+//	Glyph lookup and glyph run cache
+//
+//*******************************************************
+
+// Font cell of every character, built from the translation table so GetIndex() doesn't have to search it.
+// -1 for the characters that aren't in the table.
+static INT16		gsGlyphIndex[ 0x10000 ];
+static BOOLEAN		gfGlyphIndexBuilt = FALSE;
+
+// The strings printed by mprintf(), gprintf(), gprintfDirty() and mprintf_buffer() are kept as runs: the pixels
+// the glyphs of the string write, rendered once by the same blitters, and the spans of each row they cover. When a
+// string is printed again with the same font and colours, its run is copied span by span instead of blitting it
+// glyph by glyph. The font blitters never read the destination, so the result is the same. A run is only made
+// the second time a string is seen, strings that are printed once (changing numbers and such) only cost a lookup.
+#define FONT_RUN_CACHE_BYTES	( 2 * 1024 * 1024 )
+#define FONT_RUN_MAX_PIXELS		( 64 * 1024 )
+
+enum
+{
+	FONT_RUN_MONO,		// Blt8BPPDataTo16BPPBufferMonoShadowClip() with the font colours
+	FONT_RUN_SHADED,	// Blt8BPPDataTo16BPPBufferTransparentClip() with the current shade table of the font
+};
+
+typedef struct
+{
+	UINT16	usRow;
+	UINT16	usStart;
+	UINT16	usLength;
+} FONT_RUN_SPAN;
+
+typedef struct
+{
+	std::wstring				Key;
+	UINT32						uiBytes;
+	BOOLEAN						fRendered;
+	BOOLEAN						fDirect;		// too big to keep, always printed glyph by glyph
+	INT16						sOffsetX;		// of the top left pixel, from the print position
+	INT16						sOffsetY;
+	UINT16						usWidth;
+	UINT16						usHeight;
+	std::vector<UINT16>			usPixels;
+	std::vector<FONT_RUN_SPAN>	Spans;			// sorted by row
+} FONT_GLYPH_RUN;
+
+typedef std::list<FONT_GLYPH_RUN> FONT_RUN_LIST;
+
+static FONT_RUN_LIST	gFontRuns;			// most recently printed first
+static std::unordered_map<std::wstring, FONT_RUN_LIST::iterator> gFontRunIndex;
+static UINT32			guiFontRunBytes = 0;
+
+UINT32	guiFontCacheGeneration = 0;
+
+//*****************************************************************************
+// FlushFontCaches
+//
+//	Forgets the glyph runs and the glyph indices. Has to be called whenever a
+// font, a font palette or the translation table changes. Caches elsewhere that
+// depend on the fonts (the line wrap cache) check guiFontCacheGeneration.
+//
+//*****************************************************************************
+void FlushFontCaches( void )
+{
+	gFontRuns.clear();
+	gFontRunIndex.clear();
+	guiFontRunBytes = 0;
+	gfGlyphIndexBuilt = FALSE;
+	guiFontCacheGeneration++;
+}
+
+static void BuildGlyphIndex( void )
+{
+	FontTranslationTable	*pTable = pFManager->pTranslationTable;
+	UINT16					usCount;
+
+	memset( gsGlyphIndex, 0xff, sizeof( gsGlyphIndex ) );
+
+	// backwards, so a character that is in the table twice gets the first of its cells, like the search did
+	for ( usCount = pTable->usNumberOfSymbols; usCount > 0; usCount-- )
+	{
+		gsGlyphIndex[ pTable->DynamicArrayOf16BitValues[ usCount - 1 ] ] = (INT16)( usCount - 1 );
+	}
+
+	gfGlyphIndexBuilt = TRUE;
+}
+
+static void BltGlyph( UINT16 *pBuffer, UINT32 uiPitchBYTES, INT32 iX, INT32 iY, UINT16 usIndex, SGPRect *pClip, UINT8 ubKind )
+{
+	if ( ubKind == FONT_RUN_MONO )
+		Blt8BPPDataTo16BPPBufferMonoShadowClip( pBuffer, uiPitchBYTES, FontObjs[FontDefault], iX, iY, usIndex, pClip, FontForeground16, FontBackground16, FontShadow16 );
+	else
+		Blt8BPPDataTo16BPPBufferTransparentClip( pBuffer, uiPitchBYTES, FontObjs[FontDefault], iX, iY, usIndex, pClip );
+}
+
+static void MakeGlyphRunKey( std::wstring &Key, const CHAR16 *pString, UINT8 ubKind )
+{
+	Key.clear();
+	Key.push_back( (wchar_t)ubKind );
+	Key.push_back( (wchar_t)FontDefault );
+
+	if ( ubKind == FONT_RUN_MONO )
+	{
+		Key.push_back( (wchar_t)FontForeground16 );
+		Key.push_back( (wchar_t)FontBackground16 );
+		Key.push_back( (wchar_t)FontShadow16 );
+	}
+	else
+	{
+		UINT64 uiShade = (UINT64)(size_t)FontObjs[FontDefault]->pShadeCurrent;
+
+		Key.push_back( (wchar_t)( uiShade & 0xffff ) );
+		Key.push_back( (wchar_t)( ( uiShade >> 16 ) & 0xffff ) );
+		Key.push_back( (wchar_t)( ( uiShade >> 32 ) & 0xffff ) );
+		Key.push_back( (wchar_t)( ( uiShade >> 48 ) & 0xffff ) );
+	}
+
+	Key.append( pString );
+}
+
+static void RenderGlyphRun( FONT_GLYPH_RUN *pRun, const CHAR16 *pString, UINT8 ubKind )
+{
+	HVOBJECT			hFont = FontObjs[FontDefault];
+	ETRLEObject			*pTrav;
+	const CHAR16		*pCur;
+	std::vector<UINT16>	usWhite;
+	SGPRect				Clip;
+	FONT_RUN_SPAN		Span;
+	INT32				iX, iLeft, iTop, iRight, iBottom, iCol, iRow;
+	UINT32				uiPixels, uiPos;
+	UINT16				usIndex;
+
+	pRun->fRendered = TRUE;
+	pRun->usWidth = pRun->usHeight = 0;
+
+	// the box the glyphs cover
+	iX = 0;
+	iLeft = iTop = INT_MAX;
+	iRight = iBottom = INT_MIN;
+	for ( pCur = pString; *pCur != 0; pCur++ )
+	{
+		pTrav = &hFont->pETRLEObject[ GetIndex( *pCur ) ];
+		if ( pTrav->usWidth != 0 && pTrav->usHeight != 0 )
+		{
+			iLeft = __min( iLeft, iX + pTrav->sOffsetX );
+			iRight = __max( iRight, iX + pTrav->sOffsetX + (INT32)pTrav->usWidth );
+			iTop = __min( iTop, (INT32)pTrav->sOffsetY );
+			iBottom = __max( iBottom, pTrav->sOffsetY + (INT32)pTrav->usHeight );
+		}
+		iX += pTrav->usWidth + pTrav->sOffsetX;
+	}
+
+	// nothing to draw
+	if ( iLeft >= iRight )
+		return;
+
+	if ( ( iRight - iLeft ) * ( iBottom - iTop ) > FONT_RUN_MAX_PIXELS )
+	{
+		pRun->fDirect = TRUE;
+		return;
+	}
+
+	pRun->sOffsetX = (INT16)iLeft;
+	pRun->sOffsetY = (INT16)iTop;
+	pRun->usWidth = (UINT16)( iRight - iLeft );
+	pRun->usHeight = (UINT16)( iBottom - iTop );
+
+	// Print the string onto a black and onto a white buffer. The pixels that come out the same in both are the
+	// ones the glyphs write.
+	uiPixels = pRun->usWidth * pRun->usHeight;
+	pRun->usPixels.assign( uiPixels, 0 );
+	usWhite.assign( uiPixels, 0xffff );
+
+	Clip.iLeft = 0;
+	Clip.iTop = 0;
+	Clip.iRight = pRun->usWidth;
+	Clip.iBottom = pRun->usHeight;
+
+	iX = -iLeft;
+	for ( pCur = pString; *pCur != 0; pCur++ )
+	{
+		usIndex = GetIndex( *pCur );
+		BltGlyph( &pRun->usPixels[0], pRun->usWidth * 2, iX, -iTop, usIndex, &Clip, ubKind );
+		BltGlyph( &usWhite[0], pRun->usWidth * 2, iX, -iTop, usIndex, &Clip, ubKind );
+		iX += GetWidth( hFont, usIndex );
+	}
+
+	for ( iRow = 0; iRow < pRun->usHeight; iRow++ )
+	{
+		uiPos = iRow * pRun->usWidth;
+		for ( iCol = 0; iCol < pRun->usWidth; )
+		{
+			if ( pRun->usPixels[ uiPos + iCol ] != usWhite[ uiPos + iCol ] )
+			{
+				iCol++;
+				continue;
+			}
+
+			Span.usRow = (UINT16)iRow;
+			Span.usStart = (UINT16)iCol;
+			while ( iCol < pRun->usWidth && pRun->usPixels[ uiPos + iCol ] == usWhite[ uiPos + iCol ] )
+				iCol++;
+			Span.usLength = (UINT16)( iCol - Span.usStart );
+			pRun->Spans.push_back( Span );
+		}
+	}
+
+	pRun->uiBytes += uiPixels * sizeof( UINT16 ) + (UINT32)pRun->Spans.size() * sizeof( FONT_RUN_SPAN );
+}
+
+static void DrawGlyphRun( const FONT_GLYPH_RUN *pRun, UINT16 *pDestBuf, UINT32 uiDestPitchBYTES, INT32 x, INT32 y )
+{
+	const FONT_RUN_SPAN	*pSpan;
+	size_t				uiCount;
+	INT32				iLeft, iTop, iY, iStart, iEnd;
+
+	iLeft = x + pRun->sOffsetX;
+	iTop = y + pRun->sOffsetY;
+
+	for ( uiCount = 0; uiCount < pRun->Spans.size(); uiCount++ )
+	{
+		pSpan = &pRun->Spans[ uiCount ];
+
+		iY = iTop + pSpan->usRow;
+		if ( iY < FontDestRegion.iTop )
+			continue;
+		if ( iY >= FontDestRegion.iBottom )
+			break;
+
+		iStart = __max( iLeft + pSpan->usStart, FontDestRegion.iLeft );
+		iEnd = __min( iLeft + pSpan->usStart + pSpan->usLength, FontDestRegion.iRight );
+		if ( iStart < iEnd )
+		{
+			memcpy( (UINT8 *)pDestBuf + iY * uiDestPitchBYTES + iStart * sizeof( UINT16 ),
+					&pRun->usPixels[ pSpan->usRow * pRun->usWidth + ( iStart - iLeft ) ],
+					( iEnd - iStart ) * sizeof( UINT16 ) );
+		}
+	}
+}
+
+// The run of a string in the current font and colours, NULL the first time the string is seen
+static FONT_GLYPH_RUN *FindGlyphRun( const CHAR16 *pString, UINT8 ubKind )
+{
+	static std::wstring	Key;
+	FONT_GLYPH_RUN		*pRun;
+
+	MakeGlyphRunKey( Key, pString, ubKind );
+
+	std::unordered_map<std::wstring, FONT_RUN_LIST::iterator>::iterator it = gFontRunIndex.find( Key );
+	if ( it == gFontRunIndex.end() )
+	{
+		gFontRuns.push_front( FONT_GLYPH_RUN() );
+		pRun = &gFontRuns.front();
+		pRun->Key = Key;
+		pRun->uiBytes = sizeof( FONT_GLYPH_RUN ) + (UINT32)Key.size() * 2 * sizeof( wchar_t );
+		pRun->fRendered = FALSE;
+		pRun->fDirect = FALSE;
+		gFontRunIndex[ Key ] = gFontRuns.begin();
+		guiFontRunBytes += pRun->uiBytes;
+		pRun = NULL;
+	}
+	else
+	{
+		gFontRuns.splice( gFontRuns.begin(), gFontRuns, it->second );
+		pRun = &gFontRuns.front();
+		if ( !pRun->fRendered )
+		{
+			guiFontRunBytes -= pRun->uiBytes;
+			RenderGlyphRun( pRun, pString, ubKind );
+			guiFontRunBytes += pRun->uiBytes;
+		}
+	}
+
+	// make room, but never drop the run just found
+	while ( guiFontRunBytes > FONT_RUN_CACHE_BYTES && gFontRuns.size() > 1 )
+	{
+		guiFontRunBytes -= gFontRuns.back().uiBytes;
+		gFontRunIndex.erase( gFontRuns.back().Key );
+		gFontRuns.pop_back();
+	}
+
+	return( pRun );
+}
+
+UINT32 GetHeight(HVOBJECT hSrcVObject, INT16 ssIndex);
+
+// Prints a string with the current font, from its glyph run if it has one. The destination buffer must be locked.
+static void PrintGlyphString( UINT16 *pDestBuf, UINT32 uiDestPitchBYTES, INT32 x, INT32 y, const CHAR16 *pString, UINT8 ubKind )
+{
+	FONT_GLYPH_RUN	*pRun = NULL;
+	const CHAR16	*curletter;
+	INT32			destx, desty;
+	UINT16			transletter;
+
+	// runs don't wrap
+	if ( !FontDestWrap && *pString != 0 )
+		pRun = FindGlyphRun( pString, ubKind );
+
+	if ( pRun != NULL && !pRun->fDirect )
+	{
+		DrawGlyphRun( pRun, pDestBuf, uiDestPitchBYTES, x, y );
+		return;
+	}
+
+	curletter=pString;
+
+	destx=x;
+	desty=y;
+
+	while((*curletter)!=0)
+	{
+		transletter=GetIndex(*curletter++);
+
+		if(FontDestWrap && BltIsClipped(FontObjs[FontDefault], destx, desty, transletter, &FontDestRegion))
+		{
+			destx=x;
+			desty+=GetHeight(FontObjs[FontDefault], transletter);
+		}
+
+		BltGlyph( pDestBuf, uiDestPitchBYTES, destx, desty, transletter, &FontDestRegion, ubKind );
+		destx+=GetWidth(FontObjs[FontDefault], transletter);
+	}
+}
+
 //*****************************************************************************
 // SetFontColors
 //
@@ -297,6 +626,8 @@ UINT16 *SetFontObjectPalette8BPP(INT32 iFont, SGPPaletteEntry *pPal8)
 	FontObjs[iFont]->p16BPPPalette=pPal16;
 	FontObjs[iFont]->pShadeCurrent=pPal16;
 
+	FlushFontCaches();
+
 	return(pPal16);
 }
 
@@ -313,6 +644,8 @@ UINT16 *SetFontObjectPalette16BPP(INT32 iFont, UINT16 *pPal16)
 	FontObjs[iFont]->p16BPPPalette=pPal16;
 	FontObjs[iFont]->pShadeCurrent=pPal16;
 
+	FlushFontCaches();
+
 	return(pPal16);
 
 }
@@ -410,6 +743,8 @@ UINT32					LoadIndex;
 	if(FontDefault==(-1))
 		FontDefault=LoadIndex;
 
+	FlushFontCaches();
+
 	return(LoadIndex);
 }
 
@@ -426,6 +761,8 @@ void UnloadFont(UINT32 FontIndex)
 
 	DeleteVideoObject(FontObjs[FontIndex]);
 	FontObjs[FontIndex]=NULL;
+
+	FlushFontCaches();
 }
 
 //*****************************************************************************
@@ -738,24 +1075,14 @@ UINT16 GetFontHeight(INT32 FontNum)
 //*****************************************************************************
 INT16 GetIndex(CHAR16 siChar)
 {
-	UINT16 *pTrav;
-	UINT16 ssCount=0;
-	UINT16	usNumberOfSymbols = pFManager->pTranslationTable->usNumberOfSymbols;
+	INT16 ssIndex;
 
-//inshy: We don't need anymore ANSI convertation to UNICODE.
-//siChar = GetUnicodeChar(siChar);
+	if ( !gfGlyphIndexBuilt )
+		BuildGlyphIndex();
 
-	// search the Translation Table and return the index for the font
-	pTrav = pFManager->pTranslationTable->DynamicArrayOf16BitValues;
-	while (ssCount < usNumberOfSymbols )
-	{
-		if (siChar == *pTrav)
-		{
-		return ssCount;
-	}
-		ssCount++;
-		pTrav++;
-	}
+	ssIndex = gsGlyphIndex[ (UINT16)siChar ];
+	if ( ssIndex >= 0 )
+		return ssIndex;
 
 	// If here, present warning and give the first index
 	DbgMessage(TOPIC_FONT_HANDLER, DBG_LEVEL_0, String("Error: Invalid character given %d", siChar));
@@ -816,8 +1143,6 @@ BOOLEAN SetFontDestBuffer(UINT32 DestBuffer, INT32 x1, INT32 y1, INT32 x2, INT32
 //*****************************************************************************
 UINT32 mprintf(INT32 x, INT32 y, const CHAR16* pFontString, ...)
 {
-INT32		destx, desty;
-CHAR16	*curletter, transletter;
 va_list argptr;
 CHAR16	string[512];
 UINT32			uiDestPitchBYTES;
@@ -837,27 +1162,10 @@ UINT8				*pDestBuf;
 		    }
     }
 
-	curletter=string;
-
-	destx=x;
-	desty=y;
-
 	// Lock the dest buffer
 	pDestBuf = LockVideoSurface( FontDestBuffer, &uiDestPitchBYTES );
 
-	while((*curletter)!=0)
-	{
-		transletter=GetIndex(*curletter++);
-
-		if(FontDestWrap && BltIsClipped(FontObjs[FontDefault], destx, desty, transletter, &FontDestRegion))
-		{
-			destx=x;
-			desty+=GetHeight(FontObjs[FontDefault], transletter);
-		}
-
-		Blt8BPPDataTo16BPPBufferMonoShadowClip((UINT16*)pDestBuf, uiDestPitchBYTES, FontObjs[FontDefault], destx, desty, transletter, &FontDestRegion, FontForeground16, FontBackground16, FontShadow16 );
-		destx+=GetWidth(FontObjs[FontDefault], transletter);
-	}
+	PrintGlyphString( (UINT16*)pDestBuf, uiDestPitchBYTES, x, y, string, FONT_RUN_MONO );
 
 	// Unlock buffer
 	UnLockVideoSurface( FontDestBuffer );
@@ -923,8 +1231,6 @@ void FindFontCenterCoordinates( INT16 sLeft, INT16 sTop, INT16 sWidth, INT16 sHe
 //*****************************************************************************
 UINT32 gprintf(INT32 x, INT32 y, const STR16 pFontString, ...)
 {
-INT32		destx, desty;
-CHAR16	*curletter, transletter;
 va_list argptr;
 CHAR16	string[512];
 UINT32			uiDestPitchBYTES;
@@ -943,27 +1249,10 @@ UINT8				*pDestBuf;
 		     return(0);
 		    }
     }
-	curletter=string;
-
-	destx=x;
-	desty=y;
-
 	// Lock the dest buffer
 	pDestBuf = LockVideoSurface( FontDestBuffer, &uiDestPitchBYTES );
 
-	while((*curletter)!=0)
-	{
-		transletter=GetIndex(*curletter++);
-
-		if(FontDestWrap && BltIsClipped(FontObjs[FontDefault], destx, desty, transletter, &FontDestRegion))
-		{
-			destx=x;
-			desty+=GetHeight(FontObjs[FontDefault], transletter);
-		}
-
-		Blt8BPPDataTo16BPPBufferTransparentClip( (UINT16*)pDestBuf, uiDestPitchBYTES, FontObjs[FontDefault], destx, desty, transletter, &FontDestRegion );
-		destx+=GetWidth(FontObjs[FontDefault], transletter);
-	}
+	PrintGlyphString( (UINT16*)pDestBuf, uiDestPitchBYTES, x, y, string, FONT_RUN_SHADED );
 
 	// Unlock buffer
 	UnLockVideoSurface( FontDestBuffer );
@@ -973,8 +1262,6 @@ UINT8				*pDestBuf;
 
 UINT32 gprintfDirty(INT32 x, INT32 y, const STR16 pFontString, ...)
 {
-INT32		destx, desty;
-CHAR16	*curletter, transletter;
 va_list argptr;
 CHAR16	string[512];
 UINT32			uiDestPitchBYTES;
@@ -993,27 +1280,10 @@ UINT8				*pDestBuf;
 		     return(0);
 		    }
     }
-	curletter=string;
-
-	destx=x;
-	desty=y;
-
 	// Lock the dest buffer
 	pDestBuf = LockVideoSurface( FontDestBuffer, &uiDestPitchBYTES );
 
-	while((*curletter)!=0)
-	{
-		transletter=GetIndex(*curletter++);
-
-		if(FontDestWrap && BltIsClipped(FontObjs[FontDefault], destx, desty, transletter, &FontDestRegion))
-		{
-			destx=x;
-			desty+=GetHeight(FontObjs[FontDefault], transletter);
-		}
-
-		Blt8BPPDataTo16BPPBufferTransparentClip( (UINT16*)pDestBuf, uiDestPitchBYTES, FontObjs[FontDefault], destx, desty, transletter, &FontDestRegion );
-		destx+=GetWidth(FontObjs[FontDefault], transletter);
-	}
+	PrintGlyphString( (UINT16*)pDestBuf, uiDestPitchBYTES, x, y, string, FONT_RUN_SHADED );
 
 	// Unlock buffer
 	UnLockVideoSurface( FontDestBuffer );
@@ -1070,8 +1340,6 @@ CHAR16	string[512];
 
 UINT32	mprintf_buffer( UINT8 *pDestBuf, UINT32 uiDestPitchBYTES, UINT32 FontType, INT32 x, INT32 y, const STR16 pFontString, ...)
 {
-INT32		destx, desty;
-CHAR16	*curletter, transletter;
 va_list argptr;
 CHAR16	string[512];
 
@@ -1089,24 +1357,8 @@ CHAR16	string[512];
 		     return(0);
 		    }
     }
-	curletter=string;
-
-	destx=x;
-	desty=y;
 
-	while((*curletter)!=0)
-	{
-		transletter=GetIndex(*curletter++);
-
-		if(FontDestWrap && BltIsClipped(FontObjs[FontDefault], destx, desty, transletter, &FontDestRegion))
-		{
-			destx=x;
-			desty+=GetHeight(FontObjs[FontDefault], transletter);
-		}
-
-		Blt8BPPDataTo16BPPBufferMonoShadowClip((UINT16*)pDestBuf, uiDestPitchBYTES, FontObjs[FontDefault], destx, desty, transletter, &FontDestRegion, FontForeground16, FontBackground16, FontShadow16 );
-		destx+=GetWidth(FontObjs[FontDefault], transletter);
-	}
+	PrintGlyphString( (UINT16*)pDestBuf, uiDestPitchBYTES, x, y, string, FONT_RUN_MONO );
 
 	return(0);
 }
@@ -1301,6 +1553,8 @@ UINT8 uiPixelDepth;
 	for(count=0; count < MAX_FONTS; count++)
 		FontObjs[count]=NULL;
 
+	FlushFontCaches();
+
 	return TRUE;
 }
 
@@ -1323,6 +1577,8 @@ void ShutdownFontManager(void)
 		if(FontObjs[count]!=NULL)
 			UnloadFont(count);
 	}
+
+	FlushFontCaches();
 }
 
 
@@ -1347,6 +1603,8 @@ void DestroyEnglishTransTable( void )
 			pFManager->pTranslationTable = NULL;
 		}
 	}
+
+	FlushFontCaches();
 }
 
 
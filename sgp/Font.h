@@ -130,6 +130,12 @@ extern FontTranslationTable *CreateEnglishTransTable(	);
 extern INT16 GetIndex(CHAR16 siChar);
 extern UINT32 GetWidth(HVOBJECT hSrcVObject, INT16 ssIndex);
 
+// Printed strings are kept pre-rendered (see Font.cpp). Anything that changes what the glyphs look like has to
+// flush them, the font functions here do it themselves. Caches of text measured in these fonts compare
+// guiFontCacheGeneration to find out when to start over.
+extern UINT32 guiFontCacheGeneration;
+extern void FlushFontCaches( void );
+
 extern INT16 StringPixLengthArgFastHelp( INT32 usUseFont, INT32 usBoldFont, UINT32 uiCharCount, STR16 pFontString );
 extern INT16 StringPixLengthArg(INT32 usUseFont, UINT32 uiCharCount, STR16 pFontString, ...);
 extern INT16 StringPixLength(const CHAR16* string,INT32 UseFont);
@@ -562,6 +562,12 @@ void ShutdownStandardGamingPlatform(void)
 	// Shut down the different components of the SGP
 	//
 
+	// write the profile started with /PROFILE
+	if ( ProfilerIsRecording() )
+	{
+		ProfilerStop();
+	}
+
 	ClearTimerNotifyCallbacks();
 
 	// TEST
@@ -1292,6 +1298,11 @@ void ProcessJa2CommandLineBeforeInitialization(CHAR8 *pCommandLine)
 			bScreenModeCmdLine = TRUE; /* if set TRUE, INI is no longer evaluated */
 			/* no resolution read from Args. Still from INI, but could be added here, too...*/
 		}
+		else if(!_strnicmp(pToken, "/PROFILE", 8))
+		{
+			//record zones from the start, they are written on exit (see profiler.h)
+			ProfilerStart();
+		}
 
 		//get the next token
 		pToken=strtok(NULL, cSeparators);
@@ -0,0 +1,584 @@
+	#include "types.h"
+	#include "shade_palette_store.h"
+	#include "himage.h"
+	#include "MemMan.h"
+	#include "FileMan.h"
+	#include "DEBUG.H"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#define SHADE_CACHE_ID				"SHTB"
+#define SHADE_CACHE_VERSION			2
+#define SHADE_TABLE_ENTRIES			256
+#define SHADE_CACHE_ENTRY_BYTES		( sizeof( SHADE_PALETTE_KEY ) + SHADE_TABLE_ENTRIES * sizeof( UINT16 ) )
+// about 2 MB, a cache that would grow past it is written again with only the tables used since the game started
+#define SHADE_CACHE_MAX_TABLES		4096
+
+// Layout of the cache file: the header, then one or more chunks. Everything is kept 8 byte aligned, so the keys
+// and tables can be used in place.
+typedef struct
+{
+	CHAR8	szID[4];
+	UINT32	uiVersion;
+	UINT16	usRedMask;					// the pixel format the tables were made for
+	UINT16	usGreenMask;
+	UINT16	usBlueMask;
+	UINT16	usAlphaMask;
+	UINT32	uiReserved[2];
+} SHADE_CACHE_HEADER;
+
+// followed by the keys sorted and the tables in the same order. The tables computed since the last save are
+// appended as a chunk of their own, so the file is never written again just to add a few tables.
+typedef struct
+{
+	UINT32	uiCount;
+	UINT32	uiReserved;
+} SHADE_CACHE_CHUNK_HEADER;
+
+typedef struct SHADE_PALETTE_KEY
+{
+	UINT64	uiPaletteHash;
+	UINT16	usRed;
+	UINT16	usGreen;
+	UINT16	usBlue;
+	UINT16	fMono;
+
+	bool operator<( const SHADE_PALETTE_KEY &other ) const
+	{
+		if ( uiPaletteHash != other.uiPaletteHash )
+			return uiPaletteHash < other.uiPaletteHash;
+		if ( usRed != other.usRed )
+			return usRed < other.usRed;
+		if ( usGreen != other.usGreen )
+			return usGreen < other.usGreen;
+		if ( usBlue != other.usBlue )
+			return usBlue < other.usBlue;
+		return fMono < other.fMono;
+	}
+} SHADE_PALETTE_KEY;
+
+typedef struct
+{
+	UINT32				uiCount;
+	SHADE_PALETTE_KEY	*pKeys;
+	UINT16				*pTables;
+	std::vector<bool>	Used;			// tables handed out since the game started, kept when the file is pruned
+} SHADE_CACHE_CHUNK;
+
+// a loaded cache file, with the chunks appended to it since
+typedef struct
+{
+	std::vector<UINT8*>				Buffers;	// what was read and appended, the chunks lie in these
+	std::vector<SHADE_CACHE_CHUNK>	Chunks;
+	UINT32							uiCount;	// tables in all the chunks
+	UINT32							uiBytes;	// size of the file
+	UINT32							uiInUse;	// tables of this file handed out
+} SHADE_CACHE_BLOCK;
+
+typedef struct
+{
+	UINT16				*pTable;
+	UINT32				uiRefs;
+	SHADE_CACHE_BLOCK	*pBlock;		// the cache file the table lies in, NULL if it was computed
+	BOOLEAN				fSaved;			// the cache file has it
+} SHADE_PALETTE;
+
+typedef std::map<SHADE_PALETTE_KEY, SHADE_PALETTE> SHADE_PALETTE_MAP;
+typedef std::map<SHADE_PALETTE_KEY, const UINT16*> SHADE_TABLE_MAP;
+
+SHADE_PALETTE_STATS gShadePaletteStats;
+
+static std::mutex								gShadePaletteLock;
+static SHADE_PALETTE_MAP						gShadePalettes;
+static std::unordered_map<UINT16*, SHADE_PALETTE_MAP::iterator>	gShadePaletteOwners;
+static SHADE_CACHE_BLOCK						*gpShadeCache = NULL;	// the tables are looked up in this one
+static std::vector<SHADE_CACHE_BLOCK*>			gOldShadeCaches;		// replaced ones, with tables still in use
+static BOOLEAN									gfShadeCacheChanged = FALSE;
+static BOOLEAN									gfShadeCacheRewrite = FALSE;	// the file can't be appended to
+
+
+static void FreeShadeCacheBlock( SHADE_CACHE_BLOCK *pBlock )
+{
+	std::vector<SHADE_CACHE_BLOCK*>::iterator it = std::find( gOldShadeCaches.begin(), gOldShadeCaches.end(), pBlock );
+
+	if ( it != gOldShadeCaches.end() )
+		gOldShadeCaches.erase( it );
+
+	for ( size_t cnt = 0; cnt < pBlock->Buffers.size(); cnt++ )
+		MemFree( pBlock->Buffers[ cnt ] );
+	delete pBlock;
+}
+
+// the table of Key in pBlock, NULL if it hasn't got it
+static UINT16 *FindCachedShadePalette( SHADE_CACHE_BLOCK *pBlock, const SHADE_PALETTE_KEY &Key )
+{
+	for ( size_t cnt = 0; cnt < pBlock->Chunks.size(); cnt++ )
+	{
+		SHADE_CACHE_CHUNK &Chunk = pBlock->Chunks[ cnt ];
+		SHADE_PALETTE_KEY *pKeysEnd = Chunk.pKeys + Chunk.uiCount;
+		SHADE_PALETTE_KEY *pFound = std::lower_bound( Chunk.pKeys, pKeysEnd, Key );
+
+		if ( pFound != pKeysEnd && !( Key < *pFound ) )
+		{
+			Chunk.Used[ pFound - Chunk.pKeys ] = true;
+			return( Chunk.pTables + ( pFound - Chunk.pKeys ) * SHADE_TABLE_ENTRIES );
+		}
+	}
+
+	return( NULL );
+}
+
+// makes pBlock the cache, the previous one is kept as long as its tables are in use
+static void SetShadeCacheBlock( SHADE_CACHE_BLOCK *pBlock )
+{
+	if ( gpShadeCache )
+	{
+		if ( gpShadeCache->uiInUse == 0 )
+			FreeShadeCacheBlock( gpShadeCache );
+		else
+			gOldShadeCaches.push_back( gpShadeCache );
+	}
+
+	gpShadeCache = pBlock;
+
+	// anything not in the new cache is a change
+	gfShadeCacheChanged = FALSE;
+	for ( SHADE_PALETTE_MAP::iterator it = gShadePalettes.begin(); it != gShadePalettes.end(); ++it )
+	{
+		it->second.fSaved = ( FindCachedShadePalette( pBlock, it->first ) != NULL );
+		if ( !it->second.fSaved )
+			gfShadeCacheChanged = TRUE;
+	}
+}
+
+static SHADE_CACHE_BLOCK *MakeShadeCacheBlock( void )
+{
+	SHADE_CACHE_BLOCK *pBlock = new SHADE_CACHE_BLOCK;
+
+	pBlock->uiCount = 0;
+	pBlock->uiBytes = sizeof( SHADE_CACHE_HEADER );
+	pBlock->uiInUse = 0;
+
+	return( pBlock );
+}
+
+static UINT32 ShadeCacheChunkSize( UINT32 uiCount )
+{
+	return( sizeof( SHADE_CACHE_CHUNK_HEADER ) + uiCount * SHADE_CACHE_ENTRY_BYTES );
+}
+
+// the chunk at pData, which has to stay allocated as long as pBlock
+static void AddShadeCacheChunk( SHADE_CACHE_BLOCK *pBlock, UINT8 *pData )
+{
+	SHADE_CACHE_CHUNK Chunk;
+
+	Chunk.uiCount = ( (SHADE_CACHE_CHUNK_HEADER *)pData )->uiCount;
+	Chunk.pKeys = (SHADE_PALETTE_KEY *)( pData + sizeof( SHADE_CACHE_CHUNK_HEADER ) );
+	Chunk.pTables = (UINT16 *)( Chunk.pKeys + Chunk.uiCount );
+	Chunk.Used.assign( Chunk.uiCount, false );
+
+	pBlock->Chunks.push_back( Chunk );
+	pBlock->uiCount += Chunk.uiCount;
+	pBlock->uiBytes += ShadeCacheChunkSize( Chunk.uiCount );
+}
+
+static UINT8 *MakeShadeCacheChunk( const SHADE_TABLE_MAP &Tables, UINT32 *puiSize )
+{
+	SHADE_CACHE_CHUNK_HEADER *pHeader;
+	SHADE_PALETTE_KEY *pKey;
+	UINT16 *pTable;
+	UINT8 *pData;
+
+	*puiSize = ShadeCacheChunkSize( (UINT32)Tables.size() );
+	pData = (UINT8 *)MemAlloc( *puiSize );
+	if ( pData == NULL )
+		return( NULL );
+
+	pHeader = (SHADE_CACHE_CHUNK_HEADER *)pData;
+	pHeader->uiCount = (UINT32)Tables.size();
+	pHeader->uiReserved = 0;
+
+	pKey = (SHADE_PALETTE_KEY *)( pData + sizeof( SHADE_CACHE_CHUNK_HEADER ) );
+	pTable = (UINT16 *)( pKey + Tables.size() );
+	for ( SHADE_TABLE_MAP::const_iterator it = Tables.begin(); it != Tables.end(); ++it, ++pKey, pTable += SHADE_TABLE_ENTRIES )
+	{
+		*pKey = it->first;
+		memcpy( pTable, it->second, SHADE_TABLE_ENTRIES * sizeof( UINT16 ) );
+	}
+
+	return( pData );
+}
+
+UINT64 HashShadePalette( SGPPaletteEntry *pPalette )
+{
+	// FNV-1a over the colours, the flags don't go into the tables
+	UINT64 uiHash = 14695981039346656037ULL;
+	UINT32 cnt;
+
+	for ( cnt = 0; cnt < SHADE_TABLE_ENTRIES; cnt++ )
+	{
+		uiHash = ( uiHash ^ pPalette[ cnt ].peRed ) * 1099511628211ULL;
+		uiHash = ( uiHash ^ pPalette[ cnt ].peGreen ) * 1099511628211ULL;
+		uiHash = ( uiHash ^ pPalette[ cnt ].peBlue ) * 1099511628211ULL;
+	}
+
+	return( uiHash );
+}
+
+UINT16 *AcquireShadePalette( SGPPaletteEntry *pPalette, UINT64 uiPaletteHash, UINT32 rscale, UINT32 gscale, UINT32 bscale, BOOLEAN mono )
+{
+	SHADE_PALETTE_KEY Key;
+	SHADE_PALETTE Palette;
+	SHADE_PALETTE_MAP::iterator it;
+
+	// the shade levels can come from a text file, ones that don't fit in a key aren't shared
+	if ( rscale > 0xFFFF || gscale > 0xFFFF || bscale > 0xFFFF )
+	{
+		return( Create16BPPPaletteShaded( pPalette, rscale, gscale, bscale, mono ) );
+	}
+
+	memset( &Key, 0, sizeof( Key ) );
+	Key.uiPaletteHash = uiPaletteHash;
+	Key.usRed = (UINT16)rscale;
+	Key.usGreen = (UINT16)gscale;
+	Key.usBlue = (UINT16)bscale;
+	Key.fMono = mono ? 1 : 0;
+
+	std::lock_guard<std::mutex> guard( gShadePaletteLock );
+
+	it = gShadePalettes.find( Key );
+	if ( it != gShadePalettes.end() )
+	{
+		it->second.uiRefs++;
+		gShadePaletteStats.uiReferences++;
+		return( it->second.pTable );
+	}
+
+	Palette.pTable = NULL;
+	Palette.uiRefs = 1;
+	Palette.pBlock = NULL;
+	Palette.fSaved = FALSE;
+
+	if ( gpShadeCache )
+	{
+		Palette.pTable = FindCachedShadePalette( gpShadeCache, Key );
+		if ( Palette.pTable )
+		{
+			Palette.pBlock = gpShadeCache;
+			Palette.fSaved = TRUE;
+			gpShadeCache->uiInUse++;
+			gShadePaletteStats.uiFromCache++;
+		}
+	}
+
+	if ( Palette.pTable == NULL )
+	{
+		Palette.pTable = Create16BPPPaletteShaded( pPalette, rscale, gscale, bscale, mono );
+		gShadePaletteStats.uiCreated++;
+		gfShadeCacheChanged = TRUE;
+	}
+
+	it = gShadePalettes.insert( std::make_pair( Key, Palette ) ).first;
+	gShadePaletteOwners[ Palette.pTable ] = it;
+
+	gShadePaletteStats.uiTables++;
+	gShadePaletteStats.uiReferences++;
+
+	return( Palette.pTable );
+}
+
+void ReleaseShadePalette( UINT16 *pTable )
+{
+	if ( pTable == NULL )
+		return;
+
+	std::lock_guard<std::mutex> guard( gShadePaletteLock );
+
+	std::unordered_map<UINT16*, SHADE_PALETTE_MAP::iterator>::iterator owner = gShadePaletteOwners.find( pTable );
+
+	if ( owner == gShadePaletteOwners.end() )
+	{
+		MemFree( pTable );
+		return;
+	}
+
+	SHADE_PALETTE &Palette = owner->second->second;
+
+	gShadePaletteStats.uiReferences--;
+	if ( --Palette.uiRefs > 0 )
+		return;
+
+	if ( Palette.pBlock == NULL )
+	{
+		MemFree( pTable );
+	}
+	else if ( --Palette.pBlock->uiInUse == 0 && Palette.pBlock != gpShadeCache )
+	{
+		FreeShadeCacheBlock( Palette.pBlock );
+	}
+
+	gShadePalettes.erase( owner->second );
+	gShadePaletteOwners.erase( owner );
+	gShadePaletteStats.uiTables--;
+}
+
+UINT32 ShadePaletteBytesSaved( void )
+{
+	return( ( gShadePaletteStats.uiReferences - gShadePaletteStats.uiTables ) * SHADE_TABLE_ENTRIES * sizeof( UINT16 ) );
+}
+
+BOOLEAN LoadShadePaletteCache( STR pFilename )
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	SHADE_CACHE_HEADER *pHeader;
+	SHADE_CACHE_BLOCK *pBlock;
+	HWFILE hFile;
+	UINT8 *pData;
+	UINT32 uiSize, uiBytesRead, uiOffset, uiCount;
+
+	if ( !FileExists( pFilename ) )
+		return( FALSE );
+
+	hFile = FileOpen( pFilename, FILE_ACCESS_READ, FALSE );
+	if ( !hFile )
+		return( FALSE );
+
+	uiSize = FileGetSize( hFile );
+	if ( uiSize < sizeof( SHADE_CACHE_HEADER ) )
+	{
+		FileClose( hFile );
+		return( FALSE );
+	}
+
+	pData = (UINT8 *)MemAlloc( uiSize );
+	if ( pData == NULL || !FileRead( hFile, pData, uiSize, &uiBytesRead ) || uiBytesRead != uiSize )
+	{
+		FileClose( hFile );
+		if ( pData )
+			MemFree( pData );
+		return( FALSE );
+	}
+	FileClose( hFile );
+
+	// tables made for another pixel format, or an older file, are of no use
+	pHeader = (SHADE_CACHE_HEADER *)pData;
+	if ( memcmp( pHeader->szID, SHADE_CACHE_ID, 4 ) != 0 || pHeader->uiVersion != SHADE_CACHE_VERSION ||
+		pHeader->usRedMask != gusRedMask || pHeader->usGreenMask != gusGreenMask || pHeader->usBlueMask != gusBlueMask || pHeader->usAlphaMask != gusAlphaMask )
+	{
+		MemFree( pData );
+		return( FALSE );
+	}
+
+	pBlock = MakeShadeCacheBlock( );
+	pBlock->Buffers.push_back( pData );
+
+	for ( uiOffset = sizeof( SHADE_CACHE_HEADER ); uiSize - uiOffset >= sizeof( SHADE_CACHE_CHUNK_HEADER ); uiOffset += ShadeCacheChunkSize( uiCount ) )
+	{
+		uiCount = ( (SHADE_CACHE_CHUNK_HEADER *)( pData + uiOffset ) )->uiCount;
+		if ( uiCount > ( uiSize - uiOffset - sizeof( SHADE_CACHE_CHUNK_HEADER ) ) / SHADE_CACHE_ENTRY_BYTES )
+			break;
+
+		AddShadeCacheChunk( pBlock, pData + uiOffset );
+	}
+
+	std::lock_guard<std::mutex> guard( gShadePaletteLock );
+
+	SetShadeCacheBlock( pBlock );
+
+	// a chunk that was cut off while it was appended, the good ones are used and the file is written again
+	gfShadeCacheRewrite = ( uiOffset != uiSize );
+
+	gShadePaletteStats.uiCacheBytes = uiSize;
+	gShadePaletteStats.uiCacheLoadTime = (UINT32)std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - start ).count();
+
+	return( TRUE );
+}
+
+BOOLEAN ShadePaletteCacheChanged( void )
+{
+	return( gfShadeCacheChanged );
+}
+
+static BOOLEAN AppendShadePaletteCache( STR pFilename, const SHADE_TABLE_MAP &Tables )
+{
+	HWFILE hFile;
+	UINT8 *pChunk;
+	UINT32 uiSize, uiBytesWritten;
+	BOOLEAN fWritten;
+
+	pChunk = MakeShadeCacheChunk( Tables, &uiSize );
+	if ( pChunk == NULL )
+		return( FALSE );
+
+	hFile = FileOpen( pFilename, FILE_ACCESS_WRITE | FILE_OPEN_EXISTING, FALSE );
+	if ( !hFile )
+	{
+		MemFree( pChunk );
+		gfShadeCacheRewrite = TRUE;
+		return( FALSE );
+	}
+	fWritten = FileSeek( hFile, 0, FILE_SEEK_FROM_END ) && FileWrite( hFile, pChunk, uiSize, &uiBytesWritten ) && uiBytesWritten == uiSize;
+	FileClose( hFile );
+
+	if ( !fWritten )
+	{
+		// part of the chunk may be in the file, which can only be fixed by writing it again
+		MemFree( pChunk );
+		gfShadeCacheRewrite = TRUE;
+		return( FALSE );
+	}
+
+	// what was written is part of the cache, no need to read it back
+	gpShadeCache->Buffers.push_back( pChunk );
+	AddShadeCacheChunk( gpShadeCache, pChunk );
+
+	for ( SHADE_PALETTE_MAP::iterator it = gShadePalettes.begin(); it != gShadePalettes.end(); ++it )
+		it->second.fSaved = TRUE;
+
+	gShadePaletteStats.uiCacheBytes = gpShadeCache->uiBytes;
+	gfShadeCacheChanged = FALSE;
+
+	return( TRUE );
+}
+
+static BOOLEAN RewriteShadePaletteCache( STR pFilename, const SHADE_TABLE_MAP &Tables )
+{
+	SHADE_CACHE_HEADER Header;
+	SHADE_CACHE_BLOCK *pBlock;
+	HWFILE hFile;
+	UINT8 *pChunk;
+	UINT32 uiSize, uiBytesWritten;
+	BOOLEAN fWritten;
+
+	pChunk = MakeShadeCacheChunk( Tables, &uiSize );
+	if ( pChunk == NULL )
+		return( FALSE );
+
+	memset( &Header, 0, sizeof( Header ) );
+	memcpy( Header.szID, SHADE_CACHE_ID, 4 );
+	Header.uiVersion = SHADE_CACHE_VERSION;
+	Header.usRedMask = gusRedMask;
+	Header.usGreenMask = gusGreenMask;
+	Header.usBlueMask = gusBlueMask;
+	Header.usAlphaMask = gusAlphaMask;
+
+	// opening a file to write doesn't truncate it, a smaller file needs the old one gone
+	if ( FileExists( pFilename ) )
+		FileDelete( pFilename );
+
+	hFile = FileOpen( pFilename, FILE_ACCESS_WRITE | FILE_CREATE_ALWAYS, FALSE );
+	if ( !hFile )
+	{
+		MemFree( pChunk );
+		return( FALSE );
+	}
+	fWritten = FileWrite( hFile, &Header, sizeof( Header ), &uiBytesWritten ) && uiBytesWritten == sizeof( Header ) &&
+		FileWrite( hFile, pChunk, uiSize, &uiBytesWritten ) && uiBytesWritten == uiSize;
+	FileClose( hFile );
+
+	if ( !fWritten )
+	{
+		MemFree( pChunk );
+		return( FALSE );
+	}
+
+	// what was written is the new cache, no need to read it back
+	pBlock = MakeShadeCacheBlock( );
+	pBlock->Buffers.push_back( pChunk );
+	AddShadeCacheChunk( pBlock, pChunk );
+
+	SetShadeCacheBlock( pBlock );
+	gShadePaletteStats.uiCacheBytes = pBlock->uiBytes;
+	gfShadeCacheRewrite = FALSE;
+
+	return( TRUE );
+}
+
+BOOLEAN SaveShadePaletteCache( STR pFilename )
+{
+	SHADE_TABLE_MAP Tables;
+	SHADE_PALETTE_MAP::iterator it;
+	size_t cnt;
+	UINT32 uiEntry;
+
+	std::lock_guard<std::mutex> guard( gShadePaletteLock );
+
+	// the tables computed since the cache was loaded or saved go on the end of the file
+	for ( it = gShadePalettes.begin(); it != gShadePalettes.end(); ++it )
+	{
+		if ( !it->second.fSaved )
+			Tables[ it->first ] = it->second.pTable;
+	}
+
+	if ( gpShadeCache && !gfShadeCacheRewrite && gpShadeCache->uiCount + Tables.size() <= SHADE_CACHE_MAX_TABLES && FileExists( pFilename ) )
+	{
+		if ( Tables.empty() )
+		{
+			gfShadeCacheChanged = FALSE;
+			return( TRUE );
+		}
+		return( AppendShadePaletteCache( pFilename, Tables ) );
+	}
+
+	// A new file, a broken one or one that would grow too big: all the tables that fit. Past the limit only the
+	// ones used since the game started are kept, what is left of maps and light colours not seen for a while is
+	// dropped. If those are too many as well, only the tables in use are kept.
+	for ( it = gShadePalettes.begin(); it != gShadePalettes.end(); ++it )
+		Tables[ it->first ] = it->second.pTable;
+
+	if ( gpShadeCache )
+	{
+		SHADE_TABLE_MAP All( Tables ), Used( Tables );
+
+		for ( cnt = 0; cnt < gpShadeCache->Chunks.size(); cnt++ )
+		{
+			SHADE_CACHE_CHUNK &Chunk = gpShadeCache->Chunks[ cnt ];
+
+			for ( uiEntry = 0; uiEntry < Chunk.uiCount; uiEntry++ )
+			{
+				All[ Chunk.pKeys[ uiEntry ] ] = Chunk.pTables + uiEntry * SHADE_TABLE_ENTRIES;
+				if ( Chunk.Used[ uiEntry ] )
+					Used[ Chunk.pKeys[ uiEntry ] ] = Chunk.pTables + uiEntry * SHADE_TABLE_ENTRIES;
+			}
+		}
+
+		if ( All.size() <= SHADE_CACHE_MAX_TABLES )
+			Tables.swap( All );
+		else if ( Used.size() <= SHADE_CACHE_MAX_TABLES )
+			Tables.swap( Used );
+	}
+
+	return( RewriteShadePaletteCache( pFilename, Tables ) );
+}
+
+void ShutdownShadePaletteStore( void )
+{
+	std::lock_guard<std::mutex> guard( gShadePaletteLock );
+
+	for ( SHADE_PALETTE_MAP::iterator it = gShadePalettes.begin(); it != gShadePalettes.end(); ++it )
+	{
+		if ( it->second.pBlock == NULL )
+			MemFree( it->second.pTable );
+	}
+	gShadePalettes.clear();
+	gShadePaletteOwners.clear();
+
+	while ( !gOldShadeCaches.empty() )
+		FreeShadeCacheBlock( gOldShadeCaches.back() );
+
+	if ( gpShadeCache )
+	{
+		FreeShadeCacheBlock( gpShadeCache );
+		gpShadeCache = NULL;
+	}
+
+	gfShadeCacheChanged = FALSE;
+	gfShadeCacheRewrite = FALSE;
+	memset( &gShadePaletteStats, 0, sizeof( gShadePaletteStats ) );
+}
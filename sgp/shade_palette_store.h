@@ -0,0 +1,53 @@
+#ifndef __SHADE_PALETTE_STORE
+#define __SHADE_PALETTE_STORE
+
+#include "types.h"
+#include "himage.h"
+
+// One copy of every 16 bit shade table (the 8 to 16 bit palettes Create16BPPPaletteShaded() makes), shared by all
+// the video objects that need it. A table is found by what it is made from: a hash of the 8 bit palette and the
+// shade level (the scale and mono arguments). For lit objects the palette is the one with the light colour
+// already added, as CreateTilePaletteTables() builds it, so the light colour is part of the key as well. Tables
+// are counted by reference and freed when the last object releases them.
+//
+// Tables can also come from a cache file that holds the tables made before, in chunks: each has the keys sorted,
+// then the tables in the same order. It is read in one piece and the tables are used where they lie, so loading
+// it costs one read and no copying. Saving appends the tables computed since as a new chunk. Only when the file
+// would hold more than SHADE_CACHE_MAX_TABLES is it written again, with just the tables used since the game started.
+
+typedef struct
+{
+	UINT32	uiTables;			// different tables in use
+	UINT32	uiReferences;		// tables handed out and not released yet
+	UINT32	uiCreated;			// tables that had to be computed
+	UINT32	uiFromCache;		// tables found in the cache file
+	UINT32	uiCacheBytes;		// size of the cache file loaded
+	UINT32	uiCacheLoadTime;	// milliseconds spent loading it
+} SHADE_PALETTE_STATS;
+
+extern SHADE_PALETTE_STATS gShadePaletteStats;
+
+// Hash of an 8 bit palette for AcquireShadePalette(), worked out once for all the tables of a palette
+UINT64		HashShadePalette( SGPPaletteEntry *pPalette );
+
+// Same arguments and result as Create16BPPPaletteShaded(), but the table is shared and must be given back with
+// ReleaseShadePalette(), never MemFree()d.
+UINT16		*AcquireShadePalette( SGPPaletteEntry *pPalette, UINT64 uiPaletteHash, UINT32 rscale, UINT32 gscale, UINT32 bscale, BOOLEAN mono );
+// Tables that aren't from the store are MemFree()d, so a pShades[] array can be cleaned up the same way whoever
+// made its tables. NULL is ignored.
+void		ReleaseShadePalette( UINT16 *pTable );
+
+// memory the sharing saves right now
+UINT32		ShadePaletteBytesSaved( void );
+
+// Loads the cache file, if it was written for the current pixel format. Tables of an older cache that are still
+// in use stay valid.
+BOOLEAN		LoadShadePaletteCache( STR pFilename );
+// TRUE if tables were computed since the cache was loaded or saved
+BOOLEAN		ShadePaletteCacheChanged( void );
+// Appends the computed tables in use to the cache file, or prunes it as above, and uses the result as the cache
+BOOLEAN		SaveShadePaletteCache( STR pFilename );
+
+void		ShutdownShadePaletteStore( void );
+
+#endif
@@ -6,10 +6,31 @@
 	#include "vobject.h"
 	#include "vobject_blitters.h"
 	#include "shading.h"
+	#include "vobject_blitters_sse2.h"
+
+#include <stdlib.h>
+#include <emmintrin.h>
+#ifdef JA2TESTVERSION
+#include <chrono>
+#endif
 
 BOOLEAN ShadesCalculateTables(SGPPaletteEntry *p8BPPPalette);
 BOOLEAN ShadesCalculatePalette(SGPPaletteEntry *pSrcPalette, SGPPaletteEntry *pDestPalette, UINT16 usRed, UINT16 usGreen, UINT16 usBlue, BOOLEAN fMono);
-void FindIndecies(SGPPaletteEntry *pSrcPalette, SGPPaletteEntry *pMapPalette, UINT8 *pTable);
+
+// Entries 1-255 of the palette to search, one array per channel, so that the SSE2 search can take 8 entries at a
+// time. Entry 0 is the transparent colour and never a match, it holds a colour too far away from every 8 bit
+// colour to win, and the distances still fit in an INT16.
+#define PALETTE_SEARCH_FAR		10000
+
+typedef struct
+{
+	INT16	sRed[256];
+	INT16	sGreen[256];
+	INT16	sBlue[256];
+} PALETTE_SEARCH;
+
+static void PreparePaletteSearch(SGPPaletteEntry *pMapPalette, PALETTE_SEARCH *pSearch);
+static void FindIndecies(SGPPaletteEntry *pSrcPalette, PALETTE_SEARCH *pSearch, UINT8 *pTable);
 void FindMaskIndecies(UINT8 *, UINT8 *, UINT8 *);
 
 SGPPaletteEntry Shaded8BPPPalettes[HVOBJECT_SHADE_TABLES+3][256];
@@ -24,6 +45,7 @@ FLOAT	guiBrightPercent = (FLOAT)1.1;
 BOOLEAN ShadesCalculateTables(SGPPaletteEntry *p8BPPPalette)
 {
 UINT32	uiCount;
+PALETTE_SEARCH Search;
 
 		// Green palette
 		ShadesCalculatePalette(p8BPPPalette, Shaded8BPPPalettes[0], 0, 255, 0, TRUE);
@@ -57,9 +79,10 @@ UINT32	uiCount;
 
 
 	// Remap the shade colors to the original palette
+	PreparePaletteSearch(p8BPPPalette, &Search);
 	for(uiCount=0; uiCount < (HVOBJECT_SHADE_TABLES+3); uiCount++)
 	{
-		FindIndecies(Shaded8BPPPalettes[uiCount], p8BPPPalette, ubColorTables[uiCount]);
+		FindIndecies(Shaded8BPPPalettes[uiCount], &Search, ubColorTables[uiCount]);
 		ubColorTables[uiCount][0]=0;
 	}
 
@@ -101,85 +124,114 @@ UINT32 rmod, gmod, bmod;
 
 
 
-void FindIndecies(SGPPaletteEntry *pSrcPalette, SGPPaletteEntry *pMapPalette, UINT8 *pTable)
+static void PreparePaletteSearch(SGPPaletteEntry *pMapPalette, PALETTE_SEARCH *pSearch)
+{
+UINT32 cnt;
+
+	pSearch->sRed[0] = pSearch->sGreen[0] = pSearch->sBlue[0] = PALETTE_SEARCH_FAR;
+
+	for ( cnt = 1; cnt < 256; cnt++ )
+	{
+		pSearch->sRed[cnt] = pMapPalette[cnt].peRed;
+		pSearch->sGreen[cnt] = pMapPalette[cnt].peGreen;
+		pSearch->sBlue[cnt] = pMapPalette[cnt].peBlue;
+	}
+}
+
+// Delta = abs(red-origred) + abs(green-origgreen) + abs(blue-origblue), the first of the closest colours wins
+static UINT8 FindClosestIndex(PALETTE_SEARCH *pSearch, INT16 sRed, INT16 sGreen, INT16 sBlue)
+{
+UINT32 cnt, uiDelta, uiCurDelta = 0xFFFF;
+UINT8 ubCurIndex = 0;
+
+	for ( cnt = 1; cnt < 256; cnt++ )
+	{
+		uiDelta = abs( pSearch->sRed[cnt] - sRed ) + abs( pSearch->sGreen[cnt] - sGreen ) + abs( pSearch->sBlue[cnt] - sBlue );
+
+		if ( uiDelta < uiCurDelta )
+		{
+			uiCurDelta = uiDelta;
+			ubCurIndex = (UINT8)cnt;
+		}
+	}
+
+	return( ubCurIndex );
+}
+
+static inline __m128i AbsDiffSSE2(__m128i a, __m128i b)
+{
+	__m128i d = _mm_sub_epi16( a, b );
+
+	return( _mm_max_epi16( d, _mm_sub_epi16( _mm_setzero_si128(), d ) ) );
+}
+
+// Same search, 8 entries at a time. Each lane keeps the first of its closest entries, and of the lanes with the
+// smallest delta the lowest index wins, so the result is the same.
+static UINT8 FindClosestIndexSSE2(PALETTE_SEARCH *pSearch, INT16 sRed, INT16 sGreen, INT16 sBlue)
+{
+	__m128i vRed = _mm_set1_epi16( sRed );
+	__m128i vGreen = _mm_set1_epi16( sGreen );
+	__m128i vBlue = _mm_set1_epi16( sBlue );
+	__m128i vIndex = _mm_setr_epi16( 0, 1, 2, 3, 4, 5, 6, 7 );
+	__m128i vStep = _mm_set1_epi16( 8 );
+	__m128i vCurDelta = _mm_set1_epi16( 0x7FFF );
+	__m128i vCurIndex = _mm_setzero_si128();
+	__m128i vDelta, vCloser;
+	INT16 sCurDelta[8], sCurIndex[8];
+	UINT32 cnt;
+	INT16 sBestDelta = 0x7FFF, sBestIndex = 0;
+
+	for ( cnt = 0; cnt < 256; cnt += 8 )
+	{
+		vDelta = _mm_add_epi16( _mm_add_epi16( AbsDiffSSE2( _mm_loadu_si128( (__m128i *)&pSearch->sRed[cnt] ), vRed ),
+												AbsDiffSSE2( _mm_loadu_si128( (__m128i *)&pSearch->sGreen[cnt] ), vGreen ) ),
+												AbsDiffSSE2( _mm_loadu_si128( (__m128i *)&pSearch->sBlue[cnt] ), vBlue ) );
+
+		vCloser = _mm_cmplt_epi16( vDelta, vCurDelta );
+		vCurDelta = _mm_min_epi16( vDelta, vCurDelta );
+		vCurIndex = _mm_or_si128( _mm_and_si128( vCloser, vIndex ), _mm_andnot_si128( vCloser, vCurIndex ) );
+		vIndex = _mm_add_epi16( vIndex, vStep );
+	}
+
+	_mm_storeu_si128( (__m128i *)sCurDelta, vCurDelta );
+	_mm_storeu_si128( (__m128i *)sCurIndex, vCurIndex );
+
+	for ( cnt = 0; cnt < 8; cnt++ )
+	{
+		if ( sCurDelta[cnt] < sBestDelta || ( sCurDelta[cnt] == sBestDelta && sCurIndex[cnt] < sBestIndex ) )
+		{
+			sBestDelta = sCurDelta[cnt];
+			sBestIndex = sCurIndex[cnt];
+		}
+	}
+
+	return( (UINT8)sBestIndex );
+}
+
+// For colours 1-255 of the shaded palette, finds the closest colour in the searched palette. Index 0 is always 0,
+// for the transparent colour.
+static void FindIndecies(SGPPaletteEntry *pSrcPalette, PALETTE_SEARCH *pSearch, UINT8 *pTable)
 {
-UINT16 usCurIndex, usCurDelta, usCurCount;
-UINT32 *pSavedPtr;
-
-__asm {
-
-// Assumes:
-//	ESI = Pointer to source palette (shaded values)
-//	EDI = Pointer to original palette (palette we'll end up using!)
-//	EBX = Pointer to array of indecies
-
-		mov		esi, pSrcPalette
-		mov		edi, pMapPalette
-		mov		ebx, pTable
-
-		mov		BYTE PTR [ebx],0						; Index 0 is always 0, for trans col
-		inc		ebx
-
-		add		esi,4												; Goto next color entry
-		add		edi,4
-		mov		pSavedPtr, edi							; Save pointer to original pal
-
-		mov		usCurCount, 255							; We'll check cols 1-255
-
-DoNextIndex:
-
-		mov		edi, pSavedPtr							; Restore saved ptr
-		mov		usCurIndex, 256							; Set found index & delta to some
-		mov		usCurDelta, 0ffffh					; val so we get at least 1 col.
-
-		mov		ecx,255											; Check cols 1-255 of orig pal
-		push	ebx
-		xor		bx,bx
-
-NextColor:
-		xor		ah,ah						; Calc delta between shaded color
-		mov		al,[edi]										; and a color in the orig palette.
-		mov		bl,[esi]										; Formula:
-		sub		ax,bx						;	Delta = abs(red-origred) +
-		or		ax,ax												;			abs(green-origgreen) +
-		jns		NC1
-		neg		ax
-NC1:mov		dx,ax						;			abs(blue-origblue)
-		xor		ah,ah
-		mov		al,[edi+1]
-		mov		bl,[esi+1]
-		sub		ax,bx
-		or		ax,ax												;			abs(green-origgreen) +
-		jns		NC2
-		neg		ax
-NC2:add		dx,ax
-		xor		ah,ah
-		mov		al,[edi+2]
-		mov		bl,[esi+2]
-		sub		ax,bx
-		or		ax,ax												;			abs(green-origgreen) +
-		jns		NC3
-		neg		ax
-NC3:add		dx,ax
-
-		cmp		dx,usCurDelta								; If delta < old delta
-		jae		NotThisCol									;	Save this delta and it's
-		mov		ax,256						;	palette index
-		mov		[usCurDelta],dx
-		sub	ax,cx
-		mov		[usCurIndex],ax
-NotThisCol:
-		add		edi,4												; Try next color in orginal pal
-		dec		cx
-		jnz	NextColor
-
-		pop		ebx
-		mov		ax,usCurIndex								; By now, usCurIndex holds pal index
-		mov		[ebx],al										; of closest color in orig pal
-		inc		ebx													; so save it, then repeat above
-		add		esi,4												; for the other cols in shade pal
-		dec		usCurCount
-		jnz		DoNextIndex
+UINT32 cnt;
+
+	pTable[0] = 0;
+
+	for ( cnt = 1; cnt < 256; cnt++ )
+	{
+		// the dark tables are mostly runs of the same colour
+		if ( cnt > 1 && pSrcPalette[cnt].peRed == pSrcPalette[cnt - 1].peRed && pSrcPalette[cnt].peGreen == pSrcPalette[cnt - 1].peGreen &&
+			pSrcPalette[cnt].peBlue == pSrcPalette[cnt - 1].peBlue )
+		{
+			pTable[cnt] = pTable[cnt - 1];
+		}
+		else if ( gfBlitterSSE2 )
+		{
+			pTable[cnt] = FindClosestIndexSSE2( pSearch, pSrcPalette[cnt].peRed, pSrcPalette[cnt].peGreen, pSrcPalette[cnt].peBlue );
+		}
+		else
+		{
+			pTable[cnt] = FindClosestIndex( pSearch, pSrcPalette[cnt].peRed, pSrcPalette[cnt].peGreen, pSrcPalette[cnt].peBlue );
+		}
 	}
 }
 
@@ -281,3 +333,181 @@ BOOLEAN Set8BitModePalette(SGPPaletteEntry *pPal)
 	return(TRUE);
 }
 
+
+#ifdef JA2TESTVERSION
+static UINT32 ShadingTestRandom( UINT32 &uiSeed, UINT32 uiRange )
+{
+	uiSeed = uiSeed * 1103515245 + 12345;
+	return( ( uiSeed >> 8 ) % uiRange );
+}
+
+// The search the asm FindIndecies did, step by step: 16 bit delta, starting at 0xFFFF, index 256 if nothing is
+// closer, which ends up as 0 in the table.
+static void FindIndeciesReference(SGPPaletteEntry *pSrcPalette, SGPPaletteEntry *pMapPalette, UINT8 *pTable)
+{
+UINT32 cnt, uiMap;
+UINT16 usCurIndex, usCurDelta, usDelta;
+
+	pTable[0] = 0;
+
+	for ( cnt = 1; cnt < 256; cnt++ )
+	{
+		usCurIndex = 256;
+		usCurDelta = 0xFFFF;
+
+		for ( uiMap = 1; uiMap < 256; uiMap++ )
+		{
+			usDelta = (UINT16)( abs( pMapPalette[uiMap].peRed - pSrcPalette[cnt].peRed ) + abs( pMapPalette[uiMap].peGreen - pSrcPalette[cnt].peGreen ) +
+								abs( pMapPalette[uiMap].peBlue - pSrcPalette[cnt].peBlue ) );
+			if ( usDelta < usCurDelta )
+			{
+				usCurDelta = usDelta;
+				usCurIndex = (UINT16)uiMap;
+			}
+		}
+
+		pTable[cnt] = (UINT8)usCurIndex;
+	}
+}
+
+// Checks FindIndecies, on the scalar and (if the CPU has it) the SSE2 path, against the asm search:
+// - every 24 bit colour, for a random palette, a palette full of ties and a grey ramp (about a minute)
+// - the shade tables of 2000 random palettes with repeated colours
+// Then times the 51 shade tables of the random palette on each path, in microseconds per set of tables.
+void CompareFindIndecies( UINT32 *puiMismatches, UINT32 *puiReferenceTime, UINT32 *puiScalarTime, UINT32 *puiSSE2Time )
+{
+	static SGPPaletteEntry	SavedPalettes[HVOBJECT_SHADE_TABLES+3][256];
+	static UINT8			ubSavedTables[HVOBJECT_SHADE_TABLES+3][256];
+	static UINT8			ubTables[HVOBJECT_SHADE_TABLES+3][256];
+	SGPPaletteEntry			Palette[256], RandomPalette[256], Src[256];
+	UINT8					ubReference[256], ubResult[256];
+	PALETTE_SEARCH			Search;
+	BOOLEAN					fSSE2 = gfBlitterSSE2;
+	UINT32					uiSeed = 1;
+	UINT32					cnt, uiPalette, uiColour, uiTable;
+	UINT8					ubPath;
+
+	*puiMismatches = 0;
+	*puiReferenceTime = *puiScalarTime = *puiSSE2Time = 0;
+
+	// ShadesCalculateTables() is used to make the test tables, the real ones are put back at the end
+	memcpy( SavedPalettes, Shaded8BPPPalettes, sizeof( SavedPalettes ) );
+	memcpy( ubSavedTables, ubColorTables, sizeof( ubSavedTables ) );
+
+	memset( Palette, 0, sizeof( Palette ) );
+	memset( Src, 0, sizeof( Src ) );
+
+	for ( uiPalette = 0; uiPalette < 3; uiPalette++ )
+	{
+		for ( cnt = 0; cnt < 256; cnt++ )
+		{
+			if ( uiPalette == 0 )
+			{
+				Palette[cnt].peRed = (UINT8)ShadingTestRandom( uiSeed, 256 );
+				Palette[cnt].peGreen = (UINT8)ShadingTestRandom( uiSeed, 256 );
+				Palette[cnt].peBlue = (UINT8)ShadingTestRandom( uiSeed, 256 );
+			}
+			else if ( uiPalette == 1 )
+			{
+				// 8 colours over and over, and ones the same distance apart
+				Palette[cnt].peRed = (UINT8)( ( cnt % 8 ) * 32 );
+				Palette[cnt].peGreen = (UINT8)( ( cnt % 8 ) * 32 );
+				Palette[cnt].peBlue = (UINT8)( ( cnt & 8 ) ? 64 : 0 );
+			}
+			else
+			{
+				Palette[cnt].peRed = Palette[cnt].peGreen = Palette[cnt].peBlue = (UINT8)cnt;
+			}
+		}
+		if ( uiPalette == 0 )
+		{
+			memcpy( RandomPalette, Palette, sizeof( Palette ) );
+		}
+
+		PreparePaletteSearch( Palette, &Search );
+
+		// colours 1-255 of Src take the next 255 colours
+		for ( uiColour = 0; uiColour < 0x1000000; uiColour += 255 )
+		{
+			for ( cnt = 1; cnt < 256; cnt++ )
+			{
+				UINT32 uiRGB = ( uiColour + cnt - 1 ) & 0xFFFFFF;
+
+				Src[cnt].peRed = (UINT8)( uiRGB >> 16 );
+				Src[cnt].peGreen = (UINT8)( uiRGB >> 8 );
+				Src[cnt].peBlue = (UINT8)uiRGB;
+			}
+
+			FindIndeciesReference( Src, Palette, ubReference );
+			for ( ubPath = 0; ubPath < ( fSSE2 ? 2 : 1 ); ubPath++ )
+			{
+				gfBlitterSSE2 = ubPath ? TRUE : FALSE;
+				FindIndecies( Src, &Search, ubResult );
+				if ( memcmp( ubReference, ubResult, sizeof( ubResult ) ) )
+					(*puiMismatches)++;
+			}
+		}
+	}
+
+	// the shade tables have long runs of one colour, and palettes with repeated colours have ties
+	for ( uiPalette = 0; uiPalette < 2000; uiPalette++ )
+	{
+		UINT32 uiColours = 1 + ShadingTestRandom( uiSeed, 64 );
+
+		for ( cnt = 0; cnt < 256; cnt++ )
+		{
+			UINT32 uiRGB = ( ( cnt % uiColours ) * 2654435761u ) ^ uiPalette;
+
+			Palette[cnt].peRed = (UINT8)( uiRGB >> 16 );
+			Palette[cnt].peGreen = (UINT8)( uiRGB >> 8 );
+			Palette[cnt].peBlue = (UINT8)uiRGB;
+		}
+
+		ShadesCalculateTables( Palette );
+		PreparePaletteSearch( Palette, &Search );
+		for ( uiTable = 0; uiTable < HVOBJECT_SHADE_TABLES+3; uiTable++ )
+		{
+			FindIndeciesReference( Shaded8BPPPalettes[uiTable], Palette, ubReference );
+			for ( ubPath = 0; ubPath < ( fSSE2 ? 2 : 1 ); ubPath++ )
+			{
+				gfBlitterSSE2 = ubPath ? TRUE : FALSE;
+				FindIndecies( Shaded8BPPPalettes[uiTable], &Search, ubResult );
+				if ( memcmp( ubReference, ubResult, sizeof( ubResult ) ) )
+					(*puiMismatches)++;
+			}
+		}
+	}
+
+	// what ShadesCalculateTables() does, 100 times on each path
+	ShadesCalculateTables( RandomPalette );
+	PreparePaletteSearch( RandomPalette, &Search );
+	for ( ubPath = 0; ubPath < ( fSSE2 ? 3 : 2 ); ubPath++ )
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		gfBlitterSSE2 = ( ubPath == 2 ) ? TRUE : FALSE;
+		for ( cnt = 0; cnt < 100; cnt++ )
+		{
+			for ( uiTable = 0; uiTable < HVOBJECT_SHADE_TABLES+3; uiTable++ )
+			{
+				if ( ubPath == 0 )
+					FindIndeciesReference( Shaded8BPPPalettes[uiTable], RandomPalette, ubTables[uiTable] );
+				else
+					FindIndecies( Shaded8BPPPalettes[uiTable], &Search, ubTables[uiTable] );
+			}
+		}
+
+		UINT32 uiTime = (UINT32)( std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - start ).count() / 100 );
+		if ( ubPath == 0 )
+			*puiReferenceTime = uiTime;
+		else if ( ubPath == 1 )
+			*puiScalarTime = uiTime;
+		else
+			*puiSSE2Time = uiTime;
+	}
+
+	gfBlitterSSE2 = fSSE2;
+	memcpy( Shaded8BPPPalettes, SavedPalettes, sizeof( SavedPalettes ) );
+	memcpy( ubColorTables, ubSavedTables, sizeof( ubSavedTables ) );
+}
+#endif
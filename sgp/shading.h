@@ -32,6 +32,11 @@ extern FLOAT	guiBrightPercent;
 }
 #endif
 
+#ifdef JA2TESTVERSION
+// FindIndecies against the asm search it replaced, and how long the shade tables take on each path
+void CompareFindIndecies( UINT32 *puiMismatches, UINT32 *puiReferenceTime, UINT32 *puiScalarTime, UINT32 *puiSSE2Time );
+#endif
+
 #define DEFAULT_SHADE_LEVEL		4
 
 #endif
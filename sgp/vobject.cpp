@@ -6,6 +6,8 @@
 #include "vobject.h"
 #include "WCheck.h"
 #include "vobject_blitters.h"
+#include "vobject_blitters_sse2.h"
+#include "shade_palette_store.h"
 #include "sgp.h"
 
 #include <unordered_map>
@@ -148,6 +150,7 @@ BOOLEAN InitializeVideoObjectManager( )
 	RegisterDebugTopic(TOPIC_VIDEOOBJECT, "Video Object Manager");
 	gpVObjectHead = gpVObjectTail = NULL;
 #endif
+	DetectBlitterCPUFeatures();
 	gfVideoObjectsInit=TRUE;
 	return TRUE ;
 }
@@ -189,6 +192,7 @@ BOOLEAN ShutdownVideoObjectManager( )
 	guiVObjectIndex = 1;
 	guiVObjectSize = 0;
 	guiVObjectTotalAdded = 0;
+	ShutdownShadePaletteStore();
 	UnRegisterDebugTopic(TOPIC_VIDEOOBJECT, "Video Objects");
 	gfVideoObjectsInit=FALSE;
 	return TRUE;
@@ -823,6 +827,7 @@ BOOLEAN DeleteVideoObject( HVOBJECT hVObject )
 UINT16 CreateObjectPaletteTables(HVOBJECT pObj, UINT32 uiType)
 {
 UINT32 count;
+UINT64 uiPaletteHash;
 
 		// this creates the highlight table. Specify the glow-type when creating the tables
 		// through uiType, symbols are from VOBJECT.H
@@ -832,31 +837,34 @@ UINT32 count;
 			pObj->pShades[ count ] = NULL;
 		else if ( pObj->pShades[ count ] != NULL )
 		{
-			MemFree( pObj->pShades[ count ] );
+			ReleaseShadePalette( pObj->pShades[ count ] );
 			pObj->pShades[ count ] = NULL;
 		}
 	}
 
+		// the tables are shared with every other object that has the same palette
+		uiPaletteHash = HashShadePalette( pObj->pPaletteEntry );
+
 		switch(uiType)
 		{
 			case HVOBJECT_GLOW_GREEN:	// green glow
-				pObj->pShades[0]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 0, 255, 0, TRUE);
+				pObj->pShades[0]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 0, 255, 0, TRUE);
 				break;
 			case HVOBJECT_GLOW_BLUE:	// blue glow
-				pObj->pShades[0]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 0, 0, 255, TRUE);
+				pObj->pShades[0]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 0, 0, 255, TRUE);
 				break;
 			case HVOBJECT_GLOW_YELLOW:	// yellow glow
-				pObj->pShades[0]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 255, 255, 0, TRUE);
+				pObj->pShades[0]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 255, 255, 0, TRUE);
 				break;
 			case HVOBJECT_GLOW_RED:	// red glow
-				pObj->pShades[0]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 255, 0, 0, TRUE);
+				pObj->pShades[0]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 255, 0, 0, TRUE);
 				break;
 		}
 
 		// these are the brightening tables, 115%-150% brighter than original
-		pObj->pShades[1]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 293, 293, 293, FALSE);
-		pObj->pShades[2]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 281, 281, 281, FALSE);
-		pObj->pShades[3]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 268, 268, 268, FALSE);
+		pObj->pShades[1]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 293, 293, 293, FALSE);
+		pObj->pShades[2]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 281, 281, 281, FALSE);
+		pObj->pShades[3]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 268, 268, 268, FALSE);
 
 		// palette 4 is the non-modified palette.
 		// if the standard one has already been made, we'll use it
@@ -864,23 +872,23 @@ UINT32 count;
 			pObj->pShades[4]=pObj->p16BPPPalette;
 		else
 		{
-			// or create our own, and assign it to the standard one
+			// or create our own, and assign it to the standard one (not shared, the standard one belongs to the object)
 			pObj->pShades[4]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 255, 255, 255, FALSE);
 			pObj->p16BPPPalette=pObj->pShades[4];
 		}
 
 		// the rest are darkening tables, right down to all-black.
-		pObj->pShades[5]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 195, 195, 195, FALSE);
-		pObj->pShades[6]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 165, 165, 165, FALSE);
-		pObj->pShades[7]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 135, 135, 135, FALSE);
-		pObj->pShades[8]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 105, 105, 105, FALSE);
-		pObj->pShades[9]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 75, 75, 75, FALSE);
-		pObj->pShades[10]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 45, 45, 45, FALSE);
-		pObj->pShades[11]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 36, 36, 36, FALSE);
-		pObj->pShades[12]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 27, 27, 27, FALSE);
-		pObj->pShades[13]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 18, 18, 18, FALSE);
-		pObj->pShades[14]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 9, 9, 9, FALSE);
-		pObj->pShades[15]=Create16BPPPaletteShaded( pObj->pPaletteEntry, 0, 0, 0, FALSE);
+		pObj->pShades[5]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 195, 195, 195, FALSE);
+		pObj->pShades[6]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 165, 165, 165, FALSE);
+		pObj->pShades[7]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 135, 135, 135, FALSE);
+		pObj->pShades[8]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 105, 105, 105, FALSE);
+		pObj->pShades[9]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 75, 75, 75, FALSE);
+		pObj->pShades[10]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 45, 45, 45, FALSE);
+		pObj->pShades[11]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 36, 36, 36, FALSE);
+		pObj->pShades[12]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 27, 27, 27, FALSE);
+		pObj->pShades[13]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 18, 18, 18, FALSE);
+		pObj->pShades[14]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 9, 9, 9, FALSE);
+		pObj->pShades[15]=AcquireShadePalette( pObj->pPaletteEntry, uiPaletteHash, 0, 0, 0, FALSE);
 
 		// Set current shade table to neutral color
 		pObj->pShadeCurrent=pObj->pShades[4];
@@ -1063,7 +1071,7 @@ BOOLEAN f16BitPal;
 				else
 					f16BitPal = FALSE;
 
-				MemFree( hVObject->pShades[x] );
+				ReleaseShadePalette( hVObject->pShades[x] );
 				hVObject->pShades[x] = NULL;
 
 				if ( f16BitPal )
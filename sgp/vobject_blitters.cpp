@@ -7,10 +7,12 @@
 	#include "WCheck.h"
 	#include "vobject.h"
 	#include "vobject_blitters.h"
+	#include "vobject_blitters_sse2.h"
 	#include "shading.h"
 	#include "sgp_logger.h"
 
 #include <map>
+#include <vector>
 std::map<UINT32,ClipRectangle> g_SurfaceRectangle;
 
 static UINT8 g_AlphaTimesValueCache[256][256];
@@ -3273,6 +3275,12 @@ BOOLEAN Blt8BPPDataTo16BPPBufferTransZ( UINT16 *pBuffer, UINT32 uiDestPitchBYTES
 	p16BPPPalette = hSrcVObject->pShadeCurrent;
 	LineSkip=(uiDestPitchBYTES-(usWidth*2));
 
+	if ( gfBlitterSSE2 )
+	{
+		Blt8BPPETRLEZNoClipSSE2( SrcPtr, (UINT16 *)DestPtr, (UINT16 *)ZPtr, uiDestPitchBYTES, p16BPPPalette, usZValue, TRUE, usWidth, usHeight );
+		return(TRUE);
+	}
+
 	__asm {
 
 		mov		esi, SrcPtr
@@ -3392,6 +3400,12 @@ BOOLEAN Blt8BPPDataTo16BPPBufferTransZNB( UINT16 *pBuffer, UINT32 uiDestPitchBYT
 	p16BPPPalette = hSrcVObject->pShadeCurrent;
 	LineSkip=(uiDestPitchBYTES-(usWidth*2));
 
+	if ( gfBlitterSSE2 )
+	{
+		Blt8BPPETRLEZNoClipSSE2( SrcPtr, (UINT16 *)DestPtr, (UINT16 *)ZPtr, uiDestPitchBYTES, p16BPPPalette, usZValue, FALSE, usWidth, usHeight );
+		return(TRUE);
+	}
+
 	__asm {
 
 		mov		esi, SrcPtr
@@ -8477,6 +8491,12 @@ BOOLEAN Blt8BPPDataTo16BPPBufferTransZClip( UINT16 *pBuffer, UINT32 uiDestPitchB
 	p16BPPPalette = hSrcVObject->pShadeCurrent;
 	LineSkip=(uiDestPitchBYTES-(BlitLength*2));
 
+	if ( gfBlitterSSE2 )
+	{
+		Blt8BPPETRLEZSSE2( SrcPtr, (UINT16 *)DestPtr, (UINT16 *)ZPtr, uiDestPitchBYTES, p16BPPPalette, usZValue, TRUE, TopSkip, LeftSkip, BlitLength, BlitHeight );
+		return(TRUE);
+	}
+
 	__asm {
 
 		mov		esi, SrcPtr
@@ -8728,6 +8748,12 @@ BOOLEAN Blt8BPPDataTo16BPPBufferTransZNBClip( UINT16 *pBuffer, UINT32 uiDestPitc
 	p16BPPPalette = hSrcVObject->pShadeCurrent;
 	LineSkip=(uiDestPitchBYTES-(BlitLength*2));
 
+	if ( gfBlitterSSE2 )
+	{
+		Blt8BPPETRLEZSSE2( SrcPtr, (UINT16 *)DestPtr, (UINT16 *)ZPtr, uiDestPitchBYTES, p16BPPPalette, usZValue, FALSE, TopSkip, LeftSkip, BlitLength, BlitHeight );
+		return(TRUE);
+	}
+
 	__asm {
 
 		mov		esi, SrcPtr
@@ -11671,12 +11697,13 @@ FillLineEnd:
 
 
 /**********************************************************************************************
- BltIsClippedOrOffScreen
+ BltCalcClipSkips
 
-	Determines whether a given blit will need clipping or not. Returns TRUE/FALSE.
+	Calculates how much of a blit hangs off each side of the clip region. Returns TRUE if it needs
+	clipping, FALSE if not and -1 if nothing of it is in the clip region.
 
 **********************************************************************************************/
-CHAR8 BltIsClippedOrOffScreen( HVOBJECT hSrcVObject, INT32 iX, INT32 iY, UINT16 usIndex, SGPRect *clipregion )
+static CHAR8 BltCalcClipSkips( HVOBJECT hSrcVObject, INT32 iX, INT32 iY, UINT16 usIndex, SGPRect *clipregion, INT32 &iLeftSkip, INT32 &iRightSkip, INT32 &iTopSkip, INT32 &iBottomSkip )
 {
 	UINT32 usHeight, usWidth;
 	ETRLEObject *pTrav;
@@ -11712,32 +11739,30 @@ CHAR8 BltIsClippedOrOffScreen( HVOBJECT hSrcVObject, INT32 iX, INT32 iY, UINT16
 
 
 	// Calculate rows hanging off each side of the screen
-	gLeftSkip=__min(ClipX1 - min(ClipX1, iTempX), (INT32)usWidth);
-	gRightSkip=__min(max(ClipX2, (iTempX+(INT32)usWidth)) - ClipX2, (INT32)usWidth);
-	gTopSkip=__min(ClipY1 - __min(ClipY1, iTempY), (INT32)usHeight);
-	gBottomSkip=__min(__max(ClipY2, (iTempY+(INT32)usHeight)) - ClipY2, (INT32)usHeight);
-
-	gfUsePreCalcSkips = TRUE;
+	iLeftSkip=__min(ClipX1 - min(ClipX1, iTempX), (INT32)usWidth);
+	iRightSkip=__min(max(ClipX2, (iTempX+(INT32)usWidth)) - ClipX2, (INT32)usWidth);
+	iTopSkip=__min(ClipY1 - __min(ClipY1, iTempY), (INT32)usHeight);
+	iBottomSkip=__min(__max(ClipY2, (iTempY+(INT32)usHeight)) - ClipY2, (INT32)usHeight);
 
 	// check if whole thing is clipped
-	if((gLeftSkip >=(INT32)usWidth) || (gRightSkip >=(INT32)usWidth))
+	if((iLeftSkip >=(INT32)usWidth) || (iRightSkip >=(INT32)usWidth))
 		return(-1 );
 
 	// check if whole thing is clipped
-	if((gTopSkip >=(INT32)usHeight) || (gBottomSkip >=(INT32)usHeight))
+	if((iTopSkip >=(INT32)usHeight) || (iBottomSkip >=(INT32)usHeight))
 		return(-1 );
 
 
-	if ( gLeftSkip )
+	if ( iLeftSkip )
 		return( TRUE );
 
-	if ( gRightSkip )
+	if ( iRightSkip )
 		return( TRUE );
 
-	if ( gTopSkip )
+	if ( iTopSkip )
 		return( TRUE );
 
-	if ( gBottomSkip )
+	if ( iBottomSkip )
 		return( TRUE );
 
 
@@ -11745,6 +11770,36 @@ CHAR8 BltIsClippedOrOffScreen( HVOBJECT hSrcVObject, INT32 iX, INT32 iY, UINT16
 }
 
 
+/**********************************************************************************************
+ BltIsClippedOrOffScreen
+
+	Determines whether a given blit will need clipping or not. Returns TRUE/FALSE.
+
+**********************************************************************************************/
+CHAR8 BltIsClippedOrOffScreen( HVOBJECT hSrcVObject, INT32 iX, INT32 iY, UINT16 usIndex, SGPRect *clipregion )
+{
+	CHAR8 bResult = BltCalcClipSkips( hSrcVObject, iX, iY, usIndex, clipregion, gLeftSkip, gRightSkip, gTopSkip, gBottomSkip );
+
+	gfUsePreCalcSkips = TRUE;
+
+	return( bResult );
+}
+
+/**********************************************************************************************
+ BltIsClippedOrOffScreenNoPreCalc
+
+	The same, without keeping the skips for the next blit in gLeftSkip etc., so it can be
+	called from more than one thread at a time.
+
+**********************************************************************************************/
+CHAR8 BltIsClippedOrOffScreenNoPreCalc( HVOBJECT hSrcVObject, INT32 iX, INT32 iY, UINT16 usIndex, SGPRect *clipregion )
+{
+	INT32 iLeftSkip, iRightSkip, iTopSkip, iBottomSkip;
+
+	return( BltCalcClipSkips( hSrcVObject, iX, iY, usIndex, clipregion, iLeftSkip, iRightSkip, iTopSkip, iBottomSkip ) );
+}
+
+
 
 
 // Blt8BPPDataTo16BPPBufferOutline
@@ -14883,3 +14938,156 @@ BlitDone:
 	return(TRUE);
 
 }
+
+#ifdef JA2TESTVERSION
+// tiny generator of its own, so the test blits the same images every time and doesn't touch the game's randoms
+static UINT32 BlitterTestRandom( UINT32 &uiSeed, UINT32 uiRange )
+{
+	uiSeed = uiSeed * 1103515245 + 12345;
+	return ( uiSeed >> 8 ) % uiRange;
+}
+
+// An ETRLE image of random transparent and opaque runs. With fShortLines some lines leave out the transparent run
+// at their end, which only the unclipped blitters can take.
+static void MakeBlitterTestImage( std::vector<UINT8> &data, UINT16 usWidth, UINT16 usHeight, BOOLEAN fShortLines, UINT32 &uiSeed )
+{
+	data.clear();
+
+	for ( UINT16 usLine = 0; usLine < usHeight; ++usLine )
+	{
+		UINT32 uiLeft = usWidth;
+
+		while ( uiLeft > 0 )
+		{
+			UINT32 uiRun = 1 + BlitterTestRandom( uiSeed, __min( uiLeft, 127 ) );
+			BOOLEAN fTransparent = BlitterTestRandom( uiSeed, 3 ) == 0;
+
+			if ( fTransparent && uiRun == uiLeft && fShortLines && BlitterTestRandom( uiSeed, 2 ) )
+			{
+				break;
+			}
+
+			if ( fTransparent )
+			{
+				data.push_back( (UINT8)( 0x80 | uiRun ) );
+			}
+			else
+			{
+				data.push_back( (UINT8)uiRun );
+				for ( UINT32 cnt = 0; cnt < uiRun; ++cnt )
+				{
+					// 0 isn't an opaque pixel, the clipped blitters look for it to find the end of the line
+					data.push_back( (UINT8)( 1 + BlitterTestRandom( uiSeed, 255 ) ) );
+				}
+			}
+			uiLeft -= uiRun;
+		}
+
+		data.push_back( 0 );
+	}
+}
+
+// Blits random images onto random destination and z buffers with TransZ, TransZNB and their Clip versions, once
+// through the asm and once through the SSE2 code, and compares the resulting buffers. Does nothing without SSE2.
+void CompareBlitterSSE2( UINT32 *puiBlits, UINT32 *puiMismatches )
+{
+	const UINT32		uiWidth = 320;
+	const UINT32		uiHeight = 240;
+	const UINT32		uiPitchBYTES = uiWidth * 2;
+	const UINT32		uiPixels = uiWidth * uiHeight;
+	BOOLEAN				fSSE2 = gfBlitterSSE2;
+	UINT32				uiSeed = 1;
+	UINT16				usPalette[ 256 ];
+	std::vector<UINT8>	image;
+	std::vector<UINT16>	dest( uiPixels ), z( uiPixels ), destAsm( uiPixels ), zAsm( uiPixels ), destSSE2( uiPixels ), zSSE2( uiPixels );
+	ETRLEObject			etrle;
+	SGPVObject			vobject;
+
+	*puiBlits = 0;
+	*puiMismatches = 0;
+
+	if ( !fSSE2 )
+		return;
+
+	for ( UINT32 cnt = 0; cnt < 256; ++cnt )
+	{
+		usPalette[ cnt ] = (UINT16)( cnt * 251 + 7 );
+	}
+
+	memset( &etrle, 0, sizeof( etrle ) );
+	memset( &vobject, 0, sizeof( vobject ) );
+	vobject.pETRLEObject = &etrle;
+	vobject.pShadeCurrent = usPalette;
+	vobject.usNumberOfObjects = 1;
+	vobject.ubBitDepth = 8;
+
+	for ( UINT32 uiTest = 0; uiTest < 2000; ++uiTest )
+	{
+		BOOLEAN fShortLines = ( uiTest % 4 ) == 3;
+		UINT16 usZValue = (UINT16)BlitterTestRandom( uiSeed, 0x10000 );
+
+		etrle.usWidth = (UINT16)( 1 + BlitterTestRandom( uiSeed, 200 ) );
+		etrle.usHeight = (UINT16)( 1 + BlitterTestRandom( uiSeed, 150 ) );
+		MakeBlitterTestImage( image, etrle.usWidth, etrle.usHeight, fShortLines, uiSeed );
+		etrle.uiDataLength = (UINT32)image.size();
+		vobject.pPixData = &image[ 0 ];
+		vobject.uiSizePixData = etrle.uiDataLength;
+
+		// z values below, at and above the object's, with long stretches of one of them so the 8 pixel steps
+		// see all kinds of mixes
+		for ( UINT32 cnt = 0; cnt < uiPixels; ++cnt )
+		{
+			dest[ cnt ] = (UINT16)BlitterTestRandom( uiSeed, 0x10000 );
+			z[ cnt ] = (UINT16)( usZValue + (INT32)( ( cnt / ( 1 + uiTest % 16 ) ) % 3 ) - 1 );
+		}
+
+		for ( UINT8 ubBlitter = 0; ubBlitter < ( fShortLines ? 2 : 4 ); ++ubBlitter )
+		{
+			SGPRect	clip;
+			INT32	iX, iY;
+
+			if ( ubBlitter < 2 )
+			{
+				iX = BlitterTestRandom( uiSeed, uiWidth - etrle.usWidth + 1 );
+				iY = BlitterTestRandom( uiSeed, uiHeight - etrle.usHeight + 1 );
+			}
+			else
+			{
+				iX = (INT32)BlitterTestRandom( uiSeed, uiWidth + etrle.usWidth ) - etrle.usWidth;
+				iY = (INT32)BlitterTestRandom( uiSeed, uiHeight + etrle.usHeight ) - etrle.usHeight;
+			}
+
+			clip.iLeft = BlitterTestRandom( uiSeed, uiWidth );
+			clip.iRight = clip.iLeft + 1 + BlitterTestRandom( uiSeed, uiWidth - clip.iLeft );
+			clip.iTop = BlitterTestRandom( uiSeed, uiHeight );
+			clip.iBottom = clip.iTop + 1 + BlitterTestRandom( uiSeed, uiHeight - clip.iTop );
+
+			for ( UINT8 ubPass = 0; ubPass < 2; ++ubPass )
+			{
+				UINT16 *pDest = ubPass ? &destSSE2[ 0 ] : &destAsm[ 0 ];
+				UINT16 *pZ = ubPass ? &zSSE2[ 0 ] : &zAsm[ 0 ];
+
+				memcpy( pDest, &dest[ 0 ], uiPixels * sizeof( UINT16 ) );
+				memcpy( pZ, &z[ 0 ], uiPixels * sizeof( UINT16 ) );
+				gfBlitterSSE2 = ubPass ? TRUE : FALSE;
+
+				switch ( ubBlitter )
+				{
+					case 0:	Blt8BPPDataTo16BPPBufferTransZ( pDest, uiPitchBYTES, pZ, usZValue, &vobject, iX, iY, 0 );					break;
+					case 1:	Blt8BPPDataTo16BPPBufferTransZNB( pDest, uiPitchBYTES, pZ, usZValue, &vobject, iX, iY, 0 );					break;
+					case 2:	Blt8BPPDataTo16BPPBufferTransZClip( pDest, uiPitchBYTES, pZ, usZValue, &vobject, iX, iY, 0, &clip );		break;
+					case 3:	Blt8BPPDataTo16BPPBufferTransZNBClip( pDest, uiPitchBYTES, pZ, usZValue, &vobject, iX, iY, 0, &clip );		break;
+				}
+			}
+
+			++(*puiBlits);
+			if ( destAsm != destSSE2 || zAsm != zSSE2 )
+			{
+				++(*puiMismatches);
+			}
+		}
+	}
+
+	gfBlitterSSE2 = fSSE2;
+}
+#endif
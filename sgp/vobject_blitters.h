@@ -48,6 +48,8 @@ void GetClippingRect(SGPRect *clip);
 
 BOOLEAN BltIsClipped(HVOBJECT hSrcVObject, INT32 iX, INT32 iY, UINT16 usIndex, SGPRect *clipregion);
 CHAR8 BltIsClippedOrOffScreen( HVOBJECT hSrcVObject, INT32 iX, INT32 iY, UINT16 usIndex, SGPRect *clipregion );
+// doesn't set the pre-calculated skips, for blits on other threads
+CHAR8 BltIsClippedOrOffScreenNoPreCalc( HVOBJECT hSrcVObject, INT32 iX, INT32 iY, UINT16 usIndex, SGPRect *clipregion );
 
 
 UINT16 *InitZBuffer(UINT32 uiPitch, UINT32 uiHeight);
@@ -0,0 +1,222 @@
+	#include "types.h"
+	#include "vobject_blitters_sse2.h"
+
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#else
+	#include <cpuid.h>
+#endif
+
+BOOLEAN gfBlitterSSE2 = FALSE;
+
+void DetectBlitterCPUFeatures( void )
+{
+	// CPUID leaf 1, EDX bit 26
+#if defined(_MSC_VER)
+	int iRegs[4];
+
+	__cpuid( iRegs, 1 );
+	gfBlitterSSE2 = ( iRegs[3] & ( 1 << 26 ) ) ? TRUE : FALSE;
+#else
+	unsigned int uiEAX, uiEBX, uiECX, uiEDX;
+
+	gfBlitterSSE2 = FALSE;
+	if ( __get_cpuid( 1, &uiEAX, &uiEBX, &uiECX, &uiEDX ) )
+	{
+		gfBlitterSSE2 = ( uiEDX & ( 1 << 26 ) ) ? TRUE : FALSE;
+	}
+#endif
+}
+
+// Draws a run of opaque pixels.
+static inline void BlitZSpanSSE2( UINT16 *pDest, UINT16 *pZ, const UINT8 *pSrc, UINT32 uiCount, const UINT16 *p16BPPPalette, UINT16 usZValue, BOOLEAN fWriteZ )
+{
+	// SSE2 only has signed 16 bit compares, so flip the top bit of both sides first
+	const __m128i vBias = _mm_set1_epi16( (short)0x8000 );
+	const __m128i vZValue = _mm_set1_epi16( (short)usZValue );
+	const __m128i vZValueBiased = _mm_xor_si128( vZValue, vBias );
+
+	while ( uiCount >= 8 )
+	{
+		__m128i vZBuf = _mm_loadu_si128( (const __m128i *)pZ );
+		// set where the z buffer is above our z value, ie. where the old pixel stays
+		__m128i vKeep = _mm_cmpgt_epi16( _mm_xor_si128( vZBuf, vBias ), vZValueBiased );
+
+		if ( _mm_movemask_epi8( vKeep ) != 0xFFFF )
+		{
+			__m128i vPixels = _mm_setr_epi16( p16BPPPalette[ pSrc[0] ], p16BPPPalette[ pSrc[1] ], p16BPPPalette[ pSrc[2] ], p16BPPPalette[ pSrc[3] ],
+											  p16BPPPalette[ pSrc[4] ], p16BPPPalette[ pSrc[5] ], p16BPPPalette[ pSrc[6] ], p16BPPPalette[ pSrc[7] ] );
+			__m128i vDest = _mm_loadu_si128( (const __m128i *)pDest );
+
+			vDest = _mm_or_si128( _mm_and_si128( vKeep, vDest ), _mm_andnot_si128( vKeep, vPixels ) );
+			_mm_storeu_si128( (__m128i *)pDest, vDest );
+
+			if ( fWriteZ )
+			{
+				vZBuf = _mm_or_si128( _mm_and_si128( vKeep, vZBuf ), _mm_andnot_si128( vKeep, vZValue ) );
+				_mm_storeu_si128( (__m128i *)pZ, vZBuf );
+			}
+		}
+
+		pDest += 8;
+		pZ += 8;
+		pSrc += 8;
+		uiCount -= 8;
+	}
+
+	while ( uiCount-- )
+	{
+		if ( *pZ <= usZValue )
+		{
+			if ( fWriteZ )
+			{
+				*pZ = usZValue;
+			}
+			*pDest = p16BPPPalette[ *pSrc ];
+		}
+
+		++pDest;
+		++pZ;
+		++pSrc;
+	}
+}
+
+// Run decoding follows the asm Clip blitters step by step, including skipping to the end of a line by looking for
+// the zero byte that ends it.
+void Blt8BPPETRLEZSSE2( UINT8 *pSrc, UINT16 *pDest, UINT16 *pZ, UINT32 uiDestPitchBYTES, UINT16 *p16BPPPalette, UINT16 usZValue, BOOLEAN fWriteZ,
+						INT32 iTopSkip, INT32 iLeftSkip, INT32 iBlitLength, INT32 iBlitHeight )
+{
+	UINT32	uiLineSkip = uiDestPitchBYTES / 2 - iBlitLength;
+	UINT32	uiRun;
+	UINT32	uiCount;
+	UINT32	uiUnblitted;
+	INT32	iLSCount;
+
+	// skip the lines clipped at the top
+	while ( iTopSkip > 0 )
+	{
+		uiRun = *pSrc++;
+		if ( uiRun & 0x80 )
+		{
+			continue;
+		}
+		if ( uiRun == 0 )
+		{
+			--iTopSkip;
+			continue;
+		}
+		pSrc += uiRun;
+	}
+
+	while ( iBlitHeight > 0 )
+	{
+		// skip the pixels clipped on the left; a run straddling the edge is blitted from where the edge is
+		iLSCount = iLeftSkip;
+		uiCount = 0;
+		BOOLEAN fTransparent = FALSE;
+
+		while ( iLSCount > 0 )
+		{
+			uiRun = *pSrc++;
+			if ( uiRun & 0x80 )
+			{
+				uiRun &= 0x7F;
+				if ( (INT32)uiRun > iLSCount )
+				{
+					uiCount = uiRun - iLSCount;
+					fTransparent = TRUE;
+				}
+				iLSCount -= __min( (INT32)uiRun, iLSCount );
+			}
+			else
+			{
+				if ( (INT32)uiRun > iLSCount )
+				{
+					pSrc += iLSCount;
+					uiCount = uiRun - iLSCount;
+				}
+				else
+				{
+					pSrc += uiRun;
+				}
+				iLSCount -= __min( (INT32)uiRun, iLSCount );
+			}
+		}
+
+		iLSCount = iBlitLength;
+
+		while ( iLSCount > 0 )
+		{
+			if ( !uiCount )
+			{
+				uiRun = *pSrc++;
+				fTransparent = ( uiRun & 0x80 ) ? TRUE : FALSE;
+				uiCount = uiRun & 0x7F;
+			}
+
+			uiUnblitted = 0;
+			if ( (INT32)uiCount > iLSCount )
+			{
+				uiUnblitted = uiCount - iLSCount;
+				uiCount = iLSCount;
+			}
+			iLSCount -= uiCount;
+
+			if ( !fTransparent )
+			{
+				BlitZSpanSSE2( pDest, pZ, pSrc, uiCount, p16BPPPalette, usZValue, fWriteZ );
+				pSrc += uiCount + uiUnblitted;
+			}
+
+			pDest += uiCount;
+			pZ += uiCount;
+			uiCount = 0;
+		}
+
+		// skip what's clipped on the right, up to the end of line marker
+		while ( *pSrc++ != 0 )
+			;
+
+		pDest += uiLineSkip;
+		pZ += uiLineSkip;
+		--iBlitHeight;
+	}
+}
+
+// Run decoding follows the asm of Blt8BPPDataTo16BPPBufferTransZ: a zero byte ends the line wherever it comes.
+void Blt8BPPETRLEZNoClipSSE2( UINT8 *pSrc, UINT16 *pDest, UINT16 *pZ, UINT32 uiDestPitchBYTES, UINT16 *p16BPPPalette, UINT16 usZValue, BOOLEAN fWriteZ,
+							  UINT32 usWidth, UINT32 usHeight )
+{
+	UINT32	uiLineSkip = uiDestPitchBYTES / 2 - usWidth;
+	UINT32	uiRun;
+
+	while ( usHeight > 0 )
+	{
+		uiRun = *pSrc++;
+
+		if ( uiRun & 0x80 )
+		{
+			uiRun &= 0x7F;
+		}
+		else if ( uiRun )
+		{
+			BlitZSpanSSE2( pDest, pZ, pSrc, uiRun, p16BPPPalette, usZValue, fWriteZ );
+			pSrc += uiRun;
+		}
+		else
+		{
+			// end of line
+			if ( --usHeight == 0 )
+			{
+				break;
+			}
+			pDest += uiLineSkip;
+			pZ += uiLineSkip;
+			continue;
+		}
+
+		pDest += uiRun;
+		pZ += uiRun;
+	}
+}
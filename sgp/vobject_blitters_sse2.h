@@ -0,0 +1,34 @@
+#ifndef __VOBJECT_BLITTERS_SSE2
+#define __VOBJECT_BLITTERS_SSE2
+
+#include "types.h"
+
+// SSE2 versions of the inner loops of the plain Z blitters (Blt8BPPDataTo16BPPBufferTransZ, ...TransZNB and
+// their Clip versions). The ETRLE runs are still decoded one by one, but long runs of opaque pixels get their
+// z test, z write and pixel write done 8 pixels at a time. The asm blitters stay the reference, and are used
+// whenever the CPU lacks SSE2.
+
+extern BOOLEAN gfBlitterSSE2;
+
+// Checks the CPU and sets gfBlitterSSE2. Called once when the video object manager starts up.
+void DetectBlitterCPUFeatures( void );
+
+// Blits BlitHeight lines of an ETRLE image, starting TopSkip lines into the source and LeftSkip pixels into every
+// line, BlitLength pixels wide. pSrc, pDest and pZ point where the asm blitters would start (the first source
+// line, the first visible destination pixel). Pixels are drawn where the z buffer is not above usZValue, and
+// if fWriteZ is set the z buffer is updated as well.
+void Blt8BPPETRLEZSSE2( UINT8 *pSrc, UINT16 *pDest, UINT16 *pZ, UINT32 uiDestPitchBYTES, UINT16 *p16BPPPalette, UINT16 usZValue, BOOLEAN fWriteZ,
+						INT32 iTopSkip, INT32 iLeftSkip, INT32 iBlitLength, INT32 iBlitHeight );
+
+// The same for the unclipped blitters: each line is blitted run by run up to the zero byte that ends it, as their
+// asm does, usWidth is only needed to get to the start of the next destination line.
+void Blt8BPPETRLEZNoClipSSE2( UINT8 *pSrc, UINT16 *pDest, UINT16 *pZ, UINT32 uiDestPitchBYTES, UINT16 *p16BPPPalette, UINT16 usZValue, BOOLEAN fWriteZ,
+							  UINT32 usWidth, UINT32 usHeight );
+
+#ifdef JA2TESTVERSION
+// golden image test: the same random blits through the asm and the SSE2 code, counts the blits and those whose
+// destination or z buffer came out different
+void CompareBlitterSSE2( UINT32 *puiBlits, UINT32 *puiMismatches );
+#endif
+
+#endif